@@ -13,12 +13,38 @@ struct mge_engine_config_t
 	mgl_bool_t debug_mode;
 	mgl_u64_t max_resource_count;
 	mgl_u64_t max_scene_node_count;
+	mgl_u64_t worker_thread_count;
+	mgl_u64_t max_job_count;
+	mgl_u64_t target_frame_rate;
+	mgl_u64_t fixed_update_rate;
+	mgl_u64_t max_fixed_update_count;
+	mgl_bool_t headless;
+	mgl_u64_t frame_cap;
+	mgl_u64_t max_scene_command_count;
+	mgl_u64_t scene_update_budget;
+	mgl_u64_t profile_frame_count;
+	mgl_u64_t max_profile_event_count;
+	mgl_u64_t memory_steady_frame;
+	mgl_u64_t frame_allocator_size;
 };
 
 #define MGE_DEFAULT_ENGINE_CONFIG ((mge_engine_config_t) { \
 MGL_FALSE,\
 1024,\
 1024,\
+0,\
+4096,\
+60,\
+60,\
+8,\
+MGL_FALSE,\
+0,\
+4096,\
+2000,\
+0,\
+65536,\
+0,\
+4194304,\
 })
 
 void mge_load_config(int argc, char** argv, mge_engine_config_t* config);
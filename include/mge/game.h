@@ -4,22 +4,58 @@
 extern "C" {
 #endif
 
+#include <mgl/type.h>
+
 typedef struct mge_engine_config_t mge_engine_config_t;
 typedef struct mge_resource_manager_t mge_resource_manager_t;
 typedef struct mge_scene_manager_t mge_scene_manager_t;
+typedef struct mge_scene_commands_t mge_scene_commands_t;
+typedef struct mge_scene_scheduler_t mge_scene_scheduler_t;
+typedef struct mge_job_system_t mge_job_system_t;
+typedef struct mge_loop_t mge_loop_t;
+typedef struct mge_frame_allocator_t mge_frame_allocator_t;
 typedef struct mge_game_locator_t mge_game_locator_t;
 
 struct mge_game_locator_t
 {
 	mge_resource_manager_t* resource_manager;
 	mge_scene_manager_t* scene_manager;
-	
+	mge_scene_commands_t* scene_commands;
+	mge_scene_scheduler_t* scene_scheduler;
+	mge_job_system_t* job_system;
+	mge_loop_t* loop;
+
+	/// <summary>
+	///		Allocator for game allocations, tracked under the "game" tag.
+	/// </summary>
+	void* game_allocator;
+
+	/// <summary>
+	///		Allocator for per-frame temporaries, whose memory stays valid until the end of the next frame and doesn't need
+	///		to be deallocated (see mge/memory/frame.h).
+	/// </summary>
+	mge_frame_allocator_t* frame_allocator;
+
+	/// <summary>
+	///		Command line arguments, including the engine options, for games with options of their own.
+	/// </summary>
+	mgl_u64_t argument_count;
+	char** arguments;
+
+	/// <summary>
+	///		Exit code returned by the engine once it terminates (0 by default), for tools which report failures.
+	/// </summary>
+	int exit_code;
 };
 
 extern void mge_game_load(mge_game_locator_t* locator);
 
 extern void mge_game_unload(mge_game_locator_t* locator);
 
+extern void mge_game_fixed_update(mge_game_locator_t* locator);
+
+extern void mge_game_update(mge_game_locator_t* locator);
+
 extern void mge_game_get_config(mge_engine_config_t* config);
 
 #ifdef __cplusplus
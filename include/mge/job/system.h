@@ -0,0 +1,137 @@
+#ifndef MGE_JOB_SYSTEM_H
+#define MGE_JOB_SYSTEM_H
+#ifdef __cplusplus
+extern "C" {
+#endif 
+
+#include <mgl/type.h>
+
+#define MGE_MAX_JOB_DATA_SIZE 32
+
+	typedef struct mge_job_t mge_job_t;
+	typedef struct mge_job_system_t mge_job_system_t;
+	typedef struct mge_job_system_stats_t mge_job_system_stats_t;
+
+	/// <summary>
+	///		Job function.
+	///		Receives the job being executed (which can be used as a parent for new jobs) and a pointer to the job's data copy.
+	/// </summary>
+	typedef void(*mge_job_func_t)(mge_job_t* job, void* data);
+
+	struct mge_job_system_stats_t
+	{
+		/// <summary>
+		///		Number of workers (including the main thread).
+		/// </summary>
+		mgl_u64_t worker_count;
+
+		/// <summary>
+		///		Number of jobs executed since the last stats reset.
+		/// </summary>
+		mgl_u64_t executed_job_count;
+
+		/// <summary>
+		///		Number of times a worker tried to steal a job from another worker.
+		/// </summary>
+		mgl_u64_t steal_attempt_count;
+
+		/// <summary>
+		///		Number of jobs successfully stolen from other workers.
+		/// </summary>
+		mgl_u64_t steal_count;
+	};
+
+	/// <summary>
+	///		Initializes a job system.
+	///		The calling thread becomes worker 0 and worker_count - 1 worker threads are started.
+	///		Each worker owns a work-stealing deque and a ring of max_job_count jobs.
+	///		Finished jobs are recycled by the ring, so job pointers must not be used after the job finishes.
+	/// </summary>
+	/// <param name="allocator">Allocator used</param>
+	/// <param name="worker_count">Worker count, including the calling thread (0 = one per logical CPU)</param>
+	/// <param name="max_job_count">Max number of unfinished jobs created by a single worker (must be a power of two)</param>
+	/// <returns>Pointer to job system</returns>
+	mge_job_system_t* mge_init_job_system(void* allocator, mgl_u64_t worker_count, mgl_u64_t max_job_count);
+
+	/// <summary>
+	///		Terminates a job system, stopping and joining every worker thread.
+	///		Must be called from the thread which initialized the job system.
+	/// </summary>
+	/// <param name="system">Pointer to job system</param>
+	void mge_terminate_job_system(mge_job_system_t* system);
+
+	/// <summary>
+	///		Creates a new job, without running it.
+	///		Must be called from a worker thread of this job system.
+	///		If a parent is passed, the parent is only considered finished after this job finishes.
+	/// </summary>
+	/// <param name="system">Pointer to job system</param>
+	/// <param name="parent">Parent job (can be NULL)</param>
+	/// <param name="func">Job function</param>
+	/// <param name="data">Data copied into the job (can be NULL)</param>
+	/// <param name="data_size">Data size (at most MGE_MAX_JOB_DATA_SIZE bytes)</param>
+	/// <returns>Pointer to job</returns>
+	mge_job_t* mge_create_job(mge_job_system_t* system, mge_job_t* parent, mge_job_func_t func, const void* data, mgl_u64_t data_size);
+
+	/// <summary>
+	///		Pushes a job into the calling worker's queue, where it can be executed or stolen by any worker.
+	/// </summary>
+	/// <param name="job">Job</param>
+	void mge_run_job(mge_job_t* job);
+
+	/// <summary>
+	///		Waits until a job and all of its children finish.
+	///		The calling worker executes other jobs while waiting.
+	///		Must be called from the worker which created the job, since once the job finishes its slot can be reused by
+	///		that worker for another job (use mge_run_and_wait_job to wait on a job created by another worker).
+	/// </summary>
+	/// <param name="job">Job</param>
+	void mge_wait_job(mge_job_t* job);
+
+	/// <summary>
+	///		Runs a job (see mge_run_job) and waits until it and all of its children finish (see mge_wait_job).
+	///		Can be called from any worker, since the job can't finish before it's run.
+	/// </summary>
+	/// <param name="job">Job, which must not have been run yet</param>
+	void mge_run_and_wait_job(mge_job_t* job);
+
+	/// <summary>
+	///		Checks if a job and all of its children have finished.
+	///		Must be called from the worker which created the job (see mge_wait_job).
+	/// </summary>
+	/// <param name="job">Job</param>
+	/// <returns>MGL_TRUE if finished, otherwise MGL_FALSE</returns>
+	mgl_bool_t mge_is_job_finished(mge_job_t* job);
+
+	/// <summary>
+	///		Gets the number of workers in a job system (including the main thread).
+	/// </summary>
+	/// <param name="system">Pointer to job system</param>
+	/// <returns>Worker count</returns>
+	mgl_u64_t mge_get_job_worker_count(mge_job_system_t* system);
+
+	/// <summary>
+	///		Gets the index of the worker running on the calling thread.
+	/// </summary>
+	/// <param name="system">Pointer to job system</param>
+	/// <returns>Worker index, or mge_get_job_worker_count(system) if the calling thread isn't a worker</returns>
+	mgl_u64_t mge_get_job_worker_index(mge_job_system_t* system);
+
+	/// <summary>
+	///		Gets the accumulated stats of every worker.
+	///		Counters are read without synchronization, so they are only exact when no jobs are running.
+	/// </summary>
+	/// <param name="system">Pointer to job system</param>
+	/// <param name="stats">Out stats</param>
+	void mge_get_job_system_stats(mge_job_system_t* system, mge_job_system_stats_t* stats);
+
+	/// <summary>
+	///		Resets the stats counters of every worker.
+	/// </summary>
+	/// <param name="system">Pointer to job system</param>
+	void mge_reset_job_system_stats(mge_job_system_t* system);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -15,8 +15,21 @@ enum
 
 void mge_internal_init_log(void);
 
+/// <summary>
+///		Writes every pending log message (including messages other threads are logging while it's called), frees the
+///		log rings and closes the logs. Other threads must not log after it returns.
+/// </summary>
 void mge_internal_terminate_log(void);
 
+/// <summary>
+///		Logs a message.
+///		With MGE_ASYNC_LOG, the message is copied into the calling thread's log ring and written by the log thread
+///		once the line is complete (the message ends with a new line), so lines logged in parts are never interleaved
+///		with messages from other threads. A line which doesn't fit on the ring is dropped as a whole, and the number of
+///		dropped lines is logged instead.
+/// </summary>
+/// <param name="log">Log channel (MGE_LOG_*)</param>
+/// <param name="msg">Message</param>
 void mge_log(mgl_enum_t log, const mgl_chr8_t* msg);
 
 void mge_fatal_error(mgl_enum_t log, const mgl_chr8_t* msg);
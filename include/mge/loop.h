@@ -0,0 +1,102 @@
+#ifndef MGE_LOOP_H
+#define MGE_LOOP_H
+#ifdef __cplusplus
+extern "C" {
+#endif 
+
+#include <mgl/type.h>
+
+	typedef struct mge_engine_config_t mge_engine_config_t;
+	typedef struct mge_game_locator_t mge_game_locator_t;
+	typedef struct mge_loop_t mge_loop_t;
+	typedef struct mge_frame_info_t mge_frame_info_t;
+
+	struct mge_frame_info_t
+	{
+		/// <summary>
+		///		Index of the current frame.
+		/// </summary>
+		mgl_u64_t index;
+
+		/// <summary>
+		///		Simulation time since the loop started, in nanoseconds.
+		/// </summary>
+		mgl_u64_t time;
+
+		/// <summary>
+		///		Time since the previous frame, in seconds (used by the variable-rate update).
+		/// </summary>
+		mgl_f64_t delta_time;
+
+		/// <summary>
+		///		Fixed simulation step, in seconds (used by the fixed-rate update).
+		/// </summary>
+		mgl_f64_t fixed_delta_time;
+
+		/// <summary>
+		///		How far the simulation is between the last fixed update and the next one, in the range [0, 1[.
+		///		Can be used to interpolate state on the variable-rate update.
+		/// </summary>
+		mgl_f64_t interpolation;
+
+		/// <summary>
+		///		Number of fixed updates run on the current frame.
+		/// </summary>
+		mgl_u32_t fixed_update_count;
+
+		/// <summary>
+		///		Total number of fixed updates dropped because the catch-up limit was reached.
+		/// </summary>
+		mgl_u64_t dropped_fixed_update_count;
+
+		/// <summary>
+		///		Durations of each phase of the last completed frame, in nanoseconds.
+		/// </summary>
+		struct
+		{
+			mgl_u64_t fixed_update;
+			mgl_u64_t update;
+			mgl_u64_t idle;
+			mgl_u64_t frame;
+		} phase_time;
+	};
+
+	/// <summary>
+	///		Initializes the engine main loop.
+	/// </summary>
+	/// <param name="allocator">Allocator used</param>
+	/// <param name="config">Engine config (frame rates, catch-up limit, headless mode and frame cap)</param>
+	/// <returns>Pointer to loop</returns>
+	mge_loop_t* mge_init_loop(void* allocator, const mge_engine_config_t* config);
+
+	/// <summary>
+	///		Terminates the engine main loop.
+	/// </summary>
+	/// <param name="loop">Pointer to loop</param>
+	void mge_terminate_loop(mge_loop_t* loop);
+
+	/// <summary>
+	///		Runs the main loop until it is stopped or the frame cap is reached.
+	///		Each frame runs the fixed-rate updates, the variable-rate update and then waits for the next frame.
+	/// </summary>
+	/// <param name="loop">Pointer to loop</param>
+	/// <param name="locator">Game locator passed to the game update functions</param>
+	void mge_run_loop(mge_loop_t* loop, mge_game_locator_t* locator);
+
+	/// <summary>
+	///		Requests the main loop to stop after the current frame.
+	/// </summary>
+	/// <param name="loop">Pointer to loop</param>
+	void mge_stop_loop(mge_loop_t* loop);
+
+	/// <summary>
+	///		Gets the timing info of the current frame.
+	/// </summary>
+	/// <param name="loop">Pointer to loop</param>
+	/// <returns>Pointer to frame info</returns>
+	const mge_frame_info_t* mge_get_frame_info(mge_loop_t* loop);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,47 @@
+#ifndef MGE_MEMORY_FRAME_H
+#define MGE_MEMORY_FRAME_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <mgl/type.h>
+
+	typedef struct mge_frame_allocator_t mge_frame_allocator_t;
+
+	/// <summary>
+	///		Initializes a frame allocator, a bump allocator over two buffers which swap at every frame boundary.
+	///		Memory allocated on a frame stays valid until the end of the next frame, so it doesn't need to be deallocated
+	///		(deallocations do nothing).
+	///		The returned pointer is an MGL allocator and can be passed anywhere an allocator is expected.
+	///		Allocations can be made from any thread, running out of space on a frame is a fatal error.
+	/// </summary>
+	/// <param name="allocator">Allocator used for the buffers</param>
+	/// <param name="size">Size of each buffer</param>
+	/// <returns>Pointer to frame allocator</returns>
+	mge_frame_allocator_t* mge_init_frame_allocator(void* allocator, mgl_u64_t size);
+
+	/// <summary>
+	///		Terminates a frame allocator.
+	/// </summary>
+	/// <param name="allocator">Pointer to frame allocator</param>
+	void mge_terminate_frame_allocator(mge_frame_allocator_t* allocator);
+
+	/// <summary>
+	///		Swaps the buffers of a frame allocator, invalidating the memory allocated on the frame before the last one.
+	///		Called by the main loop at the end of every frame, while no other thread is allocating.
+	///		WARNING: This function shouldn't be used directly.
+	/// </summary>
+	/// <param name="allocator">Pointer to frame allocator</param>
+	void mge_swap_frame_allocator(mge_frame_allocator_t* allocator);
+
+	/// <summary>
+	///		Gets the highest number of bytes allocated on a frame, useful to choose -mge-frame-allocator-size.
+	/// </summary>
+	/// <param name="allocator">Pointer to frame allocator</param>
+	/// <returns>Peak size</returns>
+	mgl_u64_t mge_get_frame_allocator_peak_size(mge_frame_allocator_t* allocator);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,45 @@
+#ifndef MGE_MEMORY_POOL_H
+#define MGE_MEMORY_POOL_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <mgl/type.h>
+
+// Max number of threads with their own block cache on each pool allocator, other threads share the global free list
+#define MGE_MAX_POOL_THREAD_COUNT 64
+
+	typedef struct mge_pool_allocator_t mge_pool_allocator_t;
+
+	/// <summary>
+	///		Initializes a pool allocator, which hands out fixed-size blocks carved from chunks allocated on another allocator.
+	///		The returned pointer is an MGL allocator and can be passed anywhere an allocator is expected, as long as no
+	///		allocation is bigger than the block size or aligned to more than 16 bytes (which is a fatal error).
+	///		Each thread keeps a cache of free blocks, so allocations and deallocations only take a lock when a batch of
+	///		blocks is moved between a thread cache and the global free list.
+	///		Chunks are only given back to the wrapped allocator when the pool allocator is terminated.
+	/// </summary>
+	/// <param name="allocator">Allocator used for chunks</param>
+	/// <param name="block_size">Block size (rounded up to a multiple of 16)</param>
+	/// <param name="chunk_block_count">Number of blocks allocated at once when the pool runs out of blocks</param>
+	/// <returns>Pointer to pool allocator</returns>
+	mge_pool_allocator_t* mge_init_pool_allocator(void* allocator, mgl_u64_t block_size, mgl_u64_t chunk_block_count);
+
+	/// <summary>
+	///		Terminates a pool allocator, deallocating every chunk.
+	///		Blocks still allocated become invalid.
+	/// </summary>
+	/// <param name="allocator">Pointer to pool allocator</param>
+	void mge_terminate_pool_allocator(mge_pool_allocator_t* allocator);
+
+	/// <summary>
+	///		Gets the block size of a pool allocator, which is the max size it can allocate.
+	/// </summary>
+	/// <param name="allocator">Pointer to pool allocator</param>
+	/// <returns>Block size</returns>
+	mgl_u64_t mge_get_pool_allocator_block_size(mge_pool_allocator_t* allocator);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
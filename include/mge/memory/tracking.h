@@ -0,0 +1,93 @@
+#ifndef MGE_MEMORY_TRACKING_H
+#define MGE_MEMORY_TRACKING_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <mgl/type.h>
+
+#define MGE_MAX_TRACKING_ALLOCATOR_COUNT 64
+#define MGE_MAX_MEMORY_TAG_SIZE 32
+
+	typedef struct mge_tracking_allocator_t mge_tracking_allocator_t;
+	typedef struct mge_memory_stats_t mge_memory_stats_t;
+
+	struct mge_memory_stats_t
+	{
+		/// <summary>
+		///		Number of bytes currently allocated.
+		/// </summary>
+		mgl_u64_t live_bytes;
+
+		/// <summary>
+		///		Number of allocations not yet deallocated.
+		/// </summary>
+		mgl_u64_t live_allocation_count;
+
+		/// <summary>
+		///		Highest number of bytes allocated at the same time.
+		/// </summary>
+		mgl_u64_t peak_bytes;
+
+		/// <summary>
+		///		Number of allocations (including reallocations) since the allocator was initialized.
+		/// </summary>
+		mgl_u64_t allocation_count;
+
+		/// <summary>
+		///		Number of allocations made on frames after the steady state frame (see -mge-memory-steady-frame).
+		/// </summary>
+		mgl_u64_t steady_allocation_count;
+	};
+
+	/// <summary>
+	///		Initializes a tracking allocator, which forwards every allocation to another allocator and keeps count of the
+	///		memory allocated through it under a tag (usually a subsystem name).
+	///		The returned pointer is an MGL allocator and can be passed anywhere an allocator is expected.
+	///		Every tracking allocator is registered globally, so its stats can be found by tag.
+	/// </summary>
+	/// <param name="allocator">Allocator wrapped</param>
+	/// <param name="tag">Tag (copied, truncated to MGE_MAX_MEMORY_TAG_SIZE)</param>
+	/// <returns>Pointer to tracking allocator</returns>
+	mge_tracking_allocator_t* mge_init_tracking_allocator(void* allocator, const mgl_chr8_t* tag);
+
+	/// <summary>
+	///		Terminates a tracking allocator, logging a warning if it still has live allocations.
+	/// </summary>
+	/// <param name="allocator">Pointer to tracking allocator</param>
+	void mge_terminate_tracking_allocator(mge_tracking_allocator_t* allocator);
+
+	/// <summary>
+	///		Gets the stats of a tracking allocator.
+	///		Can be called from any thread at any time, the counters are atomic.
+	/// </summary>
+	/// <param name="allocator">Pointer to tracking allocator</param>
+	/// <param name="stats">Out stats</param>
+	void mge_get_tracking_allocator_stats(mge_tracking_allocator_t* allocator, mge_memory_stats_t* stats);
+
+	/// <summary>
+	///		Gets the stats of every tracking allocator with a tag, added together.
+	/// </summary>
+	/// <param name="tag">Tag (NULL for the totals of every tracking allocator)</param>
+	/// <param name="stats">Out stats</param>
+	/// <returns>MGL_TRUE if any tracking allocator matched, otherwise MGL_FALSE</returns>
+	mgl_bool_t mge_get_memory_stats(const mgl_chr8_t* tag, mge_memory_stats_t* stats);
+
+	/// <summary>
+	///		Logs the stats of every tracking allocator and the totals.
+	///		Called at shutdown, after the engine is terminated, so any live memory left is a leak.
+	/// </summary>
+	void mge_log_memory_stats(void);
+
+	/// <summary>
+	///		Starts counting allocations as steady state allocations, which are expected to not happen every frame.
+	///		The first steady state allocation of each tracking allocator is logged as a warning.
+	///		Called by the main loop on the frame set by -mge-memory-steady-frame.
+	///		WARNING: This function shouldn't be used directly.
+	/// </summary>
+	void mge_enter_steady_memory_state(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,75 @@
+#ifndef MGE_PROFILE_H
+#define MGE_PROFILE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <mgl/type.h>
+
+// Path of the trace written when the capture started by -mge-profile finishes
+#define MGE_PROFILE_TRACE_PATH u8"mge_profile.json"
+
+	/// <summary>
+	///		Is a profile capture running?
+	///		WARNING: This should not be set manually.
+	/// </summary>
+	extern volatile mgl_bool_t mge_internal_profiling;
+
+	/// <summary>
+	///		Initializes the profiler.
+	///		WARNING: This function shouldn't be used directly.
+	/// </summary>
+	/// <param name="allocator">Allocator used</param>
+	/// <param name="max_event_count">Max number of events each thread can record on a capture</param>
+	void mge_internal_init_profiler(void* allocator, mgl_u64_t max_event_count);
+
+	/// <summary>
+	///		Terminates the profiler.
+	///		WARNING: This function shouldn't be used directly.
+	/// </summary>
+	void mge_internal_terminate_profiler(void);
+
+	/// <summary>
+	///		Starts a profile capture, discarding the events of the last one.
+	///		Should be called while no other thread is recording events (e.g. between frames).
+	/// </summary>
+	void mge_start_profile_capture(void);
+
+	/// <summary>
+	///		Stops the running profile capture, if any, and writes it to a Chrome trace file
+	///		(which can be opened with chrome://tracing or https://ui.perfetto.dev).
+	///		The names and details of the events recorded must still be valid.
+	/// </summary>
+	/// <param name="path">Trace file path</param>
+	void mge_finish_profile_capture(const mgl_chr8_t* path);
+
+	/// <summary>
+	///		Records the beginning of a profile event on the calling thread.
+	///		WARNING: This function shouldn't be used directly, use MGE_PROFILE_BEGIN instead.
+	/// </summary>
+	/// <param name="name">Event name (must stay valid until the capture is written)</param>
+	/// <param name="detail">Event detail, shown as an argument (can be NULL, must stay valid until the capture is written)</param>
+	void mge_internal_begin_profile_event(const mgl_chr8_t* name, const mgl_chr8_t* detail);
+
+	/// <summary>
+	///		Records the end of the last profile event begun on the calling thread.
+	///		WARNING: This function shouldn't be used directly, use MGE_PROFILE_END instead.
+	/// </summary>
+	void mge_internal_end_profile_event(void);
+
+	// Profile events nest: every MGE_PROFILE_BEGIN must be matched by a MGE_PROFILE_END on the same thread.
+	// While no capture is running they only cost a branch, and without MGE_PROFILE they compile to nothing.
+#ifdef MGE_PROFILE
+#	define MGE_PROFILE_BEGIN(name) do { if (mge_internal_profiling) mge_internal_begin_profile_event(name, NULL); } while (0)
+#	define MGE_PROFILE_BEGIN_DETAIL(name, detail) do { if (mge_internal_profiling) mge_internal_begin_profile_event(name, detail); } while (0)
+#	define MGE_PROFILE_END() do { if (mge_internal_profiling) mge_internal_end_profile_event(); } while (0)
+#else
+#	define MGE_PROFILE_BEGIN(name) do {} while (0)
+#	define MGE_PROFILE_BEGIN_DETAIL(name, detail) do {} while (0)
+#	define MGE_PROFILE_END() do {} while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif
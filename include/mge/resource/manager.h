@@ -10,7 +10,10 @@ extern "C" {
 #define MGE_MAX_RESOURCE_DEPENDENCY_COUNT 8
 #define MGE_MAX_RESOURCE_NAME_SIZE 64
 #define MGE_MAX_RESOURCE_DATA_PATH_SIZE 256
+#define MGE_MAX_BACKGROUND_RESOURCE_LOAD_COUNT 256
+#define MGE_MAX_RESOURCE_NATIVE_DIRECTORY_COUNT 8
 
+	typedef struct mge_job_system_t mge_job_system_t;
 	typedef struct mge_resource_t mge_resource_t;
 	typedef struct mge_resource_access_base_t mge_resource_access_base_t;
 	typedef struct mge_resource_manager_t mge_resource_manager_t;
@@ -33,6 +36,7 @@ extern "C" {
 		MGE_RESOURCE_STREAMING_SOUND	= 0x06,
 		MGE_RESOURCE_MATERIAL			= 0x07,
 		MGE_RESOURCE_SHADER				= 0x08,
+		MGE_RESOURCE_PREFAB				= 0x09,
 	};
 
 	struct mge_resource_t
@@ -70,45 +74,115 @@ extern "C" {
 	///		Initializes a resource manager.
 	/// </summary>
 	/// <param name="allocator">Allocator used</param>
+	/// <param name="job_system">Job system used to load permanent resources in the background (can be NULL)</param>
 	/// <param name="max_resource_count">Max resource count</param>
 	/// <returns>Pointer to manager</returns>
-	mge_resource_manager_t* mge_init_resource_manager(void* allocator, mgl_u64_t max_resource_count);
+	mge_resource_manager_t* mge_init_resource_manager(void* allocator, mge_job_system_t* job_system, mgl_u64_t max_resource_count);
 
 	/// <summary>
-	///		Terminates a resource manager.
+	///		Terminates a resource manager, waiting for its background loads first.
 	/// </summary>
 	/// <param name="manager">Pointer to manager</param>
 	void mge_terminate_resource_manager(mge_resource_manager_t* manager);
 
 	/// <summary>
 	///		Adds a resource info file to the resource manager.
+	///		Permanent resources are loaded on the manager's job system while the rest of the file is parsed and the caller
+	///		goes on, up to MGE_MAX_BACKGROUND_RESOURCE_LOAD_COUNT at a time. They are loaded right away when there is no
+	///		job system, when it has a single worker or when the calling thread isn't one of its workers.
+	///		When the manager has an I/O queue, the file's permanent resources are loaded together by mge_load_resources instead.
+	///		The file's resources can be found once it returns. Info files are added one at a time, but lookups can go on
+	///		while they are added.
 	/// </summary>
 	/// <param name="manager">Pointer to manager</param>
 	/// <param name="path">Path to resource info file</param>
 	void mge_add_resource_info_file(mge_resource_manager_t* manager, const mgl_chr8_t* path);
 
 	/// <summary>
-	///		Searchs for a resource.
+	///		Adds a resource info file to the resource manager on its job system (see mge_add_resource_info_file), loading
+	///		its permanent resources on the same job, so new resources can be added during gameplay.
+	///		The file's resources can be found (mge_try_find_resource) once the whole file is added, and
+	///		mge_wait_resource_loads waits for it. It is added right away in the same cases permanent resources are loaded
+	///		right away. Can be called from several workers at once.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	/// <param name="path">Path to resource info file (copied)</param>
+	void mge_queue_resource_info_file(mge_resource_manager_t* manager, const mgl_chr8_t* path);
+
+	/// <summary>
+	///		Maps an archive to the native directory it reads its files from, so the resource data files on it can be read
+	///		directly by the resource manager's I/O queue.
+	///		The I/O queue is only available on Linux builds with MGE_IO_URING, on other builds the mapping isn't used.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	/// <param name="archive">Archive name (the first part of resource data paths)</param>
+	/// <param name="directory">Native directory path</param>
+	void mge_add_resource_native_directory(mge_resource_manager_t* manager, const mgl_chr8_t* archive, const mgl_chr8_t* directory);
+
+	/// <summary>
+	///		Searchs for a resource, failing if it isn't found.
+	///		Lookups read the last published snapshot of the manager's name index and never block, even while info files
+	///		are being added.
 	/// </summary>
 	/// <param name="manager">Pointer to manager</param>
 	/// <param name="name">Resource name</param>
 	/// <returns>Pointer to resource</returns>
 	mge_resource_t* mge_find_resource(mge_resource_manager_t* manager, const mgl_chr8_t* name);
 
+	/// <summary>
+	///		Searchs for a resource (see mge_find_resource).
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	/// <param name="name">Resource name</param>
+	/// <returns>Pointer to resource, or NULL if it wasn't found (e.g. its info file is still being added)</returns>
+	mge_resource_t* mge_try_find_resource(mge_resource_manager_t* manager, const mgl_chr8_t* name);
+
 	/// <summary>
 	///		Opens a resource access.
+	///		Opening a permanent resource which is being loaded in the background waits for it to be loaded.
 	/// </summary>
 	/// <param name="rsc">Resource pointer</param>
 	/// <param name="access">Access pointer</param>
 	/// <param name="rsc_type">Type of resource</param>
 	void mge_open_resource(mge_resource_t* rsc, void* access, mgl_enum_u32_t rsc_type);
 
+	/// <summary>
+	///		Loads a set of resources ahead of opening them, skipping the ones already loaded.
+	///		Text resources without dependencies on a native directory are read in batches through the manager's I/O queue,
+	///		with many reads in flight at once, when it is available. The rest are loaded one by one, as on open.
+	///		Resources which aren't permanent stay loaded until an access to them is opened and closed again.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	/// <param name="resources">Resources</param>
+	/// <param name="count">Resource count</param>
+	void mge_load_resources(mge_resource_manager_t* manager, mge_resource_t** resources, mgl_u64_t count);
+
+	/// <summary>
+	///		Waits until every permanent resource queued for background loading is loaded, and every queued info file added.
+	///		Opening a resource already waits for it, so this is only needed before using resources without opening them
+	///		(for example, to know when a loading screen can end).
+	///		Must be called from a worker thread of the manager's job system.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	void mge_wait_resource_loads(mge_resource_manager_t* manager);
+
 	/// <summary>
 	///		Closes a resource access.
 	/// </summary>
 	/// <param name="access">Resource a access</param>
 	void mge_close_resource(void* access);
 
+	/// <summary>
+	///		Gets the allocator resource data of a given size is allocated on: small data comes from a pool owned by the
+	///		resource manager and bigger data from the resource manager's allocator.
+	///		Loaders keep the allocator with the data, to deallocate it on unload.
+	///		WARNING: This function shouldn't be used directly.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	/// <param name="size">Data size</param>
+	/// <returns>Allocator</returns>
+	void* mge_internal_get_resource_data_allocator(mge_resource_manager_t* manager, mgl_u64_t size);
+
 #ifdef __cplusplus
 }
 #endif
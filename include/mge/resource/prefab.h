@@ -0,0 +1,100 @@
+#ifndef MGE_RESOURCE_PREFAB_H
+#define MGE_RESOURCE_PREFAB_H
+#ifdef __cplusplus
+extern "C" {
+#endif 
+
+#include <mge/resource/manager.h>
+#include <mge/scene/node.h>
+
+#define MGE_PREFAB_NO_PARENT 0xFFFFFFFF
+#define MGE_MAX_PREFAB_NODE_COUNT 0x01000000
+#define MGE_MAX_PREFAB_COMPONENT_COUNT 0x01000000
+#define MGE_MAX_PREFAB_PAYLOADS_SIZE 0x40000000
+
+	typedef struct mge_prefab_component_t mge_prefab_component_t;
+	typedef struct mge_prefab_resource_data_t mge_prefab_resource_data_t;
+	typedef struct mge_prefab_resource_access_t mge_prefab_resource_access_t;
+
+	struct mge_prefab_component_t
+	{
+		/// <summary>
+		///		Index of the prefab node which owns the component.
+		/// </summary>
+		mgl_u32_t node;
+
+		/// <summary>
+		///		Component type (must be registered on the scene manager when the prefab is instantiated).
+		/// </summary>
+		mgl_u32_t type;
+
+		/// <summary>
+		///		Component bounds (empty if the component has no bounds).
+		/// </summary>
+		mge_aabb_t bounds;
+
+		/// <summary>
+		///		Offset of the component payload on the payloads array.
+		///		The payload is copied to the component memory right after its mge_scene_component_t base.
+		/// </summary>
+		mgl_u64_t payload_offset;
+
+		/// <summary>
+		///		Payload size in bytes.
+		/// </summary>
+		mgl_u64_t payload_size;
+	};
+
+	struct mge_prefab_resource_access_t
+	{
+		mge_resource_access_base_t base;
+		mge_prefab_resource_data_t* data;
+	};
+
+	/// <summary>
+	///		Flattened scene node hierarchy.
+	///		Nodes are ordered so that every node comes after its parent.
+	/// </summary>
+	struct mge_prefab_resource_data_t
+	{
+		void* allocator;
+		mgl_u64_t node_count;
+		mgl_u64_t component_count;
+		mgl_u64_t payloads_size;
+
+		/// <summary>
+		///		Node local transforms.
+		/// </summary>
+		const mgl_f32m4x4_t* transforms;
+
+		/// <summary>
+		///		Node components.
+		/// </summary>
+		const mge_prefab_component_t* components;
+
+		/// <summary>
+		///		Node parent indices (lower than the node's index), or MGE_PREFAB_NO_PARENT for the prefab's root nodes.
+		/// </summary>
+		const mgl_u32_t* parents;
+
+		/// <summary>
+		///		Node names.
+		/// </summary>
+		const mgl_chr8_t (*names)[MGE_MAX_SCENE_NODE_NAME_SIZE];
+
+		/// <summary>
+		///		Component payloads.
+		/// </summary>
+		const mgl_u8_t* payloads;
+	};
+
+	void mge_resource_load_prefab(mge_resource_t* rsc);
+
+	void mge_resource_unload_prefab(mge_resource_t* rsc);
+
+	void mge_resource_access_prefab(mge_resource_t* rsc, mge_prefab_resource_access_t* access);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
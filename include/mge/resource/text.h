@@ -22,7 +22,17 @@ extern "C" {
 		const mgl_chr8_t* text;
 	};
 
-	void mge_resource_load_text(void* allocator, mge_resource_t* rsc);
+	/// <summary>
+	///		Allocates the data of a text resource for a text of a given size, with the null character already written.
+	///		The text is then read to data->text, and the data is deallocated with mgl_deallocate on data->allocator.
+	///		WARNING: This function shouldn't be used directly.
+	/// </summary>
+	/// <param name="rsc">Text resource</param>
+	/// <param name="text_size">Text size, without the null character</param>
+	/// <returns>Text resource data</returns>
+	mge_text_resource_data_t* mge_internal_allocate_text_resource_data(mge_resource_t* rsc, mgl_u64_t text_size);
+
+	void mge_resource_load_text(mge_resource_t* rsc);
 
 	void mge_resource_unload_text(mge_resource_t* rsc);
 
@@ -0,0 +1,132 @@
+#ifndef MGE_SCENE_BOUNDS_H
+#define MGE_SCENE_BOUNDS_H
+#ifdef __cplusplus
+extern "C" {
+#endif 
+
+#include <mgl/type.h>
+#include <mgl/math/matrix4x4.h>
+
+/// <summary>
+///		Accesses an element of a 4x4 matrix (matrices are stored in column-major order).
+/// </summary>
+#define MGE_F32M4X4_AT(m, row, col) ((m)->data[(col) * 4 + (row)])
+
+	typedef struct mge_aabb_t mge_aabb_t;
+	typedef struct mge_sphere_t mge_sphere_t;
+	typedef struct mge_ray_t mge_ray_t;
+	typedef struct mge_frustum_t mge_frustum_t;
+
+	/// <summary>
+	///		Axis-aligned bounding box.
+	///		An empty box has min greater than max.
+	/// </summary>
+	struct mge_aabb_t
+	{
+		mgl_f32_t min[3];
+		mgl_f32_t max[3];
+	};
+
+	struct mge_sphere_t
+	{
+		mgl_f32_t center[3];
+		mgl_f32_t radius;
+	};
+
+	struct mge_ray_t
+	{
+		mgl_f32_t origin[3];
+		mgl_f32_t direction[3];
+		mgl_f32_t max_distance;
+	};
+
+	/// <summary>
+	///		View frustum, stored as 6 planes (left, right, bottom, top, near, far).
+	///		Each plane is stored as (a, b, c, d), with the normal (a, b, c) pointing inside, so points inside satisfy a*x + b*y + c*z + d >= 0.
+	/// </summary>
+	struct mge_frustum_t
+	{
+		mgl_f32_t planes[6][4];
+	};
+
+	/// <summary>
+	///		Sets an AABB to the empty box.
+	/// </summary>
+	/// <param name="aabb">Out AABB</param>
+	void mge_clear_aabb(mge_aabb_t* aabb);
+
+	/// <summary>
+	///		Checks if an AABB is empty.
+	/// </summary>
+	/// <param name="aabb">AABB</param>
+	/// <returns>MGL_TRUE if empty, otherwise MGL_FALSE</returns>
+	mgl_bool_t mge_is_aabb_empty(const mge_aabb_t* aabb);
+
+	/// <summary>
+	///		Computes the smallest AABB which contains two AABBs.
+	/// </summary>
+	/// <param name="a">First AABB</param>
+	/// <param name="b">Second AABB</param>
+	/// <param name="out">Out AABB (can be one of the inputs)</param>
+	void mge_merge_aabb(const mge_aabb_t* a, const mge_aabb_t* b, mge_aabb_t* out);
+
+	/// <summary>
+	///		Computes the AABB of a transformed AABB.
+	/// </summary>
+	/// <param name="m">Transform matrix</param>
+	/// <param name="aabb">AABB</param>
+	/// <param name="out">Out AABB (must not be the input)</param>
+	void mge_transform_aabb(const mgl_f32m4x4_t* m, const mge_aabb_t* aabb, mge_aabb_t* out);
+
+	/// <summary>
+	///		Gets the surface area of an AABB (0 if empty).
+	/// </summary>
+	/// <param name="aabb">AABB</param>
+	/// <returns>Surface area</returns>
+	mgl_f32_t mge_get_aabb_surface_area(const mge_aabb_t* aabb);
+
+	/// <summary>
+	///		Extracts the frustum planes from a view-projection matrix (OpenGL clip space conventions).
+	/// </summary>
+	/// <param name="m">View-projection matrix</param>
+	/// <param name="frustum">Out frustum</param>
+	void mge_frustum_from_matrix(const mgl_f32m4x4_t* m, mge_frustum_t* frustum);
+
+	/// <summary>
+	///		Checks if two AABBs overlap.
+	/// </summary>
+	/// <param name="a">First AABB</param>
+	/// <param name="b">Second AABB</param>
+	/// <returns>MGL_TRUE if they overlap, otherwise MGL_FALSE</returns>
+	mgl_bool_t mge_aabb_intersects_aabb(const mge_aabb_t* a, const mge_aabb_t* b);
+
+	/// <summary>
+	///		Checks if an AABB overlaps a sphere.
+	/// </summary>
+	/// <param name="aabb">AABB</param>
+	/// <param name="sphere">Sphere</param>
+	/// <returns>MGL_TRUE if they overlap, otherwise MGL_FALSE</returns>
+	mgl_bool_t mge_aabb_intersects_sphere(const mge_aabb_t* aabb, const mge_sphere_t* sphere);
+
+	/// <summary>
+	///		Checks if an AABB is at least partially inside a frustum.
+	///		Conservative: boxes near the frustum corners may be reported as inside.
+	/// </summary>
+	/// <param name="aabb">AABB</param>
+	/// <param name="frustum">Frustum</param>
+	/// <returns>MGL_TRUE if inside, otherwise MGL_FALSE</returns>
+	mgl_bool_t mge_aabb_intersects_frustum(const mge_aabb_t* aabb, const mge_frustum_t* frustum);
+
+	/// <summary>
+	///		Checks if a ray intersects an AABB.
+	/// </summary>
+	/// <param name="aabb">AABB</param>
+	/// <param name="ray">Ray</param>
+	/// <param name="distance">Out distance along the ray to the entry point (can be NULL)</param>
+	/// <returns>MGL_TRUE if the ray hits the AABB before its max distance, otherwise MGL_FALSE</returns>
+	mgl_bool_t mge_aabb_intersects_ray(const mge_aabb_t* aabb, const mge_ray_t* ray, mgl_f32_t* distance);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,151 @@
+#ifndef MGE_SCENE_BVH_H
+#define MGE_SCENE_BVH_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <mgl/type.h>
+#include <mge/scene/bounds.h>
+
+	typedef struct mge_scene_manager_t mge_scene_manager_t;
+	typedef struct mge_scene_bvh_t mge_scene_bvh_t;
+	typedef struct mge_scene_bvh_stats_t mge_scene_bvh_stats_t;
+
+	struct mge_scene_bvh_stats_t
+	{
+		/// <summary>
+		///		Number of tree nodes.
+		/// </summary>
+		mgl_u64_t tree_node_count;
+
+		/// <summary>
+		///		Number of scene nodes stored in the tree.
+		/// </summary>
+		mgl_u64_t tree_scene_node_count;
+
+		/// <summary>
+		///		Number of scene nodes added since the last rebuild, which are tested linearly until the next one.
+		/// </summary>
+		mgl_u64_t overflow_scene_node_count;
+
+		/// <summary>
+		///		Number of times the tree was rebuilt.
+		/// </summary>
+		mgl_u64_t rebuild_count;
+
+		/// <summary>
+		///		Current SAH cost of the tree (expected intersection tests per query, relative to the root).
+		/// </summary>
+		mgl_f32_t cost;
+
+		/// <summary>
+		///		SAH cost of the tree right after the last rebuild.
+		/// </summary>
+		mgl_f32_t build_cost;
+	};
+
+	/// <summary>
+	///		Initializes a bounding volume hierarchy over the global bounds of the nodes of a scene.
+	///		Only nodes with non-empty bounds are stored.
+	///		The tree is built with the surface area heuristic and then refitted on every update, being rebuilt
+	///		periodically or when refitting has degraded it too much.
+	///		Frozen nodes are left out (see mge_init_static_scene_bvh).
+	///		The BVH consumes the scene manager's moved nodes list, so there can be at most one such BVH per scene manager at a
+	///		time (initializing a second one is a fatal error).
+	/// </summary>
+	/// <param name="allocator">Allocator used</param>
+	/// <param name="manager">Pointer to scene manager</param>
+	/// <param name="rebuild_interval">Number of updates between full rebuilds (0 = only rebuild when the tree degrades)</param>
+	/// <returns>Pointer to BVH</returns>
+	mge_scene_bvh_t* mge_init_scene_bvh(void* allocator, mge_scene_manager_t* manager, mgl_u64_t rebuild_interval);
+
+	/// <summary>
+	///		Initializes a bounding volume hierarchy over the global bounds of the frozen nodes of a scene.
+	///		It doesn't use the moved nodes list: updating it does nothing unless nodes were frozen, unfrozen or destroyed,
+	///		or the bounds of frozen nodes changed, in which case it is rebuilt.
+	/// </summary>
+	/// <param name="allocator">Allocator used</param>
+	/// <param name="manager">Pointer to scene manager</param>
+	/// <returns>Pointer to BVH</returns>
+	mge_scene_bvh_t* mge_init_static_scene_bvh(void* allocator, mge_scene_manager_t* manager);
+
+	/// <summary>
+	///		Terminates a bounding volume hierarchy.
+	/// </summary>
+	/// <param name="bvh">Pointer to BVH</param>
+	void mge_terminate_scene_bvh(mge_scene_bvh_t* bvh);
+
+	/// <summary>
+	///		Updates a bounding volume hierarchy with the nodes which moved since the last update.
+	///		Should be called once per frame, after the scene transforms are updated.
+	/// </summary>
+	/// <param name="bvh">Pointer to BVH</param>
+	void mge_update_scene_bvh(mge_scene_bvh_t* bvh);
+
+	/// <summary>
+	///		Rebuilds a bounding volume hierarchy from scratch.
+	/// </summary>
+	/// <param name="bvh">Pointer to BVH</param>
+	void mge_rebuild_scene_bvh(mge_scene_bvh_t* bvh);
+
+	/// <summary>
+	///		Finds the scene nodes whose bounds overlap an AABB.
+	/// </summary>
+	/// <param name="bvh">Pointer to BVH</param>
+	/// <param name="aabb">AABB</param>
+	/// <param name="nodes">Out scene node indices (can be NULL)</param>
+	/// <param name="max_node_count">Max number of indices written</param>
+	/// <returns>Number of scene nodes found (can be bigger than max_node_count)</returns>
+	mgl_u64_t mge_query_scene_bvh_aabb(mge_scene_bvh_t* bvh, const mge_aabb_t* aabb, mgl_u32_t* nodes, mgl_u64_t max_node_count);
+
+	/// <summary>
+	///		Finds the scene nodes whose bounds overlap a sphere.
+	/// </summary>
+	/// <param name="bvh">Pointer to BVH</param>
+	/// <param name="sphere">Sphere</param>
+	/// <param name="nodes">Out scene node indices (can be NULL)</param>
+	/// <param name="max_node_count">Max number of indices written</param>
+	/// <returns>Number of scene nodes found (can be bigger than max_node_count)</returns>
+	mgl_u64_t mge_query_scene_bvh_sphere(mge_scene_bvh_t* bvh, const mge_sphere_t* sphere, mgl_u32_t* nodes, mgl_u64_t max_node_count);
+
+	/// <summary>
+	///		Finds the scene nodes whose bounds are at least partially inside a frustum.
+	/// </summary>
+	/// <param name="bvh">Pointer to BVH</param>
+	/// <param name="frustum">Frustum</param>
+	/// <param name="nodes">Out scene node indices (can be NULL)</param>
+	/// <param name="max_node_count">Max number of indices written</param>
+	/// <returns>Number of scene nodes found (can be bigger than max_node_count)</returns>
+	mgl_u64_t mge_query_scene_bvh_frustum(mge_scene_bvh_t* bvh, const mge_frustum_t* frustum, mgl_u32_t* nodes, mgl_u64_t max_node_count);
+
+	/// <summary>
+	///		Finds the scene nodes whose bounds are hit by a ray, in no particular order.
+	/// </summary>
+	/// <param name="bvh">Pointer to BVH</param>
+	/// <param name="ray">Ray</param>
+	/// <param name="nodes">Out scene node indices (can be NULL)</param>
+	/// <param name="max_node_count">Max number of indices written</param>
+	/// <returns>Number of scene nodes found (can be bigger than max_node_count)</returns>
+	mgl_u64_t mge_query_scene_bvh_ray(mge_scene_bvh_t* bvh, const mge_ray_t* ray, mgl_u32_t* nodes, mgl_u64_t max_node_count);
+
+	/// <summary>
+	///		Finds the scene node whose bounds are hit first by a ray.
+	/// </summary>
+	/// <param name="bvh">Pointer to BVH</param>
+	/// <param name="ray">Ray</param>
+	/// <param name="node">Out scene node index</param>
+	/// <param name="distance">Out distance along the ray to the hit (can be NULL)</param>
+	/// <returns>MGL_TRUE if a node was hit, otherwise MGL_FALSE</returns>
+	mgl_bool_t mge_raycast_scene_bvh(mge_scene_bvh_t* bvh, const mge_ray_t* ray, mgl_u32_t* node, mgl_f32_t* distance);
+
+	/// <summary>
+	///		Gets the stats of a bounding volume hierarchy.
+	/// </summary>
+	/// <param name="bvh">Pointer to BVH</param>
+	/// <param name="stats">Out stats</param>
+	void mge_get_scene_bvh_stats(mge_scene_bvh_t* bvh, mge_scene_bvh_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,83 @@
+#ifndef MGE_SCENE_CAMERA_H
+#define MGE_SCENE_CAMERA_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <mgl/type.h>
+#include <mgl/math/matrix4x4.h>
+
+#include <mge/scene/component.h>
+
+#define MGE_MAX_CAMERA_VIEW_COUNT 2
+
+	typedef struct mge_camera_component_t mge_camera_component_t;
+
+	/// <summary>
+	///		Camera component (type MGE_SCENE_COMPONENT_CAMERA).
+	///		A camera has one view, or two views (one per eye) when used as a VR camera.
+	///		Each view looks down the negative Z axis of the node's global transform multiplied by the view's eye transform.
+	/// </summary>
+	struct mge_camera_component_t
+	{
+		mge_scene_component_t base;
+
+		/// <summary>
+		///		Number of views (1, or 2 for VR cameras).
+		/// </summary>
+		mgl_u32_t view_count;
+
+		/// <summary>
+		///		Projection matrix of each view (OpenGL clip space conventions).
+		/// </summary>
+		mgl_f32m4x4_t projection[MGE_MAX_CAMERA_VIEW_COUNT];
+
+		/// <summary>
+		///		Eye transform of each view, relative to the node (must be rigid, identity for non-VR cameras).
+		/// </summary>
+		mgl_f32m4x4_t eye[MGE_MAX_CAMERA_VIEW_COUNT];
+
+		/// <summary>
+		///		Index of the camera's first view on the culling stage (see mge_gather_scene_culling).
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_u64_t first_culling_view;
+	};
+
+	/// <summary>
+	///		Registers the camera component type on a scene manager.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	/// <param name="max_camera_count">Max camera count</param>
+	void mge_register_camera_component_type(mge_scene_manager_t* manager, mgl_u64_t max_camera_count);
+
+	/// <summary>
+	///		Creates a camera component with a single view, an identity projection and an identity eye transform.
+	/// </summary>
+	/// <param name="node">Node</param>
+	/// <returns>Pointer to camera</returns>
+	mge_camera_component_t* mge_create_camera_component(mge_scene_node_t* node);
+
+	/// <summary>
+	///		Sets the projection of a camera view to a perspective projection.
+	/// </summary>
+	/// <param name="camera">Pointer to camera</param>
+	/// <param name="view">View index</param>
+	/// <param name="fov_y">Vertical field of view in radians</param>
+	/// <param name="aspect">Aspect ratio (width / height)</param>
+	/// <param name="near">Near plane distance</param>
+	/// <param name="far">Far plane distance</param>
+	void mge_set_camera_perspective(mge_camera_component_t* camera, mgl_u32_t view, mgl_f32_t fov_y, mgl_f32_t aspect, mgl_f32_t near, mgl_f32_t far);
+
+	/// <summary>
+	///		Computes the view-projection matrix of a camera view from its node's global transform.
+	/// </summary>
+	/// <param name="camera">Pointer to camera</param>
+	/// <param name="view">View index</param>
+	/// <param name="out">Out view-projection matrix</param>
+	void mge_get_camera_view_projection(mge_camera_component_t* camera, mgl_u32_t view, mgl_f32m4x4_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
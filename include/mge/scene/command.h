@@ -0,0 +1,120 @@
+#ifndef MGE_SCENE_COMMAND_H
+#define MGE_SCENE_COMMAND_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <mgl/type.h>
+#include <mgl/math/matrix4x4.h>
+
+#include <mge/scene/manager.h>
+
+	typedef struct mge_scene_commands_t mge_scene_commands_t;
+	typedef struct mge_scene_command_buffer_t mge_scene_command_buffer_t;
+
+	/// <summary>
+	///		Initializes a set of scene command buffers.
+	///		Each thread records scene mutations into its own buffer without any synchronization, and the buffers are
+	///		applied together to the scene on a sync point, in an order which doesn't depend on thread scheduling.
+	/// </summary>
+	/// <param name="allocator">Allocator used</param>
+	/// <param name="manager">Pointer to scene manager</param>
+	/// <param name="buffer_count">Number of buffers (one per thread which records commands)</param>
+	/// <param name="max_command_count">Max number of commands recorded on a buffer between two applies</param>
+	/// <returns>Pointer to command buffers</returns>
+	mge_scene_commands_t* mge_init_scene_commands(void* allocator, mge_scene_manager_t* manager, mgl_u64_t buffer_count, mgl_u64_t max_command_count);
+
+	/// <summary>
+	///		Terminates a set of scene command buffers, discarding any commands which weren't applied.
+	/// </summary>
+	/// <param name="commands">Pointer to command buffers</param>
+	void mge_terminate_scene_commands(mge_scene_commands_t* commands);
+
+	/// <summary>
+	///		Gets a command buffer.
+	///		Job system workers should use the buffer with their worker index (mge_get_job_worker_index).
+	/// </summary>
+	/// <param name="commands">Pointer to command buffers</param>
+	/// <param name="index">Buffer index</param>
+	/// <returns>Pointer to command buffer</returns>
+	mge_scene_command_buffer_t* mge_get_scene_command_buffer(mge_scene_commands_t* commands, mgl_u64_t index);
+
+	/// <summary>
+	///		Sets the key of the commands recorded next on a buffer.
+	///		Commands are applied sorted by key, and commands with the same key are applied in the order they were recorded.
+	///		Jobs which record commands should use a key which identifies the job's work (for example, the index of the chunk
+	///		of objects it updates) so that the result doesn't depend on which worker ran the job. Defaults to 0.
+	/// </summary>
+	/// <param name="buffer">Pointer to command buffer</param>
+	/// <param name="key">Sort key</param>
+	void mge_set_scene_command_key(mge_scene_command_buffer_t* buffer, mgl_u64_t key);
+
+	/// <summary>
+	///		Records the creation of a scene node.
+	///		The returned handle is pending: it can be passed to other commands recorded on the same buffer, and after the
+	///		commands are applied it can be turned into the node's handle with mge_resolve_scene_command_handle.
+	/// </summary>
+	/// <param name="buffer">Pointer to command buffer</param>
+	/// <param name="parent">Parent node handle (can be pending)</param>
+	/// <param name="name">Node name (can be NULL)</param>
+	/// <returns>Pending node handle</returns>
+	mge_scene_node_handle_t mge_record_create_scene_node(mge_scene_command_buffer_t* buffer, mge_scene_node_handle_t parent, const mgl_chr8_t* name);
+
+	/// <summary>
+	///		Records the destruction of a scene node and its children.
+	///		The node is queued for destruction when the commands are applied (see mge_queue_scene_node_destroy).
+	/// </summary>
+	/// <param name="buffer">Pointer to command buffer</param>
+	/// <param name="node">Node handle (can be pending)</param>
+	void mge_record_destroy_scene_node(mge_scene_command_buffer_t* buffer, mge_scene_node_handle_t node);
+
+	/// <summary>
+	///		Records moving a scene node under a new parent (see mge_scene_node_set_parent).
+	/// </summary>
+	/// <param name="buffer">Pointer to command buffer</param>
+	/// <param name="node">Node handle (can be pending)</param>
+	/// <param name="parent">New parent node handle (can be pending)</param>
+	void mge_record_set_scene_node_parent(mge_scene_command_buffer_t* buffer, mge_scene_node_handle_t node, mge_scene_node_handle_t parent);
+
+	/// <summary>
+	///		Records a write to the local transform of a scene node.
+	/// </summary>
+	/// <param name="buffer">Pointer to command buffer</param>
+	/// <param name="node">Node handle (can be pending)</param>
+	/// <param name="local">New local transform</param>
+	void mge_record_set_scene_node_transform(mge_scene_command_buffer_t* buffer, mge_scene_node_handle_t node, const mgl_f32m4x4_t* local);
+
+	/// <summary>
+	///		Records the creation of a component.
+	///		The data is copied into the buffer, and is copied into the component (right after its mge_scene_component_t base)
+	///		when the commands are applied.
+	/// </summary>
+	/// <param name="buffer">Pointer to command buffer</param>
+	/// <param name="node">Node handle (can be pending)</param>
+	/// <param name="type">Component type</param>
+	/// <param name="data">Component data, without the mge_scene_component_t base (can be NULL)</param>
+	/// <param name="data_size">Component data size</param>
+	void mge_record_create_scene_component(mge_scene_command_buffer_t* buffer, mge_scene_node_handle_t node, mgl_enum_u32_t type, const void* data, mgl_u64_t data_size);
+
+	/// <summary>
+	///		Applies the commands of every buffer to the scene and clears the buffers.
+	///		Commands are merged by key (see mge_set_scene_command_key), and commands on nodes which don't exist anymore are dropped.
+	///		Must not be called while other threads are recording commands. Called by the main loop once per frame, after the game update.
+	/// </summary>
+	/// <param name="commands">Pointer to command buffers</param>
+	void mge_apply_scene_commands(mge_scene_commands_t* commands);
+
+	/// <summary>
+	///		Turns a pending node handle returned by mge_record_create_scene_node into the handle of the created node.
+	///		Only valid until the commands are applied again, after that (or before the commands are applied) it returns
+	///		MGE_SCENE_NODE_NULL_HANDLE. Handles which aren't pending are returned unchanged.
+	/// </summary>
+	/// <param name="commands">Pointer to command buffers</param>
+	/// <param name="handle">Node handle</param>
+	/// <returns>Node handle (MGE_SCENE_NODE_NULL_HANDLE if the node wasn't created)</returns>
+	mge_scene_node_handle_t mge_resolve_scene_command_handle(mge_scene_commands_t* commands, mge_scene_node_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -8,12 +8,26 @@ extern "C" {
 
 #include <mgl/type.h>
 #include <mgl/math/matrix4x4.h>
+#include <mge/scene/bounds.h>
 
 #define MGE_MAX_SCENE_NODE_NAME_SIZE 32
 
 	typedef struct mge_scene_node_t mge_scene_node_t;
 	typedef struct mge_scene_component_t mge_scene_component_t;
 	typedef struct mge_scene_manager_t mge_scene_manager_t;
+	typedef struct mge_scene_component_pool_t mge_scene_component_pool_t;
+
+	/// <summary>
+	///		Engine component types.
+	///		Types below MGE_FIRST_GAME_SCENE_COMPONENT_TYPE are reserved for the engine.
+	/// </summary>
+	enum
+	{
+		MGE_SCENE_COMPONENT_CAMERA			= 0x01,
+		MGE_SCENE_COMPONENT_OCCLUDER		= 0x02,
+
+		MGE_FIRST_GAME_SCENE_COMPONENT_TYPE	= 0x10,
+	};
 
 	/// <summary>
 	///		Base struct for scene components.
@@ -27,6 +41,8 @@ extern "C" {
 	///		</code>
 	/// 
 	///		Each component type should be created and handled by its own manager.
+	///		Component types registered on the scene manager are stored densely in a mge_scene_component_pool_t,
+	///		and should be created with mge_create_scene_component.
 	/// </summary>
 	struct mge_scene_component_t
 	{
@@ -48,15 +64,62 @@ extern "C" {
 
 		/// <summary>
 		///		Next sibling component.
+		///		WARNING: This should not be set manually.
 		/// </summary>
 		mge_scene_component_t* next;
 
+		/// <summary>
+		///		Previous sibling component.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mge_scene_component_t* prev;
+
+		/// <summary>
+		///		Pool which stores this component (NULL if the component isn't pooled).
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mge_scene_component_pool_t* pool;
+
+		/// <summary>
+		///		Component bounds, in the node's local space (empty if the component has no bounds).
+		///		WARNING: This should not be set manually, instead, call mge_scene_component_set_bounds.
+		/// </summary>
+		mge_aabb_t bounds;
+
+		/// <summary>
+		///		Time of the component's last update by the scene scheduler (0 if it was never updated).
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_u64_t update_time;
+
 		/// <summary>
 		///		Function called when the component is destroyed.
 		/// </summary>
 		void(*destroy_func)(void* component);
 	};
 
+	/// <summary>
+	///		Sets the bounds of a component and updates its node's bounds.
+	/// </summary>
+	/// <param name="component">Component</param>
+	/// <param name="bounds">Bounds in the node's local space (NULL to clear them)</param>
+	void mge_scene_component_set_bounds(mge_scene_component_t* component, const mge_aabb_t* bounds);
+
+	/// <summary>
+	///		Creates a component of a type registered on the node's scene manager and adds it to the node.
+	///		Only the mge_scene_component_t base is initialized, the rest of the component is zeroed.
+	/// </summary>
+	/// <param name="node">Node</param>
+	/// <param name="type">Component type</param>
+	/// <returns>Pointer to component</returns>
+	void* mge_create_scene_component(mge_scene_node_t* node, mgl_enum_u32_t type);
+
+	/// <summary>
+	///		Removes a component from its node and destroys it.
+	/// </summary>
+	/// <param name="component">Pointer to component</param>
+	void mge_destroy_scene_component(void* component);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,95 @@
+#ifndef MGE_SCENE_CULLING_H
+#define MGE_SCENE_CULLING_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <mgl/type.h>
+#include <mge/scene/bounds.h>
+
+	typedef struct mge_scene_manager_t mge_scene_manager_t;
+	typedef struct mge_camera_component_t mge_camera_component_t;
+	typedef struct mge_job_system_t mge_job_system_t;
+	typedef struct mge_culling_t mge_culling_t;
+
+	/// <summary>
+	///		Initializes a culling stage.
+	///		A culling stage tests a set of bounds against a set of views (frusta) and produces, for each view,
+	///		a compact list with the IDs of the visible bounds, in the order they were added.
+	///		Bounds are stored as structures of arrays and tested four at a time with SIMD instructions.
+	/// </summary>
+	/// <param name="allocator">Allocator used</param>
+	/// <param name="max_bounds_count">Max number of bounds</param>
+	/// <param name="max_view_count">Max number of views</param>
+	/// <returns>Pointer to culling stage</returns>
+	mge_culling_t* mge_init_culling(void* allocator, mgl_u64_t max_bounds_count, mgl_u64_t max_view_count);
+
+	/// <summary>
+	///		Terminates a culling stage.
+	/// </summary>
+	/// <param name="culling">Pointer to culling stage</param>
+	void mge_terminate_culling(mge_culling_t* culling);
+
+	/// <summary>
+	///		Removes every bounds and view from a culling stage.
+	/// </summary>
+	/// <param name="culling">Pointer to culling stage</param>
+	void mge_clear_culling(mge_culling_t* culling);
+
+	/// <summary>
+	///		Adds bounds to a culling stage.
+	/// </summary>
+	/// <param name="culling">Pointer to culling stage</param>
+	/// <param name="id">ID written to the visible lists (scene node index when gathered from a scene)</param>
+	/// <param name="aabb">Bounds (must not be empty)</param>
+	void mge_add_culling_bounds(mge_culling_t* culling, mgl_u32_t id, const mge_aabb_t* aabb);
+
+	/// <summary>
+	///		Adds a view to a culling stage.
+	/// </summary>
+	/// <param name="culling">Pointer to culling stage</param>
+	/// <param name="frustum">View frustum</param>
+	/// <returns>View index</returns>
+	mgl_u64_t mge_add_culling_view(mge_culling_t* culling, const mge_frustum_t* frustum);
+
+	/// <summary>
+	///		Clears a culling stage and fills it with the global bounds of every node which is active in the hierarchy,
+	///		and with the views of every active camera component.
+	///		Each camera's first_culling_view is set to the index of its first view.
+	/// </summary>
+	/// <param name="culling">Pointer to culling stage</param>
+	/// <param name="manager">Pointer to scene manager</param>
+	void mge_gather_scene_culling(mge_culling_t* culling, mge_scene_manager_t* manager);
+
+	/// <summary>
+	///		Tests every bounds against every view, filling the visible lists.
+	///		If a job system is passed, the bounds are split in chunks which are culled in parallel.
+	///		Must be called from a worker thread of the job system.
+	/// </summary>
+	/// <param name="culling">Pointer to culling stage</param>
+	/// <param name="system">Pointer to job system (can be NULL, to cull on the calling thread)</param>
+	void mge_run_culling(mge_culling_t* culling, mge_job_system_t* system);
+
+	/// <summary>
+	///		Gets the visible list of a view, filled by the last call to mge_run_culling.
+	/// </summary>
+	/// <param name="culling">Pointer to culling stage</param>
+	/// <param name="view">View index</param>
+	/// <param name="count">Out visible count</param>
+	/// <returns>IDs of the visible bounds</returns>
+	const mgl_u32_t* mge_get_culling_visible_list(mge_culling_t* culling, mgl_u64_t view, mgl_u64_t* count);
+
+	/// <summary>
+	///		Gets the visible list of a camera view, filled by the last call to mge_run_culling.
+	/// </summary>
+	/// <param name="culling">Pointer to culling stage</param>
+	/// <param name="camera">Pointer to camera</param>
+	/// <param name="view">Camera view index</param>
+	/// <param name="count">Out visible count</param>
+	/// <returns>Indices of the visible scene nodes</returns>
+	const mgl_u32_t* mge_get_camera_visible_scene_nodes(mge_culling_t* culling, mge_camera_component_t* camera, mgl_u32_t view, mgl_u64_t* count);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
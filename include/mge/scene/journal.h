@@ -0,0 +1,90 @@
+#ifndef MGE_SCENE_JOURNAL_H
+#define MGE_SCENE_JOURNAL_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <mgl/type.h>
+
+#define MGE_SCENE_NODE_CREATED 0x01
+#define MGE_SCENE_NODE_DESTROYED 0x02
+#define MGE_SCENE_NODE_TRANSFORMED 0x04
+#define MGE_SCENE_NODE_COMPONENT_ADDED 0x08
+#define MGE_SCENE_NODE_COMPONENT_REMOVED 0x10
+#define MGE_SCENE_NODE_RELOCATED 0x20
+
+	typedef struct mge_scene_manager_t mge_scene_manager_t;
+	typedef struct mge_scene_journal_t mge_scene_journal_t;
+
+	/// <summary>
+	///		List of the scene nodes which changed during a frame.
+	///		Each node index appears at most once, with every change made to it OR'ed together (MGE_SCENE_NODE_* flags):
+	///			MGE_SCENE_NODE_CREATED and MGE_SCENE_NODE_DESTROYED can both be set, check the node's trash flag to know if it is alive;
+	///			MGE_SCENE_NODE_TRANSFORMED is set when the global transform was updated;
+	///			MGE_SCENE_NODE_RELOCATED is set when the node at that index was swapped with another index by mge_defragment_scene.
+	/// </summary>
+	struct mge_scene_journal_t
+	{
+		/// <summary>
+		///		Indices of the nodes which changed, in the order of their first change.
+		/// </summary>
+		mgl_u32_t* nodes;
+
+		/// <summary>
+		///		Number of nodes which changed.
+		/// </summary>
+		mgl_u64_t node_count;
+
+		/// <summary>
+		///		Changes of each node, indexed by node index (zero for nodes which didn't change).
+		/// </summary>
+		mgl_u8_t* changes;
+	};
+
+	/// <summary>
+	///		Gets the change journal of the last frame.
+	///		The main loop publishes it after updating the scene transforms, and it stays the same until the next frame is
+	///		published, so it can be read from any thread without locks during the next frame.
+	/// </summary>
+	/// <param name="manager">Pointer to scene manager</param>
+	/// <returns>Pointer to journal</returns>
+	const mge_scene_journal_t* mge_get_scene_journal(mge_scene_manager_t* manager);
+
+	/// <summary>
+	///		Adds changes to a node on the scene manager's journal for the current frame.
+	///		WARNING: This function shouldn't be used directly.
+	/// </summary>
+	/// <param name="manager">Pointer to scene manager</param>
+	/// <param name="index">Node index</param>
+	/// <param name="changes">MGE_SCENE_NODE_* flags</param>
+	void mge_record_scene_node_change(mge_scene_manager_t* manager, mgl_u64_t index, mgl_u8_t changes);
+
+	/// <summary>
+	///		Publishes the journal of the current frame, so that it is returned by mge_get_scene_journal, and starts a new one.
+	///		Called by the main loop after the scene transforms are updated.
+	///		WARNING: This function shouldn't be used directly.
+	/// </summary>
+	/// <param name="manager">Pointer to scene manager</param>
+	void mge_publish_scene_journal(mge_scene_manager_t* manager);
+
+	/// <summary>
+	///		Initializes a scene journal.
+	///		WARNING: This function shouldn't be used directly.
+	/// </summary>
+	/// <param name="allocator">Allocator used</param>
+	/// <param name="max_node_count">Max number of scene nodes</param>
+	/// <returns>Pointer to journal</returns>
+	mge_scene_journal_t* mge_init_scene_journal(void* allocator, mgl_u64_t max_node_count);
+
+	/// <summary>
+	///		Terminates a scene journal.
+	///		WARNING: This function shouldn't be used directly.
+	/// </summary>
+	/// <param name="allocator">Allocator used</param>
+	/// <param name="journal">Pointer to journal</param>
+	void mge_terminate_scene_journal(void* allocator, mge_scene_journal_t* journal);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -6,9 +6,28 @@ extern "C" {
 
 #include <mgl/type.h>
 
+#define MGE_MAX_SCENE_COMPONENT_TYPE_COUNT 64
+#define MGE_SCENE_NAME_TABLE_EMPTY 0xFFFFFFFF
+#define MGE_SCENE_NODE_NULL_HANDLE ((mge_scene_node_handle_t) { 0, 0 })
+
 	typedef struct mge_scene_node_t mge_scene_node_t;
 	typedef struct mge_scene_component_t mge_scene_component_t;
 	typedef struct mge_scene_manager_t mge_scene_manager_t;
+	typedef struct mge_scene_component_pool_t mge_scene_component_pool_t;
+	typedef struct mge_prefab_resource_data_t mge_prefab_resource_data_t;
+	typedef struct mge_scene_node_handle_t mge_scene_node_handle_t;
+	typedef struct mge_scene_journal_t mge_scene_journal_t;
+
+	/// <summary>
+	///		Stable reference to a scene node.
+	///		Unlike node pointers, handles stay valid when nodes are relocated by mge_defragment_scene,
+	///		and they resolve to NULL once the node is destroyed, even if its slot is reused.
+	/// </summary>
+	struct mge_scene_node_handle_t
+	{
+		mgl_u32_t index;
+		mgl_u32_t generation;
+	};
 
 	struct mge_scene_manager_t
 	{
@@ -17,6 +36,105 @@ extern "C" {
 		mgl_u64_t max_node_count;
 		mge_scene_node_t* nodes;
 		mge_scene_node_t* root;
+
+		/// <summary>
+		///		Effective active state of each node, one bit per node index.
+		///		A bit is set if the node and all of its ancestors are active.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_u64_t* active_bits;
+
+		/// <summary>
+		///		Nodes on frozen subtrees (see mge_scene_node_freeze), one bit per node index, and a counter which is incremented
+		///		every time the set of frozen nodes or their bounds change.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_u64_t* static_bits;
+		mgl_u64_t static_version;
+
+		/// <summary>
+		///		Indices of the nodes whose global bounds changed since the last call to mge_clear_moved_scene_nodes.
+		///		Each node appears at most once (deduplicated by moved_bits).
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_u32_t* moved_nodes;
+		mgl_u64_t moved_node_count;
+		mgl_u64_t* moved_bits;
+
+		/// <summary>
+		///		Dynamic BVH which consumes the moved nodes list (NULL if there's none), there can only be one since it clears it.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		void* moved_nodes_consumer;
+
+		/// <summary>
+		///		Change journal being recorded for the current frame, and the one published for the last frame (see mge_get_scene_journal).
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mge_scene_journal_t* journal;
+		mge_scene_journal_t* published_journal;
+
+		/// <summary>
+		///		Indices of the nodes queued for destruction with mge_queue_scene_node_destroy.
+		///		A queued node is only destroyed on the next flush if its bit on destroy_bits is still set.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_u32_t* destroy_queue;
+		mgl_u64_t destroy_queue_count;
+		mgl_u64_t* destroy_bits;
+
+		/// <summary>
+		///		Scratch list with the indices of the nodes being destroyed.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_u32_t* destroy_nodes;
+
+		/// <summary>
+		///		No node below this index is free.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_u64_t free_node_hint;
+
+		/// <summary>
+		///		Open addressing hash table (linear probing) which maps (parent, name) pairs to node indices.
+		///		Siblings with the same name are chained through their nodes, and only the first one is stored.
+		///		Empty slots are set to MGE_SCENE_NAME_TABLE_EMPTY. The root node isn't stored.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_u32_t* name_table;
+		mgl_u64_t name_table_mask;
+
+		/// <summary>
+		///		Node index and generation of each handle, and the stack of free handles.
+		///		A handle's generation is incremented when its node is destroyed. Generations start at 1, so null handles never resolve.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_u32_t* handle_nodes;
+		mgl_u32_t* handle_generations;
+		mgl_u32_t* free_handles;
+		mgl_u64_t free_handle_count;
+
+		/// <summary>
+		///		Node slot where the next call to mge_defragment_scene resumes.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_u64_t defragment_cursor;
+
+		/// <summary>
+		///		Translation, rotation (quaternion) and scale of the nodes which use TRS, as one array per component indexed by node
+		///		(padded to a multiple of 4 nodes), and bitsets with the nodes which use TRS and the nodes whose TRS changed.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		struct
+		{
+			mgl_f32_t* translation[3];
+			mgl_f32_t* rotation[4];
+			mgl_f32_t* scale[3];
+			mgl_u64_t* bits;
+			mgl_u64_t* dirty_bits;
+		} trs;
+
+		mge_scene_component_pool_t* component_pools[MGE_MAX_SCENE_COMPONENT_TYPE_COUNT];
 	};
 
 	/// <summary>
@@ -41,11 +159,37 @@ extern "C" {
 	mge_scene_node_t* mge_create_scene_node(mge_scene_node_t* parent, const mgl_chr8_t* name);
 
 	/// <summary>
-	///		Destroys a scene node and all of its children.
+	///		Instantiates a prefab, creating its nodes and components under a parent node.
+	///		The prefab's nodes are placed on a contiguous block of node slots and are wired up in a single pass,
+	///		so prefab node i is always at the returned pointer plus i.
+	/// </summary>
+	/// <param name="parent">Pointer to the parent of the prefab's root nodes</param>
+	/// <param name="prefab">Prefab data</param>
+	/// <returns>Pointer to the first prefab node</returns>
+	mge_scene_node_t* mge_instantiate_prefab(mge_scene_node_t* parent, const mge_prefab_resource_data_t* prefab);
+
+	/// <summary>
+	///		Destroys a scene node and all of its children immediately.
+	///		Component destroy functions must not destroy scene nodes, but they can queue them for destruction.
 	/// </summary>
 	/// <param name="node">Pointer to node</param>
 	void mge_destroy_scene_node(mge_scene_node_t* node);
 
+	/// <summary>
+	///		Queues a scene node and all of its children for destruction on the next call to mge_flush_scene_node_destroy_queue.
+	///		Queuing a node more than once, or queuing one of its ancestors too, is allowed.
+	/// </summary>
+	/// <param name="node">Pointer to node</param>
+	void mge_queue_scene_node_destroy(mge_scene_node_t* node);
+
+	/// <summary>
+	///		Destroys every queued scene node and its children in bulk.
+	///		The components of the destroyed nodes are destroyed grouped by type.
+	///		Called by the main loop once per frame, before the transforms are updated.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	void mge_flush_scene_node_destroy_queue(mge_scene_manager_t* manager);
+
 	/// <summary>
 	///		Destroys every child in the scene node, without destroying the node itself.
 	/// </summary>
@@ -58,6 +202,97 @@ extern "C" {
 	/// <param name="node">Node</param>
 	void mge_clear_components_scene_node(mge_scene_node_t* node);
 
+	/// <summary>
+	///		Finds a scene node by its path from the root node, with names separated by '/' (for example, u8"a/b/c").
+	///		Each path component is an average O(1) lookup on the scene manager's name table.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	/// <param name="path">Node path (an empty path returns the root node)</param>
+	/// <returns>Pointer to node, or NULL if no node matches the path</returns>
+	mge_scene_node_t* mge_find_scene_node(mge_scene_manager_t* manager, const mgl_chr8_t* path);
+
+	/// <summary>
+	///		Gets the node referenced by a handle.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	/// <param name="handle">Node handle</param>
+	/// <returns>Pointer to node, or NULL if the node was destroyed</returns>
+	mge_scene_node_t* mge_resolve_scene_node_handle(mge_scene_manager_t* manager, mge_scene_node_handle_t handle);
+
+	/// <summary>
+	///		Relocates scene nodes so that they end up on the node array in depth-first order, starting right after the root.
+	///		Hierarchy traversals then walk the array mostly sequentially, instead of jumping around slots left over by destroyed nodes.
+	///		The pass is incremental: it stops after moving max_move_count nodes and the next call resumes where it stopped.
+	///		Relocated nodes are added to the moved nodes list, so spatial structures pick up their new indices.
+	///		WARNING: Node pointers and indices (including visible lists) are invalidated, use handles to keep references across calls.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	/// <param name="max_move_count">Max number of nodes moved by this call</param>
+	/// <returns>Number of nodes moved (0 if the pass reached the end without moving any node)</returns>
+	mgl_u64_t mge_defragment_scene(mge_scene_manager_t* manager, mgl_u64_t max_move_count);
+
+	/// <summary>
+	///		Adds a node to the name table.
+	///		WARNING: This function shouldn't be used directly.
+	/// </summary>
+	/// <param name="node">Node</param>
+	void mge_insert_scene_node_name(mge_scene_node_t* node);
+
+	/// <summary>
+	///		Removes a node from the name table.
+	///		WARNING: This function shouldn't be used directly.
+	/// </summary>
+	/// <param name="node">Node</param>
+	void mge_remove_scene_node_name(mge_scene_node_t* node);
+
+	/// <summary>
+	///		Updates the global transforms (and bounds) of every dirty node in a single depth-first pass.
+	///		Called by the main loop once per frame.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	void mge_update_scene_transforms(mge_scene_manager_t* manager);
+
+	/// <summary>
+	///		Adds a node to the moved nodes list, if it isn't there already.
+	///		WARNING: This function shouldn't be used directly.
+	/// </summary>
+	/// <param name="node">Node</param>
+	void mge_mark_scene_node_moved(mge_scene_node_t* node);
+
+	/// <summary>
+	///		Clears the moved nodes list.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	void mge_clear_moved_scene_nodes(mge_scene_manager_t* manager);
+
+	/// <summary>
+	///		Gets the index of the next node which is active in the hierarchy.
+	///		Scans the active bitset a word at a time, so inactive subtrees are skipped in bulk.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	/// <param name="index">Index where the search starts (inclusive)</param>
+	/// <returns>Node index, or max_node_count if there are no more active nodes</returns>
+	mgl_u64_t mge_next_active_scene_node(mge_scene_manager_t* manager, mgl_u64_t index);
+
+	/// <summary>
+	///		Registers a component type on a scene manager, creating the pool where its components are stored.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	/// <param name="type">Component type (lower than MGE_MAX_SCENE_COMPONENT_TYPE_COUNT)</param>
+	/// <param name="component_size">Component size in bytes (including the mge_scene_component_t base)</param>
+	/// <param name="max_component_count">Max component count</param>
+	/// <param name="destroy_func">Function called when a component is destroyed (can be NULL)</param>
+	/// <returns>Pointer to the component pool</returns>
+	mge_scene_component_pool_t* mge_register_scene_component_type(mge_scene_manager_t* manager, mgl_enum_u32_t type, mgl_u64_t component_size, mgl_u64_t max_component_count, void(*destroy_func)(void* component));
+
+	/// <summary>
+	///		Gets the pool which stores the components of a type.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	/// <param name="type">Component type</param>
+	/// <returns>Pointer to the component pool, or NULL if the type isn't registered</returns>
+	mge_scene_component_pool_t* mge_get_scene_component_pool(mge_scene_manager_t* manager, mgl_enum_u32_t type);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,12 +6,14 @@ extern "C" {
 
 #include <mgl/type.h>
 #include <mgl/math/matrix4x4.h>
+#include <mge/scene/bounds.h>
 
 #define MGE_MAX_SCENE_NODE_NAME_SIZE 32
 	
 	typedef struct mge_scene_node_t mge_scene_node_t;
 	typedef struct mge_scene_component_t mge_scene_component_t;
 	typedef struct mge_scene_manager_t mge_scene_manager_t;
+	typedef struct mge_scene_node_handle_t mge_scene_node_handle_t;
 
 	struct mge_scene_node_t
 	{
@@ -23,6 +25,7 @@ extern "C" {
 		/// <summary>
 		///		Is this scene node active?
 		///		If this is set to MGL_FALSE, this node and all of its children stop havung their components updated.
+		///		WARNING: This should not be set manually, instead, call mge_scene_node_set_active.
 		/// </summary>
 		mgl_bool_t active;
 
@@ -33,6 +36,12 @@ extern "C" {
 		/// </summary>
 		mgl_bool_t trash;
 
+		/// <summary>
+		///		Index of the scene manager handle which references this node.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_u32_t handle;
+
 		/// <summary>
 		///		Parent node.
 		///		WARNING: This should not be set manually.
@@ -51,6 +60,12 @@ extern "C" {
 		/// </summary>
 		mge_scene_node_t* next;
 
+		/// <summary>
+		///		Previous sibling node.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mge_scene_node_t* prev;
+
 		/// <summary>
 		///		First component in this node.
 		///		WARNING: This should not be set manually.
@@ -59,9 +74,24 @@ extern "C" {
 
 		/// <summary>
 		///		Scene node name.
+		///		WARNING: This should not be set manually, instead, call mge_scene_node_set_name.
 		/// </summary>
 		mgl_chr8_t name[MGE_MAX_SCENE_NODE_NAME_SIZE];
 
+		/// <summary>
+		///		Hash of the scene node name, used by the scene manager's name table.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_u32_t name_hash;
+
+		/// <summary>
+		///		Previous and next sibling nodes with the same name.
+		///		Only the first node of each chain is stored on the scene manager's name table.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mge_scene_node_t* prev_same_name;
+		mge_scene_node_t* next_same_name;
+
 		/// <summary>
 		///		Node transform.
 		/// </summary>
@@ -86,6 +116,24 @@ extern "C" {
 			/// </summary>
 			mgl_bool_t dirty;
 		} transform;
+
+		/// <summary>
+		///		Node bounds.
+		/// </summary>
+		struct
+		{
+			/// <summary>
+			///		Node local bounds, which contain the bounds of all of its components (empty if none has bounds).
+			///		WARNING: This should not be set manually, instead, call mge_scene_component_set_bounds.
+			/// </summary>
+			mge_aabb_t local;
+
+			/// <summary>
+			///		Node world-space bounds, updated together with the global transform.
+			///		WARNING: This should not be set manually.
+			/// </summary>
+			mge_aabb_t global;
+		} bounds;
 	};
 
 	/// <summary>
@@ -115,6 +163,80 @@ extern "C" {
 	/// <param name="node">Node</param>
 	void mge_scene_node_set_dirty(mge_scene_node_t* node);
 
+	/// <summary>
+	///		Recomputes a node's local bounds from its components and, if its transform is up to date, its global bounds.
+	/// </summary>
+	/// <param name="node">Node</param>
+	void mge_scene_node_update_bounds(mge_scene_node_t* node);
+
+	/// <summary>
+	///		Sets a node's active flag, updating the effective active state of the node and its subtree.
+	/// </summary>
+	/// <param name="node">Node</param>
+	/// <param name="active">Is the node active?</param>
+	void mge_scene_node_set_active(mge_scene_node_t* node, mgl_bool_t active);
+
+	/// <summary>
+	///		Checks if a node is active in the hierarchy (the node and all of its ancestors are active).
+	///		This is a single bit test on the scene manager's active bitset.
+	/// </summary>
+	/// <param name="node">Node</param>
+	/// <returns>MGL_TRUE if active, otherwise MGL_FALSE</returns>
+	mgl_bool_t mge_scene_node_is_active(mge_scene_node_t* node);
+
+	/// <summary>
+	///		Gets a stable handle to a scene node, which can be resolved with mge_resolve_scene_node_handle.
+	/// </summary>
+	/// <param name="node">Node</param>
+	/// <returns>Node handle</returns>
+	mge_scene_node_handle_t mge_scene_node_get_handle(mge_scene_node_t* node);
+
+	/// <summary>
+	///		Freezes a scene node and its subtree.
+	///		The global transforms of a frozen subtree are baked and it is skipped by dirty tracking and transform updates,
+	///		so transform changes on frozen nodes, or on the ancestors of a frozen subtree, are ignored until it is unfrozen.
+	///		Frozen nodes are stored on static BVHs instead of dynamic ones. Children created under frozen nodes are frozen too.
+	/// </summary>
+	/// <param name="node">Node (can't be the root)</param>
+	void mge_scene_node_freeze(mge_scene_node_t* node);
+
+	/// <summary>
+	///		Unfreezes a frozen subtree and marks it as dirty.
+	/// </summary>
+	/// <param name="node">Root of the frozen subtree (its parent must not be frozen)</param>
+	void mge_scene_node_unfreeze(mge_scene_node_t* node);
+
+	/// <summary>
+	///		Checks if a scene node is frozen.
+	/// </summary>
+	/// <param name="node">Node</param>
+	/// <returns>MGL_TRUE if frozen, otherwise MGL_FALSE</returns>
+	mgl_bool_t mge_scene_node_is_frozen(mge_scene_node_t* node);
+
+	/// <summary>
+	///		Renames a scene node, updating the scene manager's name table.
+	/// </summary>
+	/// <param name="node">Node</param>
+	/// <param name="name">New node name (truncated to MGE_MAX_SCENE_NODE_NAME_SIZE - 1 characters)</param>
+	void mge_scene_node_set_name(mge_scene_node_t* node, const mgl_chr8_t* name);
+
+	/// <summary>
+	///		Moves a scene node (and its subtree) under a new parent, keeping its local transform.
+	/// </summary>
+	/// <param name="node">Node</param>
+	/// <param name="parent">New parent node (must not be the node itself or one of its descendants)</param>
+	void mge_scene_node_set_parent(mge_scene_node_t* node, mge_scene_node_t* parent);
+
+	/// <summary>
+	///		Finds a child of a scene node by name.
+	///		Average O(1), through the scene manager's name table.
+	///		If more than one child has the same name, any of them may be returned.
+	/// </summary>
+	/// <param name="parent">Parent node</param>
+	/// <param name="name">Child name</param>
+	/// <returns>Pointer to child node, or NULL if there is no child with the name</returns>
+	mge_scene_node_t* mge_find_scene_node_child(mge_scene_node_t* parent, const mgl_chr8_t* name);
+
 	/// <summary>
 	///		Adds a component to a node.
 	///		WARNING: This function shouldn't be used directly.
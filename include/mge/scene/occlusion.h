@@ -0,0 +1,165 @@
+#ifndef MGE_SCENE_OCCLUSION_H
+#define MGE_SCENE_OCCLUSION_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <mgl/type.h>
+#include <mgl/math/matrix4x4.h>
+
+#include <mge/scene/component.h>
+#include <mge/scene/bounds.h>
+
+	typedef struct mge_occluder_component_t mge_occluder_component_t;
+	typedef struct mge_occlusion_t mge_occlusion_t;
+	typedef struct mge_occlusion_stats_t mge_occlusion_stats_t;
+
+	/// <summary>
+	///		Occluder component (type MGE_SCENE_COMPONENT_OCCLUDER).
+	///		Designates a simplified triangle mesh, in the node's local space, which is rasterized into the occlusion depth buffer.
+	///		Occluder meshes should be conservative: they must not cover anything the real geometry doesn't.
+	/// </summary>
+	struct mge_occluder_component_t
+	{
+		mge_scene_component_t base;
+
+		/// <summary>
+		///		Vertex positions (3 floats per vertex). Owned by the caller, must outlive the component.
+		/// </summary>
+		const mgl_f32_t* vertices;
+
+		/// <summary>
+		///		Triangle vertex indices (3 per triangle). Owned by the caller, must outlive the component.
+		/// </summary>
+		const mgl_u32_t* indices;
+
+		/// <summary>
+		///		Number of triangles.
+		/// </summary>
+		mgl_u64_t triangle_count;
+	};
+
+	struct mge_occlusion_stats_t
+	{
+		/// <summary>
+		///		Number of occluder triangles rasterized since the last clear (after near plane clipping).
+		/// </summary>
+		mgl_u64_t rasterized_triangle_count;
+
+		/// <summary>
+		///		Number of bounds tested since the last clear.
+		/// </summary>
+		mgl_u64_t tested_bounds_count;
+
+		/// <summary>
+		///		Number of bounds found occluded since the last clear.
+		/// </summary>
+		mgl_u64_t occluded_bounds_count;
+	};
+
+	/// <summary>
+	///		Registers the occluder component type on a scene manager.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	/// <param name="max_occluder_count">Max occluder count</param>
+	void mge_register_occluder_component_type(mge_scene_manager_t* manager, mgl_u64_t max_occluder_count);
+
+	/// <summary>
+	///		Creates an occluder component.
+	/// </summary>
+	/// <param name="node">Node</param>
+	/// <param name="vertices">Vertex positions (3 floats per vertex)</param>
+	/// <param name="indices">Triangle vertex indices (3 per triangle)</param>
+	/// <param name="triangle_count">Triangle count</param>
+	/// <returns>Pointer to occluder</returns>
+	mge_occluder_component_t* mge_create_occluder_component(mge_scene_node_t* node, const mgl_f32_t* vertices, const mgl_u32_t* indices, mgl_u64_t triangle_count);
+
+	/// <summary>
+	///		Initializes an occlusion culling stage, with a low resolution CPU depth buffer.
+	///		Occluders are rasterized into the depth buffer with SIMD instructions, a hierarchical Z pyramid (the farthest depth
+	///		of each 2x2 block of the previous level) is built from it and bounds are then tested against the pyramid.
+	/// </summary>
+	/// <param name="allocator">Allocator used</param>
+	/// <param name="width">Depth buffer width (must be a power of two, at least 4)</param>
+	/// <param name="height">Depth buffer height (must be a power of two)</param>
+	/// <returns>Pointer to occlusion culling stage</returns>
+	mge_occlusion_t* mge_init_occlusion(void* allocator, mgl_u64_t width, mgl_u64_t height);
+
+	/// <summary>
+	///		Terminates an occlusion culling stage.
+	/// </summary>
+	/// <param name="occlusion">Pointer to occlusion culling stage</param>
+	void mge_terminate_occlusion(mge_occlusion_t* occlusion);
+
+	/// <summary>
+	///		Clears the depth buffer and sets the view-projection matrix used by the next rasterizations and tests.
+	/// </summary>
+	/// <param name="occlusion">Pointer to occlusion culling stage</param>
+	/// <param name="view_projection">View-projection matrix (OpenGL clip space conventions)</param>
+	void mge_clear_occlusion(mge_occlusion_t* occlusion, const mgl_f32m4x4_t* view_projection);
+
+	/// <summary>
+	///		Rasterizes a triangle mesh into the depth buffer.
+	///		Triangles are clipped against the near plane and are rasterized regardless of their winding.
+	/// </summary>
+	/// <param name="occlusion">Pointer to occlusion culling stage</param>
+	/// <param name="model">Model matrix</param>
+	/// <param name="vertices">Vertex positions (3 floats per vertex)</param>
+	/// <param name="indices">Triangle vertex indices (3 per triangle)</param>
+	/// <param name="triangle_count">Triangle count</param>
+	void mge_rasterize_occluder(mge_occlusion_t* occlusion, const mgl_f32m4x4_t* model, const mgl_f32_t* vertices, const mgl_u32_t* indices, mgl_u64_t triangle_count);
+
+	/// <summary>
+	///		Rasterizes every active occluder component of a scene into the depth buffer.
+	/// </summary>
+	/// <param name="occlusion">Pointer to occlusion culling stage</param>
+	/// <param name="manager">Pointer to scene manager</param>
+	void mge_rasterize_scene_occluders(mge_occlusion_t* occlusion, mge_scene_manager_t* manager);
+
+	/// <summary>
+	///		Builds the hierarchical Z pyramid from the depth buffer.
+	///		Must be called after the occluders are rasterized and before any bounds are tested.
+	/// </summary>
+	/// <param name="occlusion">Pointer to occlusion culling stage</param>
+	void mge_build_occlusion_pyramid(mge_occlusion_t* occlusion);
+
+	/// <summary>
+	///		Checks if an AABB is completely hidden behind the rasterized occluders.
+	///		The test is conservative: boxes which cross the near plane are never occluded.
+	/// </summary>
+	/// <param name="occlusion">Pointer to occlusion culling stage</param>
+	/// <param name="aabb">AABB</param>
+	/// <returns>MGL_TRUE if occluded, otherwise MGL_FALSE</returns>
+	mgl_bool_t mge_is_aabb_occluded(mge_occlusion_t* occlusion, const mge_aabb_t* aabb);
+
+	/// <summary>
+	///		Removes the occluded nodes from a list of scene nodes (for example, a visible list from the culling stage).
+	/// </summary>
+	/// <param name="occlusion">Pointer to occlusion culling stage</param>
+	/// <param name="manager">Pointer to scene manager</param>
+	/// <param name="nodes">Scene node indices</param>
+	/// <param name="count">Scene node count</param>
+	/// <param name="out">Out indices of the nodes which aren't occluded (can be the same as nodes)</param>
+	/// <returns>Number of nodes which aren't occluded</returns>
+	mgl_u64_t mge_filter_occluded_scene_nodes(mge_occlusion_t* occlusion, mge_scene_manager_t* manager, const mgl_u32_t* nodes, mgl_u64_t count, mgl_u32_t* out);
+
+	/// <summary>
+	///		Gets the depth buffer (row-major, bottom row first, depths in [0, 1] where 1 is the far plane).
+	/// </summary>
+	/// <param name="occlusion">Pointer to occlusion culling stage</param>
+	/// <param name="width">Out width</param>
+	/// <param name="height">Out height</param>
+	/// <returns>Depth buffer</returns>
+	const mgl_f32_t* mge_get_occlusion_depth_buffer(mge_occlusion_t* occlusion, mgl_u64_t* width, mgl_u64_t* height);
+
+	/// <summary>
+	///		Gets the stats of an occlusion culling stage.
+	/// </summary>
+	/// <param name="occlusion">Pointer to occlusion culling stage</param>
+	/// <param name="stats">Out stats</param>
+	void mge_get_occlusion_stats(mge_occlusion_t* occlusion, mge_occlusion_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,137 @@
+#ifndef MGE_SCENE_POOL_H
+#define MGE_SCENE_POOL_H
+#ifdef __cplusplus
+extern "C" {
+#endif 
+
+#include <mgl/type.h>
+
+	typedef struct mge_scene_node_t mge_scene_node_t;
+	typedef struct mge_scene_component_t mge_scene_component_t;
+	typedef struct mge_scene_component_pool_t mge_scene_component_pool_t;
+
+	/// <summary>
+	///		Dense storage for every component of a single type.
+	///		Components are stored contiguously, with the active ones first:
+	///			[0, active_component_count[ are active;
+	///			[active_component_count, component_count[ are inactive.
+	///		A component only counts as active if its node is active in the hierarchy (see mge_scene_node_is_active).
+	///		Destroying or (de)activating a component moves other components of the same pool,
+	///		so pointers to pooled components must not be kept across those operations (keep the node instead).
+	/// </summary>
+	struct mge_scene_component_pool_t
+	{
+		/// <summary>
+		///		Allocator used.
+		/// </summary>
+		void* allocator;
+
+		/// <summary>
+		///		Type of the components stored in this pool.
+		/// </summary>
+		mgl_enum_u32_t type;
+
+		/// <summary>
+		///		Size of each component in bytes (including the mge_scene_component_t base).
+		/// </summary>
+		mgl_u64_t component_size;
+
+		/// <summary>
+		///		Max number of components.
+		/// </summary>
+		mgl_u64_t max_component_count;
+
+		/// <summary>
+		///		Number of components currently in the pool.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_u64_t component_count;
+
+		/// <summary>
+		///		Number of active components on active nodes, which are stored at the start of the array.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_u64_t active_component_count;
+
+		/// <summary>
+		///		Component array.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_u8_t* components;
+
+		/// <summary>
+		///		Function called when a component in this pool is destroyed, before it is removed from the pool (can be NULL).
+		/// </summary>
+		void(*destroy_func)(void* component);
+
+		/// <summary>
+		///		Set while the scene scheduler iterates the active components, when components of the pool must not be
+		///		created, destroyed, activated or deactivated.
+		///		WARNING: This should not be set manually.
+		/// </summary>
+		mgl_bool_t updating;
+	};
+
+	/// <summary>
+	///		Initializes a component pool.
+	/// </summary>
+	/// <param name="allocator">Allocator used</param>
+	/// <param name="type">Component type</param>
+	/// <param name="component_size">Component size in bytes (including the mge_scene_component_t base)</param>
+	/// <param name="max_component_count">Max component count</param>
+	/// <param name="destroy_func">Function called when a component is destroyed (can be NULL)</param>
+	/// <returns>Pointer to pool</returns>
+	mge_scene_component_pool_t* mge_init_scene_component_pool(void* allocator, mgl_enum_u32_t type, mgl_u64_t component_size, mgl_u64_t max_component_count, void(*destroy_func)(void* component));
+
+	/// <summary>
+	///		Terminates a component pool, destroying every component left in it.
+	/// </summary>
+	/// <param name="pool">Pointer to pool</param>
+	void mge_terminate_scene_component_pool(mge_scene_component_pool_t* pool);
+
+	/// <summary>
+	///		Creates an active component in a pool and adds it to a node.
+	///		Only the mge_scene_component_t base is initialized.
+	/// </summary>
+	/// <param name="pool">Pointer to pool</param>
+	/// <param name="node">Node</param>
+	/// <returns>Pointer to component</returns>
+	void* mge_create_pooled_scene_component(mge_scene_component_pool_t* pool, mge_scene_node_t* node);
+
+	/// <summary>
+	///		Activates or deactivates a pooled component, moving it to the matching part of its pool.
+	/// </summary>
+	/// <param name="component">Pointer to component</param>
+	/// <param name="active">Is the component active?</param>
+	/// <returns>New pointer to the component</returns>
+	void* mge_set_pooled_scene_component_active(void* component, mgl_bool_t active);
+
+	/// <summary>
+	///		Moves a pooled component to the matching part of its pool after its node's active state changed.
+	///		Called by the scene manager, shouldn't be needed elsewhere.
+	/// </summary>
+	/// <param name="component">Pointer to component</param>
+	/// <returns>New pointer to the component</returns>
+	void* mge_refresh_pooled_scene_component(void* component);
+
+	/// <summary>
+	///		Gets the active components in a pool as a contiguous array.
+	///		The stride between components is pool->component_size.
+	/// </summary>
+	/// <param name="pool">Pointer to pool</param>
+	/// <param name="count">Out active component count</param>
+	/// <returns>Pointer to the first active component</returns>
+	void* mge_get_active_pooled_scene_components(mge_scene_component_pool_t* pool, mgl_u64_t* count);
+
+	/// <summary>
+	///		Gets a component in a pool by index.
+	/// </summary>
+	/// <param name="pool">Pointer to pool</param>
+	/// <param name="index">Component index</param>
+	/// <returns>Pointer to component</returns>
+#define MGE_POOLED_SCENE_COMPONENT(pool, index) ((void*)((pool)->components + (index) * (pool)->component_size))
+
+#ifdef __cplusplus
+}
+#endif
+#endif
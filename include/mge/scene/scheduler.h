@@ -0,0 +1,100 @@
+#ifndef MGE_SCENE_SCHEDULER_H
+#define MGE_SCENE_SCHEDULER_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <mgl/type.h>
+
+	typedef struct mge_scene_manager_t mge_scene_manager_t;
+	typedef struct mge_scene_component_t mge_scene_component_t;
+	typedef struct mge_scene_scheduler_t mge_scene_scheduler_t;
+	typedef struct mge_scene_update_stats_t mge_scene_update_stats_t;
+
+	/// <summary>
+	///		Updates a component.
+	/// </summary>
+	/// <param name="component">Pointer to component</param>
+	/// <param name="delta_time">Time since the component's last update, in seconds</param>
+	/// <param name="data">User data passed on registration</param>
+	typedef void(*mge_scene_update_func_t)(mge_scene_component_t* component, mgl_f64_t delta_time, void* data);
+
+	/// <summary>
+	///		Gets the update priority of a component, from 0 (update once per interval) to 1 (update every frame).
+	/// </summary>
+	/// <param name="component">Pointer to component</param>
+	/// <param name="data">User data passed on registration</param>
+	/// <returns>Priority</returns>
+	typedef mgl_f32_t(*mge_scene_update_priority_func_t)(mge_scene_component_t* component, void* data);
+
+	struct mge_scene_update_stats_t
+	{
+		/// <summary>
+		///		Number of components updated on the last run.
+		/// </summary>
+		mgl_u64_t update_count;
+
+		/// <summary>
+		///		Number of components which were due for an update on the last run, but were deferred because the budget was spent.
+		/// </summary>
+		mgl_u64_t deferred_count;
+
+		/// <summary>
+		///		Time spent on the last run, in nanoseconds.
+		/// </summary>
+		mgl_u64_t time;
+	};
+
+	/// <summary>
+	///		Initializes a scene update scheduler, which updates the active components of the registered types every frame.
+	/// </summary>
+	/// <param name="allocator">Allocator used</param>
+	/// <param name="manager">Pointer to scene manager</param>
+	/// <param name="budget">Time budget for the updates which can be deferred, in microseconds</param>
+	/// <returns>Pointer to scheduler</returns>
+	mge_scene_scheduler_t* mge_init_scene_scheduler(void* allocator, mge_scene_manager_t* manager, mgl_u64_t budget);
+
+	/// <summary>
+	///		Terminates a scene update scheduler.
+	/// </summary>
+	/// <param name="scheduler">Pointer to scheduler</param>
+	void mge_terminate_scene_scheduler(mge_scene_scheduler_t* scheduler);
+
+	/// <summary>
+	///		Registers the update function of a component type, which must be registered on the scene manager.
+	///		With an interval of 0, every component is updated on every run.
+	///		Otherwise, each component is updated at least once per interval, and more often if the budget allows it:
+	///		a component is due once the time since its last update reaches interval * (1 - priority), and due components are
+	///		updated until the budget is spent, the rest being deferred to the next run. Without a priority function every
+	///		component is due on every run. Types get the budget in registration order.
+	///		Update functions must not create, destroy, activate or deactivate components of their own type (record scene
+	///		commands instead), since that moves the components being updated. This is asserted on debug builds.
+	/// </summary>
+	/// <param name="scheduler">Pointer to scheduler</param>
+	/// <param name="type">Component type</param>
+	/// <param name="update">Update function</param>
+	/// <param name="priority">Priority function (can be NULL)</param>
+	/// <param name="interval">Max time between updates of a component, in nanoseconds (0 = every run)</param>
+	/// <param name="data">User data passed to the functions</param>
+	void mge_register_scene_update(mge_scene_scheduler_t* scheduler, mgl_enum_u32_t type, mge_scene_update_func_t update, mge_scene_update_priority_func_t priority, mgl_u64_t interval, void* data);
+
+	/// <summary>
+	///		Updates the components of every registered type.
+	///		Called by the main loop once per frame, after the game update.
+	/// </summary>
+	/// <param name="scheduler">Pointer to scheduler</param>
+	/// <param name="time">Current time in nanoseconds (must be greater than 0 and never decrease)</param>
+	void mge_run_scene_updates(mge_scene_scheduler_t* scheduler, mgl_u64_t time);
+
+	/// <summary>
+	///		Gets the stats of a registered component type on the last run.
+	/// </summary>
+	/// <param name="scheduler">Pointer to scheduler</param>
+	/// <param name="type">Component type</param>
+	/// <param name="stats">Out stats</param>
+	void mge_get_scene_update_stats(mge_scene_scheduler_t* scheduler, mgl_enum_u32_t type, mge_scene_update_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,82 @@
+#ifndef MGE_SCENE_TRS_H
+#define MGE_SCENE_TRS_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <mgl/type.h>
+
+	typedef struct mge_scene_node_t mge_scene_node_t;
+	typedef struct mge_scene_manager_t mge_scene_manager_t;
+
+	/// <summary>
+	///		Switches a scene node to the translation/rotation/scale representation.
+	///		The current local transform is decomposed (it must not have shear or projection), and from then on the local
+	///		transform matrix is composed from the node's TRS when it is needed, overwriting manual changes to it.
+	///		The setters below enable TRS automatically.
+	/// </summary>
+	/// <param name="node">Node</param>
+	void mge_scene_node_enable_trs(mge_scene_node_t* node);
+
+	/// <summary>
+	///		Switches a scene node back to a plain local transform matrix, which keeps the last composed value.
+	/// </summary>
+	/// <param name="node">Node</param>
+	void mge_scene_node_disable_trs(mge_scene_node_t* node);
+
+	/// <summary>
+	///		Checks if a scene node uses the translation/rotation/scale representation.
+	/// </summary>
+	/// <param name="node">Node</param>
+	/// <returns>MGL_TRUE if TRS is enabled, otherwise MGL_FALSE</returns>
+	mgl_bool_t mge_scene_node_has_trs(mge_scene_node_t* node);
+
+	/// <summary>
+	///		Sets the local translation of a scene node.
+	/// </summary>
+	/// <param name="node">Node</param>
+	/// <param name="translation">Translation (x, y, z)</param>
+	void mge_scene_node_set_translation(mge_scene_node_t* node, const mgl_f32_t translation[3]);
+
+	/// <summary>
+	///		Sets the local rotation of a scene node.
+	/// </summary>
+	/// <param name="node">Node</param>
+	/// <param name="rotation">Unit quaternion (x, y, z, w)</param>
+	void mge_scene_node_set_rotation(mge_scene_node_t* node, const mgl_f32_t rotation[4]);
+
+	/// <summary>
+	///		Sets the local scale of a scene node.
+	/// </summary>
+	/// <param name="node">Node</param>
+	/// <param name="scale">Scale (x, y, z)</param>
+	void mge_scene_node_set_scale(mge_scene_node_t* node, const mgl_f32_t scale[3]);
+
+	/// <summary>
+	///		Gets the local translation, rotation and scale of a scene node which uses TRS.
+	/// </summary>
+	/// <param name="node">Node</param>
+	/// <param name="translation">Out translation (can be NULL)</param>
+	/// <param name="rotation">Out rotation quaternion (can be NULL)</param>
+	/// <param name="scale">Out scale (can be NULL)</param>
+	void mge_scene_node_get_trs(mge_scene_node_t* node, mgl_f32_t translation[3], mgl_f32_t rotation[4], mgl_f32_t scale[3]);
+
+	/// <summary>
+	///		Composes the local transform matrix of a scene node from its TRS, if it changed.
+	///		WARNING: This function shouldn't be used directly.
+	/// </summary>
+	/// <param name="node">Node</param>
+	void mge_compose_scene_node_trs(mge_scene_node_t* node);
+
+	/// <summary>
+	///		Composes the local transform matrices of every node whose TRS changed, four nodes at a time with SIMD instructions.
+	///		Called by mge_update_scene_transforms before the global transforms are updated.
+	///		WARNING: This function shouldn't be used directly.
+	/// </summary>
+	/// <param name="manager">Pointer to manager</param>
+	void mge_compose_scene_trs(mge_scene_manager_t* manager);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
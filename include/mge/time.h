@@ -0,0 +1,28 @@
+#ifndef MGE_TIME_H
+#define MGE_TIME_H
+#ifdef __cplusplus
+extern "C" {
+#endif 
+
+#include <mgl/type.h>
+
+#define MGE_NANOSECONDS_PER_SECOND 1000000000ull
+
+	/// <summary>
+	///		Gets the current time of a monotonic clock.
+	///		The value is only meaningful when compared with other values returned by this function.
+	/// </summary>
+	/// <returns>Time in nanoseconds</returns>
+	mgl_u64_t mge_get_time(void);
+
+	/// <summary>
+	///		Suspends the calling thread for at least the specified time.
+	///		The actual sleep duration depends on the OS scheduler granularity.
+	/// </summary>
+	/// <param name="ns">Time in nanoseconds</param>
+	void mge_sleep(mgl_u64_t ns);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
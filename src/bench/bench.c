@@ -0,0 +1,390 @@
+#include "bench.h"
+#include "data.h"
+
+#include <mge/config.h>
+#include <mge/log.h>
+#include <mge/loop.h>
+#include <mge/time.h>
+#include <mge/platform/file.h>
+
+#include <mgl/memory/allocator.h>
+#include <mgl/stream/stream.h>
+#include <mgl/string/manipulation.h>
+
+#define BENCH_MAX_RESULT_COUNT 64
+#define BENCH_MAX_REPETITION_COUNT 64
+#define BENCH_MAX_PARAMS_SIZE 128
+#define BENCH_MAX_JSON_SIZE (1 << 16)
+
+typedef struct
+{
+	const bench_t* bench;
+	mgl_chr8_t params[BENCH_MAX_PARAMS_SIZE];
+	mgl_u64_t operation_count;
+
+	// Times are in picoseconds per operation
+	mgl_u64_t min_time;
+	mgl_u64_t median_time;
+	mgl_bool_t has_baseline;
+	mgl_u64_t baseline_time;
+} bench_result_t;
+
+static struct
+{
+	const mgl_chr8_t* filter;
+	mgl_u64_t repetition_count;
+	const mgl_chr8_t* output_path;
+	const mgl_chr8_t* baseline_path;
+	mgl_u64_t threshold;
+} bench_options = { NULL, 5, NULL, NULL, 10 };
+
+static bench_result_t bench_results[BENCH_MAX_RESULT_COUNT];
+static mgl_u64_t bench_result_count = 0;
+
+static mgl_chr8_t bench_json[BENCH_MAX_JSON_SIZE];
+static mgl_u64_t bench_json_size = 0;
+
+void bench_begin(bench_run_t * run)
+{
+	run->start_time = mge_get_time();
+}
+
+void bench_end(bench_run_t * run, mgl_u64_t operation_count)
+{
+	run->time = mge_get_time() - run->start_time;
+	run->operation_count = operation_count;
+}
+
+static mgl_bool_t bench_str_contains(const mgl_chr8_t* str, const mgl_chr8_t* sub)
+{
+	for (; *str != 0; ++str)
+	{
+		mgl_u64_t i = 0;
+		while (sub[i] != 0 && str[i] == sub[i])
+			i += 1;
+		if (sub[i] == 0)
+			return MGL_TRUE;
+	}
+	return *sub == 0;
+}
+
+// Appends a time in picoseconds as nanoseconds with three decimals
+static void bench_append_time(mgl_chr8_t* buffer, mgl_u64_t* size, mgl_u64_t max_size, mgl_u64_t time)
+{
+	mgl_chr8_t decimals[4] = { (mgl_chr8_t)('0' + time / 100 % 10), (mgl_chr8_t)('0' + time / 10 % 10), (mgl_chr8_t)('0' + time % 10), 0 };
+	bench_append_u64(buffer, size, max_size, time / 1000);
+	bench_append(buffer, size, max_size, u8".");
+	bench_append(buffer, size, max_size, decimals);
+}
+
+// Appends the change from a baseline time, in percent with one decimal
+static void bench_append_change(mgl_chr8_t* buffer, mgl_u64_t* size, mgl_u64_t max_size, const bench_result_t* result)
+{
+	mgl_u64_t base = result->baseline_time > 0 ? result->baseline_time : 1;
+	mgl_bool_t faster = result->median_time < result->baseline_time;
+	mgl_u64_t difference = faster ? result->baseline_time - result->median_time : result->median_time - result->baseline_time;
+	mgl_u64_t permille = (difference * 1000 + base / 2) / base;
+	mgl_chr8_t decimal[2] = { (mgl_chr8_t)('0' + permille % 10), 0 };
+	bench_append(buffer, size, max_size, faster ? u8"-" : u8"");
+	bench_append_u64(buffer, size, max_size, permille / 10);
+	bench_append(buffer, size, max_size, u8".");
+	bench_append(buffer, size, max_size, decimal);
+}
+
+static mgl_bool_t bench_is_regression(const bench_result_t* result)
+{
+	return result->has_baseline && result->median_time * 100 > result->baseline_time * (100 + bench_options.threshold);
+}
+
+static void bench_parse_options(mge_game_locator_t* locator)
+{
+	for (mgl_u64_t i = 0; i + 1 < locator->argument_count; ++i)
+	{
+		const mgl_chr8_t* option = locator->arguments[i];
+		const mgl_chr8_t* value = locator->arguments[i + 1];
+
+		if (mgl_str_equal(option, u8"-bench-filter"))
+			bench_options.filter = value;
+		else if (mgl_str_equal(option, u8"-bench-repetitions"))
+			bench_options.repetition_count = bench_parse_u64_option(option, value);
+		else if (mgl_str_equal(option, u8"-bench-output"))
+			bench_options.output_path = value;
+		else if (mgl_str_equal(option, u8"-bench-baseline"))
+			bench_options.baseline_path = value;
+		else if (mgl_str_equal(option, u8"-bench-threshold"))
+			bench_options.threshold = bench_parse_u64_option(option, value);
+		else
+			continue;
+		i += 1;
+	}
+
+	if (bench_options.repetition_count == 0 || bench_options.repetition_count > BENCH_MAX_REPETITION_COUNT)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to parse benchmark options, the repetition count must be between 1 and 64");
+}
+
+static void bench_run(mge_game_locator_t* locator, const bench_t* bench, const mgl_u64_t* params)
+{
+	if (bench_result_count >= BENCH_MAX_RESULT_COUNT)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to run benchmark, too many results");
+	bench_result_t* result = &bench_results[bench_result_count++];
+	result->bench = bench;
+	result->has_baseline = MGL_FALSE;
+
+	// Parameters as 'name=value,name=value'
+	mgl_u64_t size = 0;
+	result->params[0] = 0;
+	for (mgl_u64_t i = 0; i < BENCH_MAX_PARAM_COUNT && bench->param_names[i] != NULL; ++i)
+	{
+		if (i > 0)
+			bench_append(result->params, &size, BENCH_MAX_PARAMS_SIZE, u8",");
+		bench_append(result->params, &size, BENCH_MAX_PARAMS_SIZE, bench->param_names[i]);
+		bench_append(result->params, &size, BENCH_MAX_PARAMS_SIZE, u8"=");
+		bench_append_u64(result->params, &size, BENCH_MAX_PARAMS_SIZE, params[i]);
+	}
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_GAME_CLIENT, u8"Running benchmark '");
+	MGE_LOG_VERBOSE_1(MGE_LOG_GAME_CLIENT, bench->name);
+	MGE_LOG_VERBOSE_1(MGE_LOG_GAME_CLIENT, u8"' (");
+	MGE_LOG_VERBOSE_1(MGE_LOG_GAME_CLIENT, result->params);
+	MGE_LOG_VERBOSE_1(MGE_LOG_GAME_CLIENT, u8")\n");
+
+	// Keep the times sorted, for the median
+	mgl_u64_t times[BENCH_MAX_REPETITION_COUNT];
+	for (mgl_u64_t r = 0; r < bench_options.repetition_count; ++r)
+	{
+		bench_run_t run;
+		run.locator = locator;
+		run.params = params;
+		run.repetition = r;
+		run.operation_count = 0;
+		bench->func(&run);
+		if (run.operation_count == 0)
+			mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to run benchmark, no operations were measured");
+
+		mgl_u64_t time = run.time * 1000 / run.operation_count;
+		mgl_u64_t j = r;
+		for (; j > 0 && times[j - 1] > time; --j)
+			times[j] = times[j - 1];
+		times[j] = time;
+		result->operation_count = run.operation_count;
+	}
+
+	result->min_time = times[0];
+	result->median_time = times[bench_options.repetition_count / 2];
+}
+
+static void bench_run_list(mge_game_locator_t* locator, const bench_t* benches, mgl_u64_t count)
+{
+	for (mgl_u64_t i = 0; i < count; ++i)
+	{
+		if (bench_options.filter != NULL && !bench_str_contains(benches[i].name, bench_options.filter))
+			continue;
+		for (mgl_u64_t j = 0; j < benches[i].param_set_count; ++j)
+			bench_run(locator, &benches[i], benches[i].param_sets[j]);
+	}
+}
+
+// Finds '"key": ' on a line and returns a pointer to the value, or NULL
+static const mgl_chr8_t* bench_find_field(const mgl_chr8_t* line, const mgl_chr8_t* line_end, const mgl_chr8_t* key)
+{
+	for (const mgl_chr8_t* p = line; p < line_end; ++p)
+	{
+		if (*p != '"')
+			continue;
+		mgl_u64_t i = 0;
+		while (key[i] != 0 && p + 1 + i < line_end && p[1 + i] == key[i])
+			i += 1;
+		if (key[i] == 0 && p + i + 4 <= line_end && p[1 + i] == '"' && p[2 + i] == ':' && p[3 + i] == ' ')
+			return p + i + 4;
+	}
+	return NULL;
+}
+
+static mgl_bool_t bench_field_equal(const mgl_chr8_t* value, const mgl_chr8_t* line_end, const mgl_chr8_t* str)
+{
+	if (value == NULL || *value != '"')
+		return MGL_FALSE;
+	value += 1;
+	while (*str != 0 && value < line_end && *value == *str)
+	{
+		value += 1;
+		str += 1;
+	}
+	return *str == 0 && value < line_end && *value == '"';
+}
+
+// Parses a time in nanoseconds with up to three decimals into picoseconds
+static mgl_u64_t bench_parse_time(const mgl_chr8_t* value, const mgl_chr8_t* line_end)
+{
+	mgl_u64_t time = 0;
+	for (; value < line_end && *value >= '0' && *value <= '9'; ++value)
+		time = time * 10 + (mgl_u64_t)(*value - '0');
+	time *= 1000;
+	if (value < line_end && *value == '.')
+	{
+		mgl_u64_t scale = 100;
+		for (++value; value < line_end && *value >= '0' && *value <= '9'; ++value, scale /= 10)
+			time += (mgl_u64_t)(*value - '0') * scale;
+	}
+	return time;
+}
+
+// The baseline is a previous output, where each benchmark result is on its own line
+static void bench_load_baseline(mge_game_locator_t* locator)
+{
+	mgl_u8_t* data;
+	mgl_u64_t size;
+	if (!mge_internal_read_file(bench_options.baseline_path, locator->game_allocator, &data, &size))
+	{
+		MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, u8"Couldn't read benchmark baseline '");
+		MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, bench_options.baseline_path);
+		MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, u8"'\n");
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to read benchmark baseline");
+	}
+
+	const mgl_chr8_t* line = (const mgl_chr8_t*)data;
+	const mgl_chr8_t* end = line + size;
+	while (line < end)
+	{
+		const mgl_chr8_t* line_end = line;
+		while (line_end < end && *line_end != '\n')
+			line_end += 1;
+
+		const mgl_chr8_t* name = bench_find_field(line, line_end, u8"name");
+		const mgl_chr8_t* params = bench_find_field(line, line_end, u8"params");
+		const mgl_chr8_t* median = bench_find_field(line, line_end, u8"median_ns_per_op");
+		if (name != NULL && params != NULL && median != NULL)
+			for (mgl_u64_t i = 0; i < bench_result_count; ++i)
+				if (bench_field_equal(name, line_end, bench_results[i].bench->name) && bench_field_equal(params, line_end, bench_results[i].params))
+				{
+					bench_results[i].has_baseline = MGL_TRUE;
+					bench_results[i].baseline_time = bench_parse_time(median, line_end);
+				}
+
+		line = line_end + 1;
+	}
+
+	mgl_error_t err = mgl_deallocate(locator->game_allocator, data);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_GAME_CLIENT, u8"Failed to deallocate benchmark baseline", err);
+}
+
+static void bench_write_json(void)
+{
+	mgl_chr8_t* b = bench_json;
+	mgl_u64_t* s = &bench_json_size;
+	mgl_u64_t m = BENCH_MAX_JSON_SIZE;
+
+	bench_append(b, s, m, u8"{\n\t\"version\": \"" MGE_VERSION u8"\",\n\t\"repetitions\": ");
+	bench_append_u64(b, s, m, bench_options.repetition_count);
+	bench_append(b, s, m, u8",\n\t\"benchmarks\": [\n");
+	for (mgl_u64_t i = 0; i < bench_result_count; ++i)
+	{
+		const bench_result_t* result = &bench_results[i];
+		bench_append(b, s, m, u8"\t\t{ \"name\": \"");
+		bench_append(b, s, m, result->bench->name);
+		bench_append(b, s, m, u8"\", \"params\": \"");
+		bench_append(b, s, m, result->params);
+		bench_append(b, s, m, u8"\", \"operations\": ");
+		bench_append_u64(b, s, m, result->operation_count);
+		bench_append(b, s, m, u8", \"min_ns_per_op\": ");
+		bench_append_time(b, s, m, result->min_time);
+		bench_append(b, s, m, u8", \"median_ns_per_op\": ");
+		bench_append_time(b, s, m, result->median_time);
+		if (result->has_baseline)
+		{
+			bench_append(b, s, m, u8", \"baseline_median_ns_per_op\": ");
+			bench_append_time(b, s, m, result->baseline_time);
+			bench_append(b, s, m, u8", \"change_percent\": ");
+			bench_append_change(b, s, m, result);
+			bench_append(b, s, m, bench_is_regression(result) ? u8", \"regression\": true" : u8", \"regression\": false");
+		}
+		bench_append(b, s, m, i + 1 < bench_result_count ? u8" },\n" : u8" }\n");
+	}
+	bench_append(b, s, m, u8"\t]\n}\n");
+}
+
+static void bench_print_summary(void)
+{
+	mgl_chr8_t line[512];
+	for (mgl_u64_t i = 0; i < bench_result_count; ++i)
+	{
+		const bench_result_t* result = &bench_results[i];
+		mgl_u64_t size = 0;
+		bench_append(line, &size, sizeof(line), result->bench->name);
+		bench_append(line, &size, sizeof(line), u8" (");
+		bench_append(line, &size, sizeof(line), result->params);
+		bench_append(line, &size, sizeof(line), u8"): ");
+		bench_append_time(line, &size, sizeof(line), result->median_time);
+		bench_append(line, &size, sizeof(line), u8" ns/op");
+		if (result->has_baseline)
+		{
+			bench_append(line, &size, sizeof(line), u8" (baseline ");
+			bench_append_time(line, &size, sizeof(line), result->baseline_time);
+			bench_append(line, &size, sizeof(line), u8" ns/op, ");
+			bench_append_change(line, &size, sizeof(line), result);
+			bench_append(line, &size, sizeof(line), bench_is_regression(result) ? u8"%, REGRESSION)" : u8"%)");
+		}
+		bench_append(line, &size, sizeof(line), u8"\n");
+		mgl_print(mgl_stdout_stream, line);
+	}
+}
+
+void mge_game_get_config(mge_engine_config_t* config)
+{
+	// Benchmarks run on load, the loop only runs a single frame
+	config->headless = MGL_TRUE;
+	config->target_frame_rate = 0;
+	config->frame_cap = 1;
+}
+
+void mge_game_load(mge_game_locator_t* locator)
+{
+	bench_parse_options(locator);
+	bench_register_archive();
+
+	bench_run_list(locator, bench_resource_benches, bench_resource_bench_count);
+	bench_run_list(locator, bench_scene_benches, bench_scene_bench_count);
+	if (bench_result_count == 0)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to run benchmarks, no benchmark matches the filter");
+
+	if (bench_options.baseline_path != NULL)
+		bench_load_baseline(locator);
+
+	// The JSON goes to stdout unless an output file is set, in which case a summary is printed instead
+	bench_write_json();
+	if (bench_options.output_path == NULL)
+		mgl_print(mgl_stdout_stream, bench_json);
+	else
+	{
+		if (!mge_internal_write_file(bench_options.output_path, bench_json, bench_json_size))
+			mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to write benchmark results");
+		bench_print_summary();
+	}
+
+	for (mgl_u64_t i = 0; i < bench_result_count; ++i)
+		if (bench_is_regression(&bench_results[i]))
+		{
+			MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, u8"Benchmark '");
+			MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, bench_results[i].bench->name);
+			MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, u8"' (");
+			MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, bench_results[i].params);
+			MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, u8") regressed over the threshold\n");
+			locator->exit_code = 1;
+		}
+}
+
+void mge_game_unload(mge_game_locator_t* locator)
+{
+	bench_unregister_archive();
+}
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+
+}
@@ -0,0 +1,78 @@
+#ifndef MGE_BENCH_BENCH_H
+#define MGE_BENCH_BENCH_H
+
+#include <mge/game.h>
+
+#define BENCH_MAX_PARAM_COUNT 3
+#define BENCH_MAX_PARAM_SET_COUNT 8
+
+typedef struct bench_t bench_t;
+typedef struct bench_run_t bench_run_t;
+
+struct bench_run_t
+{
+	mge_game_locator_t* locator;
+
+	/// <summary>
+	///		Parameter values, in the order of the benchmark's parameter names.
+	/// </summary>
+	const mgl_u64_t* params;
+
+	/// <summary>
+	///		Index of the repetition, generated data can be kept from the first one.
+	/// </summary>
+	mgl_u64_t repetition;
+
+	/// <summary>
+	///		Set by bench_begin and bench_end.
+	/// </summary>
+	mgl_u64_t start_time;
+	mgl_u64_t time;
+	mgl_u64_t operation_count;
+};
+
+struct bench_t
+{
+	/// <summary>
+	///		Name, as '<subsystem>/<operation>'.
+	/// </summary>
+	const mgl_chr8_t* name;
+
+	/// <summary>
+	///		Runs the benchmark once: sets up its data, measures a number of operations between bench_begin and bench_end,
+	///		and cleans up.
+	/// </summary>
+	void(*func)(bench_run_t* run);
+
+	/// <summary>
+	///		Parameter names (NULL after the last one).
+	/// </summary>
+	const mgl_chr8_t* param_names[BENCH_MAX_PARAM_COUNT];
+
+	/// <summary>
+	///		Parameter values to run the benchmark with.
+	/// </summary>
+	mgl_u64_t param_set_count;
+	mgl_u64_t param_sets[BENCH_MAX_PARAM_SET_COUNT][BENCH_MAX_PARAM_COUNT];
+};
+
+/// <summary>
+///		Starts measuring a benchmark run.
+/// </summary>
+/// <param name="run">Benchmark run</param>
+void bench_begin(bench_run_t* run);
+
+/// <summary>
+///		Stops measuring a benchmark run.
+/// </summary>
+/// <param name="run">Benchmark run</param>
+/// <param name="operation_count">Number of operations measured</param>
+void bench_end(bench_run_t* run, mgl_u64_t operation_count);
+
+extern const bench_t bench_resource_benches[];
+extern const mgl_u64_t bench_resource_bench_count;
+
+extern const bench_t bench_scene_benches[];
+extern const mgl_u64_t bench_scene_bench_count;
+
+#endif
@@ -0,0 +1,227 @@
+#include "data.h"
+
+#include <mge/log.h>
+#include <mge/resource/manager.h>
+#include <mge/platform/file.h>
+
+#include <mgl/file/windows_standard_archive.h>
+#include <mgl/memory/allocator.h>
+#include <mgl/memory/manipulation.h>
+#include <mgl/string/conversion.h>
+#include <mgl/string/manipulation.h>
+
+// Size of a resource entry on a resource info file without dependencies
+#define BENCH_RESOURCE_INFO_SIZE (4 + 4 + 8 + MGE_MAX_RESOURCE_NAME_SIZE + MGE_MAX_RESOURCE_DATA_PATH_SIZE + 4)
+
+static mgl_windows_standard_archive_t bench_archive;
+
+static void bench_write_u32(mgl_u8_t* ptr, mgl_u32_t value)
+{
+	for (mgl_u64_t i = 0; i < 4; ++i)
+		ptr[i] = (mgl_u8_t)(value >> (i * 8));
+}
+
+static void bench_write_u64(mgl_u8_t* ptr, mgl_u64_t value)
+{
+	for (mgl_u64_t i = 0; i < 8; ++i)
+		ptr[i] = (mgl_u8_t)(value >> (i * 8));
+}
+
+// Joins up to three strings into a buffer, truncating the result
+static void bench_join(mgl_chr8_t* out_str, mgl_u64_t size, const mgl_chr8_t* a, const mgl_chr8_t* b, const mgl_chr8_t* c)
+{
+	const mgl_chr8_t* parts[3] = { a, b, c };
+	mgl_u64_t length = 0;
+	for (mgl_u64_t i = 0; i < 3; ++i)
+		for (const mgl_chr8_t* p = parts[i]; p != NULL && *p != 0 && length + 1 < size; ++p)
+			out_str[length++] = *p;
+	out_str[length] = 0;
+}
+
+static void bench_write_generated_file(const mgl_chr8_t* path, const void* data, mgl_u64_t size)
+{
+	if (!mge_internal_write_file(path, data, size))
+	{
+		MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, u8"Couldn't write generated file '");
+		MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, path);
+		MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, u8"'\n");
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to write generated file");
+	}
+}
+
+void bench_register_archive(void)
+{
+	mgl_error_t err = mgl_init_windows_standard_archive(&bench_archive, mgl_standard_allocator, u8".");
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_GAME_CLIENT, u8"Failed to init generated data archive", err);
+	err = mgl_register_archive(BENCH_ARCHIVE_NAME, &bench_archive);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_GAME_CLIENT, u8"Failed to register generated data archive", err);
+}
+
+void bench_unregister_archive(void)
+{
+	mgl_unregister_archive(&bench_archive);
+	mgl_terminate_windows_standard_archive(&bench_archive);
+}
+
+mgl_u64_t bench_format_u64(mgl_u64_t value, mgl_chr8_t * out_str)
+{
+	mgl_chr8_t digits[20];
+	mgl_u64_t count = 0;
+	do
+	{
+		digits[count++] = (mgl_chr8_t)('0' + value % 10);
+		value /= 10;
+	} while (value != 0);
+
+	for (mgl_u64_t i = 0; i < count; ++i)
+		out_str[i] = digits[count - 1 - i];
+	out_str[count] = 0;
+	return count;
+}
+
+void bench_append(mgl_chr8_t * buffer, mgl_u64_t * size, mgl_u64_t max_size, const mgl_chr8_t * str)
+{
+	for (; *str != 0; ++str)
+	{
+		if (*size + 1 >= max_size)
+			mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to write output, buffer too small");
+		buffer[(*size)++] = *str;
+	}
+	buffer[*size] = 0;
+}
+
+void bench_append_u64(mgl_chr8_t * buffer, mgl_u64_t * size, mgl_u64_t max_size, mgl_u64_t value)
+{
+	mgl_chr8_t str[21];
+	bench_format_u64(value, str);
+	bench_append(buffer, size, max_size, str);
+}
+
+mgl_u64_t bench_parse_u64_option(const mgl_chr8_t * option, const mgl_chr8_t * value)
+{
+	mgl_u64_t ret;
+	if (value == NULL || mgl_u64_from_str(value, mgl_str_size(value), &ret, 10, NULL) != MGL_ERROR_NONE)
+	{
+		MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, u8"Couldn't parse the value of the option '");
+		MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, option);
+		MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, u8"'\n");
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to parse option");
+	}
+	return ret;
+}
+
+void bench_get_resource_name(mgl_u64_t index, mgl_chr8_t * out_name)
+{
+	mgl_chr8_t number[21];
+	bench_format_u64(index, number);
+	bench_join(out_name, MGE_MAX_RESOURCE_NAME_SIZE, u8"resource_", number, NULL);
+}
+
+void bench_get_resource_pack_path(const mgl_chr8_t * name, mgl_chr8_t * out_path)
+{
+	bench_join(out_path, MGE_MAX_RESOURCE_DATA_PATH_SIZE, BENCH_ARCHIVE_NAME u8"/", name, u8".mri");
+}
+
+void bench_generate_resource_pack(const mgl_chr8_t * name, mgl_u64_t count, mgl_enum_u32_t type, mgl_u64_t text_size)
+{
+	MGL_DEBUG_ASSERT(name != NULL && (type == MGE_RESOURCE_EMPTY || type == MGE_RESOURCE_TEXT));
+
+	mgl_chr8_t path[MGE_MAX_RESOURCE_DATA_PATH_SIZE];
+	mgl_chr8_t data_path[MGE_MAX_RESOURCE_DATA_PATH_SIZE];
+	bench_join(data_path, MGE_MAX_RESOURCE_DATA_PATH_SIZE, BENCH_ARCHIVE_NAME u8"/", name, u8".mrd");
+
+	// Info file
+	mgl_u64_t size = 8 + count * BENCH_RESOURCE_INFO_SIZE;
+	mgl_u8_t* info;
+	mgl_error_t err = mgl_allocate(mgl_standard_allocator, size, (void**)&info);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_GAME_CLIENT, u8"Failed to allocate generated resource info file", err);
+	mgl_mem_set(info, size, 0);
+
+	bench_write_u32(info, 1);
+	bench_write_u32(info + 4, (mgl_u32_t)count);
+	for (mgl_u64_t i = 0; i < count; ++i)
+	{
+		mgl_u8_t* entry = info + 8 + i * BENCH_RESOURCE_INFO_SIZE;
+		bench_write_u32(entry, type);
+		bench_write_u32(entry + 4, 0);
+		bench_write_u64(entry + 8, i * (sizeof(mgl_u64_t) + text_size));
+		bench_get_resource_name(i, (mgl_chr8_t*)(entry + 16));
+		if (type == MGE_RESOURCE_TEXT)
+			mgl_str_copy(data_path, (mgl_chr8_t*)(entry + 16 + MGE_MAX_RESOURCE_NAME_SIZE), MGE_MAX_RESOURCE_DATA_PATH_SIZE);
+	}
+
+	bench_join(path, MGE_MAX_RESOURCE_DATA_PATH_SIZE, name, u8".mri", NULL);
+	bench_write_generated_file(path, info, size);
+	err = mgl_deallocate(mgl_standard_allocator, info);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_GAME_CLIENT, u8"Failed to deallocate generated resource info file", err);
+
+	if (type != MGE_RESOURCE_TEXT)
+		return;
+
+	// Data file, each text is preceded by its size (as the text resource loader reads it)
+	size = count * (sizeof(mgl_u64_t) + text_size);
+	mgl_u8_t* data;
+	err = mgl_allocate(mgl_standard_allocator, size, (void**)&data);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_GAME_CLIENT, u8"Failed to allocate generated resource data file", err);
+
+	for (mgl_u64_t i = 0; i < count; ++i)
+	{
+		mgl_u8_t* entry = data + i * (sizeof(mgl_u64_t) + text_size);
+		mgl_mem_copy(entry, &text_size, sizeof(mgl_u64_t));
+		for (mgl_u64_t j = 0; j < text_size; ++j)
+			entry[sizeof(mgl_u64_t) + j] = (mgl_u8_t)('a' + (i + j) % 26);
+	}
+
+	bench_join(path, MGE_MAX_RESOURCE_DATA_PATH_SIZE, name, u8".mrd", NULL);
+	bench_write_generated_file(path, data, size);
+	err = mgl_deallocate(mgl_standard_allocator, data);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_GAME_CLIENT, u8"Failed to deallocate generated resource data file", err);
+}
+
+mgl_u64_t bench_get_hierarchy_size(mgl_u64_t depth, mgl_u64_t fan_out)
+{
+	mgl_u64_t size = 0;
+	mgl_u64_t level_size = 1;
+	for (mgl_u64_t i = 0; i < depth; ++i)
+	{
+		level_size *= fan_out;
+		size += level_size;
+	}
+	return size;
+}
+
+mgl_u64_t bench_generate_hierarchy(mge_scene_node_t * parent, mgl_u64_t depth, mgl_u64_t fan_out, mge_scene_node_t ** out_nodes)
+{
+	MGL_DEBUG_ASSERT(parent != NULL && out_nodes != NULL);
+
+	mgl_u64_t count = 0;
+	mgl_u64_t level_start = 0;
+	mgl_u64_t level_size = 0;
+	for (mgl_u64_t level = 0; level < depth; ++level)
+	{
+		// The top level hangs from the parent, the others from each node of the level above
+		mgl_u64_t parent_count = level == 0 ? 1 : level_size;
+		for (mgl_u64_t i = 0; i < parent_count; ++i)
+			for (mgl_u64_t j = 0; j < fan_out; ++j)
+				out_nodes[count++] = mge_create_scene_node(level == 0 ? parent : out_nodes[level_start + i], NULL);
+
+		level_start = count - parent_count * fan_out;
+		level_size = parent_count * fan_out;
+	}
+
+	return count;
+}
+
+mgl_u32_t bench_random(mgl_u32_t * state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return *state;
+}
@@ -0,0 +1,107 @@
+#ifndef MGE_BENCH_DATA_H
+#define MGE_BENCH_DATA_H
+
+#include <mge/scene/manager.h>
+
+// Synthetic data generators shared by the benchmark and soak tools.
+// Generated files are written to the working directory, which is registered as the 'bench' archive.
+
+#define BENCH_ARCHIVE_NAME u8"bench"
+
+/// <summary>
+///		Registers the working directory as the 'bench' archive, so generated files can be found by the resource manager.
+/// </summary>
+void bench_register_archive(void);
+
+/// <summary>
+///		Unregisters the 'bench' archive.
+/// </summary>
+void bench_unregister_archive(void);
+
+/// <summary>
+///		Writes a decimal number followed by a null character.
+/// </summary>
+/// <param name="value">Value</param>
+/// <param name="out_str">Out string (at least 21 characters)</param>
+/// <returns>Number of digits written</returns>
+mgl_u64_t bench_format_u64(mgl_u64_t value, mgl_chr8_t* out_str);
+
+/// <summary>
+///		Appends a string to a buffer, keeping it null terminated.
+///		Fails fatally if the buffer is too small.
+/// </summary>
+/// <param name="buffer">Buffer</param>
+/// <param name="size">Size of the string on the buffer, updated</param>
+/// <param name="max_size">Buffer size</param>
+/// <param name="str">String appended</param>
+void bench_append(mgl_chr8_t* buffer, mgl_u64_t* size, mgl_u64_t max_size, const mgl_chr8_t* str);
+
+/// <summary>
+///		Appends a decimal number to a buffer (see bench_append).
+/// </summary>
+/// <param name="buffer">Buffer</param>
+/// <param name="size">Size of the string on the buffer, updated</param>
+/// <param name="max_size">Buffer size</param>
+/// <param name="value">Value appended</param>
+void bench_append_u64(mgl_chr8_t* buffer, mgl_u64_t* size, mgl_u64_t max_size, mgl_u64_t value);
+
+/// <summary>
+///		Parses the decimal value of a command line option, failing fatally if it isn't a number.
+/// </summary>
+/// <param name="option">Option name, for the error message</param>
+/// <param name="value">Option value (can be NULL)</param>
+/// <returns>Value</returns>
+mgl_u64_t bench_parse_u64_option(const mgl_chr8_t* option, const mgl_chr8_t* value);
+
+/// <summary>
+///		Gets the name of the generated resource with an index ('resource_<index>').
+/// </summary>
+/// <param name="index">Resource index</param>
+/// <param name="out_name">Out name (MGE_MAX_RESOURCE_NAME_SIZE characters)</param>
+void bench_get_resource_name(mgl_u64_t index, mgl_chr8_t* out_name);
+
+/// <summary>
+///		Generates a resource pack: a resource info file '<name>.mri' with a number of resources and, for text resources,
+///		a data file '<name>.mrd' with their texts.
+///		The info file is then added to the resource manager as 'bench/<name>.mri'.
+/// </summary>
+/// <param name="name">Pack name</param>
+/// <param name="count">Number of resources</param>
+/// <param name="type">Type of the resources (MGE_RESOURCE_EMPTY or MGE_RESOURCE_TEXT)</param>
+/// <param name="text_size">Size of each text, for text resources</param>
+void bench_generate_resource_pack(const mgl_chr8_t* name, mgl_u64_t count, mgl_enum_u32_t type, mgl_u64_t text_size);
+
+/// <summary>
+///		Gets the path the resource manager finds a generated pack's info file on ('bench/<name>.mri').
+/// </summary>
+/// <param name="name">Pack name</param>
+/// <param name="out_path">Out path (MGE_MAX_RESOURCE_DATA_PATH_SIZE characters)</param>
+void bench_get_resource_pack_path(const mgl_chr8_t* name, mgl_chr8_t* out_path);
+
+/// <summary>
+///		Gets the number of nodes in a hierarchy generated by bench_generate_hierarchy.
+/// </summary>
+/// <param name="depth">Number of levels</param>
+/// <param name="fan_out">Number of children of each node above the last level</param>
+/// <returns>Node count</returns>
+mgl_u64_t bench_get_hierarchy_size(mgl_u64_t depth, mgl_u64_t fan_out);
+
+/// <summary>
+///		Generates a hierarchy of nodes under a parent, where every node above the last level has the same number of
+///		children, breadth-first.
+/// </summary>
+/// <param name="parent">Parent of the hierarchy's top level</param>
+/// <param name="depth">Number of levels</param>
+/// <param name="fan_out">Number of children of each node above the last level (and number of top level nodes)</param>
+/// <param name="out_nodes">Out nodes, in creation order (bench_get_hierarchy_size entries)</param>
+/// <returns>Node count</returns>
+mgl_u64_t bench_generate_hierarchy(mge_scene_node_t* parent, mgl_u64_t depth, mgl_u64_t fan_out, mge_scene_node_t** out_nodes);
+
+/// <summary>
+///		Returns the next value of a xorshift random number generator.
+/// </summary>
+/// <param name="state">Generator state (must not be zero)</param>
+/// <returns>Random value</returns>
+mgl_u32_t bench_random(mgl_u32_t* state);
+
+#endif
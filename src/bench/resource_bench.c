@@ -0,0 +1,154 @@
+#include "bench.h"
+#include "data.h"
+
+#include <mge/resource/manager.h>
+#include <mge/resource/text.h>
+#include <mge/platform/file.h>
+
+#include <mgl/memory/allocator.h>
+
+// Number of resources looked up, opened or closed on each run
+#define LOOKUP_COUNT 1000
+#define MAX_RESOURCE_COUNT 100000
+#define TEXT_SIZE 64
+
+// Batch loads read up to this much data, in up to LOOKUP_COUNT resources
+#define LOAD_DATA_SIZE (64 * 1024 * 1024)
+
+static mgl_chr8_t names[LOOKUP_COUNT][MGE_MAX_RESOURCE_NAME_SIZE];
+static mge_resource_t* lookups[LOOKUP_COUNT];
+static mge_text_resource_access_t accesses[MAX_RESOURCE_COUNT];
+
+static void get_pack_name(const mgl_chr8_t* prefix, mgl_u64_t count, mgl_chr8_t* out_name)
+{
+	mgl_chr8_t number[21];
+	bench_format_u64(count, number);
+	mgl_u64_t length = 0;
+	for (const mgl_chr8_t* p = prefix; *p != 0; ++p)
+		out_name[length++] = *p;
+	for (const mgl_chr8_t* p = number; *p != 0; ++p)
+		out_name[length++] = *p;
+	out_name[length] = 0;
+}
+
+static mge_resource_manager_t* load_pack(bench_run_t* run, const mgl_chr8_t* prefix, mgl_u64_t count, mgl_enum_u32_t type)
+{
+	mgl_chr8_t name[64];
+	mgl_chr8_t path[MGE_MAX_RESOURCE_DATA_PATH_SIZE];
+	get_pack_name(prefix, count, name);
+	if (run->repetition == 0)
+		bench_generate_resource_pack(name, count, type, TEXT_SIZE);
+
+	mge_resource_manager_t* manager = mge_init_resource_manager(run->locator->game_allocator, NULL, count);
+	bench_get_resource_pack_path(name, path);
+	mge_add_resource_info_file(manager, path);
+	return manager;
+}
+
+static void pick_resources(mgl_u64_t count)
+{
+	mgl_u32_t random = 12345;
+	for (mgl_u64_t i = 0; i < LOOKUP_COUNT; ++i)
+		bench_get_resource_name(bench_random(&random) % count, names[i]);
+}
+
+static void bench_find_resource(bench_run_t* run)
+{
+	mgl_u64_t count = run->params[0];
+	mge_resource_manager_t* manager = load_pack(run, u8"mge_bench_find_", count, MGE_RESOURCE_EMPTY);
+	pick_resources(count);
+
+	bench_begin(run);
+	for (mgl_u64_t i = 0; i < LOOKUP_COUNT; ++i)
+		lookups[i] = mge_find_resource(manager, names[i]);
+	bench_end(run, LOOKUP_COUNT);
+
+	mge_terminate_resource_manager(manager);
+}
+
+static void bench_open_close_resource(bench_run_t* run)
+{
+	mgl_u64_t count = run->params[0];
+	mgl_bool_t loaded = run->params[1] != 0;
+	mge_resource_manager_t* manager = load_pack(run, u8"mge_bench_text_", count, MGE_RESOURCE_TEXT);
+	pick_resources(count);
+	for (mgl_u64_t i = 0; i < LOOKUP_COUNT; ++i)
+		lookups[i] = mge_find_resource(manager, names[i]);
+
+	// Keeping every resource open measures the reference counting alone, otherwise each open loads the resource
+	if (loaded)
+		for (mgl_u64_t i = 0; i < count; ++i)
+		{
+			bench_get_resource_name(i, names[0]);
+			mge_open_resource(mge_find_resource(manager, names[0]), &accesses[i], MGE_RESOURCE_TEXT);
+		}
+
+	bench_begin(run);
+	for (mgl_u64_t i = 0; i < LOOKUP_COUNT; ++i)
+	{
+		mge_text_resource_access_t access;
+		mge_open_resource(lookups[i], &access, MGE_RESOURCE_TEXT);
+		mge_close_resource(&access);
+	}
+	bench_end(run, LOOKUP_COUNT);
+
+	if (loaded)
+		for (mgl_u64_t i = 0; i < count; ++i)
+			mge_close_resource(&accesses[i]);
+
+	mge_terminate_resource_manager(manager);
+}
+
+static void bench_load_resources(bench_run_t* run)
+{
+	mgl_u64_t size = run->params[0];
+	mgl_bool_t cold = run->params[1] != 0;
+	mgl_bool_t batched = run->params[2] != 0;
+	mgl_u64_t count = LOAD_DATA_SIZE / size < LOOKUP_COUNT ? LOAD_DATA_SIZE / size : LOOKUP_COUNT;
+
+	mgl_chr8_t name[64];
+	mgl_chr8_t path[MGE_MAX_RESOURCE_DATA_PATH_SIZE];
+	get_pack_name(u8"mge_bench_load_", size, name);
+	if (run->repetition == 0)
+		bench_generate_resource_pack(name, count, MGE_RESOURCE_TEXT, size);
+
+	// Without a native directory, every resource is loaded through MGL, as on open
+	mge_resource_manager_t* manager = mge_init_resource_manager(run->locator->game_allocator, NULL, count);
+	if (batched)
+		mge_add_resource_native_directory(manager, BENCH_ARCHIVE_NAME, u8".");
+	bench_get_resource_pack_path(name, path);
+	mge_add_resource_info_file(manager, path);
+	for (mgl_u64_t i = 0; i < count; ++i)
+	{
+		bench_get_resource_name(i, names[0]);
+		lookups[i] = mge_find_resource(manager, names[0]);
+	}
+
+	// Cold runs read the data file from the disk (on Linux, elsewhere they are the same as warm runs)
+	if (cold)
+	{
+		mgl_chr8_t data_path[MGE_MAX_RESOURCE_DATA_PATH_SIZE];
+		mgl_u64_t length = 0;
+		data_path[0] = 0;
+		bench_append(data_path, &length, MGE_MAX_RESOURCE_DATA_PATH_SIZE, name);
+		bench_append(data_path, &length, MGE_MAX_RESOURCE_DATA_PATH_SIZE, u8".mrd");
+		mge_internal_drop_file_cache(data_path);
+	}
+
+	bench_begin(run);
+	mge_load_resources(manager, lookups, count);
+	bench_end(run, count);
+
+	mge_terminate_resource_manager(manager);
+}
+
+const bench_t bench_resource_benches[] =
+{
+	{ u8"resource/find", &bench_find_resource, { u8"count", NULL }, 3, { { 100 }, { 1000 }, { 10000 } } },
+	{ u8"resource/open_close", &bench_open_close_resource, { u8"count", u8"loaded", NULL }, 2, { { 1000, 0 }, { 1000, 1 } } },
+	{ u8"resource/load", &bench_load_resources, { u8"size", u8"cold", u8"batched" }, 8, {
+		{ 4096, 0, 0 }, { 4096, 0, 1 }, { 4096, 1, 0 }, { 4096, 1, 1 },
+		{ 1048576, 0, 0 }, { 1048576, 0, 1 }, { 1048576, 1, 0 }, { 1048576, 1, 1 } } },
+};
+
+const mgl_u64_t bench_resource_bench_count = sizeof(bench_resource_benches) / sizeof(bench_t);
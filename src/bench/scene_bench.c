@@ -0,0 +1,77 @@
+#include "bench.h"
+#include "data.h"
+
+#include <mge/log.h>
+#include <mge/scene/manager.h>
+#include <mge/scene/node.h>
+
+#include <mgl/memory/allocator.h>
+
+#define MAX_NODE_COUNT (1 << 20)
+
+static mge_scene_node_t* nodes[MAX_NODE_COUNT];
+
+static mge_scene_manager_t* init_manager(bench_run_t* run, mgl_u64_t node_count)
+{
+	if (node_count > MAX_NODE_COUNT)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to run scene benchmark, too many nodes");
+
+	// Plus the root node
+	return mge_init_scene_manager(run->locator->game_allocator, node_count + 1);
+}
+
+static void bench_create_scene_node(bench_run_t* run)
+{
+	mgl_u64_t count = run->params[0];
+	mge_scene_manager_t* manager = init_manager(run, count);
+
+	bench_begin(run);
+	for (mgl_u64_t i = 0; i < count; ++i)
+		nodes[i] = mge_create_scene_node(manager->root, NULL);
+	bench_end(run, count);
+
+	mge_terminate_scene_manager(manager);
+}
+
+static void bench_destroy_scene_node(bench_run_t* run)
+{
+	mgl_u64_t count = run->params[0];
+	mge_scene_manager_t* manager = init_manager(run, count);
+	for (mgl_u64_t i = 0; i < count; ++i)
+		nodes[i] = mge_create_scene_node(manager->root, NULL);
+
+	// Newest first, as temporary nodes usually are
+	bench_begin(run);
+	for (mgl_u64_t i = count; i > 0; --i)
+		mge_destroy_scene_node(nodes[i - 1]);
+	bench_end(run, count);
+
+	mge_terminate_scene_manager(manager);
+}
+
+static void bench_update_scene_transforms(bench_run_t* run)
+{
+	mgl_u64_t depth = run->params[0];
+	mgl_u64_t fan_out = run->params[1];
+	mge_scene_manager_t* manager = init_manager(run, bench_get_hierarchy_size(depth, fan_out));
+	mgl_u64_t count = bench_generate_hierarchy(manager->root, depth, fan_out, nodes);
+	mge_update_scene_transforms(manager);
+
+	// Every node moves, through its top level ancestor
+	bench_begin(run);
+	for (mgl_u64_t i = 0; i < fan_out; ++i)
+		mge_scene_node_set_dirty(nodes[i]);
+	mge_update_scene_transforms(manager);
+	bench_end(run, count);
+
+	mge_terminate_scene_manager(manager);
+}
+
+const bench_t bench_scene_benches[] =
+{
+	{ u8"scene/create_node", &bench_create_scene_node, { u8"count", NULL }, 2, { { 10000 }, { 100000 } } },
+	{ u8"scene/destroy_node", &bench_destroy_scene_node, { u8"count", NULL }, 2, { { 10000 }, { 100000 } } },
+	{ u8"scene/update_transforms", &bench_update_scene_transforms, { u8"depth", u8"fan_out", NULL }, 3, { { 1, 65536 }, { 4, 16 }, { 16, 2 } } },
+};
+
+const mgl_u64_t bench_scene_bench_count = sizeof(bench_scene_benches) / sizeof(bench_t);
@@ -0,0 +1,143 @@
+#include <mge/game.h>
+#include <mge/config.h>
+#include <mge/log.h>
+#include <mge/loop.h>
+#include <mge/time.h>
+
+#include <mge/job/system.h>
+#include <mge/memory/frame.h>
+#include <mge/memory/pool.h>
+
+#include <mgl/memory/allocator.h>
+#include <mgl/stream/stream.h>
+
+// Each thread keeps this many allocations live and replaces a random one on every step,
+// with sizes between 16 and MAX_ALLOCATION_SIZE, like small resource data or per-frame temporaries
+#define LIVE_ALLOCATION_COUNT 256
+#define STEP_COUNT 65536
+#define MAX_ALLOCATION_SIZE 256
+
+// The frame allocator churn is split across frames, since its memory is only released when frames end
+#define FRAME_COUNT 16
+#define FRAME_ALLOCATOR_SIZE (64 * 1024 * 1024)
+
+typedef struct
+{
+	void* allocator;
+	mgl_bool_t deallocate;
+	mgl_u64_t step_count;
+} churn_t;
+
+static mgl_u64_t standard_time = 0;
+static mgl_u64_t pool_time = 0;
+static mgl_u64_t frame_time = 0;
+
+static mgl_u32_t next_random(mgl_u32_t* state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return *state;
+}
+
+static void print_stat(const mgl_chr8_t* name, mgl_u64_t value, const mgl_chr8_t* unit)
+{
+	mgl_print(mgl_stdout_stream, name);
+	mgl_print_u64(mgl_stdout_stream, value, 10);
+	mgl_print(mgl_stdout_stream, unit);
+}
+
+static void churn(void* allocator, mgl_bool_t deallocate, mgl_u64_t step_count, mgl_u32_t seed)
+{
+	void* live[LIVE_ALLOCATION_COUNT];
+	mgl_u32_t random = seed;
+
+	for (mgl_u64_t i = 0; i < LIVE_ALLOCATION_COUNT; ++i)
+		if (mgl_allocate(allocator, 16 + next_random(&random) % (MAX_ALLOCATION_SIZE - 15), &live[i]) != MGL_ERROR_NONE)
+			mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to allocate");
+
+	for (mgl_u64_t i = 0; i < step_count; ++i)
+	{
+		mgl_u64_t slot = next_random(&random) % LIVE_ALLOCATION_COUNT;
+		if (deallocate && mgl_deallocate(allocator, live[slot]) != MGL_ERROR_NONE)
+			mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to deallocate");
+		if (mgl_allocate(allocator, 16 + next_random(&random) % (MAX_ALLOCATION_SIZE - 15), &live[slot]) != MGL_ERROR_NONE)
+			mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to allocate");
+		*(mgl_u8_t*)live[slot] = (mgl_u8_t)i;
+	}
+
+	if (deallocate)
+		for (mgl_u64_t i = 0; i < LIVE_ALLOCATION_COUNT; ++i)
+			if (mgl_deallocate(allocator, live[i]) != MGL_ERROR_NONE)
+				mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to deallocate");
+}
+
+static void churn_job(mge_job_t* job, void* data)
+{
+	const churn_t* c = *(const churn_t**)data;
+	churn(c->allocator, c->deallocate, c->step_count, (mgl_u32_t)(mgl_u64_t)job | 1);
+}
+
+// Returns the time taken with every worker churning at the same time
+static mgl_u64_t run_churn(mge_game_locator_t* locator, void* allocator, mgl_bool_t deallocate, mgl_u64_t step_count)
+{
+	churn_t c;
+	c.allocator = allocator;
+	c.deallocate = deallocate;
+	c.step_count = step_count;
+	const churn_t* ptr = &c;
+
+	mgl_u64_t worker_count = mge_get_job_worker_count(locator->job_system);
+	mgl_u64_t start = mge_get_time();
+	mge_job_t* root = mge_create_job(locator->job_system, NULL, &churn_job, &ptr, sizeof(ptr));
+	for (mgl_u64_t i = 1; i < worker_count; ++i)
+		mge_run_job(mge_create_job(locator->job_system, root, &churn_job, &ptr, sizeof(ptr)));
+	mge_run_job(root);
+	mge_wait_job(root);
+	return mge_get_time() - start;
+}
+
+void mge_game_get_config(mge_engine_config_t* config)
+{
+	config->debug_mode = MGL_TRUE;
+
+	// Big enough for every worker's churn on a single frame
+	config->frame_allocator_size = FRAME_ALLOCATOR_SIZE;
+
+	// Run frames back to back, sleeping between frames leaves the caches cold
+	config->target_frame_rate = 0;
+}
+
+void mge_game_load(mge_game_locator_t* locator)
+{
+	mge_pool_allocator_t* pool = mge_init_pool_allocator(locator->game_allocator, MAX_ALLOCATION_SIZE, 1024);
+	standard_time = run_churn(locator, mgl_standard_allocator, MGL_TRUE, STEP_COUNT);
+	pool_time = run_churn(locator, pool, MGL_TRUE, STEP_COUNT);
+	mge_terminate_pool_allocator(pool);
+}
+
+void mge_game_unload(mge_game_locator_t* locator)
+{
+	mgl_u64_t worker_count = mge_get_job_worker_count(locator->job_system);
+	mgl_u64_t step_count = STEP_COUNT * worker_count;
+	print_stat(u8"Worker threads: ", worker_count, u8"\n");
+	print_stat(u8"Steps per thread: ", STEP_COUNT, u8"\n");
+	print_stat(u8"Standard allocator time per step: ", standard_time / step_count, u8" ns\n");
+	print_stat(u8"Pool allocator time per step: ", pool_time / step_count, u8" ns\n");
+	print_stat(u8"Frame allocator time per step: ", frame_time / step_count, u8" ns\n");
+	print_stat(u8"Frame allocator peak size: ", mge_get_frame_allocator_peak_size(locator->frame_allocator), u8" bytes\n");
+}
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	// Nothing is deallocated on the frame allocator, the memory is released at the end of the next frame
+	frame_time += run_churn(locator, locator->frame_allocator, MGL_FALSE, STEP_COUNT / FRAME_COUNT);
+
+	if (mge_get_frame_info(locator->loop)->index + 1 >= FRAME_COUNT)
+		mge_stop_loop(locator->loop);
+}
@@ -0,0 +1,112 @@
+#include <mge/game.h>
+#include <mge/config.h>
+#include <mge/log.h>
+#include <mge/loop.h>
+#include <mge/time.h>
+
+#include <mge/job/system.h>
+
+#include <mgl/memory/allocator.h>
+#include <mgl/file/logger.h>
+#include <mgl/stream/stream.h>
+
+// Lines are logged in bursts which fit in a thread's log ring, with a pause for the log thread to catch up,
+// so that the times measured are the cost of logging on the calling thread and not the cost of writing the files
+#define BURST_LINE_COUNT 256
+#define BURST_COUNT 64
+#define BURST_PAUSE_TIME 5000000
+
+static void print_stat(const mgl_chr8_t* name, mgl_u64_t value, const mgl_chr8_t* unit)
+{
+	mgl_print(mgl_stdout_stream, name);
+	mgl_print_u64(mgl_stdout_stream, value, 10);
+	mgl_print(mgl_stdout_stream, unit);
+}
+
+static mgl_u64_t log_burst(void)
+{
+	// Each line is logged in three parts, as the engine does when logging names
+	mgl_u64_t start = mge_get_time();
+	for (mgl_u64_t i = 0; i < BURST_LINE_COUNT; ++i)
+	{
+		mge_log(MGE_LOG_GAME_CLIENT, u8"Loaded resource '");
+		mge_log(MGE_LOG_GAME_CLIENT, u8"example/async_log/resource");
+		mge_log(MGE_LOG_GAME_CLIENT, u8"'\n");
+	}
+	return mge_get_time() - start;
+}
+
+static void log_burst_job(mge_job_t* job, void* data)
+{
+	log_burst();
+}
+
+void mge_game_get_config(mge_engine_config_t* config)
+{
+	config->debug_mode = MGL_TRUE;
+}
+
+void mge_game_load(mge_game_locator_t* locator)
+{
+	// Log directly to a logger, which is what mge_log does without a log thread
+	mgl_logger_t* logger = mgl_logger_open(mgl_standard_allocator, u8"async_log_example");
+	mgl_u64_t direct_time = 0;
+	for (mgl_u64_t b = 0; b < BURST_COUNT; ++b)
+	{
+		mgl_u64_t start = mge_get_time();
+		for (mgl_u64_t i = 0; i < BURST_LINE_COUNT; ++i)
+		{
+			mgl_logger_add(logger, u8"Loaded resource '");
+			mgl_logger_add(logger, u8"example/async_log/resource");
+			mgl_logger_add(logger, u8"'\n");
+		}
+		direct_time += mge_get_time() - start;
+	}
+	mgl_logger_close(logger);
+
+	// Log from the main thread
+	mgl_u64_t main_time = 0;
+	for (mgl_u64_t b = 0; b < BURST_COUNT; ++b)
+	{
+		main_time += log_burst();
+		mge_sleep(BURST_PAUSE_TIME);
+	}
+
+	// Log from every worker at the same time
+	mgl_u64_t worker_count = mge_get_job_worker_count(locator->job_system);
+	mgl_u64_t parallel_time = 0;
+	for (mgl_u64_t b = 0; b < BURST_COUNT; ++b)
+	{
+		mgl_u64_t start = mge_get_time();
+		mge_job_t* root = mge_create_job(locator->job_system, NULL, &log_burst_job, NULL, 0);
+		for (mgl_u64_t i = 1; i < worker_count; ++i)
+			mge_run_job(mge_create_job(locator->job_system, root, &log_burst_job, NULL, 0));
+		mge_run_job(root);
+		mge_wait_job(root);
+		parallel_time += mge_get_time() - start;
+		mge_sleep(BURST_PAUSE_TIME);
+	}
+
+	mgl_u64_t line_count = BURST_COUNT * BURST_LINE_COUNT;
+	print_stat(u8"Lines per thread: ", line_count, u8"\n");
+	print_stat(u8"Worker threads: ", worker_count, u8"\n");
+	print_stat(u8"Direct logger time per line: ", direct_time / line_count, u8" ns\n");
+	print_stat(u8"mge_log time per line: ", main_time / line_count, u8" ns\n");
+	print_stat(u8"mge_log time per line (all workers): ", parallel_time / (line_count * worker_count), u8" ns\n");
+}
+
+void mge_game_unload(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	// This example only runs on load, stop after the first frame
+	mge_stop_loop(locator->loop);
+}
@@ -0,0 +1,161 @@
+#include <mge/game.h>
+#include <mge/config.h>
+#include <mge/log.h>
+#include <mge/loop.h>
+#include <mge/time.h>
+
+#include <mge/scene/manager.h>
+#include <mge/scene/node.h>
+#include <mge/scene/component.h>
+#include <mge/scene/bvh.h>
+
+#include <mgl/stream/stream.h>
+
+#define NODE_COUNT 100000
+#define MOVED_NODE_COUNT (NODE_COUNT / 10)
+#define FRAME_COUNT 100
+#define QUERY_COUNT 100
+#define WORLD_SIZE 1000.0f
+#define QUERY_SIZE 50.0f
+
+static mge_scene_bvh_t* bvh;
+static mge_scene_node_t* nodes[NODE_COUNT];
+static mgl_u32_t results[NODE_COUNT];
+static mgl_u32_t random_state = 12345;
+
+static mgl_u64_t update_time;
+static mgl_u64_t aabb_query_time;
+static mgl_u64_t ray_query_time;
+static mgl_u64_t scan_query_time;
+static mgl_u64_t query_result_count;
+static mgl_u64_t first_query_result_count;
+static mgl_u64_t scan_result_count;
+
+static mgl_f32_t random_f32(mgl_f32_t max)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return (mgl_f32_t)(random_state % 1000000) / 1000000.0f * max;
+}
+
+static void print_stat(const mgl_chr8_t* name, mgl_u64_t value, const mgl_chr8_t* unit)
+{
+	mgl_print(mgl_stdout_stream, name);
+	mgl_print_u64(mgl_stdout_stream, value, 10);
+	mgl_print(mgl_stdout_stream, unit);
+}
+
+void mge_game_get_config(mge_engine_config_t* config)
+{
+	config->debug_mode = MGL_TRUE;
+	config->max_scene_node_count = NODE_COUNT + 1;
+	config->target_frame_rate = 0;
+	config->headless = MGL_TRUE;
+	config->frame_cap = FRAME_COUNT;
+}
+
+void mge_game_load(mge_game_locator_t* locator)
+{
+	mge_scene_manager_t* manager = locator->scene_manager;
+	mge_register_scene_component_type(manager, MGE_FIRST_GAME_SCENE_COMPONENT_TYPE, sizeof(mge_scene_component_t), NODE_COUNT, NULL);
+
+	// Create nodes scattered around the world, each one with a unit box
+	mge_aabb_t box = { { -0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, 0.5f } };
+	for (mgl_u32_t i = 0; i < NODE_COUNT; ++i)
+	{
+		nodes[i] = mge_create_scene_node(manager->root, NULL);
+		mgl_f32m4x4_t* local = mge_scene_node_get_local_transform(nodes[i]);
+		MGE_F32M4X4_AT(local, 0, 3) = random_f32(WORLD_SIZE);
+		MGE_F32M4X4_AT(local, 1, 3) = random_f32(WORLD_SIZE);
+		MGE_F32M4X4_AT(local, 2, 3) = random_f32(WORLD_SIZE);
+		mge_scene_node_set_dirty(nodes[i]);
+		mge_scene_component_set_bounds(mge_create_scene_component(nodes[i], MGE_FIRST_GAME_SCENE_COMPONENT_TYPE), &box);
+	}
+	mge_update_scene_transforms(manager);
+
+	mgl_u64_t start = mge_get_time();
+	bvh = mge_init_scene_bvh(manager->allocator, manager, 0);
+	print_stat(u8"Build time: ", (mge_get_time() - start) / 1000, u8" us\n");
+}
+
+void mge_game_unload(mge_game_locator_t* locator)
+{
+	mge_scene_bvh_stats_t stats;
+	mge_get_scene_bvh_stats(bvh, &stats);
+
+	print_stat(u8"Nodes: ", NODE_COUNT, u8"\n");
+	print_stat(u8"Moved nodes per frame: ", MOVED_NODE_COUNT, u8"\n");
+	print_stat(u8"Frames: ", FRAME_COUNT, u8"\n");
+	print_stat(u8"Tree nodes: ", stats.tree_node_count, u8"\n");
+	print_stat(u8"Rebuilds: ", stats.rebuild_count, u8"\n");
+	print_stat(u8"SAH cost (x100): ", (mgl_u64_t)(stats.cost * 100.0f), u8"\n");
+	print_stat(u8"Build SAH cost (x100): ", (mgl_u64_t)(stats.build_cost * 100.0f), u8"\n");
+	print_stat(u8"Update time per frame: ", update_time / FRAME_COUNT / 1000, u8" us\n");
+	print_stat(u8"AABB queries/sec: ", (mgl_u64_t)FRAME_COUNT * QUERY_COUNT * MGE_NANOSECONDS_PER_SECOND / (aabb_query_time > 0 ? aabb_query_time : 1), u8"\n");
+	print_stat(u8"Raycasts/sec: ", (mgl_u64_t)FRAME_COUNT * QUERY_COUNT * MGE_NANOSECONDS_PER_SECOND / (ray_query_time > 0 ? ray_query_time : 1), u8"\n");
+	print_stat(u8"Linear scan queries/sec: ", (mgl_u64_t)FRAME_COUNT * MGE_NANOSECONDS_PER_SECOND / (scan_query_time > 0 ? scan_query_time : 1), u8"\n");
+	print_stat(u8"AABB query results: ", query_result_count, u8"\n");
+	print_stat(u8"First query results (BVH): ", first_query_result_count, u8"\n");
+	print_stat(u8"First query results (linear scan): ", scan_result_count, u8"\n");
+
+	mge_terminate_scene_bvh(bvh);
+}
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	mge_scene_manager_t* manager = locator->scene_manager;
+
+	// Pick up the nodes moved on the last frame
+	mgl_u64_t start = mge_get_time();
+	mge_update_scene_bvh(bvh);
+	update_time += mge_get_time() - start;
+
+	// AABB queries
+	mge_aabb_t query[QUERY_COUNT];
+	for (mgl_u32_t i = 0; i < QUERY_COUNT; ++i)
+		for (int j = 0; j < 3; ++j)
+		{
+			query[i].min[j] = random_f32(WORLD_SIZE - QUERY_SIZE);
+			query[i].max[j] = query[i].min[j] + QUERY_SIZE;
+		}
+
+	start = mge_get_time();
+	for (mgl_u32_t i = 0; i < QUERY_COUNT; ++i)
+		query_result_count += mge_query_scene_bvh_aabb(bvh, &query[i], results, NODE_COUNT);
+	aabb_query_time += mge_get_time() - start;
+
+	// Linear scan over every node, for comparison (only the first query)
+	start = mge_get_time();
+	for (mgl_u64_t i = 0; i < manager->max_node_count; ++i)
+		if (!manager->nodes[i].trash && mge_aabb_intersects_aabb(&manager->nodes[i].bounds.global, &query[0]))
+			scan_result_count += 1;
+	scan_query_time += mge_get_time() - start;
+	first_query_result_count += mge_query_scene_bvh_aabb(bvh, &query[0], NULL, 0);
+
+	// Raycasts
+	start = mge_get_time();
+	for (mgl_u32_t i = 0; i < QUERY_COUNT; ++i)
+	{
+		mge_ray_t ray = { { random_f32(WORLD_SIZE), random_f32(WORLD_SIZE), 0.0f }, { 0.01f, 0.01f, 1.0f }, 2.0f * WORLD_SIZE };
+		mgl_u32_t node;
+		mge_raycast_scene_bvh(bvh, &ray, &node, NULL);
+	}
+	ray_query_time += mge_get_time() - start;
+
+	// Move some nodes
+	for (mgl_u32_t i = 0; i < MOVED_NODE_COUNT; ++i)
+	{
+		mge_scene_node_t* node = nodes[random_state % NODE_COUNT];
+		mgl_f32m4x4_t* local = mge_scene_node_get_local_transform(node);
+		MGE_F32M4X4_AT(local, 0, 3) += random_f32(2.0f) - 1.0f;
+		MGE_F32M4X4_AT(local, 1, 3) += random_f32(2.0f) - 1.0f;
+		MGE_F32M4X4_AT(local, 2, 3) += random_f32(2.0f) - 1.0f;
+		mge_scene_node_set_dirty(node);
+	}
+}
@@ -0,0 +1,123 @@
+#include <mge/game.h>
+#include <mge/config.h>
+#include <mge/log.h>
+#include <mge/loop.h>
+#include <mge/time.h>
+
+#include <mge/job/system.h>
+#include <mge/scene/manager.h>
+#include <mge/scene/node.h>
+#include <mge/scene/camera.h>
+#include <mge/scene/culling.h>
+
+#include <mgl/stream/stream.h>
+
+#define BOUNDS_COUNT 1000000
+#define ROUND_COUNT 16
+#define WORLD_SIZE 2000.0f
+#define EYE_DISTANCE 0.064f
+
+static mgl_u32_t random_state = 12345;
+
+static mgl_f32_t random_f32(mgl_f32_t max)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return (mgl_f32_t)(random_state % 1000000) / 1000000.0f * max;
+}
+
+static void print_stat(const mgl_chr8_t* name, mgl_u64_t value, const mgl_chr8_t* unit)
+{
+	mgl_print(mgl_stdout_stream, name);
+	mgl_print_u64(mgl_stdout_stream, value, 10);
+	mgl_print(mgl_stdout_stream, unit);
+}
+
+static mgl_u64_t benchmark(mge_culling_t* culling, mge_job_system_t* system)
+{
+	mgl_u64_t start = mge_get_time();
+	for (mgl_u32_t i = 0; i < ROUND_COUNT; ++i)
+		mge_run_culling(culling, system);
+	mgl_u64_t elapsed = mge_get_time() - start;
+	return (mgl_u64_t)BOUNDS_COUNT * ROUND_COUNT * MGE_NANOSECONDS_PER_SECOND / (elapsed > 0 ? elapsed : 1);
+}
+
+void mge_game_get_config(mge_engine_config_t* config)
+{
+	config->debug_mode = MGL_TRUE;
+}
+
+void mge_game_load(mge_game_locator_t* locator)
+{
+	mge_scene_manager_t* manager = locator->scene_manager;
+
+	// Create a VR camera at the center of the world
+	mge_register_camera_component_type(manager, 1);
+	mge_scene_node_t* node = mge_create_scene_node(manager->root, u8"camera");
+	mge_camera_component_t* camera = mge_create_camera_component(node);
+	camera->view_count = 2;
+	for (mgl_u32_t v = 0; v < 2; ++v)
+	{
+		mge_set_camera_perspective(camera, v, 1.6f, 1.0f, 0.1f, 0.5f * WORLD_SIZE);
+		MGE_F32M4X4_AT(&camera->eye[v], 0, 3) = v == 0 ? -0.5f * EYE_DISTANCE : 0.5f * EYE_DISTANCE;
+	}
+
+	// Fill the culling stage with random boxes around the camera
+	mge_culling_t* culling = mge_init_culling(manager->allocator, BOUNDS_COUNT, 2);
+	mge_frustum_t frusta[2];
+	for (mgl_u32_t v = 0; v < 2; ++v)
+	{
+		mgl_f32m4x4_t view_projection;
+		mge_get_camera_view_projection(camera, v, &view_projection);
+		mge_frustum_from_matrix(&view_projection, &frusta[v]);
+		mge_add_culling_view(culling, &frusta[v]);
+	}
+
+	mgl_u64_t reference_count = 0;
+	for (mgl_u32_t i = 0; i < BOUNDS_COUNT; ++i)
+	{
+		mge_aabb_t aabb;
+		for (int j = 0; j < 3; ++j)
+		{
+			aabb.min[j] = random_f32(WORLD_SIZE) - 0.5f * WORLD_SIZE;
+			aabb.max[j] = aabb.min[j] + 0.5f + random_f32(4.0f);
+		}
+		mge_add_culling_bounds(culling, i, &aabb);
+		reference_count += mge_aabb_intersects_frustum(&aabb, &frusta[0]) + mge_aabb_intersects_frustum(&aabb, &frusta[1]);
+	}
+
+	// Warm up
+	mge_run_culling(culling, NULL);
+
+	print_stat(u8"Bounds: ", BOUNDS_COUNT, u8"\n");
+	print_stat(u8"Views: ", 2, u8"\n");
+	print_stat(u8"Workers: ", mge_get_job_worker_count(locator->job_system), u8"\n");
+	print_stat(u8"Bounds/sec (single thread): ", benchmark(culling, NULL), u8"\n");
+	print_stat(u8"Bounds/sec (job system): ", benchmark(culling, locator->job_system), u8"\n");
+
+	mgl_u64_t left_count, right_count;
+	mge_get_culling_visible_list(culling, 0, &left_count);
+	mge_get_culling_visible_list(culling, 1, &right_count);
+	print_stat(u8"Visible (left eye): ", left_count, u8"\n");
+	print_stat(u8"Visible (right eye): ", right_count, u8"\n");
+	print_stat(u8"Visible (scalar reference, both eyes): ", reference_count, u8"\n");
+
+	mge_terminate_culling(culling);
+}
+
+void mge_game_unload(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	// This example only runs on load, stop after the first frame
+	mge_stop_loop(locator->loop);
+}
@@ -0,0 +1,155 @@
+#include <mge/game.h>
+#include <mge/config.h>
+#include <mge/log.h>
+#include <mge/loop.h>
+#include <mge/time.h>
+
+#include <mge/scene/manager.h>
+#include <mge/scene/node.h>
+
+#include <mgl/stream/stream.h>
+
+#define NODE_COUNT 100000
+#define CHURN_COUNT (NODE_COUNT / 5)
+#define RUN_COUNT 5
+#define MOVES_PER_STEP 4096
+
+static mge_scene_node_handle_t handles[NODE_COUNT];
+static mgl_u32_t random_state = 12345;
+
+static mgl_u32_t random_u32(void)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return random_state;
+}
+
+static void print_stat(const mgl_chr8_t* name, mgl_u64_t value, const mgl_chr8_t* unit)
+{
+	mgl_print(mgl_stdout_stream, name);
+	mgl_print_u64(mgl_stdout_stream, value, 10);
+	mgl_print(mgl_stdout_stream, unit);
+}
+
+static mgl_f32_t walk(mge_scene_node_t* node)
+{
+	mgl_f32_t sum = MGE_F32M4X4_AT(&node->transform.global, 0, 3);
+	for (mge_scene_node_t* c = node->first_child; c != NULL; c = c->next)
+		sum += walk(c);
+	return sum;
+}
+
+static void benchmark(mge_scene_manager_t* manager, mgl_u64_t* walk_time, mgl_u64_t* update_time)
+{
+	// Keep the best of a few runs
+	*walk_time = ~0ull;
+	*update_time = ~0ull;
+	for (mgl_u64_t i = 0; i < RUN_COUNT; ++i)
+	{
+		mgl_u64_t start = mge_get_time();
+		if (walk(manager->root) < 0.0f)
+			mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Unexpected walk result");
+		mgl_u64_t time = mge_get_time() - start;
+		*walk_time = time < *walk_time ? time : *walk_time;
+
+		start = mge_get_time();
+		for (mge_scene_node_t* c = manager->root->first_child; c != NULL; c = c->next)
+			mge_scene_node_set_dirty(c);
+		mge_update_scene_transforms(manager);
+		time = mge_get_time() - start;
+		*update_time = time < *update_time ? time : *update_time;
+	}
+}
+
+void mge_game_get_config(mge_engine_config_t* config)
+{
+	config->debug_mode = MGL_TRUE;
+	config->max_scene_node_count = NODE_COUNT + 1;
+}
+
+void mge_game_load(mge_game_locator_t* locator)
+{
+	mge_scene_manager_t* manager = locator->scene_manager;
+
+	// Each node is the child of a random previous node, so depth-first order has nothing to do with creation order
+	for (mgl_u64_t i = 0; i < NODE_COUNT; ++i)
+	{
+		mge_scene_node_t* parent = i == 0 ? manager->root : mge_resolve_scene_node_handle(manager, handles[random_u32() % i]);
+		mge_scene_node_t* node = mge_create_scene_node(parent, NULL);
+		MGE_F32M4X4_AT(mge_scene_node_get_local_transform(node), 0, 3) = 1.0f;
+		handles[i] = mge_scene_node_get_handle(node);
+	}
+
+	// Destroy random subtrees and fill the holes with new nodes under random parents
+	mgl_u64_t count = NODE_COUNT;
+	for (mgl_u64_t i = 0; i < CHURN_COUNT; ++i)
+	{
+		mge_scene_node_t* node = mge_resolve_scene_node_handle(manager, handles[1 + random_u32() % (count - 1)]);
+		if (node != NULL && node->first_child == NULL)
+			mge_destroy_scene_node(node);
+	}
+	mgl_u64_t alive_count = 0;
+	for (mgl_u64_t i = 0; i < count; ++i)
+		if (mge_resolve_scene_node_handle(manager, handles[i]) != NULL)
+			handles[alive_count++] = handles[i];
+	for (count = alive_count; count < NODE_COUNT; ++count)
+	{
+		mge_scene_node_t* node = mge_create_scene_node(mge_resolve_scene_node_handle(manager, handles[random_u32() % count]), NULL);
+		handles[count] = mge_scene_node_get_handle(node);
+	}
+	mge_update_scene_transforms(manager);
+
+	mgl_u64_t walk_before, update_before;
+	benchmark(manager, &walk_before, &update_before);
+
+	// Defragment incrementally, as a game would do a bit on each frame
+	mge_scene_node_handle_t handle = handles[NODE_COUNT / 2];
+	mge_scene_node_t* node = mge_resolve_scene_node_handle(manager, handle);
+	mgl_u64_t index = (mgl_u64_t)(node - manager->nodes);
+	mgl_u64_t step_count = 0;
+	mgl_u64_t move_count = 0;
+	mgl_u64_t start = mge_get_time();
+	for (mgl_u64_t moved = 1; moved > 0; ++step_count)
+	{
+		moved = mge_defragment_scene(manager, MOVES_PER_STEP);
+		move_count += moved;
+	}
+	mgl_u64_t defragment_time = mge_get_time() - start;
+	mge_clear_moved_scene_nodes(manager);
+
+	// Node pointers are invalidated, but handles still resolve to the same nodes
+	node = mge_resolve_scene_node_handle(manager, handle);
+	if (node == NULL || node->manager != manager || mge_scene_node_get_handle(node).index != handle.index)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Scene node handle didn't survive defragmentation");
+
+	mgl_u64_t walk_after, update_after;
+	benchmark(manager, &walk_after, &update_after);
+
+	print_stat(u8"Scene nodes: ", NODE_COUNT, u8"\n");
+	print_stat(u8"Sample node index: ", index, u8" -> ");
+	print_stat(u8"", (mgl_u64_t)(node - manager->nodes), u8"\n");
+	print_stat(u8"Defragmentation: ", move_count, u8" nodes moved in ");
+	print_stat(u8"", step_count, u8" steps, ");
+	print_stat(u8"", defragment_time / 1000, u8" us\n");
+	print_stat(u8"Hierarchy walk before: ", walk_before / 1000, u8" us\n");
+	print_stat(u8"Hierarchy walk after: ", walk_after / 1000, u8" us\n");
+	print_stat(u8"Transform update before: ", update_before / 1000, u8" us\n");
+	print_stat(u8"Transform update after: ", update_after / 1000, u8" us\n");
+}
+
+void mge_game_unload(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	// This example only runs on load, stop after the first frame
+	mge_stop_loop(locator->loop);
+}
@@ -0,0 +1,108 @@
+#include <mge/game.h>
+#include <mge/config.h>
+#include <mge/log.h>
+#include <mge/loop.h>
+#include <mge/time.h>
+
+#include <mge/job/system.h>
+
+#include <mgl/stream/stream.h>
+
+#define ITEM_COUNT (1 << 20)
+#define GRAIN_SIZE 64
+#define ROUND_COUNT 16
+
+typedef struct
+{
+	mge_job_system_t* system;
+	mgl_u32_t* items;
+	mgl_u32_t begin;
+	mgl_u32_t end;
+} range_t;
+
+static mgl_u32_t items[ITEM_COUNT];
+
+static void hash_range_job(mge_job_t* job, void* data)
+{
+	range_t* range = (range_t*)data;
+
+	// Split the range until it is fine-grained enough
+	while (range->end - range->begin > GRAIN_SIZE)
+	{
+		range_t half = *range;
+		half.begin = range->begin + (range->end - range->begin) / 2;
+		range->end = half.begin;
+		mge_run_job(mge_create_job(range->system, job, &hash_range_job, &half, sizeof(half)));
+	}
+
+	for (mgl_u32_t i = range->begin; i < range->end; ++i)
+	{
+		mgl_u32_t x = range->items[i] + i;
+		x ^= x >> 16;
+		x *= 0x45d9f3b;
+		x ^= x >> 16;
+		range->items[i] = x;
+	}
+}
+
+static void print_stat(const mgl_chr8_t* name, mgl_u64_t value, const mgl_chr8_t* unit)
+{
+	mgl_print(mgl_stdout_stream, name);
+	mgl_print_u64(mgl_stdout_stream, value, 10);
+	mgl_print(mgl_stdout_stream, unit);
+}
+
+void mge_game_get_config(mge_engine_config_t* config)
+{
+	config->debug_mode = MGL_TRUE;
+}
+
+void mge_game_load(mge_game_locator_t* locator)
+{
+	mge_job_system_t* system = locator->job_system;
+
+	// Warm up
+	range_t range = { system, items, 0, ITEM_COUNT };
+	mge_job_t* root = mge_create_job(system, NULL, &hash_range_job, &range, sizeof(range));
+	mge_run_job(root);
+	mge_wait_job(root);
+	mge_reset_job_system_stats(system);
+
+	// Run benchmark
+	mgl_u64_t start = mge_get_time();
+	for (mgl_u32_t i = 0; i < ROUND_COUNT; ++i)
+	{
+		root = mge_create_job(system, NULL, &hash_range_job, &range, sizeof(range));
+		mge_run_job(root);
+		mge_wait_job(root);
+	}
+	mgl_u64_t elapsed = mge_get_time() - start;
+
+	mge_job_system_stats_t stats;
+	mge_get_job_system_stats(system, &stats);
+
+	print_stat(u8"Workers: ", stats.worker_count, u8"\n");
+	print_stat(u8"Jobs executed: ", stats.executed_job_count, u8"\n");
+	print_stat(u8"Time: ", elapsed / 1000, u8" us\n");
+	print_stat(u8"Jobs/sec: ", stats.executed_job_count * MGE_NANOSECONDS_PER_SECOND / (elapsed > 0 ? elapsed : 1), u8"\n");
+	print_stat(u8"Steal attempts: ", stats.steal_attempt_count, u8"\n");
+	print_stat(u8"Steals: ", stats.steal_count, u8"\n");
+	print_stat(u8"Steal rate: ", stats.steal_count * 10000 / (stats.executed_job_count > 0 ? stats.executed_job_count : 1), u8" (1/10000 of executed jobs)\n");
+	print_stat(u8"Steal success: ", stats.steal_count * 10000 / (stats.steal_attempt_count > 0 ? stats.steal_attempt_count : 1), u8" (1/10000 of attempts)\n");
+}
+
+void mge_game_unload(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	// This example only runs on load, stop after the first frame
+	mge_stop_loop(locator->loop);
+}
@@ -0,0 +1,167 @@
+#include <mge/game.h>
+#include <mge/config.h>
+#include <mge/log.h>
+#include <mge/loop.h>
+#include <mge/time.h>
+
+#include <mge/scene/manager.h>
+#include <mge/scene/node.h>
+#include <mge/scene/component.h>
+#include <mge/scene/journal.h>
+
+#include <mgl/stream/stream.h>
+
+#define NODE_COUNT 50000
+#define CHANGES_PER_FRAME 100
+#define FRAME_COUNT 100
+
+typedef struct
+{
+	mgl_bool_t alive;
+	mgl_f32_t position[3];
+	mgl_u32_t component_count;
+} mirror_node_t;
+
+// Copy of the scene kept up to date only from the journal, as a renderer or a replication system would do
+static mirror_node_t mirror[NODE_COUNT + 1];
+static mge_scene_node_handle_t handles[NODE_COUNT];
+static mgl_u32_t random_state = 12345;
+
+static mgl_u64_t journal_node_count;
+static mgl_u64_t journal_time;
+static mgl_u64_t scan_time;
+
+static mgl_u32_t random_u32(void)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return random_state;
+}
+
+static void print_stat(const mgl_chr8_t* name, mgl_u64_t value, const mgl_chr8_t* unit)
+{
+	mgl_print(mgl_stdout_stream, name);
+	mgl_print_u64(mgl_stdout_stream, value, 10);
+	mgl_print(mgl_stdout_stream, unit);
+}
+
+static void mirror_node(mge_scene_manager_t* manager, mgl_u64_t index)
+{
+	mge_scene_node_t* node = &manager->nodes[index];
+	mirror[index].alive = !node->trash;
+	if (node->trash)
+		return;
+
+	for (mgl_u64_t i = 0; i < 3; ++i)
+		mirror[index].position[i] = MGE_F32M4X4_AT(&node->transform.global, i, 3);
+	mirror[index].component_count = 0;
+	for (mge_scene_component_t* c = node->first_component; c != NULL; c = c->next)
+		mirror[index].component_count += 1;
+}
+
+static mge_scene_node_t* random_node(mge_scene_manager_t* manager)
+{
+	mge_scene_node_t* node = mge_resolve_scene_node_handle(manager, handles[random_u32() % NODE_COUNT]);
+	return node != NULL ? node : manager->root;
+}
+
+void mge_game_get_config(mge_engine_config_t* config)
+{
+	config->debug_mode = MGL_TRUE;
+	config->max_scene_node_count = NODE_COUNT + 1;
+	config->target_frame_rate = 0;
+	config->headless = MGL_TRUE;
+	config->frame_cap = FRAME_COUNT;
+}
+
+void mge_game_load(mge_game_locator_t* locator)
+{
+	mge_scene_manager_t* manager = locator->scene_manager;
+	mge_register_scene_component_type(manager, MGE_FIRST_GAME_SCENE_COMPONENT_TYPE, sizeof(mge_scene_component_t), NODE_COUNT, NULL);
+
+	for (mgl_u64_t i = 0; i < NODE_COUNT / 2; ++i)
+		handles[i] = mge_scene_node_get_handle(mge_create_scene_node(i == 0 ? manager->root : random_node(manager), NULL));
+
+	// Start from a full copy, the journal only has the changes made after it
+	for (mgl_u64_t i = 0; i < manager->max_node_count; ++i)
+		mirror_node(manager, i);
+}
+
+void mge_game_unload(mge_game_locator_t* locator)
+{
+	print_stat(u8"Scene nodes: ", NODE_COUNT, u8"\n");
+	print_stat(u8"Frames: ", FRAME_COUNT, u8"\n");
+	print_stat(u8"Journal nodes per frame: ", journal_node_count / (FRAME_COUNT - 1), u8"\n");
+	print_stat(u8"Journal read time per frame: ", journal_time / (FRAME_COUNT - 1), u8" ns\n");
+	print_stat(u8"Full scan time per frame: ", scan_time / (FRAME_COUNT - 1), u8" ns\n");
+}
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	mge_scene_manager_t* manager = locator->scene_manager;
+
+	// Apply the changes of the last frame
+	const mge_scene_journal_t* journal = mge_get_scene_journal(manager);
+	mgl_u64_t start = mge_get_time();
+	for (mgl_u64_t i = 0; i < journal->node_count; ++i)
+		mirror_node(manager, journal->nodes[i]);
+	if (mge_get_frame_info(locator->loop)->index > 0)
+	{
+		journal_time += mge_get_time() - start;
+		journal_node_count += journal->node_count;
+	}
+
+	// The mirror must match the scene, which is what a consumer without a journal would have to scan every frame
+	start = mge_get_time();
+	for (mgl_u64_t i = 0; i < manager->max_node_count; ++i)
+	{
+		mge_scene_node_t* node = &manager->nodes[i];
+		mgl_u32_t component_count = 0;
+		for (mge_scene_component_t* c = node->trash ? NULL : node->first_component; c != NULL; c = c->next)
+			component_count += 1;
+		if (mirror[i].alive != !node->trash || (!node->trash &&
+			(mirror[i].position[0] != MGE_F32M4X4_AT(&node->transform.global, 0, 3) ||
+			mirror[i].position[1] != MGE_F32M4X4_AT(&node->transform.global, 1, 3) ||
+			mirror[i].position[2] != MGE_F32M4X4_AT(&node->transform.global, 2, 3) ||
+			mirror[i].component_count != component_count)))
+			mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Scene mirror doesn't match the scene");
+	}
+	if (mge_get_frame_info(locator->loop)->index > 0)
+		scan_time += mge_get_time() - start;
+
+	// Move, create, destroy and add components to a few nodes
+	for (mgl_u64_t i = 0; i < CHANGES_PER_FRAME; ++i)
+	{
+		mge_scene_node_t* node = random_node(manager);
+		switch (random_u32() % 4)
+		{
+		case 0:
+			if (node != manager->root)
+			{
+				MGE_F32M4X4_AT(mge_scene_node_get_local_transform(node), random_u32() % 3, 3) += 1.0f;
+				mge_scene_node_set_dirty(node);
+			}
+			break;
+		case 1:
+		{
+			mgl_u64_t slot = random_u32() % NODE_COUNT;
+			if (mge_resolve_scene_node_handle(manager, handles[slot]) == NULL)
+				handles[slot] = mge_scene_node_get_handle(mge_create_scene_node(node, NULL));
+			break;
+		}
+		case 2:
+			if (node != manager->root)
+				mge_queue_scene_node_destroy(node);
+			break;
+		default:
+			mge_create_scene_component(node, MGE_FIRST_GAME_SCENE_COMPONENT_TYPE);
+			break;
+		}
+	}
+}
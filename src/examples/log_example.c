@@ -1,6 +1,7 @@
 #include <mge/game.h>
 #include <mge/config.h>
 #include <mge/log.h>
+#include <mge/loop.h>
 
 void mge_game_get_config(mge_engine_config_t* config)
 {
@@ -19,3 +20,14 @@ void mge_game_unload(mge_game_locator_t* locator)
 	MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, u8"Game unloaded (LOG TEST)\n");
 
 }
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	// This example only runs on load, stop after the first frame
+	mge_stop_loop(locator->loop);
+}
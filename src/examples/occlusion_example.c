@@ -0,0 +1,154 @@
+#include <mge/game.h>
+#include <mge/config.h>
+#include <mge/log.h>
+#include <mge/loop.h>
+#include <mge/time.h>
+
+#include <mge/scene/manager.h>
+#include <mge/scene/node.h>
+#include <mge/scene/camera.h>
+#include <mge/scene/culling.h>
+#include <mge/scene/occlusion.h>
+
+#include <mgl/stream/stream.h>
+
+#define BOX_COUNT 20000
+#define WALL_COUNT 6
+#define ROUND_COUNT 64
+#define DEPTH_WIDTH 256
+#define DEPTH_HEIGHT 128
+
+// Unit quad on the XY plane, scaled by each wall's transform
+static const mgl_f32_t wall_vertices[] = { -1.0f, -1.0f, 0.0f, 1.0f, -1.0f, 0.0f, 1.0f, 1.0f, 0.0f, -1.0f, 1.0f, 0.0f };
+static const mgl_u32_t wall_indices[] = { 0, 1, 2, 0, 2, 3 };
+
+static mgl_u32_t visible[BOX_COUNT];
+static mgl_u32_t random_state = 12345;
+
+static mgl_f32_t random_f32(mgl_f32_t max)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return (mgl_f32_t)(random_state % 1000000) / 1000000.0f * max;
+}
+
+static void print_stat(const mgl_chr8_t* name, mgl_u64_t value, const mgl_chr8_t* unit)
+{
+	mgl_print(mgl_stdout_stream, name);
+	mgl_print_u64(mgl_stdout_stream, value, 10);
+	mgl_print(mgl_stdout_stream, unit);
+}
+
+static mge_scene_node_t* create_node(mge_scene_node_t* parent, mgl_f32_t x, mgl_f32_t y, mgl_f32_t z, mgl_f32_t scale_x, mgl_f32_t scale_y)
+{
+	mge_scene_node_t* node = mge_create_scene_node(parent, NULL);
+	mgl_f32m4x4_t* local = mge_scene_node_get_local_transform(node);
+	MGE_F32M4X4_AT(local, 0, 0) = scale_x;
+	MGE_F32M4X4_AT(local, 1, 1) = scale_y;
+	MGE_F32M4X4_AT(local, 0, 3) = x;
+	MGE_F32M4X4_AT(local, 1, 3) = y;
+	MGE_F32M4X4_AT(local, 2, 3) = z;
+	mge_scene_node_set_dirty(node);
+	return node;
+}
+
+void mge_game_get_config(mge_engine_config_t* config)
+{
+	config->debug_mode = MGL_TRUE;
+	config->max_scene_node_count = BOX_COUNT + WALL_COUNT + 2;
+}
+
+void mge_game_load(mge_game_locator_t* locator)
+{
+	mge_scene_manager_t* manager = locator->scene_manager;
+	mge_register_camera_component_type(manager, 1);
+	mge_register_occluder_component_type(manager, WALL_COUNT);
+	mge_register_scene_component_type(manager, MGE_FIRST_GAME_SCENE_COMPONENT_TYPE, sizeof(mge_scene_component_t), BOX_COUNT, NULL);
+
+	// Camera at the origin, looking down the negative Z axis
+	mge_camera_component_t* camera = mge_create_camera_component(create_node(manager->root, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f));
+	mge_set_camera_perspective(camera, 0, 1.2f, 2.0f, 0.1f, 200.0f);
+
+	// Walls with gaps between them, like the rooms of an interior
+	for (mgl_u32_t i = 0; i < WALL_COUNT; ++i)
+	{
+		mgl_f32_t x = ((mgl_f32_t)(i % 3) - 1.0f) * 24.0f;
+		mgl_f32_t z = i < 3 ? -15.0f : -40.0f;
+		mge_create_occluder_component(create_node(manager->root, x, 0.0f, z, 10.0f, 10.0f), wall_vertices, wall_indices, 2);
+	}
+
+	// Objects scattered around the interior
+	mge_aabb_t box = { { -0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, 0.5f } };
+	for (mgl_u32_t i = 0; i < BOX_COUNT; ++i)
+	{
+		mge_scene_node_t* node = create_node(manager->root, random_f32(160.0f) - 80.0f, random_f32(16.0f) - 8.0f, -random_f32(120.0f) - 1.0f, 1.0f, 1.0f);
+		mge_scene_component_set_bounds(mge_create_scene_component(node, MGE_FIRST_GAME_SCENE_COMPONENT_TYPE), &box);
+	}
+	mge_update_scene_transforms(manager);
+
+	mge_culling_t* culling = mge_init_culling(manager->allocator, manager->max_node_count, 1);
+	mge_occlusion_t* occlusion = mge_init_occlusion(manager->allocator, DEPTH_WIDTH, DEPTH_HEIGHT);
+
+	mgl_u64_t frustum_time = 0, raster_time = 0, pyramid_time = 0, test_time = 0;
+	mgl_u64_t frustum_visible_count = 0, visible_count = 0;
+	for (mgl_u32_t i = 0; i < ROUND_COUNT; ++i)
+	{
+		mgl_u64_t start = mge_get_time();
+		mge_gather_scene_culling(culling, manager);
+		mge_run_culling(culling, locator->job_system);
+		const mgl_u32_t* list = mge_get_camera_visible_scene_nodes(culling, camera, 0, &frustum_visible_count);
+		mgl_u64_t frustum_end = mge_get_time();
+
+		mgl_f32m4x4_t view_projection;
+		mge_get_camera_view_projection(camera, 0, &view_projection);
+		mge_clear_occlusion(occlusion, &view_projection);
+		mge_rasterize_scene_occluders(occlusion, manager);
+		mgl_u64_t raster_end = mge_get_time();
+
+		mge_build_occlusion_pyramid(occlusion);
+		mgl_u64_t pyramid_end = mge_get_time();
+
+		visible_count = mge_filter_occluded_scene_nodes(occlusion, manager, list, frustum_visible_count, visible);
+		mgl_u64_t test_end = mge_get_time();
+
+		frustum_time += frustum_end - start;
+		raster_time += raster_end - frustum_end;
+		pyramid_time += pyramid_end - raster_end;
+		test_time += test_end - pyramid_end;
+	}
+
+	mge_occlusion_stats_t stats;
+	mge_get_occlusion_stats(occlusion, &stats);
+
+	print_stat(u8"Objects: ", BOX_COUNT, u8"\n");
+	print_stat(u8"Depth buffer: ", DEPTH_WIDTH, u8"x");
+	print_stat(u8"", DEPTH_HEIGHT, u8"\n");
+	print_stat(u8"Occluder triangles rasterized: ", stats.rasterized_triangle_count, u8"\n");
+	print_stat(u8"Visible after frustum culling: ", frustum_visible_count, u8"\n");
+	print_stat(u8"Visible after occlusion culling: ", visible_count, u8"\n");
+	print_stat(u8"Occluded ratio: ", stats.occluded_bounds_count * 100 / (stats.tested_bounds_count > 0 ? stats.tested_bounds_count : 1), u8"%\n");
+	print_stat(u8"Frustum culling time per frame: ", frustum_time / ROUND_COUNT / 1000, u8" us\n");
+	print_stat(u8"Rasterization time per frame: ", raster_time / ROUND_COUNT / 1000, u8" us\n");
+	print_stat(u8"Pyramid build time per frame: ", pyramid_time / ROUND_COUNT / 1000, u8" us\n");
+	print_stat(u8"Occlusion test time per frame: ", test_time / ROUND_COUNT / 1000, u8" us\n");
+
+	mge_terminate_occlusion(occlusion);
+	mge_terminate_culling(culling);
+}
+
+void mge_game_unload(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	// This example only runs on load, stop after the first frame
+	mge_stop_loop(locator->loop);
+}
@@ -0,0 +1,136 @@
+#include <mge/game.h>
+#include <mge/config.h>
+#include <mge/log.h>
+#include <mge/loop.h>
+#include <mge/time.h>
+
+#include <mge/resource/manager.h>
+#include <mge/resource/prefab.h>
+#include <mge/scene/manager.h>
+#include <mge/scene/component.h>
+#include <mge/scene/node.h>
+
+#include <mgl/stream/stream.h>
+#include <mgl/memory/allocator.h>
+#include <mgl/file/windows_standard_archive.h>
+
+#define BIG_PREFAB_NODE_COUNT 10000
+
+typedef struct
+{
+	mge_scene_component_t base;
+	mgl_u32_t color;
+} color_component_t;
+
+mgl_windows_standard_archive_t archive;
+
+static void print_stat(const mgl_chr8_t* name, mgl_u64_t value, const mgl_chr8_t* unit)
+{
+	mgl_print(mgl_stdout_stream, name);
+	mgl_print_u64(mgl_stdout_stream, value, 10);
+	mgl_print(mgl_stdout_stream, unit);
+}
+
+void mge_game_get_config(mge_engine_config_t* config)
+{
+	config->debug_mode = MGL_TRUE;
+	config->max_scene_node_count = 2 * BIG_PREFAB_NODE_COUNT + 16;
+}
+
+void mge_game_load(mge_game_locator_t* locator)
+{
+	mge_scene_manager_t* manager = locator->scene_manager;
+	mge_register_scene_component_type(manager, MGE_FIRST_GAME_SCENE_COMPONENT_TYPE, sizeof(color_component_t), 16, NULL);
+
+	// Register archive
+	mgl_error_t e = mgl_init_windows_standard_archive(&archive, mgl_standard_allocator, MGE_EXAMPLES_DATA_DIRECTORY);
+	if (e != MGL_ERROR_NONE)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to init windows archive");
+	mgl_register_archive(u8"data", &archive);
+
+	// Load a small prefab through the resource manager and instantiate it twice
+	mge_add_resource_info_file(locator->resource_manager, u8"data/prefab_resource.mri");
+	mge_prefab_resource_access_t access;
+	mge_open_resource(mge_find_resource(locator->resource_manager, u8"table_prefab"), &access, MGE_RESOURCE_PREFAB);
+	mge_scene_node_t* table = mge_instantiate_prefab(manager->root, access.data);
+	mge_scene_node_set_name(table, u8"table_1");
+	mge_instantiate_prefab(manager->root, access.data);
+	mge_close_resource(&access);
+
+	mge_scene_node_t* top = mge_find_scene_node(manager, u8"table/top");
+	if (top == NULL || mge_find_scene_node(manager, u8"table_1/leg_2") == NULL || top->first_component == NULL)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Prefab wasn't instantiated correctly");
+	mgl_print(mgl_stdout_stream, u8"Table top color: 0x");
+	mgl_print_u64(mgl_stdout_stream, ((color_component_t*)top->first_component)->color, 16);
+	mgl_print(mgl_stdout_stream, u8"\n");
+
+	// Build a big prefab in memory, where each node is the child of a random previous node
+	mgl_u64_t n = BIG_PREFAB_NODE_COUNT;
+	mgl_u8_t* memory;
+	e = mgl_allocate(manager->allocator, n * (sizeof(mgl_f32m4x4_t) + sizeof(mgl_u32_t) + MGE_MAX_SCENE_NODE_NAME_SIZE), (void**)&memory);
+	if (e != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_GAME_CLIENT, u8"Failed to allocate big prefab", e);
+
+	mgl_f32m4x4_t* transforms = (mgl_f32m4x4_t*)memory;
+	mgl_u32_t* parents = (mgl_u32_t*)(memory + n * sizeof(mgl_f32m4x4_t));
+	mgl_chr8_t(*names)[MGE_MAX_SCENE_NODE_NAME_SIZE] = (mgl_chr8_t(*)[MGE_MAX_SCENE_NODE_NAME_SIZE])(memory + n * (sizeof(mgl_f32m4x4_t) + sizeof(mgl_u32_t)));
+	mgl_u32_t random_state = 12345;
+	for (mgl_u64_t i = 0; i < n; ++i)
+	{
+		random_state = random_state * 1664525u + 1013904223u;
+		parents[i] = i == 0 ? MGE_PREFAB_NO_PARENT : (mgl_u32_t)((random_state >> 8) % i);
+		mgl_f32m4x4_identity(&transforms[i]);
+		MGE_F32M4X4_AT(&transforms[i], 0, 3) = 1.0f;
+		for (mgl_u64_t j = 0; j < MGE_MAX_SCENE_NODE_NAME_SIZE; ++j)
+			names[i][j] = 0;
+		names[i][0] = u8"abcdefghijklmnopqrstuvwxyz"[i % 26];
+		names[i][1] = u8"abcdefghijklmnopqrstuvwxyz"[(i / 26) % 26];
+		names[i][2] = u8"abcdefghijklmnopqrstuvwxyz"[(i / 676) % 26];
+	}
+
+	mge_prefab_resource_data_t prefab = { NULL, n, 0, 0, transforms, NULL, parents, (const mgl_chr8_t(*)[MGE_MAX_SCENE_NODE_NAME_SIZE])names, NULL };
+
+	// Compare instantiating it against creating the same nodes one by one, after touching the node slots once
+	mge_destroy_scene_node(mge_instantiate_prefab(manager->root, &prefab));
+	mgl_u64_t start = mge_get_time();
+	mge_scene_node_t* big = mge_instantiate_prefab(manager->root, &prefab);
+	mgl_u64_t instantiate_time = mge_get_time() - start;
+	mge_destroy_scene_node(big);
+
+	mge_scene_node_t** created = (mge_scene_node_t**)transforms;
+	start = mge_get_time();
+	for (mgl_u64_t i = 0; i < n; ++i)
+	{
+		mge_scene_node_t* node = mge_create_scene_node(i == 0 ? manager->root : created[parents[i]], names[i]);
+		*mge_scene_node_get_local_transform(node) = transforms[i];
+		mge_scene_node_set_dirty(node);
+		created[i] = node;
+	}
+	mge_update_scene_transforms(manager);
+	mgl_u64_t create_time = mge_get_time() - start;
+
+	print_stat(u8"Prefab nodes: ", n, u8"\n");
+	print_stat(u8"Instantiation time: ", instantiate_time / 1000, u8" us\n");
+	print_stat(u8"Node by node creation time: ", create_time / 1000, u8" us\n");
+
+	e = mgl_deallocate(manager->allocator, memory);
+	if (e != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_GAME_CLIENT, u8"Failed to deallocate big prefab", e);
+}
+
+void mge_game_unload(mge_game_locator_t* locator)
+{
+	mgl_unregister_archive(&archive);
+	mgl_terminate_windows_standard_archive(&archive);
+}
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	// This example only runs on load, stop after the first frame
+	mge_stop_loop(locator->loop);
+}
@@ -0,0 +1,108 @@
+#include <mge/game.h>
+#include <mge/config.h>
+#include <mge/log.h>
+#include <mge/loop.h>
+
+#include <mgl/stream/stream.h>
+
+#include <mge/job/system.h>
+#include <mge/resource/manager.h>
+#include <mge/resource/text.h>
+
+#include <mgl/file/windows_standard_archive.h>
+
+#define INFO_FILE_COUNT 4
+
+mgl_windows_standard_archive_t archive;
+
+static const mgl_chr8_t* info_files[INFO_FILE_COUNT] =
+{
+	u8"data/queue_resource_0.mri",
+	u8"data/queue_resource_1.mri",
+	u8"data/queue_resource_2.mri",
+	u8"data/queue_resource_3.mri",
+};
+
+static const mgl_chr8_t* resource_names[INFO_FILE_COUNT] =
+{
+	u8"queue_text_0",
+	u8"queue_text_1",
+	u8"queue_text_2",
+	u8"queue_text_3",
+};
+
+typedef struct
+{
+	mge_resource_manager_t* manager;
+	mgl_u32_t index;
+} queue_job_t;
+
+static void queue_info_file_job(mge_job_t* job, void* data)
+{
+	queue_job_t* queue = (queue_job_t*)data;
+	mge_queue_resource_info_file(queue->manager, info_files[queue->index]);
+}
+
+static void queue_root_job(mge_job_t* job, void* data)
+{
+
+}
+
+void mge_game_get_config(mge_engine_config_t* config)
+{
+	config->debug_mode = MGL_TRUE;
+	config->worker_thread_count = 4; // Background loads need more than one worker
+}
+
+void mge_game_load(mge_game_locator_t* locator)
+{
+	// Register archive
+	mgl_error_t e = mgl_init_windows_standard_archive(&archive, mgl_standard_allocator, MGE_EXAMPLES_DATA_DIRECTORY);
+	if (e != MGL_ERROR_NONE)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to init windows archive");
+	mgl_register_archive(u8"data", &archive);
+}
+
+void mge_game_unload(mge_game_locator_t* locator)
+{
+	mgl_unregister_archive(&archive);
+	mgl_terminate_windows_standard_archive(&archive);
+}
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	// Queue every info file at once, each from its own job, so they can be queued from several workers
+	mge_job_t* root = mge_create_job(locator->job_system, NULL, &queue_root_job, NULL, 0);
+	for (mgl_u32_t i = 0; i < INFO_FILE_COUNT; ++i)
+	{
+		queue_job_t queue = { locator->resource_manager, i };
+		mge_run_job(mge_create_job(locator->job_system, root, &queue_info_file_job, &queue, sizeof(queue)));
+	}
+	mge_run_job(root);
+	mge_wait_job(root);
+
+	// Once the loads are waited for, every file must have been added
+	mge_wait_resource_loads(locator->resource_manager);
+	for (mgl_u32_t i = 0; i < INFO_FILE_COUNT; ++i)
+	{
+		mge_resource_t* rsc = mge_try_find_resource(locator->resource_manager, resource_names[i]);
+		if (rsc == NULL)
+			mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Queued info file wasn't added by mge_wait_resource_loads");
+
+		mge_text_resource_access_t access;
+		mge_open_resource(rsc, &access, MGE_RESOURCE_TEXT);
+		mgl_print(mgl_stdout_stream, resource_names[i]);
+		mgl_print(mgl_stdout_stream, u8": ");
+		mgl_print_u64(mgl_stdout_stream, access.data->size, 10);
+		mgl_print(mgl_stdout_stream, u8" bytes\n");
+		mge_close_resource(&access);
+	}
+
+	// This example only runs once, stop after the first frame
+	mge_stop_loop(locator->loop);
+}
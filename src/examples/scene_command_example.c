@@ -0,0 +1,157 @@
+#include <mge/game.h>
+#include <mge/config.h>
+#include <mge/log.h>
+#include <mge/loop.h>
+
+#include <mge/job/system.h>
+#include <mge/scene/manager.h>
+#include <mge/scene/command.h>
+#include <mge/scene/component.h>
+#include <mge/scene/node.h>
+
+#include <mgl/stream/stream.h>
+
+#define CHUNK_COUNT 64
+#define OBJECT_COUNT 64
+
+typedef struct
+{
+	mge_scene_component_t base;
+	mgl_u32_t color;
+} color_component_t;
+
+typedef struct
+{
+	mge_game_locator_t* locator;
+	mge_scene_node_handle_t root;
+	mgl_u32_t chunk;
+} chunk_job_t;
+
+static mge_scene_node_handle_t chunk_nodes[CHUNK_COUNT];
+
+static void print_stat(const mgl_chr8_t* name, mgl_u64_t value, const mgl_chr8_t* unit)
+{
+	mgl_print(mgl_stdout_stream, name);
+	mgl_print_u64(mgl_stdout_stream, value, 10);
+	mgl_print(mgl_stdout_stream, unit);
+}
+
+static void spawn_chunk_job(mge_job_t* job, void* data)
+{
+	chunk_job_t* chunk_job = (chunk_job_t*)data;
+	mge_game_locator_t* locator = chunk_job->locator;
+
+	// Each worker records into its own buffer, the key makes the result independent of which worker ran the job
+	mge_scene_command_buffer_t* buffer = mge_get_scene_command_buffer(locator->scene_commands, mge_get_job_worker_index(locator->job_system));
+	mge_set_scene_command_key(buffer, chunk_job->chunk);
+
+	mge_scene_node_handle_t chunk = mge_record_create_scene_node(buffer, chunk_job->root, u8"chunk");
+	chunk_nodes[chunk_job->chunk] = chunk;
+
+	mge_scene_node_handle_t previous = chunk;
+	for (mgl_u32_t i = 0; i < OBJECT_COUNT; ++i)
+	{
+		mge_scene_node_handle_t object = mge_record_create_scene_node(buffer, chunk, u8"object");
+
+		mgl_f32m4x4_t transform;
+		mgl_f32m4x4_identity(&transform);
+		MGE_F32M4X4_AT(&transform, 0, 3) = (mgl_f32_t)i;
+		MGE_F32M4X4_AT(&transform, 1, 3) = (mgl_f32_t)chunk_job->chunk;
+		mge_record_set_scene_node_transform(buffer, object, &transform);
+
+		mgl_u32_t color = chunk_job->chunk * OBJECT_COUNT + i;
+		mge_record_create_scene_component(buffer, object, MGE_FIRST_GAME_SCENE_COMPONENT_TYPE, &color, sizeof(color));
+
+		// Attach every fourth object to the previous one, and throw away every sixteenth
+		if (i % 4 == 3)
+			mge_record_set_scene_node_parent(buffer, object, previous);
+		if (i % 16 == 15)
+			mge_record_destroy_scene_node(buffer, object);
+		previous = object;
+	}
+}
+
+static void spawn_job(mge_job_t* job, void* data)
+{
+	chunk_job_t chunk_job = *(chunk_job_t*)data;
+	for (mgl_u32_t i = 0; i < CHUNK_COUNT; ++i)
+	{
+		chunk_job.chunk = i;
+		mge_run_job(mge_create_job(chunk_job.locator->job_system, job, &spawn_chunk_job, &chunk_job, sizeof(chunk_job)));
+	}
+}
+
+static mgl_u64_t hash_subtree(mge_scene_node_t* node, mgl_u64_t hash)
+{
+	// Depends on the order of the children, which depends on the order the commands were applied
+	mgl_f32_t x = MGE_F32M4X4_AT(&node->transform.local, 0, 3);
+	mgl_f32_t y = MGE_F32M4X4_AT(&node->transform.local, 1, 3);
+	hash = (hash ^ (mgl_u64_t)(x + y * OBJECT_COUNT)) * 1099511628211ull;
+	if (node->first_component != NULL)
+		hash = (hash ^ ((color_component_t*)node->first_component)->color) * 1099511628211ull;
+	for (mge_scene_node_t* c = node->first_child; c != NULL; c = c->next)
+		hash = hash_subtree(c, hash);
+	return (hash ^ 0xFF) * 1099511628211ull;
+}
+
+static mgl_u64_t count_subtree(mge_scene_node_t* node)
+{
+	mgl_u64_t count = 1;
+	for (mge_scene_node_t* c = node->first_child; c != NULL; c = c->next)
+		count += count_subtree(c);
+	return count;
+}
+
+void mge_game_get_config(mge_engine_config_t* config)
+{
+	config->debug_mode = MGL_TRUE;
+	config->max_scene_node_count = CHUNK_COUNT * (OBJECT_COUNT + 1) + 1;
+	config->max_scene_command_count = CHUNK_COUNT * OBJECT_COUNT * 4;
+}
+
+void mge_game_load(mge_game_locator_t* locator)
+{
+	mge_register_scene_component_type(locator->scene_manager, MGE_FIRST_GAME_SCENE_COMPONENT_TYPE, sizeof(color_component_t), CHUNK_COUNT * OBJECT_COUNT, NULL);
+}
+
+void mge_game_unload(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	if (mge_get_frame_info(locator->loop)->index == 0)
+	{
+		// Spawn the chunks from every worker, the commands are applied by the main loop after this update
+		chunk_job_t data = { locator, mge_scene_node_get_handle(locator->scene_manager->root), 0 };
+		mge_job_t* job = mge_create_job(locator->job_system, NULL, &spawn_job, &data, sizeof(data));
+		mge_run_job(job);
+		mge_wait_job(job);
+		return;
+	}
+
+	// Pending handles can be resolved until the commands are applied again
+	mgl_u64_t node_count = 0;
+	for (mgl_u32_t i = 0; i < CHUNK_COUNT; ++i)
+	{
+		mge_scene_node_t* chunk = mge_resolve_scene_node_handle(locator->scene_manager, mge_resolve_scene_command_handle(locator->scene_commands, chunk_nodes[i]));
+		if (chunk == NULL)
+			mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Chunk node wasn't created");
+		node_count += count_subtree(chunk);
+	}
+	if (node_count != CHUNK_COUNT * (OBJECT_COUNT - OBJECT_COUNT / 16 + 1))
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Unexpected scene node count");
+
+	// The hash is the same no matter how many workers there are
+	print_stat(u8"Workers: ", mge_get_job_worker_count(locator->job_system), u8"\n");
+	print_stat(u8"Scene nodes: ", node_count, u8"\n");
+	print_stat(u8"Scene hash: ", hash_subtree(locator->scene_manager->root, 14695981039346656037ull), u8"\n");
+
+	mge_stop_loop(locator->loop);
+}
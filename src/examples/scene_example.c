@@ -1,8 +1,10 @@
 #include <mge/game.h>
 #include <mge/config.h>
 #include <mge/log.h>
+#include <mge/loop.h>
 
 #include <mge/scene/manager.h>
+#include <mge/scene/node.h>
 
 void mge_game_get_config(mge_engine_config_t* config)
 {
@@ -16,10 +18,34 @@ void mge_game_load(mge_game_locator_t* locator)
 	mge_scene_node_t* node3 = mge_create_scene_node(node2, u8"my_child_node_1");
 	mge_scene_node_t* node4 = mge_create_scene_node(node2, u8"my_child_node_2");
 	mge_scene_node_t* node5 = mge_create_scene_node(node1, u8"my_child_node_3");
+
+	// Look up nodes by path and by name
+	if (mge_find_scene_node(locator->scene_manager, u8"my_node/my_child_node/my_child_node_2") != node4 ||
+		mge_find_scene_node_child(node1, u8"my_child_node_3") != node5)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Scene node lookup failed");
+
+	mge_scene_node_set_name(node5, u8"renamed_node");
+	if (mge_find_scene_node(locator->scene_manager, u8"my_node/my_child_node_3") != NULL ||
+		mge_find_scene_node(locator->scene_manager, u8"my_node/renamed_node") != node5)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Scene node lookup failed after renaming");
+
 	mge_destroy_scene_node(node2);
+	if (mge_find_scene_node(locator->scene_manager, u8"my_node/my_child_node/my_child_node_2") != NULL)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Scene node lookup failed after destroying");
 }
 
 void mge_game_unload(mge_game_locator_t* locator)
 {
 	
 }
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	// This example only runs on load, stop after the first frame
+	mge_stop_loop(locator->loop);
+}
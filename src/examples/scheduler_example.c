@@ -0,0 +1,153 @@
+#include <mge/game.h>
+#include <mge/config.h>
+#include <mge/log.h>
+#include <mge/loop.h>
+#include <mge/time.h>
+
+#include <mge/scene/manager.h>
+#include <mge/scene/node.h>
+#include <mge/scene/component.h>
+#include <mge/scene/scheduler.h>
+
+#include <mgl/stream/stream.h>
+
+#define CROWD_COUNT 10000
+#define SPINNER_COUNT 1000
+#define FRAME_COUNT 200
+#define CROWD_UPDATE_INTERVAL 200000000
+#define CROWD_UPDATE_COST 200
+#define WORLD_SIZE 1000.0f
+
+#define CROWD_COMPONENT_TYPE (MGE_FIRST_GAME_SCENE_COMPONENT_TYPE + 0)
+#define SPINNER_COMPONENT_TYPE (MGE_FIRST_GAME_SCENE_COMPONENT_TYPE + 1)
+
+typedef struct
+{
+	mge_scene_component_t base;
+	mgl_f32_t state;
+} crowd_component_t;
+
+typedef struct
+{
+	mge_scene_component_t base;
+	mgl_f32_t angle;
+} spinner_component_t;
+
+static mgl_u32_t random_state = 12345;
+
+static mgl_f64_t max_crowd_delta_time;
+static mgl_u64_t crowd_update_count;
+static mgl_u64_t crowd_deferred_count;
+static mgl_u64_t crowd_time;
+static mgl_u64_t spinner_update_count;
+static mgl_u64_t spinner_time;
+
+static mgl_f32_t random_f32(mgl_f32_t max)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return (mgl_f32_t)(random_state % 1000000) / 1000000.0f * max;
+}
+
+static void print_stat(const mgl_chr8_t* name, mgl_u64_t value, const mgl_chr8_t* unit)
+{
+	mgl_print(mgl_stdout_stream, name);
+	mgl_print_u64(mgl_stdout_stream, value, 10);
+	mgl_print(mgl_stdout_stream, unit);
+}
+
+static void update_crowd(mge_scene_component_t* component, mgl_f64_t delta_time, void* data)
+{
+	// Stand-in for an expensive AI update
+	crowd_component_t* crowd = (crowd_component_t*)component;
+	for (mgl_u64_t i = 0; i < CROWD_UPDATE_COST; ++i)
+		crowd->state = crowd->state * 0.5f + (mgl_f32_t)delta_time;
+
+	if (delta_time > max_crowd_delta_time)
+		max_crowd_delta_time = delta_time;
+}
+
+static mgl_f32_t get_crowd_priority(mge_scene_component_t* component, void* data)
+{
+	// The camera is at the origin, closer components are updated more often
+	return 1.0f - MGE_F32M4X4_AT(&component->node->transform.global, 0, 3) / WORLD_SIZE;
+}
+
+static void update_spinner(mge_scene_component_t* component, mgl_f64_t delta_time, void* data)
+{
+	((spinner_component_t*)component)->angle += (mgl_f32_t)delta_time;
+}
+
+void mge_game_get_config(mge_engine_config_t* config)
+{
+	config->debug_mode = MGL_TRUE;
+	config->max_scene_node_count = CROWD_COUNT + SPINNER_COUNT + 1;
+	config->target_frame_rate = 60;
+	config->headless = MGL_TRUE;
+	config->frame_cap = FRAME_COUNT;
+}
+
+void mge_game_load(mge_game_locator_t* locator)
+{
+	mge_scene_manager_t* manager = locator->scene_manager;
+	mge_register_scene_component_type(manager, CROWD_COMPONENT_TYPE, sizeof(crowd_component_t), CROWD_COUNT, NULL);
+	mge_register_scene_component_type(manager, SPINNER_COMPONENT_TYPE, sizeof(spinner_component_t), SPINNER_COUNT, NULL);
+
+	// Spinners are cheap and updated every frame, crowd members at least every 200 ms depending on their distance to the camera
+	mge_register_scene_update(locator->scene_scheduler, SPINNER_COMPONENT_TYPE, &update_spinner, NULL, 0, NULL);
+	mge_register_scene_update(locator->scene_scheduler, CROWD_COMPONENT_TYPE, &update_crowd, &get_crowd_priority, CROWD_UPDATE_INTERVAL, NULL);
+
+	for (mgl_u64_t i = 0; i < CROWD_COUNT; ++i)
+	{
+		mge_scene_node_t* node = mge_create_scene_node(manager->root, NULL);
+		MGE_F32M4X4_AT(mge_scene_node_get_local_transform(node), 0, 3) = random_f32(WORLD_SIZE);
+		mge_scene_node_set_dirty(node);
+		((crowd_component_t*)mge_create_scene_component(node, CROWD_COMPONENT_TYPE))->state = 0.0f;
+	}
+
+	for (mgl_u64_t i = 0; i < SPINNER_COUNT; ++i)
+		((spinner_component_t*)mge_create_scene_component(mge_create_scene_node(manager->root, NULL), SPINNER_COMPONENT_TYPE))->angle = 0.0f;
+}
+
+void mge_game_unload(mge_game_locator_t* locator)
+{
+	const mge_frame_info_t* frame = mge_get_frame_info(locator->loop);
+
+	// No crowd member can go longer than its interval (plus the frame which crosses it) without an update
+	if (max_crowd_delta_time > (mgl_f64_t)CROWD_UPDATE_INTERVAL / MGE_NANOSECONDS_PER_SECOND + frame->delta_time)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Crowd component exceeded its update interval");
+	if (spinner_update_count != SPINNER_COUNT * (FRAME_COUNT - 1))
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Spinner components weren't updated every frame");
+
+	print_stat(u8"Crowd components: ", CROWD_COUNT, u8"\n");
+	print_stat(u8"Spinner components: ", SPINNER_COUNT, u8"\n");
+	print_stat(u8"Frames: ", FRAME_COUNT, u8"\n");
+	print_stat(u8"Crowd updates per frame: ", crowd_update_count / (FRAME_COUNT - 1), u8"\n");
+	print_stat(u8"Crowd deferred updates per frame: ", crowd_deferred_count / (FRAME_COUNT - 1), u8"\n");
+	print_stat(u8"Crowd update time per frame: ", crowd_time / (FRAME_COUNT - 1), u8" ns\n");
+	print_stat(u8"Max crowd update interval: ", (mgl_u64_t)(max_crowd_delta_time * 1000.0), u8" ms\n");
+	print_stat(u8"Spinner update time per frame: ", spinner_time / (FRAME_COUNT - 1), u8" ns\n");
+}
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	// The stats are from the previous frame's run
+	if (mge_get_frame_info(locator->loop)->index == 0)
+		return;
+
+	mge_scene_update_stats_t stats;
+	mge_get_scene_update_stats(locator->scene_scheduler, CROWD_COMPONENT_TYPE, &stats);
+	crowd_update_count += stats.update_count;
+	crowd_deferred_count += stats.deferred_count;
+	crowd_time += stats.time;
+
+	mge_get_scene_update_stats(locator->scene_scheduler, SPINNER_COMPONENT_TYPE, &stats);
+	spinner_update_count += stats.update_count;
+	spinner_time += stats.time;
+}
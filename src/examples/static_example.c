@@ -0,0 +1,168 @@
+#include <mge/game.h>
+#include <mge/config.h>
+#include <mge/log.h>
+#include <mge/loop.h>
+#include <mge/time.h>
+
+#include <mge/scene/manager.h>
+#include <mge/scene/node.h>
+#include <mge/scene/component.h>
+#include <mge/scene/bvh.h>
+
+#include <mgl/stream/stream.h>
+
+#define ROOM_COUNT 200
+#define PROPS_PER_ROOM 250
+#define DYNAMIC_NODE_COUNT 2000
+#define NODE_COUNT (2 + ROOM_COUNT * (PROPS_PER_ROOM + 1) + DYNAMIC_NODE_COUNT)
+#define FRAME_COUNT 20
+#define WORLD_SIZE 1000.0f
+
+static mge_scene_node_t* level;
+static mge_scene_node_t* dynamic_nodes[DYNAMIC_NODE_COUNT];
+static mgl_u32_t results[NODE_COUNT];
+static mgl_u32_t random_state = 12345;
+
+static mgl_f32_t random_f32(mgl_f32_t max)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return (mgl_f32_t)(random_state % 1000000) / 1000000.0f * max;
+}
+
+static void print_stat(const mgl_chr8_t* name, mgl_u64_t value, const mgl_chr8_t* unit)
+{
+	mgl_print(mgl_stdout_stream, name);
+	mgl_print_u64(mgl_stdout_stream, value, 10);
+	mgl_print(mgl_stdout_stream, unit);
+}
+
+static void set_position(mge_scene_node_t* node, mgl_f32_t x, mgl_f32_t y, mgl_f32_t z)
+{
+	mgl_f32m4x4_t* local = mge_scene_node_get_local_transform(node);
+	MGE_F32M4X4_AT(local, 0, 3) = x;
+	MGE_F32M4X4_AT(local, 1, 3) = y;
+	MGE_F32M4X4_AT(local, 2, 3) = z;
+	mge_scene_node_set_dirty(node);
+}
+
+static mgl_u64_t run_frames(mge_scene_manager_t* manager, mge_scene_bvh_t* dynamic_bvh, mge_scene_bvh_t* static_bvh)
+{
+	// Move every dynamic node and move the level root too, which doesn't affect the level once it is frozen
+	mgl_u64_t start = mge_get_time();
+	for (mgl_u64_t frame = 0; frame < FRAME_COUNT; ++frame)
+	{
+		mge_scene_node_set_dirty(level);
+		for (mgl_u64_t i = 0; i < DYNAMIC_NODE_COUNT; ++i)
+			set_position(dynamic_nodes[i], random_f32(WORLD_SIZE), random_f32(WORLD_SIZE), random_f32(WORLD_SIZE));
+		mge_update_scene_transforms(manager);
+		mge_update_scene_bvh(dynamic_bvh);
+		if (static_bvh != NULL)
+			mge_update_scene_bvh(static_bvh);
+	}
+	return (mge_get_time() - start) / FRAME_COUNT;
+}
+
+static mgl_u64_t scan(mge_scene_manager_t* manager, const mge_aabb_t* query)
+{
+	mgl_u64_t count = 0;
+	for (mgl_u64_t i = 0; i < manager->max_node_count; ++i)
+		if (!manager->nodes[i].trash && !mge_is_aabb_empty(&manager->nodes[i].bounds.global) && mge_aabb_intersects_aabb(&manager->nodes[i].bounds.global, query))
+			++count;
+	return count;
+}
+
+void mge_game_get_config(mge_engine_config_t* config)
+{
+	config->debug_mode = MGL_TRUE;
+	config->max_scene_node_count = NODE_COUNT + 1;
+}
+
+void mge_game_load(mge_game_locator_t* locator)
+{
+	mge_scene_manager_t* manager = locator->scene_manager;
+	mge_register_scene_component_type(manager, MGE_FIRST_GAME_SCENE_COMPONENT_TYPE, sizeof(mge_scene_component_t), NODE_COUNT, NULL);
+
+	// Level geometry: rooms full of props, each one with a unit box
+	mge_aabb_t box = { { -0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, 0.5f } };
+	level = mge_create_scene_node(manager->root, u8"level");
+	for (mgl_u64_t i = 0; i < ROOM_COUNT; ++i)
+	{
+		mge_scene_node_t* room = mge_create_scene_node(level, u8"room");
+		set_position(room, random_f32(WORLD_SIZE), 0.0f, random_f32(WORLD_SIZE));
+		for (mgl_u64_t j = 0; j < PROPS_PER_ROOM; ++j)
+		{
+			mge_scene_node_t* prop = mge_create_scene_node(room, u8"prop");
+			set_position(prop, random_f32(20.0f), random_f32(20.0f), random_f32(20.0f));
+			mge_scene_component_set_bounds(mge_create_scene_component(prop, MGE_FIRST_GAME_SCENE_COMPONENT_TYPE), &box);
+		}
+	}
+	for (mgl_u64_t i = 0; i < DYNAMIC_NODE_COUNT; ++i)
+	{
+		dynamic_nodes[i] = mge_create_scene_node(manager->root, u8"dynamic");
+		mge_scene_component_set_bounds(mge_create_scene_component(dynamic_nodes[i], MGE_FIRST_GAME_SCENE_COMPONENT_TYPE), &box);
+	}
+	mge_update_scene_transforms(manager);
+
+	// Everything is dynamic, one BVH holds every node
+	mge_scene_bvh_t* dynamic_bvh = mge_init_scene_bvh(manager->allocator, manager, 0);
+	mgl_u64_t dynamic_time = run_frames(manager, dynamic_bvh, NULL);
+
+	// Freeze the level, it moves to the static BVH
+	mgl_u64_t start = mge_get_time();
+	mge_scene_node_freeze(level);
+	mge_scene_bvh_t* static_bvh = mge_init_static_scene_bvh(manager->allocator, manager);
+	mgl_u64_t freeze_time = mge_get_time() - start;
+	mgl_u64_t frozen_time = run_frames(manager, dynamic_bvh, static_bvh);
+
+	// Both BVHs together find the same nodes as a linear scan
+	mgl_u64_t bvh_count = 0, scan_count = 0;
+	for (mgl_u64_t i = 0; i < 100; ++i)
+	{
+		mgl_f32_t x = random_f32(WORLD_SIZE), y = random_f32(20.0f), z = random_f32(WORLD_SIZE);
+		mge_aabb_t query = { { x, y, z }, { x + 50.0f, y + 50.0f, z + 50.0f } };
+		bvh_count += mge_query_scene_bvh_aabb(dynamic_bvh, &query, results, NODE_COUNT);
+		bvh_count += mge_query_scene_bvh_aabb(static_bvh, &query, results, NODE_COUNT);
+		scan_count += scan(manager, &query);
+	}
+	if (bvh_count != scan_count)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Static and dynamic BVH queries don't match a linear scan");
+
+	// Adding a prop to a frozen room freezes it too
+	mge_scene_node_t* prop = mge_create_scene_node(level->first_child, u8"prop");
+	if (!mge_scene_node_is_frozen(prop))
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Scene node created under a frozen node isn't frozen");
+
+	mge_scene_bvh_stats_t dynamic_stats, static_stats;
+	mge_get_scene_bvh_stats(dynamic_bvh, &dynamic_stats);
+	mge_get_scene_bvh_stats(static_bvh, &static_stats);
+
+	print_stat(u8"Static nodes: ", ROOM_COUNT * (PROPS_PER_ROOM + 1) + 1, u8"\n");
+	print_stat(u8"Dynamic nodes: ", DYNAMIC_NODE_COUNT, u8"\n");
+	print_stat(u8"Frame time (all dynamic): ", dynamic_time / 1000, u8" us\n");
+	print_stat(u8"Frame time (level frozen): ", frozen_time / 1000, u8" us\n");
+	print_stat(u8"Freeze time: ", freeze_time / 1000, u8" us\n");
+	print_stat(u8"Dynamic BVH scene nodes: ", dynamic_stats.tree_scene_node_count + dynamic_stats.overflow_scene_node_count, u8"\n");
+	print_stat(u8"Static BVH scene nodes: ", static_stats.tree_scene_node_count, u8"\n");
+	print_stat(u8"Query results: ", bvh_count, u8"\n");
+
+	mge_terminate_scene_bvh(static_bvh);
+	mge_terminate_scene_bvh(dynamic_bvh);
+}
+
+void mge_game_unload(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	// This example only runs on load, stop after the first frame
+	mge_stop_loop(locator->loop);
+}
@@ -1,6 +1,7 @@
 #include <mge/game.h>
 #include <mge/config.h>
 #include <mge/log.h>
+#include <mge/loop.h>
 
 #include <mgl/stream/stream.h>
 
@@ -23,6 +24,7 @@ void mge_game_load(mge_game_locator_t* locator)
 	if (e != MGL_ERROR_NONE)
 		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to init windows archive");
 	mgl_register_archive(u8"data", &archive);
+	mge_add_resource_native_directory(locator->resource_manager, u8"data", MGE_EXAMPLES_DATA_DIRECTORY);
 
 	// Add info file
 	mge_add_resource_info_file(locator->resource_manager, u8"data/text_resource.mri");
@@ -54,3 +56,14 @@ void mge_game_unload(mge_game_locator_t* locator)
 	mgl_unregister_archive(&archive);
 	mgl_terminate_windows_standard_archive(&archive);
 }
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	// This example only runs on load, stop after the first frame
+	mge_stop_loop(locator->loop);
+}
@@ -0,0 +1,172 @@
+#include <mge/game.h>
+#include <mge/config.h>
+#include <mge/log.h>
+#include <mge/loop.h>
+#include <mge/time.h>
+
+#include <mge/scene/manager.h>
+#include <mge/scene/node.h>
+#include <mge/scene/trs.h>
+
+#include <mgl/stream/stream.h>
+
+#include <math.h>
+
+#define GROUP_COUNT 256
+#define GROUP_SIZE 255
+#define NODE_COUNT (GROUP_COUNT * (GROUP_SIZE + 1))
+#define RUN_COUNT 5
+
+static mge_scene_node_t* nodes[NODE_COUNT];
+
+static void print_stat(const mgl_chr8_t* name, mgl_u64_t value, const mgl_chr8_t* unit)
+{
+	mgl_print(mgl_stdout_stream, name);
+	mgl_print_u64(mgl_stdout_stream, value, 10);
+	mgl_print(mgl_stdout_stream, unit);
+}
+
+static void get_rotation(mgl_u64_t i, mgl_u64_t frame, mgl_f32_t rotation[4])
+{
+	// Spin each node around a different axis
+	mgl_f32_t angle = 0.001f * (mgl_f32_t)(i + frame * 7);
+	mgl_f32_t axis[3] = { 0.48f, 0.6f, 0.64f };
+	axis[i % 3] = -axis[i % 3];
+	mgl_f32_t s = sinf(angle * 0.5f);
+	rotation[0] = axis[0] * s;
+	rotation[1] = axis[1] * s;
+	rotation[2] = axis[2] * s;
+	rotation[3] = cosf(angle * 0.5f);
+}
+
+static void compose_matrix(const mgl_f32_t t[3], const mgl_f32_t q[4], const mgl_f32_t s[3], mgl_f32m4x4_t* m)
+{
+	// What a game would otherwise do by hand for every node which moves
+	mgl_f32m4x4_t translation, rotation, scale, temp;
+	mgl_f32m4x4_identity(&translation);
+	mgl_f32m4x4_identity(&rotation);
+	mgl_f32m4x4_identity(&scale);
+	for (mgl_u64_t i = 0; i < 3; ++i)
+	{
+		MGE_F32M4X4_AT(&translation, i, 3) = t[i];
+		MGE_F32M4X4_AT(&scale, i, i) = s[i];
+	}
+	MGE_F32M4X4_AT(&rotation, 0, 0) = 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]);
+	MGE_F32M4X4_AT(&rotation, 0, 1) = 2.0f * (q[0] * q[1] - q[3] * q[2]);
+	MGE_F32M4X4_AT(&rotation, 0, 2) = 2.0f * (q[0] * q[2] + q[3] * q[1]);
+	MGE_F32M4X4_AT(&rotation, 1, 0) = 2.0f * (q[0] * q[1] + q[3] * q[2]);
+	MGE_F32M4X4_AT(&rotation, 1, 1) = 1.0f - 2.0f * (q[0] * q[0] + q[2] * q[2]);
+	MGE_F32M4X4_AT(&rotation, 1, 2) = 2.0f * (q[1] * q[2] - q[3] * q[0]);
+	MGE_F32M4X4_AT(&rotation, 2, 0) = 2.0f * (q[0] * q[2] - q[3] * q[1]);
+	MGE_F32M4X4_AT(&rotation, 2, 1) = 2.0f * (q[1] * q[2] + q[3] * q[0]);
+	MGE_F32M4X4_AT(&rotation, 2, 2) = 1.0f - 2.0f * (q[0] * q[0] + q[1] * q[1]);
+	mgl_f32m4x4_mul(&rotation, &scale, &temp);
+	mgl_f32m4x4_mul(&translation, &temp, m);
+}
+
+static mgl_f32_t max_difference(const mgl_f32m4x4_t* a, const mgl_f32m4x4_t* b)
+{
+	mgl_f32_t max = 0.0f;
+	for (mgl_u64_t i = 0; i < 16; ++i)
+	{
+		mgl_f32_t d = a->data[i] > b->data[i] ? a->data[i] - b->data[i] : b->data[i] - a->data[i];
+		max = d > max ? d : max;
+	}
+	return max;
+}
+
+static mgl_u64_t run(mge_scene_manager_t* manager, mgl_bool_t trs)
+{
+	// Keep the best of a few runs, every node is rotated and the group nodes are moved too
+	mgl_u64_t best = ~0ull;
+	for (mgl_u64_t frame = 0; frame < RUN_COUNT; ++frame)
+	{
+		mgl_u64_t start = mge_get_time();
+		for (mgl_u64_t i = 0; i < NODE_COUNT; ++i)
+		{
+			mgl_f32_t translation[3] = { (mgl_f32_t)(i % (GROUP_SIZE + 1)), (mgl_f32_t)frame, 0.0f };
+			mgl_f32_t scale[3] = { 1.0f, 2.0f, 1.0f };
+			mgl_f32_t rotation[4];
+			get_rotation(i, frame, rotation);
+			if (trs)
+			{
+				mge_scene_node_set_translation(nodes[i], translation);
+				mge_scene_node_set_rotation(nodes[i], rotation);
+				mge_scene_node_set_scale(nodes[i], scale);
+			}
+			else
+			{
+				compose_matrix(translation, rotation, scale, mge_scene_node_get_local_transform(nodes[i]));
+				mge_scene_node_set_dirty(nodes[i]);
+			}
+		}
+		mge_update_scene_transforms(manager);
+		mgl_u64_t time = mge_get_time() - start;
+		best = time < best ? time : best;
+	}
+	return best;
+}
+
+void mge_game_get_config(mge_engine_config_t* config)
+{
+	config->debug_mode = MGL_TRUE;
+	config->max_scene_node_count = NODE_COUNT + 1;
+}
+
+void mge_game_load(mge_game_locator_t* locator)
+{
+	mge_scene_manager_t* manager = locator->scene_manager;
+
+	for (mgl_u64_t i = 0; i < NODE_COUNT; ++i)
+		nodes[i] = mge_create_scene_node(i % (GROUP_SIZE + 1) == 0 ? manager->root : nodes[i - i % (GROUP_SIZE + 1)], NULL);
+
+	// A decomposed matrix composes back to itself
+	mgl_f32_t translation[3] = { 1.0f, -2.0f, 3.0f };
+	mgl_f32_t rotation[4];
+	mgl_f32_t scale[3] = { -0.5f, 2.0f, 4.0f };
+	get_rotation(12345, 0, rotation);
+	mgl_f32m4x4_t expected;
+	compose_matrix(translation, rotation, scale, &expected);
+	*mge_scene_node_get_local_transform(nodes[1]) = expected;
+	mge_scene_node_enable_trs(nodes[1]);
+	mge_scene_node_set_translation(nodes[1], translation);
+	mge_scene_node_disable_trs(nodes[1]);
+	if (max_difference(mge_scene_node_get_local_transform(nodes[1]), &expected) > 1e-5f)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"TRS decomposition doesn't match the original matrix");
+
+	// Compose by hand first and keep the results to compare them with the TRS path
+	mgl_u64_t matrix_time = run(manager, MGL_FALSE);
+	static mgl_f32m4x4_t globals[NODE_COUNT];
+	for (mgl_u64_t i = 0; i < NODE_COUNT; ++i)
+		globals[i] = *mge_scene_node_get_global_transform(nodes[i]);
+
+	mgl_u64_t trs_time = run(manager, MGL_TRUE);
+	mgl_f32_t difference = 0.0f;
+	for (mgl_u64_t i = 0; i < NODE_COUNT; ++i)
+	{
+		mgl_f32_t d = max_difference(mge_scene_node_get_global_transform(nodes[i]), &globals[i]);
+		difference = d > difference ? d : difference;
+	}
+	if (difference > 1e-3f)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"TRS global transforms don't match the hand composed ones");
+
+	print_stat(u8"Scene nodes: ", NODE_COUNT, u8"\n");
+	print_stat(u8"Hand composed matrices: ", matrix_time / 1000, u8" us\n");
+	print_stat(u8"TRS: ", trs_time / 1000, u8" us\n");
+}
+
+void mge_game_unload(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	// This example only runs on load, stop after the first frame
+	mge_stop_loop(locator->loop);
+}
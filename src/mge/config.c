@@ -102,6 +102,124 @@ void mge_load_config(int argc, char ** argv, mge_engine_config_t * config)
 				i += 1;
 				continue;
 			}
+			else if (mgl_str_equal(option, u8"worker-threads"))
+			{
+				config->worker_thread_count = mge_config_parse_u64(option, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"The option worker-threads was set to '");
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+				i += 1;
+				continue;
+			}
+			else if (mgl_str_equal(option, u8"max-job-count"))
+			{
+				config->max_job_count = mge_config_parse_u64(option, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"The option max-job-count was set to '");
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+				i += 1;
+				continue;
+			}
+			else if (mgl_str_equal(option, u8"target-frame-rate"))
+			{
+				config->target_frame_rate = mge_config_parse_u64(option, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"The option target-frame-rate was set to '");
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+				i += 1;
+				continue;
+			}
+			else if (mgl_str_equal(option, u8"fixed-update-rate"))
+			{
+				config->fixed_update_rate = mge_config_parse_u64(option, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"The option fixed-update-rate was set to '");
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+				i += 1;
+				continue;
+			}
+			else if (mgl_str_equal(option, u8"max-fixed-updates"))
+			{
+				config->max_fixed_update_count = mge_config_parse_u64(option, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"The option max-fixed-updates was set to '");
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+				i += 1;
+				continue;
+			}
+			else if (mgl_str_equal(option, u8"headless"))
+			{
+				config->headless = mge_config_parse_boolean(option, argv[i + 1]);
+				if (config->headless)
+					MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"The option headless was activated\n");
+				else
+					MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"The option headless was deactivated\n");
+				i += 1;
+				continue;
+			}
+			else if (mgl_str_equal(option, u8"frame-cap"))
+			{
+				config->frame_cap = mge_config_parse_u64(option, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"The option frame-cap was set to '");
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+				i += 1;
+				continue;
+			}
+			else if (mgl_str_equal(option, u8"max-scene-command-count"))
+			{
+				config->max_scene_command_count = mge_config_parse_u64(option, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"The option max-scene-command-count was set to '");
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+				i += 1;
+				continue;
+			}
+			else if (mgl_str_equal(option, u8"scene-update-budget"))
+			{
+				config->scene_update_budget = mge_config_parse_u64(option, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"The option scene-update-budget was set to '");
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+				i += 1;
+				continue;
+			}
+			else if (mgl_str_equal(option, u8"profile"))
+			{
+				config->profile_frame_count = mge_config_parse_u64(option, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"The option profile was set to '");
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+				i += 1;
+				continue;
+			}
+			else if (mgl_str_equal(option, u8"max-profile-event-count"))
+			{
+				config->max_profile_event_count = mge_config_parse_u64(option, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"The option max-profile-event-count was set to '");
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+				i += 1;
+				continue;
+			}
+			else if (mgl_str_equal(option, u8"memory-steady-frame"))
+			{
+				config->memory_steady_frame = mge_config_parse_u64(option, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"The option memory-steady-frame was set to '");
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+				i += 1;
+				continue;
+			}
+			else if (mgl_str_equal(option, u8"frame-allocator-size"))
+			{
+				config->frame_allocator_size = mge_config_parse_u64(option, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"The option frame-allocator-size was set to '");
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, argv[i + 1]);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+				i += 1;
+				continue;
+			}
 		}
 	}
 }
@@ -1,16 +1,68 @@
 #include <mge/game.h>
 #include <mge/config.h>
 #include <mge/log.h>
+#include <mge/loop.h>
+#include <mge/profile.h>
+#include <mge/time.h>
 
+#include <mge/job/system.h>
+#include <mge/memory/frame.h>
+#include <mge/memory/tracking.h>
 #include <mge/resource/manager.h>
 #include <mge/scene/manager.h>
+#include <mge/scene/command.h>
+#include <mge/scene/scheduler.h>
 
 #include <mgl/entry.h>
 #include <mgl/memory/allocator.h>
 
+typedef struct
+{
+	mge_game_locator_t* locator;
+	const mge_engine_config_t* config;
+	void* allocator;
+} mge_scene_init_job_data_t;
+
+static void mge_init_scene_job(mge_job_t* job, void* data)
+{
+	mge_scene_init_job_data_t* init = (mge_scene_init_job_data_t*)data;
+	mge_game_locator_t* locator = init->locator;
+	MGE_PROFILE_BEGIN(u8"Initialize scene");
+
+	// Init scene manager
+	locator->scene_manager = mge_init_scene_manager(init->allocator, init->config->max_scene_node_count);
+
+	// Init scene command buffers, one per job system worker
+	locator->scene_commands = mge_init_scene_commands(init->allocator, locator->scene_manager, mge_get_job_worker_count(locator->job_system), init->config->max_scene_command_count);
+
+	// Init scene update scheduler
+	locator->scene_scheduler = mge_init_scene_scheduler(init->allocator, locator->scene_manager, init->config->scene_update_budget);
+
+	MGE_PROFILE_END();
+}
+
+// Logs a time in nanoseconds as milliseconds with three decimals
+static void mge_log_time_ms(mgl_u64_t time)
+{
+	mgl_chr8_t digits[32];
+	mgl_u64_t i = sizeof(digits) - 1;
+	mgl_u64_t us = time / 1000;
+	digits[i] = 0;
+	for (mgl_u64_t d = 0; d < 3; ++d, us /= 10)
+		digits[--i] = (mgl_chr8_t)('0' + us % 10);
+	digits[--i] = '.';
+	do
+	{
+		digits[--i] = (mgl_chr8_t)('0' + us % 10);
+		us /= 10;
+	} while (us != 0);
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, &digits[i]);
+}
+
 int main(int argc, char** argv)
 {
 	mge_game_locator_t locator;
+	mgl_u64_t start_time = mge_get_time();
 	
 	mge_internal_init_log();
 
@@ -25,43 +77,118 @@ int main(int argc, char** argv)
 	mge_load_config(argc, argv, &config);
 	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Loaded engine configuration successfully\n");
 
+	// Init memory tracking, with one tagged allocator per subsystem
+	mge_tracking_allocator_t* profiler_allocator = mge_init_tracking_allocator(mgl_standard_allocator, u8"profiler");
+	mge_tracking_allocator_t* job_allocator = mge_init_tracking_allocator(mgl_standard_allocator, u8"job system");
+	mge_tracking_allocator_t* resource_allocator = mge_init_tracking_allocator(mgl_standard_allocator, u8"resources");
+	mge_tracking_allocator_t* scene_allocator = mge_init_tracking_allocator(mgl_standard_allocator, u8"scene");
+	mge_tracking_allocator_t* loop_allocator = mge_init_tracking_allocator(mgl_standard_allocator, u8"main loop");
+	mge_tracking_allocator_t* frame_allocator = mge_init_tracking_allocator(mgl_standard_allocator, u8"frame allocator");
+	mge_tracking_allocator_t* game_allocator = mge_init_tracking_allocator(mgl_standard_allocator, u8"game");
+	locator.game_allocator = game_allocator;
+	locator.argument_count = argc > 0 ? (mgl_u64_t)argc : 0;
+	locator.arguments = argv;
+	locator.exit_code = 0;
+
+	// Init profiler, capturing from here on with -mge-profile
+	mge_internal_init_profiler(profiler_allocator, config.max_profile_event_count);
+	if (config.profile_frame_count > 0)
+		mge_start_profile_capture();
+
 	// Init engine
 	{
-		// Init resource manager
-		locator.resource_manager = mge_init_resource_manager(mgl_standard_allocator, config.max_resource_count);
+		MGE_PROFILE_BEGIN(u8"Initialize engine");
+
+		// Init job system
+		locator.job_system = mge_init_job_system(job_allocator, config.worker_thread_count, config.max_job_count);
 
-		// Init scene manager
-		locator.scene_manager = mge_init_scene_manager(mgl_standard_allocator, config.max_scene_node_count);
+		// Init the scene subsystems on a job, while the rest of the engine is initialized
+		mge_scene_init_job_data_t scene_init = { &locator, &config, scene_allocator };
+		mge_job_t* scene_job = mge_create_job(locator.job_system, NULL, &mge_init_scene_job, &scene_init, sizeof(scene_init));
+		mge_run_job(scene_job);
 
+		// Init resource manager, which loads permanent resources on the job system
+		locator.resource_manager = mge_init_resource_manager(resource_allocator, locator.job_system, config.max_resource_count);
+
+		// Init frame allocator
+		locator.frame_allocator = mge_init_frame_allocator(frame_allocator, config.frame_allocator_size);
+
+		// Init main loop
+		locator.loop = mge_init_loop(loop_allocator, &config);
+
+		mge_wait_job(scene_job);
+
+		MGE_PROFILE_END();
 		MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Initialized engine successfully\n");
 	}
 	
 	// Load game
+	MGE_PROFILE_BEGIN(u8"Load game");
 	mge_game_load(&locator);
+	MGE_PROFILE_END();
 	MGE_LOG_VERBOSE_1(MGE_LOG_GAME_CLIENT, u8"Loaded game successfully\n");
 
+	// Permanent resources may still be loading, the game waits for them when it opens them
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Time to first frame: ");
+	mge_log_time_ms(mge_get_time() - start_time);
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8" ms\n");
+
 	// Run engine
-	// TO DO
+	mge_run_loop(locator.loop, &locator);
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Main loop stopped\n");
 
 	// Unload game
+	MGE_PROFILE_BEGIN(u8"Unload game");
 	mge_game_unload(&locator);
+	MGE_PROFILE_END();
 	MGE_LOG_VERBOSE_1(MGE_LOG_GAME_CLIENT, u8"Unloaded game successfully\n");
 
+	// Write the profile capture if the loop stopped before it finished
+	mge_finish_profile_capture(MGE_PROFILE_TRACE_PATH);
+
 	// Terminate engine
 	{
+		// Terminate main loop
+		mge_terminate_loop(locator.loop);
+
+		// Terminate frame allocator
+		mge_terminate_frame_allocator(locator.frame_allocator);
+
+		// Terminate scene update scheduler
+		mge_terminate_scene_scheduler(locator.scene_scheduler);
+
+		// Terminate scene command buffers
+		mge_terminate_scene_commands(locator.scene_commands);
+
 		// Terminate scene manager
 		mge_terminate_scene_manager(locator.scene_manager);
 
 		// Terminate resource manager
 		mge_terminate_resource_manager(locator.resource_manager);
 
+		// Terminate job system
+		mge_terminate_job_system(locator.job_system);
+
 		MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Terminated engine successfully\n");
 	}
 
+	// Terminate profiler
+	mge_internal_terminate_profiler();
+
+	// Terminate memory tracking, any memory still live is a leak
+	mge_log_memory_stats();
+	mge_terminate_tracking_allocator(game_allocator);
+	mge_terminate_tracking_allocator(frame_allocator);
+	mge_terminate_tracking_allocator(loop_allocator);
+	mge_terminate_tracking_allocator(scene_allocator);
+	mge_terminate_tracking_allocator(resource_allocator);
+	mge_terminate_tracking_allocator(job_allocator);
+	mge_terminate_tracking_allocator(profiler_allocator);
+
 	// Terminate MGL
 	mgl_terminate();
 	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Terminated MGL successfully\n");
 
 	mge_internal_terminate_log();
-	return 0;
+	return locator.exit_code;
 }
\ No newline at end of file
@@ -0,0 +1,420 @@
+#include <mge/job/system.h>
+#include <mge/time.h>
+#include <mge/log.h>
+
+#include <mge/platform/atomic.h>
+#include <mge/platform/thread.h>
+
+#include <mgl/memory/allocator.h>
+#include <mgl/memory/manipulation.h>
+
+// Idle workers first spin, then yield and finally sleep until new jobs show up
+#define MGE_JOB_IDLE_SPIN_COUNT 256
+#define MGE_JOB_IDLE_YIELD_COUNT 1024
+#define MGE_JOB_IDLE_SLEEP_TIME 50000
+
+typedef struct mge_job_worker_t mge_job_worker_t;
+
+// Job slots are reused once finished, the generation changes every time so that waiters can tell
+struct mge_job_t
+{
+	mge_job_func_t func;
+	mge_job_t* parent;
+	mge_job_system_t* system;
+	mge_job_worker_t* worker;
+	mge_atomic_i32_t unfinished;
+	mge_atomic_i32_t generation;
+	mgl_u8_t data[MGE_MAX_JOB_DATA_SIZE];
+};
+
+struct mge_job_worker_t
+{
+	mge_job_system_t* system;
+	mgl_u64_t index;
+	mge_thread_t thread;
+	mgl_u32_t random;
+
+	// Job ring
+	mge_job_t* jobs;
+	mgl_u64_t next_job;
+
+	// Work-stealing deque (Chase-Lev)
+	// 'top' is written by thieves and 'bottom' by the owner, so they are kept on different cache lines
+	mge_job_t** deque;
+	mgl_u8_t padding_0[64];
+	mge_atomic_i64_t top;
+	mgl_u8_t padding_1[64];
+	mge_atomic_i64_t bottom;
+	mgl_u8_t padding_2[64];
+
+	// Stats (only written by the owner thread)
+	mgl_u64_t executed_job_count;
+	mgl_u64_t steal_attempt_count;
+	mgl_u64_t steal_count;
+	mgl_u8_t padding_3[64];
+};
+
+struct mge_job_system_t
+{
+	void* allocator;
+	mgl_u64_t worker_count;
+	mgl_u64_t max_job_count;
+	mge_job_worker_t* workers;
+	mge_atomic_i32_t running;
+};
+
+static MGE_THREAD_LOCAL mge_job_worker_t* mge_current_job_worker = NULL;
+
+static mge_job_worker_t* mge_get_current_job_worker(mge_job_system_t* system)
+{
+	mge_job_worker_t* worker = mge_current_job_worker;
+	if (worker == NULL || worker->system != system)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to access job system, the calling thread isn't one of its workers");
+	return worker;
+}
+
+static void mge_push_job(mge_job_worker_t* worker, mge_job_t* job)
+{
+	mgl_i64_t b = mge_atomic_load_i64(&worker->bottom);
+	mgl_i64_t t = mge_atomic_load_i64(&worker->top);
+	if (b - t >= (mgl_i64_t)worker->system->max_job_count)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to run job, worker job queue is full");
+
+	worker->deque[b & (worker->system->max_job_count - 1)] = job;
+	mge_atomic_store_i64(&worker->bottom, b + 1);
+}
+
+static mge_job_t* mge_pop_job(mge_job_worker_t* worker)
+{
+	mgl_i64_t b = mge_atomic_load_i64(&worker->bottom) - 1;
+	mge_atomic_store_i64(&worker->bottom, b);
+	mgl_i64_t t = mge_atomic_load_i64(&worker->top);
+
+	if (t > b)
+	{
+		// Queue is empty
+		mge_atomic_store_i64(&worker->bottom, t);
+		return NULL;
+	}
+
+	mge_job_t* job = worker->deque[b & (worker->system->max_job_count - 1)];
+	if (t != b)
+		return job;
+
+	// This is the last job, race against thieves for it
+	if (!mge_atomic_cas_i64(&worker->top, t, t + 1))
+		job = NULL;
+	mge_atomic_store_i64(&worker->bottom, t + 1);
+	return job;
+}
+
+static mge_job_t* mge_steal_job(mge_job_worker_t* victim)
+{
+	mgl_i64_t t = mge_atomic_load_i64(&victim->top);
+	mgl_i64_t b = mge_atomic_load_i64(&victim->bottom);
+	if (t >= b)
+		return NULL;
+
+	mge_job_t* job = victim->deque[t & (victim->system->max_job_count - 1)];
+	if (!mge_atomic_cas_i64(&victim->top, t, t + 1))
+		return NULL;
+	return job;
+}
+
+static mge_job_t* mge_get_job(mge_job_worker_t* worker)
+{
+	mge_job_t* job = mge_pop_job(worker);
+	if (job != NULL)
+		return job;
+
+	// Own queue is empty, try to steal from the other workers starting on a random one
+	mge_job_system_t* system = worker->system;
+	if (system->worker_count <= 1)
+		return NULL;
+
+	worker->random ^= worker->random << 13;
+	worker->random ^= worker->random >> 17;
+	worker->random ^= worker->random << 5;
+	mgl_u64_t start = worker->random % system->worker_count;
+
+	for (mgl_u64_t i = 0; i < system->worker_count; ++i)
+	{
+		mge_job_worker_t* victim = &system->workers[(start + i) % system->worker_count];
+		if (victim == worker)
+			continue;
+
+		worker->steal_attempt_count += 1;
+		job = mge_steal_job(victim);
+		if (job != NULL)
+		{
+			worker->steal_count += 1;
+			return job;
+		}
+	}
+
+	return NULL;
+}
+
+static void mge_finish_job(mge_job_t* job)
+{
+	// Once unfinished reaches zero the job's slot can be reused, so the parent is read first
+	mge_job_t* parent = job->parent;
+	if (mge_atomic_add_i32(&job->unfinished, -1) == 0 && parent != NULL)
+		mge_finish_job(parent);
+}
+
+static void mge_execute_job(mge_job_worker_t* worker, mge_job_t* job)
+{
+	job->func(job, job->data);
+	mge_finish_job(job);
+	worker->executed_job_count += 1;
+}
+
+static void mge_job_worker_main(void* arg)
+{
+	mge_job_worker_t* worker = (mge_job_worker_t*)arg;
+	mge_current_job_worker = worker;
+
+	mgl_u64_t idle_count = 0;
+	while (mge_atomic_load_i32(&worker->system->running))
+	{
+		mge_job_t* job = mge_get_job(worker);
+		if (job != NULL)
+		{
+			mge_execute_job(worker, job);
+			idle_count = 0;
+		}
+		else if (++idle_count < MGE_JOB_IDLE_SPIN_COUNT)
+			mge_cpu_relax();
+		else if (idle_count < MGE_JOB_IDLE_YIELD_COUNT)
+			mge_internal_yield_thread();
+		else
+			mge_sleep(MGE_JOB_IDLE_SLEEP_TIME);
+	}
+
+	mge_current_job_worker = NULL;
+}
+
+mge_job_system_t * mge_init_job_system(void * allocator, mgl_u64_t worker_count, mgl_u64_t max_job_count)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL);
+	if (max_job_count == 0 || (max_job_count & (max_job_count - 1)) != 0)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to initialize job system, max job count must be a power of two");
+	if (worker_count == 0)
+		worker_count = mge_internal_get_cpu_count();
+
+	mge_job_system_t* system;
+
+	// Allocate job system
+	mgl_error_t err = mgl_allocate(allocator, sizeof(mge_job_system_t), (void**)&system);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate job system", err);
+
+	// Allocate workers
+	err = mgl_allocate(allocator, worker_count * sizeof(mge_job_worker_t), (void**)&system->workers);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate workers array on job system", err);
+
+	system->allocator = allocator;
+	system->worker_count = worker_count;
+	system->max_job_count = max_job_count;
+	mge_atomic_store_i32(&system->running, 1);
+
+	// Init workers
+	for (mgl_u64_t i = 0; i < worker_count; ++i)
+	{
+		mge_job_worker_t* worker = &system->workers[i];
+		mgl_mem_set(worker, sizeof(mge_job_worker_t), 0);
+		worker->system = system;
+		worker->index = i;
+		worker->random = (mgl_u32_t)(i * 2654435761u) | 1;
+
+		err = mgl_allocate(allocator, max_job_count * sizeof(mge_job_t), (void**)&worker->jobs);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate job ring on job system", err);
+		err = mgl_allocate(allocator, max_job_count * sizeof(mge_job_t*), (void**)&worker->deque);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate job queue on job system", err);
+
+		for (mgl_u64_t j = 0; j < max_job_count; ++j)
+		{
+			worker->jobs[j].unfinished = 0;
+			worker->jobs[j].generation = 0;
+		}
+	}
+
+	// The calling thread is worker 0, start the others
+	mge_current_job_worker = &system->workers[0];
+	for (mgl_u64_t i = 1; i < worker_count; ++i)
+		mge_internal_create_thread(&system->workers[i].thread, &mge_job_worker_main, &system->workers[i]);
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully initialized job system\n");
+
+	return system;
+}
+
+void mge_terminate_job_system(mge_job_system_t * system)
+{
+	MGL_DEBUG_ASSERT(system != NULL);
+	if (mge_current_job_worker != &system->workers[0])
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to terminate job system, it must be terminated by the thread which initialized it");
+
+	// Stop workers
+	mge_atomic_store_i32(&system->running, 0);
+	for (mgl_u64_t i = 1; i < system->worker_count; ++i)
+		mge_internal_join_thread(&system->workers[i].thread);
+	mge_current_job_worker = NULL;
+
+	// Deallocate workers
+	mgl_error_t err;
+	for (mgl_u64_t i = 0; i < system->worker_count; ++i)
+	{
+		err = mgl_deallocate(system->allocator, system->workers[i].deque);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate job queue on job system", err);
+		err = mgl_deallocate(system->allocator, system->workers[i].jobs);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate job ring on job system", err);
+	}
+
+	err = mgl_deallocate(system->allocator, system->workers);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate workers array on job system", err);
+
+	// Deallocate job system
+	err = mgl_deallocate(system->allocator, system);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate job system", err);
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully terminated job system\n");
+}
+
+mge_job_t * mge_create_job(mge_job_system_t * system, mge_job_t * parent, mge_job_func_t func, const void * data, mgl_u64_t data_size)
+{
+	MGL_DEBUG_ASSERT(system != NULL && func != NULL && (data != NULL || data_size == 0));
+	if (data_size > MGE_MAX_JOB_DATA_SIZE)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to create job, job data is too big");
+
+	mge_job_worker_t* worker = mge_get_current_job_worker(system);
+
+	// Get the next finished job from the ring (long-running jobs, such as roots, are skipped)
+	mge_job_t* job = NULL;
+	for (mgl_u64_t i = 0; i < system->max_job_count; ++i)
+	{
+		mge_job_t* candidate = &worker->jobs[worker->next_job & (system->max_job_count - 1)];
+		worker->next_job += 1;
+		if (mge_atomic_load_i32(&candidate->unfinished) == 0)
+		{
+			job = candidate;
+			break;
+		}
+	}
+	if (job == NULL)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to create job, too many unfinished jobs on this worker");
+
+	job->func = func;
+	job->parent = parent;
+	job->system = system;
+	job->worker = worker;
+	if (data_size > 0)
+		mgl_mem_copy(job->data, data, data_size);
+	mge_atomic_store_i32(&job->generation, (mgl_i32_t)((mgl_u32_t)job->generation + 1));
+	mge_atomic_store_i32(&job->unfinished, 1);
+
+	if (parent != NULL)
+		mge_atomic_add_i32(&parent->unfinished, 1);
+
+	return job;
+}
+
+void mge_run_job(mge_job_t * job)
+{
+	MGL_DEBUG_ASSERT(job != NULL);
+	mge_push_job(mge_get_current_job_worker(job->system), job);
+}
+
+// Jobs executed while waiting can create jobs on the waited job's slot once it finishes, which changes its generation
+static void mge_wait_job_generation(mge_job_worker_t* worker, mge_job_t* job, mgl_i32_t generation)
+{
+	// Help executing jobs while waiting
+	while (mge_atomic_load_i32(&job->unfinished) > 0 && mge_atomic_load_i32(&job->generation) == generation)
+	{
+		mge_job_t* other = mge_get_job(worker);
+		if (other != NULL)
+			mge_execute_job(worker, other);
+		else
+			mge_cpu_relax();
+	}
+}
+
+void mge_wait_job(mge_job_t * job)
+{
+	MGL_DEBUG_ASSERT(job != NULL);
+	mge_job_worker_t* worker = mge_get_current_job_worker(job->system);
+
+	// Only the creator reuses the job's slot, so the job can't have been replaced before it started waiting
+	MGL_DEBUG_ASSERT(job->worker == worker);
+	mge_wait_job_generation(worker, job, mge_atomic_load_i32(&job->generation));
+}
+
+void mge_run_and_wait_job(mge_job_t * job)
+{
+	MGL_DEBUG_ASSERT(job != NULL);
+	mge_job_worker_t* worker = mge_get_current_job_worker(job->system);
+
+	// The job can't finish before it's run, so its generation is still the one it was created with
+	mgl_i32_t generation = mge_atomic_load_i32(&job->generation);
+	mge_push_job(worker, job);
+	mge_wait_job_generation(worker, job, generation);
+}
+
+mgl_bool_t mge_is_job_finished(mge_job_t * job)
+{
+	MGL_DEBUG_ASSERT(job != NULL);
+	MGL_DEBUG_ASSERT(job->worker == mge_get_current_job_worker(job->system));
+	return mge_atomic_load_i32(&job->unfinished) == 0;
+}
+
+mgl_u64_t mge_get_job_worker_count(mge_job_system_t * system)
+{
+	MGL_DEBUG_ASSERT(system != NULL);
+	return system->worker_count;
+}
+
+mgl_u64_t mge_get_job_worker_index(mge_job_system_t * system)
+{
+	MGL_DEBUG_ASSERT(system != NULL);
+	mge_job_worker_t* worker = mge_current_job_worker;
+	if (worker == NULL || worker->system != system)
+		return system->worker_count;
+	return worker->index;
+}
+
+void mge_get_job_system_stats(mge_job_system_t * system, mge_job_system_stats_t * stats)
+{
+	MGL_DEBUG_ASSERT(system != NULL && stats != NULL);
+
+	stats->worker_count = system->worker_count;
+	stats->executed_job_count = 0;
+	stats->steal_attempt_count = 0;
+	stats->steal_count = 0;
+
+	for (mgl_u64_t i = 0; i < system->worker_count; ++i)
+	{
+		stats->executed_job_count += system->workers[i].executed_job_count;
+		stats->steal_attempt_count += system->workers[i].steal_attempt_count;
+		stats->steal_count += system->workers[i].steal_count;
+	}
+}
+
+void mge_reset_job_system_stats(mge_job_system_t * system)
+{
+	MGL_DEBUG_ASSERT(system != NULL);
+
+	for (mgl_u64_t i = 0; i < system->worker_count; ++i)
+	{
+		system->workers[i].executed_job_count = 0;
+		system->workers[i].steal_attempt_count = 0;
+		system->workers[i].steal_count = 0;
+	}
+}
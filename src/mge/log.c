@@ -1,55 +1,380 @@
 #include <mge/log.h>
+#include <mge/time.h>
+
+#include <mge/platform/atomic.h>
+#include <mge/platform/thread.h>
 
 #include <mgl/memory/allocator.h>
+#include <mgl/memory/manipulation.h>
+#include <mgl/string/manipulation.h>
 #include <mgl/file/logger.h>
 
 static mgl_logger_t* mge_engine_logger = NULL;
 static mgl_logger_t* mge_game_client_logger = NULL;
 static mgl_logger_t* mge_game_server_logger = NULL;
 
+// Fatal errors can terminate the log from several threads at once, only the first one does it
+enum
+{
+	MGE_LOG_ACTIVE,
+	MGE_LOG_TERMINATING,
+	MGE_LOG_TERMINATED,
+};
+static mge_atomic_i32_t mge_log_state = MGE_LOG_ACTIVE;
+static MGE_THREAD_LOCAL mgl_bool_t mge_terminating_log = MGL_FALSE;
+
+static mgl_logger_t* mge_get_logger(mgl_enum_t log)
+{
+	switch (log)
+	{
+		case MGE_LOG_ENGINE: return mge_engine_logger;
+		case MGE_LOG_GAME_CLIENT: return mge_game_client_logger;
+		case MGE_LOG_GAME_SERVER: return mge_game_server_logger;
+		default: return NULL;
+	}
+}
+
+#ifdef MGE_ASYNC_LOG
+
+// Size of each thread's log ring, in bytes (must be a power of two)
+#ifndef MGE_LOG_RING_SIZE
+#	define MGE_LOG_RING_SIZE 65536
+#endif
+
+// Messages are stored on the rings as chunks: an 8 byte header followed by the null terminated message, padded to 8 bytes
+#define MGE_LOG_CHUNK_HEADER_SIZE 8
+#define MGE_LOG_MAX_CHUNK_SIZE (MGE_LOG_RING_SIZE / 4)
+
+// Header channel which marks the end of the ring, the next chunk starts at the beginning
+#define MGE_LOG_WRAP_CHANNEL 0xFFFFFFFF
+
+// The log thread first spins, then yields and finally sleeps while there's nothing to write
+#define MGE_LOG_IDLE_SPIN_COUNT 64
+#define MGE_LOG_IDLE_YIELD_COUNT 256
+#define MGE_LOG_IDLE_SLEEP_TIME 1000000
+
+typedef struct mge_log_ring_t mge_log_ring_t;
+
+// Single producer (the owner thread), single consumer (the log thread) byte ring
+struct mge_log_ring_t
+{
+	mge_log_ring_t* next;
+	mgl_u8_t* data;
+
+	// End of the bytes written by the producer, only published once a message ends a line. A line which doesn't fit on
+	// the ring is dropped as a whole, and counted
+	mgl_u64_t write;
+	mgl_bool_t dropping;
+	mge_atomic_i64_t dropped_count;
+
+	// Set by the producer while it writes, so that terminating the log waits for it
+	mge_atomic_i32_t in_use;
+	mgl_u8_t padding_0[64];
+
+	// End of the published bytes
+	mge_atomic_i64_t head;
+	mgl_u8_t padding_1[64];
+
+	// End of the bytes already written to the logger by the log thread, and dropped lines it already reported
+	mge_atomic_i64_t tail;
+	mgl_i64_t reported_dropped_count;
+	mgl_u8_t padding_2[64];
+};
+
+static void* volatile mge_log_rings = NULL;
+static MGE_THREAD_LOCAL mge_log_ring_t* mge_current_log_ring = NULL;
+static mge_atomic_i32_t mge_log_running = 0;
+static mge_thread_t mge_log_thread;
+
+static mge_log_ring_t* mge_get_log_ring(void)
+{
+	if (mge_current_log_ring != NULL)
+		return mge_current_log_ring;
+
+	// Rings are only removed when the log is terminated, so that messages of threads which already exited are still written
+	mge_log_ring_t* ring;
+	if (mgl_allocate(mgl_standard_allocator, sizeof(mge_log_ring_t), (void**)&ring) != MGL_ERROR_NONE)
+		return NULL;
+	if (mgl_allocate(mgl_standard_allocator, MGE_LOG_RING_SIZE, (void**)&ring->data) != MGL_ERROR_NONE)
+	{
+		mgl_deallocate(mgl_standard_allocator, ring);
+		return NULL;
+	}
+	ring->write = 0;
+	ring->dropping = MGL_FALSE;
+	ring->dropped_count = 0;
+	ring->in_use = 0;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->reported_dropped_count = 0;
+
+	do
+		ring->next = (mge_log_ring_t*)mge_atomic_load_ptr(&mge_log_rings);
+	while (!mge_atomic_cas_ptr(&mge_log_rings, ring->next, ring));
+
+	mge_current_log_ring = ring;
+	return ring;
+}
+
+static void mge_write_log_chunk(mge_log_ring_t* ring, mgl_u32_t channel, const mgl_chr8_t* msg, mgl_u64_t msg_size)
+{
+	if (ring->dropping)
+		return;
+
+	mgl_u64_t size = (MGE_LOG_CHUNK_HEADER_SIZE + msg_size + 1 + 7) & ~(mgl_u64_t)7;
+	mgl_u64_t offset = ring->write & (MGE_LOG_RING_SIZE - 1);
+	mgl_u64_t wrap_size = offset + size > MGE_LOG_RING_SIZE ? MGE_LOG_RING_SIZE - offset : 0;
+
+	// Wait for the log thread to write the published lines. If the unfinished line doesn't fit even then, it is dropped,
+	// since publishing only part of it would let it be interleaved with other threads' lines
+	while (ring->write + wrap_size + size - (mgl_u64_t)mge_atomic_load_i64(&ring->tail) > MGE_LOG_RING_SIZE)
+	{
+		mgl_u64_t head = (mgl_u64_t)ring->head;
+		if ((mgl_u64_t)mge_atomic_load_i64(&ring->tail) == head)
+		{
+			ring->write = head;
+			ring->dropping = MGL_TRUE;
+			return;
+		}
+		mge_internal_yield_thread();
+	}
+
+	if (wrap_size != 0)
+	{
+		*(mgl_u32_t*)(ring->data + offset) = MGE_LOG_WRAP_CHANNEL;
+		ring->write += wrap_size;
+		offset = 0;
+	}
+
+	mgl_u32_t* header = (mgl_u32_t*)(ring->data + offset);
+	header[0] = channel;
+	header[1] = (mgl_u32_t)size;
+	mgl_mem_copy(ring->data + offset + MGE_LOG_CHUNK_HEADER_SIZE, msg, msg_size);
+	ring->data[offset + MGE_LOG_CHUNK_HEADER_SIZE + msg_size] = 0;
+	ring->write += size;
+}
+
+static void mge_report_dropped_log_lines(mge_log_ring_t* ring)
+{
+	mgl_i64_t dropped_count = mge_atomic_load_i64(&ring->dropped_count);
+	if (dropped_count == ring->reported_dropped_count)
+		return;
+
+	mgl_chr8_t count[24];
+	mgl_u64_t i = sizeof(count) - 1;
+	count[i] = 0;
+	for (mgl_u64_t n = (mgl_u64_t)(dropped_count - ring->reported_dropped_count); n != 0 || i == sizeof(count) - 1; n /= 10)
+		count[--i] = (mgl_chr8_t)('0' + n % 10);
+	ring->reported_dropped_count = dropped_count;
+
+	mgl_logger_add(mge_engine_logger, u8"Dropped ");
+	mgl_logger_add(mge_engine_logger, count + i);
+	mgl_logger_add(mge_engine_logger, u8" log lines which didn't fit on the log ring\n");
+}
+
+static mgl_bool_t mge_drain_log_ring(mge_log_ring_t* ring)
+{
+	mge_report_dropped_log_lines(ring);
+
+	mgl_u64_t tail = (mgl_u64_t)ring->tail;
+	mgl_u64_t head = (mgl_u64_t)mge_atomic_load_i64(&ring->head);
+	if (tail == head)
+		return MGL_FALSE;
+
+	while (tail != head)
+	{
+		mgl_u64_t offset = tail & (MGE_LOG_RING_SIZE - 1);
+		mgl_u32_t* header = (mgl_u32_t*)(ring->data + offset);
+		if (header[0] == MGE_LOG_WRAP_CHANNEL)
+			tail += MGE_LOG_RING_SIZE - offset;
+		else
+		{
+			mgl_logger_add(mge_get_logger(header[0]), (const mgl_chr8_t*)(header + 2));
+			tail += header[1];
+		}
+	}
+
+	mge_atomic_store_i64(&ring->tail, (mgl_i64_t)tail);
+	return MGL_TRUE;
+}
+
+static mgl_bool_t mge_drain_log_rings(void)
+{
+	mgl_bool_t drained = MGL_FALSE;
+	for (mge_log_ring_t* ring = (mge_log_ring_t*)mge_atomic_load_ptr(&mge_log_rings); ring != NULL; ring = ring->next)
+		drained |= mge_drain_log_ring(ring);
+	return drained;
+}
+
+// Must only be called once the log thread stopped. Producers which saw the log running before it stopped are still
+// writing to their rings, so this keeps draining (making room for them) until none is in use, and then once more
+static void mge_drain_log_rings_until_unused(void)
+{
+	for (;;)
+	{
+		mgl_bool_t in_use = MGL_FALSE;
+		for (mge_log_ring_t* ring = (mge_log_ring_t*)mge_atomic_load_ptr(&mge_log_rings); ring != NULL; ring = ring->next)
+			in_use |= mge_atomic_load_i32(&ring->in_use) != 0;
+		mge_drain_log_rings();
+		if (!in_use)
+			break;
+		mge_internal_yield_thread();
+	}
+}
+
+static void mge_free_log_rings(void)
+{
+	mge_log_ring_t* ring = (mge_log_ring_t*)mge_atomic_load_ptr(&mge_log_rings);
+	mge_atomic_store_ptr(&mge_log_rings, NULL);
+	mge_current_log_ring = NULL;
+
+	while (ring != NULL)
+	{
+		mge_log_ring_t* next = ring->next;
+		mgl_error_t err = mgl_deallocate(mgl_standard_allocator, ring->data);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate log ring data", err);
+		err = mgl_deallocate(mgl_standard_allocator, ring);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate log ring", err);
+		ring = next;
+	}
+}
+
+static void mge_log_thread_main(void* arg)
+{
+	mgl_u64_t idle_count = 0;
+	while (mge_atomic_load_i32(&mge_log_running))
+	{
+		if (mge_drain_log_rings())
+			idle_count = 0;
+		else if (++idle_count < MGE_LOG_IDLE_SPIN_COUNT)
+			mge_cpu_relax();
+		else if (idle_count < MGE_LOG_IDLE_YIELD_COUNT)
+			mge_internal_yield_thread();
+		else
+			mge_sleep(MGE_LOG_IDLE_SLEEP_TIME);
+	}
+}
+
+#endif
+
 void mge_internal_init_log(void)
 {
 	mge_engine_logger = mgl_logger_open(mgl_standard_allocator, u8"engine");
 	mge_game_client_logger = mgl_logger_open(mgl_standard_allocator, u8"game_client");
 	mge_game_server_logger = mgl_logger_open(mgl_standard_allocator, u8"game_server");
+
+#ifdef MGE_ASYNC_LOG
+	mge_atomic_store_i32(&mge_log_running, 1);
+	mge_internal_create_thread(&mge_log_thread, &mge_log_thread_main, NULL);
+#endif
 }
 
-void mge_internal_terminate_log(void)
+// Rings are only freed on a normal termination, since on fatal errors other threads may still be logging until the abort
+static void mge_terminate_log(mgl_bool_t free_rings)
 {
+	// A fatal error while terminating the log (from the thread which terminates it) can't wait for itself
+	if (mge_terminating_log)
+		return;
+
+#ifdef MGE_ASYNC_LOG
+	// Publish this thread's unfinished line, the other threads' rings are only written up to their published lines
+	if (mge_current_log_ring != NULL && !mge_current_log_ring->dropping)
+		mge_atomic_store_i64(&mge_current_log_ring->head, (mgl_i64_t)mge_current_log_ring->write);
+#endif
+
+	// Other callers wait until the first one has written everything and closed the loggers
+	if (!mge_atomic_cas_i32(&mge_log_state, MGE_LOG_ACTIVE, MGE_LOG_TERMINATING))
+	{
+		while (mge_atomic_load_i32(&mge_log_state) != MGE_LOG_TERMINATED)
+			mge_internal_yield_thread();
+		return;
+	}
+	mge_terminating_log = MGL_TRUE;
+
+#ifdef MGE_ASYNC_LOG
+	// Stop the log thread, and then write what is left as the only consumer
+	if (mge_atomic_cas_i32(&mge_log_running, 1, 0))
+		mge_internal_join_thread(&mge_log_thread);
+	mge_drain_log_rings_until_unused();
+	if (free_rings)
+		mge_free_log_rings();
+#endif
+
 	mgl_logger_close(mge_game_server_logger);
 	mgl_logger_close(mge_game_client_logger);
 	mgl_logger_close(mge_engine_logger);
+
+	mge_terminating_log = MGL_FALSE;
+	mge_atomic_store_i32(&mge_log_state, MGE_LOG_TERMINATED);
+}
+
+void mge_internal_terminate_log(void)
+{
+	mge_terminate_log(MGL_TRUE);
 }
 
 void mge_log(mgl_enum_t log, const mgl_chr8_t * msg)
 {
 	MGL_DEBUG_ASSERT(msg != NULL);
 
-	switch (log)
+	if (log != MGE_LOG_ENGINE && log != MGE_LOG_GAME_CLIENT && log != MGE_LOG_GAME_SERVER)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to log message, invalid log channel");
+
+#ifdef MGE_ASYNC_LOG
+	// The ring is marked as in use before checking if the log is running, so that either termination waits for this
+	// message, or the message sees the log stopped and is written directly
+	mge_log_ring_t* ring = mge_atomic_load_i32(&mge_log_running) ? mge_get_log_ring() : NULL;
+	if (ring != NULL)
 	{
-		case MGE_LOG_ENGINE: mgl_logger_add(mge_engine_logger, msg); return;
-		case MGE_LOG_GAME_CLIENT: mgl_logger_add(mge_game_client_logger, msg); return;
-		case MGE_LOG_GAME_SERVER: mgl_logger_add(mge_game_server_logger, msg); return;
-		default: mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to log message, invalid log channel"); return;
+		mge_atomic_store_i32(&ring->in_use, 1);
+		if (mge_atomic_load_i32(&mge_log_running))
+		{
+			// Long messages are split into several chunks
+			mgl_u64_t size = mgl_str_size(msg);
+			mgl_u64_t max_size = MGE_LOG_MAX_CHUNK_SIZE - MGE_LOG_CHUNK_HEADER_SIZE - 1;
+			for (mgl_u64_t i = 0; i < size; i += max_size)
+				mge_write_log_chunk(ring, (mgl_u32_t)log, msg + i, size - i < max_size ? size - i : max_size);
+
+			// Lines are only published once complete, so that messages logged in parts are never interleaved with other threads
+			if (size > 0 && msg[size - 1] == '\n')
+			{
+				if (ring->dropping)
+				{
+					ring->dropping = MGL_FALSE;
+					mge_atomic_add_i64(&ring->dropped_count, 1);
+				}
+				else
+					mge_atomic_store_i64(&ring->head, (mgl_i64_t)ring->write);
+			}
+			mge_atomic_store_i32(&ring->in_use, 0);
+			return;
+		}
+		mge_atomic_store_i32(&ring->in_use, 0);
 	}
+#endif
+
+	// Without a log thread, write directly
+	mgl_logger_add(mge_get_logger(log), msg);
 }
 
 void mge_fatal_error(mgl_enum_t log, const mgl_chr8_t * msg)
 {
 	MGL_DEBUG_ASSERT(msg != NULL);
-	
+
 	mge_log(log, u8"FATAL ERROR: ");
 	mge_log(log, msg);
 	mge_log(log, u8"\n");
 
-	mge_internal_terminate_log();
+	mge_terminate_log(MGL_FALSE);
 	mgl_abort();
 }
 
 void mge_fatal_mgl_error(mgl_enum_t log, const mgl_chr8_t * msg, mgl_error_t err)
 {
 	MGL_DEBUG_ASSERT(msg != NULL);
-	
+
 	mge_log(log, u8"FATAL MGL ERROR: ");
 	mge_log(log, msg);
 	mge_log(log, u8" (");
@@ -57,6 +382,6 @@ void mge_fatal_mgl_error(mgl_enum_t log, const mgl_chr8_t * msg, mgl_error_t err
 	mge_log(log, u8")");
 	mge_log(log, u8"\n");
 
-	mge_internal_terminate_log();
+	mge_terminate_log(MGL_FALSE);
 	mgl_abort();
 }
@@ -0,0 +1,238 @@
+#include <mge/loop.h>
+#include <mge/config.h>
+#include <mge/game.h>
+#include <mge/time.h>
+#include <mge/log.h>
+#include <mge/profile.h>
+
+#include <mge/scene/manager.h>
+#include <mge/scene/command.h>
+#include <mge/scene/journal.h>
+#include <mge/scene/scheduler.h>
+#include <mge/memory/frame.h>
+#include <mge/memory/tracking.h>
+
+#include <mge/platform/atomic.h>
+#include <mge/platform/thread.h>
+
+#include <mgl/memory/allocator.h>
+
+// The frame pacer sleeps in short steps while more time than the longest recent step is left, and only yields for the
+// rest, since sleeps overshoot by an amount which depends on the OS scheduler
+#define MGE_LOOP_SLEEP_STEP_TIME 1000000ull
+#define MGE_LOOP_INITIAL_SLEEP_ESTIMATE 2000000ull
+
+struct mge_loop_t
+{
+	void* allocator;
+
+	mgl_u64_t target_frame_time;
+	mgl_u64_t fixed_update_time;
+	mgl_u64_t max_fixed_update_count;
+	mgl_u64_t frame_cap;
+	mgl_bool_t headless;
+	mgl_u64_t profile_frame_count;
+	mgl_u64_t memory_steady_frame;
+
+	// Longest recent sleep step, decaying so that a single late wake-up doesn't make the pacer yield for long
+	mgl_u64_t sleep_estimate;
+
+	mge_atomic_i32_t running;
+	mge_frame_info_t frame;
+};
+
+static void mge_wait_until(mge_loop_t* loop, mgl_u64_t deadline)
+{
+	// Sleep most of the remaining time in one go, and then in steps, measuring how long each step actually takes
+	mgl_u64_t now = mge_get_time();
+	if (now < deadline && deadline - now > loop->sleep_estimate + MGE_LOOP_SLEEP_STEP_TIME)
+	{
+		mge_sleep(deadline - now - loop->sleep_estimate);
+		now = mge_get_time();
+	}
+
+	while (now < deadline && deadline - now > loop->sleep_estimate)
+	{
+		mge_sleep(MGE_LOOP_SLEEP_STEP_TIME);
+		mgl_u64_t slept = mge_get_time() - now;
+		now += slept;
+
+		loop->sleep_estimate -= loop->sleep_estimate / 16;
+		if (slept > loop->sleep_estimate)
+			loop->sleep_estimate = slept;
+	}
+
+	// Yield for the last stretch
+	while (mge_get_time() < deadline)
+		mge_internal_yield_thread();
+}
+
+mge_loop_t * mge_init_loop(void * allocator, const mge_engine_config_t * config)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL && config != NULL);
+	if (config->fixed_update_rate == 0)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to initialize main loop, fixed update rate must not be zero");
+
+	mge_loop_t* loop;
+
+	// Allocate loop
+	mgl_error_t err = mgl_allocate(allocator, sizeof(mge_loop_t), (void**)&loop);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate main loop", err);
+
+	loop->allocator = allocator;
+	loop->target_frame_time = config->target_frame_rate > 0 ? MGE_NANOSECONDS_PER_SECOND / config->target_frame_rate : 0;
+	loop->fixed_update_time = MGE_NANOSECONDS_PER_SECOND / config->fixed_update_rate;
+	loop->max_fixed_update_count = config->max_fixed_update_count > 0 ? config->max_fixed_update_count : 1;
+	loop->frame_cap = config->frame_cap;
+	loop->headless = config->headless;
+	loop->profile_frame_count = config->profile_frame_count;
+	loop->memory_steady_frame = config->memory_steady_frame;
+	loop->sleep_estimate = MGE_LOOP_INITIAL_SLEEP_ESTIMATE;
+	mge_atomic_store_i32(&loop->running, 0);
+
+	loop->frame.index = 0;
+	loop->frame.time = 0;
+	loop->frame.delta_time = 0.0;
+	loop->frame.fixed_delta_time = (mgl_f64_t)loop->fixed_update_time / MGE_NANOSECONDS_PER_SECOND;
+	loop->frame.interpolation = 0.0;
+	loop->frame.fixed_update_count = 0;
+	loop->frame.dropped_fixed_update_count = 0;
+	loop->frame.phase_time.fixed_update = 0;
+	loop->frame.phase_time.update = 0;
+	loop->frame.phase_time.idle = 0;
+	loop->frame.phase_time.frame = 0;
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully initialized main loop\n");
+
+	return loop;
+}
+
+void mge_terminate_loop(mge_loop_t * loop)
+{
+	MGL_DEBUG_ASSERT(loop != NULL);
+
+	// Deallocate loop
+	mgl_error_t err = mgl_deallocate(loop->allocator, loop);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate main loop", err);
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully terminated main loop\n");
+}
+
+void mge_run_loop(mge_loop_t * loop, mge_game_locator_t * locator)
+{
+	MGL_DEBUG_ASSERT(loop != NULL && locator != NULL);
+
+	mge_atomic_store_i32(&loop->running, 1);
+
+	// In headless mode the simulation clock advances by exactly one frame per frame,
+	// so server and benchmark runs are deterministic no matter how long frames take
+	mgl_u64_t headless_frame_time = loop->target_frame_time > 0 ? loop->target_frame_time : loop->fixed_update_time;
+
+	mgl_u64_t accumulator = 0;
+	mgl_u64_t last_frame_start = mge_get_time();
+	mgl_u64_t next_frame_start = last_frame_start;
+
+	while (mge_atomic_load_i32(&loop->running))
+	{
+		if (loop->frame_cap != 0 && loop->frame.index >= loop->frame_cap)
+			break;
+
+		if (loop->memory_steady_frame != 0 && loop->frame.index == loop->memory_steady_frame)
+			mge_enter_steady_memory_state();
+
+		MGE_PROFILE_BEGIN(u8"Frame");
+		mgl_u64_t frame_start = mge_get_time();
+		mgl_u64_t delta_time = loop->headless ? headless_frame_time : frame_start - last_frame_start;
+		last_frame_start = frame_start;
+
+		// Fixed-rate simulation
+		MGE_PROFILE_BEGIN(u8"Fixed updates");
+		accumulator += delta_time;
+		loop->frame.fixed_update_count = 0;
+		while (accumulator >= loop->fixed_update_time && loop->frame.fixed_update_count < loop->max_fixed_update_count)
+		{
+			MGE_PROFILE_BEGIN(u8"Game fixed update");
+			mge_game_fixed_update(locator);
+			MGE_PROFILE_END();
+			accumulator -= loop->fixed_update_time;
+			loop->frame.fixed_update_count += 1;
+		}
+
+		// Catch-up limit reached, drop the remaining steps instead of spiraling
+		if (accumulator >= loop->fixed_update_time)
+		{
+			loop->frame.dropped_fixed_update_count += accumulator / loop->fixed_update_time;
+			accumulator %= loop->fixed_update_time;
+		}
+		MGE_PROFILE_END();
+
+		mgl_u64_t fixed_update_end = mge_get_time();
+
+		// Variable-rate update
+		loop->frame.time += delta_time;
+		loop->frame.delta_time = (mgl_f64_t)delta_time / MGE_NANOSECONDS_PER_SECOND;
+		loop->frame.interpolation = (mgl_f64_t)accumulator / (mgl_f64_t)loop->fixed_update_time;
+		MGE_PROFILE_BEGIN(u8"Game update");
+		mge_game_update(locator);
+		MGE_PROFILE_END();
+		MGE_PROFILE_BEGIN(u8"Scene updates");
+		mge_run_scene_updates(locator->scene_scheduler, loop->frame.time);
+		MGE_PROFILE_END();
+		MGE_PROFILE_BEGIN(u8"Scene commands");
+		mge_apply_scene_commands(locator->scene_commands);
+		MGE_PROFILE_END();
+		MGE_PROFILE_BEGIN(u8"Scene node destruction");
+		mge_flush_scene_node_destroy_queue(locator->scene_manager);
+		MGE_PROFILE_END();
+		MGE_PROFILE_BEGIN(u8"Scene transforms");
+		mge_update_scene_transforms(locator->scene_manager);
+		MGE_PROFILE_END();
+		mge_publish_scene_journal(locator->scene_manager);
+
+		mgl_u64_t update_end = mge_get_time();
+
+		// Frame pacing
+		MGE_PROFILE_BEGIN(u8"Frame pacing");
+		if (loop->target_frame_time > 0)
+		{
+			next_frame_start += loop->target_frame_time;
+			if (next_frame_start < update_end)
+				next_frame_start = update_end; // Running behind, don't try to make up for lost frames
+			else
+				mge_wait_until(loop, next_frame_start);
+		}
+		MGE_PROFILE_END();
+
+		mgl_u64_t frame_end = mge_get_time();
+
+		loop->frame.phase_time.fixed_update = fixed_update_end - frame_start;
+		loop->frame.phase_time.update = update_end - fixed_update_end;
+		loop->frame.phase_time.idle = frame_end - update_end;
+		loop->frame.phase_time.frame = frame_end - frame_start;
+		loop->frame.index += 1;
+
+		// Release the temporaries allocated on the frame before this one
+		mge_swap_frame_allocator(locator->frame_allocator);
+		MGE_PROFILE_END();
+
+		// The profile capture started by -mge-profile covers the startup and the first frames
+		if (loop->profile_frame_count != 0 && loop->frame.index == loop->profile_frame_count)
+			mge_finish_profile_capture(MGE_PROFILE_TRACE_PATH);
+	}
+
+	mge_atomic_store_i32(&loop->running, 0);
+}
+
+void mge_stop_loop(mge_loop_t * loop)
+{
+	MGL_DEBUG_ASSERT(loop != NULL);
+	mge_atomic_store_i32(&loop->running, 0);
+}
+
+const mge_frame_info_t * mge_get_frame_info(mge_loop_t * loop)
+{
+	MGL_DEBUG_ASSERT(loop != NULL);
+	return &loop->frame;
+}
@@ -0,0 +1,163 @@
+#include <mge/memory/frame.h>
+#include <mge/log.h>
+
+#include <mge/platform/atomic.h>
+
+#include <mgl/memory/allocator.h>
+#include <mgl/memory/manipulation.h>
+
+// Every allocation is aligned to at least this
+#define MGE_FRAME_ALLOCATOR_ALIGN 16
+
+struct mge_frame_allocator_t
+{
+	// Must be the first member, so that a frame allocator can be used as an MGL allocator
+	mgl_allocator_t base;
+
+	void* allocator;
+	mgl_u64_t size;
+	mgl_u8_t* buffers[2];
+	mgl_u64_t current;
+
+	mge_atomic_i64_t offset;
+	mgl_u64_t peak_size;
+};
+
+static mgl_error_t mge_frame_allocate_aligned(void* allocator, mgl_u64_t size, mgl_u64_t align, void** out_ptr)
+{
+	mge_frame_allocator_t* frame = (mge_frame_allocator_t*)allocator;
+	MGL_DEBUG_ASSERT(align > 0 && (align & (align - 1)) == 0);
+	if (align < MGE_FRAME_ALLOCATOR_ALIGN)
+		align = MGE_FRAME_ALLOCATOR_ALIGN;
+
+	// Bump by enough to align the pointer inside the reserved range, since other threads may bump at the same time
+	mgl_u64_t reserved = (size + MGE_FRAME_ALLOCATOR_ALIGN - 1) / MGE_FRAME_ALLOCATOR_ALIGN * MGE_FRAME_ALLOCATOR_ALIGN + align - MGE_FRAME_ALLOCATOR_ALIGN;
+	mgl_u64_t end = (mgl_u64_t)mge_atomic_add_i64(&frame->offset, (mgl_i64_t)reserved);
+	if (end > frame->size)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to allocate on frame allocator, frame allocator size surpassed");
+
+	mgl_u64_t address = (mgl_u64_t)(frame->buffers[frame->current] + end - reserved);
+	*out_ptr = (void*)((address + align - 1) & ~(align - 1));
+	return MGL_ERROR_NONE;
+}
+
+static mgl_error_t mge_frame_deallocate_aligned(void* allocator, void* ptr)
+{
+	(void)allocator;
+	(void)ptr;
+
+	// Memory is released when the buffers swap
+	return MGL_ERROR_NONE;
+}
+
+static mgl_error_t mge_frame_allocate(void* allocator, mgl_u64_t size, void** out_ptr)
+{
+	return mge_frame_allocate_aligned(allocator, size, MGE_FRAME_ALLOCATOR_ALIGN, out_ptr);
+}
+
+static mgl_error_t mge_frame_reallocate(void* allocator, void* ptr, mgl_u64_t old_size, mgl_u64_t new_size, void** out_ptr)
+{
+	if (ptr != NULL && new_size <= old_size)
+	{
+		*out_ptr = ptr;
+		return MGL_ERROR_NONE;
+	}
+
+	void* new_ptr;
+	mgl_error_t err = mge_frame_allocate(allocator, new_size, &new_ptr);
+	if (err != MGL_ERROR_NONE)
+		return err;
+
+	if (ptr != NULL)
+		mgl_mem_copy(new_ptr, ptr, old_size);
+
+	*out_ptr = new_ptr;
+	return MGL_ERROR_NONE;
+}
+
+static mgl_error_t mge_frame_deallocate(void* allocator, void* ptr)
+{
+	(void)allocator;
+	(void)ptr;
+	return MGL_ERROR_NONE;
+}
+
+static mgl_allocator_functions_t mge_frame_allocator_functions =
+{
+	&mge_frame_allocate,
+	&mge_frame_reallocate,
+	&mge_frame_deallocate,
+	&mge_frame_allocate_aligned,
+	&mge_frame_deallocate_aligned,
+};
+
+mge_frame_allocator_t * mge_init_frame_allocator(void * allocator, mgl_u64_t size)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL && size > 0);
+
+	mge_frame_allocator_t* frame;
+
+	// Allocate frame allocator
+	mgl_error_t err = mgl_allocate(allocator, sizeof(mge_frame_allocator_t), (void**)&frame);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate frame allocator", err);
+
+	// Allocate buffers
+	for (mgl_u64_t i = 0; i < 2; ++i)
+	{
+		err = mgl_allocate_aligned(allocator, size, 64, (void**)&frame->buffers[i]);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate buffer on frame allocator", err);
+	}
+
+	frame->base.functions = &mge_frame_allocator_functions;
+	frame->allocator = allocator;
+	frame->size = size;
+	frame->current = 0;
+	frame->offset = 0;
+	frame->peak_size = 0;
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully initialized frame allocator\n");
+
+	return frame;
+}
+
+void mge_terminate_frame_allocator(mge_frame_allocator_t * allocator)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL);
+
+	// Deallocate buffers
+	for (mgl_u64_t i = 0; i < 2; ++i)
+	{
+		mgl_error_t err = mgl_deallocate_aligned(allocator->allocator, allocator->buffers[i]);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate buffer on frame allocator", err);
+	}
+
+	// Deallocate frame allocator
+	mgl_error_t err = mgl_deallocate(allocator->allocator, allocator);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate frame allocator", err);
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully terminated frame allocator\n");
+}
+
+void mge_swap_frame_allocator(mge_frame_allocator_t * allocator)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL);
+
+	mgl_u64_t size = (mgl_u64_t)mge_atomic_load_i64(&allocator->offset);
+	if (size > allocator->peak_size)
+		allocator->peak_size = size;
+
+	allocator->current ^= 1;
+	mge_atomic_store_i64(&allocator->offset, 0);
+}
+
+mgl_u64_t mge_get_frame_allocator_peak_size(mge_frame_allocator_t * allocator)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL);
+
+	mgl_u64_t size = (mgl_u64_t)mge_atomic_load_i64(&allocator->offset);
+	return size > allocator->peak_size ? size : allocator->peak_size;
+}
@@ -0,0 +1,293 @@
+#include <mge/memory/pool.h>
+#include <mge/log.h>
+
+#include <mge/platform/atomic.h>
+#include <mge/platform/thread.h>
+
+#include <mgl/memory/allocator.h>
+
+// Blocks are aligned to this, so any allocation aligned to it or less can be made on a pool
+#define MGE_POOL_BLOCK_ALIGN 16
+
+// Chunks start with a header with the next chunk, and are aligned to a cache line
+#define MGE_POOL_CHUNK_HEADER_SIZE 64
+
+// Number of blocks moved at once between a thread cache and the global free list.
+// A thread cache gives a batch back when it holds twice as many blocks.
+#define MGE_POOL_BATCH_SIZE 32
+
+typedef struct mge_pool_block_t mge_pool_block_t;
+
+struct mge_pool_block_t
+{
+	mge_pool_block_t* next;
+};
+
+typedef struct
+{
+	// Only accessed by its thread, padded to a cache line so that threads don't share lines
+	mge_pool_block_t* free_blocks;
+	mgl_u64_t free_block_count;
+	mgl_u8_t padding[64 - sizeof(mge_pool_block_t*) - sizeof(mgl_u64_t)];
+} mge_pool_cache_t;
+
+struct mge_pool_allocator_t
+{
+	// Must be the first member, so that a pool allocator can be used as an MGL allocator
+	mgl_allocator_t base;
+
+	void* allocator;
+	mgl_u64_t block_size;
+	mgl_u64_t chunk_block_count;
+
+	// Protects the global free list and the chunk list
+	mge_atomic_i32_t lock;
+	mge_pool_block_t* free_blocks;
+	void* chunks;
+
+	mge_pool_cache_t caches[MGE_MAX_POOL_THREAD_COUNT];
+};
+
+// Each thread gets the same cache index on every pool allocator
+static mge_atomic_i32_t mge_pool_thread_count = 0;
+static MGE_THREAD_LOCAL mgl_i32_t mge_pool_thread_index = 0; // Index plus one, 0 until the thread uses a pool
+
+static void mge_lock_pool(mge_pool_allocator_t* pool)
+{
+	while (!mge_atomic_cas_i32(&pool->lock, 0, 1))
+		mge_internal_yield_thread();
+}
+
+static void mge_unlock_pool(mge_pool_allocator_t* pool)
+{
+	mge_atomic_store_i32(&pool->lock, 0);
+}
+
+static mge_pool_cache_t* mge_get_pool_cache(mge_pool_allocator_t* pool)
+{
+	if (mge_pool_thread_index == 0)
+		mge_pool_thread_index = mge_atomic_add_i32(&mge_pool_thread_count, 1);
+	if (mge_pool_thread_index > MGE_MAX_POOL_THREAD_COUNT)
+		return NULL;
+	return &pool->caches[mge_pool_thread_index - 1];
+}
+
+// Must hold the pool lock
+static mgl_error_t mge_grow_pool(mge_pool_allocator_t* pool)
+{
+	mgl_u8_t* chunk;
+	mgl_error_t err = mgl_allocate_aligned(pool->allocator, MGE_POOL_CHUNK_HEADER_SIZE + pool->block_size * pool->chunk_block_count, MGE_POOL_CHUNK_HEADER_SIZE, (void**)&chunk);
+	if (err != MGL_ERROR_NONE)
+		return err;
+
+	*(void**)chunk = pool->chunks;
+	pool->chunks = chunk;
+
+	// Push the blocks backwards, so that they are handed out in address order
+	mgl_u8_t* blocks = chunk + MGE_POOL_CHUNK_HEADER_SIZE;
+	for (mgl_u64_t i = pool->chunk_block_count; i > 0; --i)
+	{
+		mge_pool_block_t* block = (mge_pool_block_t*)(blocks + (i - 1) * pool->block_size);
+		block->next = pool->free_blocks;
+		pool->free_blocks = block;
+	}
+
+	return MGL_ERROR_NONE;
+}
+
+// Must hold the pool lock
+static mgl_error_t mge_take_pool_blocks(mge_pool_allocator_t* pool, mgl_u64_t count, mge_pool_block_t** out_blocks, mgl_u64_t* out_count)
+{
+	if (pool->free_blocks == NULL)
+	{
+		mgl_error_t err = mge_grow_pool(pool);
+		if (err != MGL_ERROR_NONE)
+			return err;
+	}
+
+	mge_pool_block_t* last = pool->free_blocks;
+	mgl_u64_t taken = 1;
+	while (taken < count && last->next != NULL)
+	{
+		last = last->next;
+		taken += 1;
+	}
+
+	*out_blocks = pool->free_blocks;
+	*out_count = taken;
+	pool->free_blocks = last->next;
+	last->next = NULL;
+	return MGL_ERROR_NONE;
+}
+
+static mgl_error_t mge_pool_allocate(void* allocator, mgl_u64_t size, void** out_ptr)
+{
+	mge_pool_allocator_t* pool = (mge_pool_allocator_t*)allocator;
+	if (size > pool->block_size)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to allocate on pool allocator, size bigger than the block size");
+
+	mge_pool_cache_t* cache = mge_get_pool_cache(pool);
+	mgl_error_t err;
+
+	// Threads without a cache take single blocks from the global free list
+	if (cache == NULL)
+	{
+		mge_pool_block_t* block;
+		mgl_u64_t count;
+		mge_lock_pool(pool);
+		err = mge_take_pool_blocks(pool, 1, &block, &count);
+		mge_unlock_pool(pool);
+		if (err != MGL_ERROR_NONE)
+			return err;
+
+		*out_ptr = block;
+		return MGL_ERROR_NONE;
+	}
+
+	// Refill the cache with a batch
+	if (cache->free_blocks == NULL)
+	{
+		mge_lock_pool(pool);
+		err = mge_take_pool_blocks(pool, MGE_POOL_BATCH_SIZE, &cache->free_blocks, &cache->free_block_count);
+		mge_unlock_pool(pool);
+		if (err != MGL_ERROR_NONE)
+			return err;
+	}
+
+	mge_pool_block_t* block = cache->free_blocks;
+	cache->free_blocks = block->next;
+	cache->free_block_count -= 1;
+
+	*out_ptr = block;
+	return MGL_ERROR_NONE;
+}
+
+static mgl_error_t mge_pool_deallocate(void* allocator, void* ptr)
+{
+	mge_pool_allocator_t* pool = (mge_pool_allocator_t*)allocator;
+	mge_pool_block_t* block = (mge_pool_block_t*)ptr;
+	mge_pool_cache_t* cache = mge_get_pool_cache(pool);
+
+	if (cache == NULL)
+	{
+		mge_lock_pool(pool);
+		block->next = pool->free_blocks;
+		pool->free_blocks = block;
+		mge_unlock_pool(pool);
+		return MGL_ERROR_NONE;
+	}
+
+	// Blocks go to the cache of the thread which deallocates them, not the one which allocated them
+	block->next = cache->free_blocks;
+	cache->free_blocks = block;
+	cache->free_block_count += 1;
+
+	// Give a batch back, so that blocks deallocated on one thread can be used by others
+	if (cache->free_block_count >= 2 * MGE_POOL_BATCH_SIZE)
+	{
+		mge_pool_block_t* first = cache->free_blocks;
+		mge_pool_block_t* last = first;
+		for (mgl_u64_t i = 1; i < MGE_POOL_BATCH_SIZE; ++i)
+			last = last->next;
+		cache->free_blocks = last->next;
+		cache->free_block_count -= MGE_POOL_BATCH_SIZE;
+
+		mge_lock_pool(pool);
+		last->next = pool->free_blocks;
+		pool->free_blocks = first;
+		mge_unlock_pool(pool);
+	}
+
+	return MGL_ERROR_NONE;
+}
+
+static mgl_error_t mge_pool_reallocate(void* allocator, void* ptr, mgl_u64_t old_size, mgl_u64_t new_size, void** out_ptr)
+{
+	(void)old_size;
+	mge_pool_allocator_t* pool = (mge_pool_allocator_t*)allocator;
+	if (ptr == NULL)
+		return mge_pool_allocate(allocator, new_size, out_ptr);
+	if (new_size > pool->block_size)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to reallocate on pool allocator, size bigger than the block size");
+
+	// Every block has the same size, so the block is kept
+	*out_ptr = ptr;
+	return MGL_ERROR_NONE;
+}
+
+static mgl_error_t mge_pool_allocate_aligned(void* allocator, mgl_u64_t size, mgl_u64_t align, void** out_ptr)
+{
+	if (align > MGE_POOL_BLOCK_ALIGN)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to allocate on pool allocator, alignment bigger than the block alignment");
+	return mge_pool_allocate(allocator, size, out_ptr);
+}
+
+static mgl_error_t mge_pool_deallocate_aligned(void* allocator, void* ptr)
+{
+	return mge_pool_deallocate(allocator, ptr);
+}
+
+static mgl_allocator_functions_t mge_pool_allocator_functions =
+{
+	&mge_pool_allocate,
+	&mge_pool_reallocate,
+	&mge_pool_deallocate,
+	&mge_pool_allocate_aligned,
+	&mge_pool_deallocate_aligned,
+};
+
+mge_pool_allocator_t * mge_init_pool_allocator(void * allocator, mgl_u64_t block_size, mgl_u64_t chunk_block_count)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL && block_size > 0 && chunk_block_count > 0);
+
+	mge_pool_allocator_t* pool;
+
+	// Allocate pool allocator, aligned so that each thread cache is on its own cache line
+	mgl_error_t err = mgl_allocate_aligned(allocator, sizeof(mge_pool_allocator_t), 64, (void**)&pool);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate pool allocator", err);
+
+	pool->base.functions = &mge_pool_allocator_functions;
+	pool->allocator = allocator;
+	pool->block_size = (block_size + MGE_POOL_BLOCK_ALIGN - 1) / MGE_POOL_BLOCK_ALIGN * MGE_POOL_BLOCK_ALIGN;
+	pool->chunk_block_count = chunk_block_count;
+	pool->lock = 0;
+	pool->free_blocks = NULL;
+	pool->chunks = NULL;
+
+	for (mgl_u64_t i = 0; i < MGE_MAX_POOL_THREAD_COUNT; ++i)
+	{
+		pool->caches[i].free_blocks = NULL;
+		pool->caches[i].free_block_count = 0;
+	}
+
+	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"Initialized pool allocator\n");
+
+	return pool;
+}
+
+void mge_terminate_pool_allocator(mge_pool_allocator_t * allocator)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL);
+
+	// Deallocate chunks
+	while (allocator->chunks != NULL)
+	{
+		void* chunk = allocator->chunks;
+		allocator->chunks = *(void**)chunk;
+		mgl_error_t err = mgl_deallocate_aligned(allocator->allocator, chunk);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate pool allocator chunk", err);
+	}
+
+	// Deallocate pool allocator
+	mgl_error_t err = mgl_deallocate_aligned(allocator->allocator, allocator);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate pool allocator", err);
+}
+
+mgl_u64_t mge_get_pool_allocator_block_size(mge_pool_allocator_t * allocator)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL);
+	return allocator->block_size;
+}
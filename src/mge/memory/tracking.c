@@ -0,0 +1,312 @@
+#include <mge/memory/tracking.h>
+#include <mge/log.h>
+
+#include <mge/platform/atomic.h>
+#include <mge/platform/thread.h>
+
+#include <mgl/memory/allocator.h>
+#include <mgl/string/manipulation.h>
+
+// Every allocation is preceded by a header with its size and the header size, which is larger for aligned allocations
+#define MGE_TRACKING_HEADER_SIZE 16
+
+struct mge_tracking_allocator_t
+{
+	// Must be the first member, so that a tracking allocator can be used as an MGL allocator
+	mgl_allocator_t base;
+
+	void* allocator;
+	mgl_chr8_t tag[MGE_MAX_MEMORY_TAG_SIZE];
+
+	mge_atomic_i64_t live_bytes;
+	mge_atomic_i64_t live_allocation_count;
+	mge_atomic_i64_t peak_bytes;
+	mge_atomic_i64_t allocation_count;
+	mge_atomic_i64_t steady_allocation_count;
+};
+
+static mge_tracking_allocator_t* mge_tracking_allocators[MGE_MAX_TRACKING_ALLOCATOR_COUNT];
+static mgl_u64_t mge_tracking_allocator_count = 0;
+static mge_atomic_i32_t mge_tracking_allocators_lock = 0;
+static mge_atomic_i32_t mge_steady_memory_state = 0;
+
+static void mge_lock_tracking_allocators(void)
+{
+	while (!mge_atomic_cas_i32(&mge_tracking_allocators_lock, 0, 1))
+		mge_internal_yield_thread();
+}
+
+static void mge_unlock_tracking_allocators(void)
+{
+	mge_atomic_store_i32(&mge_tracking_allocators_lock, 0);
+}
+
+static void mge_log_memory_u64(mgl_u64_t value)
+{
+	mgl_chr8_t digits[21];
+	mgl_u64_t i = sizeof(digits) - 1;
+	digits[i] = 0;
+	do
+	{
+		digits[--i] = (mgl_chr8_t)('0' + value % 10);
+		value /= 10;
+	} while (value != 0);
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, &digits[i]);
+}
+
+static void mge_log_memory_stats_line(const mge_memory_stats_t* stats)
+{
+	mge_log_memory_u64(stats->live_bytes);
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8" bytes live in ");
+	mge_log_memory_u64(stats->live_allocation_count);
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8" allocations, ");
+	mge_log_memory_u64(stats->peak_bytes);
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8" bytes peak, ");
+	mge_log_memory_u64(stats->allocation_count);
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8" allocations total, ");
+	mge_log_memory_u64(stats->steady_allocation_count);
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8" on steady state\n");
+}
+
+static void mge_track_allocation(mge_tracking_allocator_t* allocator, mgl_i64_t size, mgl_i64_t count)
+{
+	mgl_i64_t live_bytes = mge_atomic_add_i64(&allocator->live_bytes, size);
+	mge_atomic_add_i64(&allocator->live_allocation_count, count);
+	mge_atomic_add_i64(&allocator->allocation_count, 1);
+
+	mgl_i64_t peak_bytes = mge_atomic_load_i64(&allocator->peak_bytes);
+	while (live_bytes > peak_bytes && !mge_atomic_cas_i64(&allocator->peak_bytes, peak_bytes, live_bytes))
+		peak_bytes = mge_atomic_load_i64(&allocator->peak_bytes);
+
+	if (mge_atomic_load_i32(&mge_steady_memory_state) && mge_atomic_add_i64(&allocator->steady_allocation_count, 1) == 1)
+	{
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"WARNING: Allocation on '");
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, allocator->tag);
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"' after reaching steady state (only the first one is logged)\n");
+	}
+}
+
+static mgl_error_t mge_tracking_allocate_aligned(void* allocator, mgl_u64_t size, mgl_u64_t align, void** out_ptr)
+{
+	mge_tracking_allocator_t* tracking = (mge_tracking_allocator_t*)allocator;
+
+	mgl_u64_t header_size = align > MGE_TRACKING_HEADER_SIZE ? align : MGE_TRACKING_HEADER_SIZE;
+	mgl_u8_t* ptr;
+	mgl_error_t err = mgl_allocate_aligned(tracking->allocator, header_size + size, header_size, (void**)&ptr);
+	if (err != MGL_ERROR_NONE)
+		return err;
+
+	ptr += header_size;
+	((mgl_u64_t*)ptr)[-2] = size;
+	((mgl_u64_t*)ptr)[-1] = header_size;
+	mge_track_allocation(tracking, (mgl_i64_t)size, 1);
+
+	*out_ptr = ptr;
+	return MGL_ERROR_NONE;
+}
+
+static mgl_error_t mge_tracking_deallocate_aligned(void* allocator, void* ptr)
+{
+	mge_tracking_allocator_t* tracking = (mge_tracking_allocator_t*)allocator;
+
+	mgl_u64_t size = ((mgl_u64_t*)ptr)[-2];
+	mgl_u64_t header_size = ((mgl_u64_t*)ptr)[-1];
+	mgl_error_t err = mgl_deallocate_aligned(tracking->allocator, (mgl_u8_t*)ptr - header_size);
+	if (err != MGL_ERROR_NONE)
+		return err;
+
+	mge_atomic_add_i64(&tracking->live_bytes, -(mgl_i64_t)size);
+	mge_atomic_add_i64(&tracking->live_allocation_count, -1);
+	return MGL_ERROR_NONE;
+}
+
+static mgl_error_t mge_tracking_allocate(void* allocator, mgl_u64_t size, void** out_ptr)
+{
+	mge_tracking_allocator_t* tracking = (mge_tracking_allocator_t*)allocator;
+
+	mgl_u8_t* ptr;
+	mgl_error_t err = mgl_allocate(tracking->allocator, MGE_TRACKING_HEADER_SIZE + size, (void**)&ptr);
+	if (err != MGL_ERROR_NONE)
+		return err;
+
+	ptr += MGE_TRACKING_HEADER_SIZE;
+	((mgl_u64_t*)ptr)[-2] = size;
+	((mgl_u64_t*)ptr)[-1] = MGE_TRACKING_HEADER_SIZE;
+	mge_track_allocation(tracking, (mgl_i64_t)size, 1);
+
+	*out_ptr = ptr;
+	return MGL_ERROR_NONE;
+}
+
+static mgl_error_t mge_tracking_reallocate(void* allocator, void* ptr, mgl_u64_t old_size, mgl_u64_t new_size, void** out_ptr)
+{
+	mge_tracking_allocator_t* tracking = (mge_tracking_allocator_t*)allocator;
+	if (ptr == NULL)
+		return mge_tracking_allocate(allocator, new_size, out_ptr);
+
+	old_size = ((mgl_u64_t*)ptr)[-2];
+	mgl_u8_t* new_ptr;
+	mgl_error_t err = mgl_reallocate(tracking->allocator, (mgl_u8_t*)ptr - MGE_TRACKING_HEADER_SIZE, MGE_TRACKING_HEADER_SIZE + old_size, MGE_TRACKING_HEADER_SIZE + new_size, (void**)&new_ptr);
+	if (err != MGL_ERROR_NONE)
+		return err;
+
+	new_ptr += MGE_TRACKING_HEADER_SIZE;
+	((mgl_u64_t*)new_ptr)[-2] = new_size;
+	mge_track_allocation(tracking, (mgl_i64_t)new_size - (mgl_i64_t)old_size, 0);
+
+	*out_ptr = new_ptr;
+	return MGL_ERROR_NONE;
+}
+
+static mgl_error_t mge_tracking_deallocate(void* allocator, void* ptr)
+{
+	mge_tracking_allocator_t* tracking = (mge_tracking_allocator_t*)allocator;
+
+	mgl_u64_t size = ((mgl_u64_t*)ptr)[-2];
+	mgl_error_t err = mgl_deallocate(tracking->allocator, (mgl_u8_t*)ptr - MGE_TRACKING_HEADER_SIZE);
+	if (err != MGL_ERROR_NONE)
+		return err;
+
+	mge_atomic_add_i64(&tracking->live_bytes, -(mgl_i64_t)size);
+	mge_atomic_add_i64(&tracking->live_allocation_count, -1);
+	return MGL_ERROR_NONE;
+}
+
+static mgl_allocator_functions_t mge_tracking_allocator_functions =
+{
+	&mge_tracking_allocate,
+	&mge_tracking_reallocate,
+	&mge_tracking_deallocate,
+	&mge_tracking_allocate_aligned,
+	&mge_tracking_deallocate_aligned,
+};
+
+mge_tracking_allocator_t * mge_init_tracking_allocator(void * allocator, const mgl_chr8_t * tag)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL && tag != NULL);
+
+	mge_tracking_allocator_t* tracking;
+
+	// Allocate tracking allocator (not tracked by itself)
+	mgl_error_t err = mgl_allocate(allocator, sizeof(mge_tracking_allocator_t), (void**)&tracking);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate tracking allocator", err);
+
+	tracking->base.functions = &mge_tracking_allocator_functions;
+	tracking->allocator = allocator;
+	mgl_str_copy(tag, tracking->tag, MGE_MAX_MEMORY_TAG_SIZE);
+	tracking->live_bytes = 0;
+	tracking->live_allocation_count = 0;
+	tracking->peak_bytes = 0;
+	tracking->allocation_count = 0;
+	tracking->steady_allocation_count = 0;
+
+	// Register it
+	mge_lock_tracking_allocators();
+	if (mge_tracking_allocator_count >= MGE_MAX_TRACKING_ALLOCATOR_COUNT)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to initialize tracking allocator, the maximum tracking allocator count was surpassed");
+	mge_tracking_allocators[mge_tracking_allocator_count++] = tracking;
+	mge_unlock_tracking_allocators();
+
+	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"Initialized tracking allocator '");
+	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, tracking->tag);
+	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"'\n");
+
+	return tracking;
+}
+
+void mge_terminate_tracking_allocator(mge_tracking_allocator_t * allocator)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL);
+
+	if (mge_atomic_load_i64(&allocator->live_allocation_count) != 0)
+	{
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"WARNING: Tracking allocator '");
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, allocator->tag);
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"' terminated with live allocations\n");
+	}
+
+	// Unregister it
+	mge_lock_tracking_allocators();
+	for (mgl_u64_t i = 0; i < mge_tracking_allocator_count; ++i)
+		if (mge_tracking_allocators[i] == allocator)
+		{
+			mge_tracking_allocators[i] = mge_tracking_allocators[--mge_tracking_allocator_count];
+			break;
+		}
+	mge_unlock_tracking_allocators();
+
+	// Deallocate tracking allocator
+	mgl_error_t err = mgl_deallocate(allocator->allocator, allocator);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate tracking allocator", err);
+}
+
+void mge_get_tracking_allocator_stats(mge_tracking_allocator_t * allocator, mge_memory_stats_t * stats)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL && stats != NULL);
+
+	stats->live_bytes = (mgl_u64_t)mge_atomic_load_i64(&allocator->live_bytes);
+	stats->live_allocation_count = (mgl_u64_t)mge_atomic_load_i64(&allocator->live_allocation_count);
+	stats->peak_bytes = (mgl_u64_t)mge_atomic_load_i64(&allocator->peak_bytes);
+	stats->allocation_count = (mgl_u64_t)mge_atomic_load_i64(&allocator->allocation_count);
+	stats->steady_allocation_count = (mgl_u64_t)mge_atomic_load_i64(&allocator->steady_allocation_count);
+}
+
+mgl_bool_t mge_get_memory_stats(const mgl_chr8_t * tag, mge_memory_stats_t * stats)
+{
+	MGL_DEBUG_ASSERT(stats != NULL);
+
+	stats->live_bytes = 0;
+	stats->live_allocation_count = 0;
+	stats->peak_bytes = 0;
+	stats->allocation_count = 0;
+	stats->steady_allocation_count = 0;
+
+	// Peaks of different allocators may not have happened at the same time, so the sum is an upper bound
+	mgl_bool_t found = MGL_FALSE;
+	mge_lock_tracking_allocators();
+	for (mgl_u64_t i = 0; i < mge_tracking_allocator_count; ++i)
+	{
+		if (tag != NULL && !mgl_str_equal(tag, mge_tracking_allocators[i]->tag))
+			continue;
+
+		mge_memory_stats_t allocator_stats;
+		mge_get_tracking_allocator_stats(mge_tracking_allocators[i], &allocator_stats);
+		stats->live_bytes += allocator_stats.live_bytes;
+		stats->live_allocation_count += allocator_stats.live_allocation_count;
+		stats->peak_bytes += allocator_stats.peak_bytes;
+		stats->allocation_count += allocator_stats.allocation_count;
+		stats->steady_allocation_count += allocator_stats.steady_allocation_count;
+		found = MGL_TRUE;
+	}
+	mge_unlock_tracking_allocators();
+
+	return found;
+}
+
+void mge_log_memory_stats(void)
+{
+	mge_memory_stats_t stats;
+
+	mge_lock_tracking_allocators();
+	for (mgl_u64_t i = 0; i < mge_tracking_allocator_count; ++i)
+	{
+		mge_get_tracking_allocator_stats(mge_tracking_allocators[i], &stats);
+		MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Memory '");
+		MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, mge_tracking_allocators[i]->tag);
+		MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"': ");
+		mge_log_memory_stats_line(&stats);
+	}
+	mge_unlock_tracking_allocators();
+
+	mge_get_memory_stats(NULL, &stats);
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Memory total: ");
+	mge_log_memory_stats_line(&stats);
+}
+
+void mge_enter_steady_memory_state(void)
+{
+	mge_atomic_store_i32(&mge_steady_memory_state, 1);
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Entered steady memory state\n");
+}
@@ -0,0 +1,77 @@
+#ifndef MGE_PLATFORM_ATOMIC_H
+#define MGE_PLATFORM_ATOMIC_H
+
+#include <mgl/type.h>
+
+// Internal atomic operations.
+// Every operation is sequentially consistent unless stated otherwise.
+
+typedef volatile mgl_i32_t mge_atomic_i32_t;
+typedef volatile mgl_i64_t mge_atomic_i64_t;
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+
+#	define mge_atomic_load_i32(ptr) (_InterlockedOr((volatile long*)(ptr), 0))
+#	define mge_atomic_store_i32(ptr, value) ((void)_InterlockedExchange((volatile long*)(ptr), (long)(value)))
+#	define mge_atomic_add_i32(ptr, value) (_InterlockedExchangeAdd((volatile long*)(ptr), (long)(value)) + (long)(value))
+#	define mge_atomic_cas_i32(ptr, expected, desired) (_InterlockedCompareExchange((volatile long*)(ptr), (long)(desired), (long)(expected)) == (long)(expected))
+
+#	define mge_atomic_load_i64(ptr) (_InterlockedOr64((volatile __int64*)(ptr), 0))
+#	define mge_atomic_store_i64(ptr, value) ((void)_InterlockedExchange64((volatile __int64*)(ptr), (__int64)(value)))
+#	define mge_atomic_add_i64(ptr, value) (_InterlockedExchangeAdd64((volatile __int64*)(ptr), (__int64)(value)) + (__int64)(value))
+#	define mge_atomic_cas_i64(ptr, expected, desired) (_InterlockedCompareExchange64((volatile __int64*)(ptr), (__int64)(desired), (__int64)(expected)) == (__int64)(expected))
+
+#	define mge_atomic_load_ptr(ptr) ((void*)_InterlockedCompareExchangePointer((void* volatile*)(ptr), NULL, NULL))
+#	define mge_atomic_store_ptr(ptr, value) ((void)_InterlockedExchangePointer((void* volatile*)(ptr), (void*)(value)))
+#	define mge_atomic_cas_ptr(ptr, expected, desired) (_InterlockedCompareExchangePointer((void* volatile*)(ptr), (void*)(desired), (void*)(expected)) == (void*)(expected))
+
+#	define mge_atomic_fence() _mm_mfence()
+#	define mge_cpu_relax() _mm_pause()
+#else
+#	define mge_atomic_load_i32(ptr) __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+#	define mge_atomic_store_i32(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_SEQ_CST)
+#	define mge_atomic_add_i32(ptr, value) __atomic_add_fetch((ptr), (value), __ATOMIC_SEQ_CST)
+#	define mge_atomic_cas_i32(ptr, expected, desired) mge_internal_atomic_cas_i32((ptr), (expected), (desired))
+
+#	define mge_atomic_load_i64(ptr) __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+#	define mge_atomic_store_i64(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_SEQ_CST)
+#	define mge_atomic_add_i64(ptr, value) __atomic_add_fetch((ptr), (value), __ATOMIC_SEQ_CST)
+#	define mge_atomic_cas_i64(ptr, expected, desired) mge_internal_atomic_cas_i64((ptr), (expected), (desired))
+
+#	define mge_atomic_load_ptr(ptr) __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+#	define mge_atomic_store_ptr(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_SEQ_CST)
+#	define mge_atomic_cas_ptr(ptr, expected, desired) mge_internal_atomic_cas_ptr((void* volatile*)(ptr), (void*)(expected), (void*)(desired))
+
+#	define mge_atomic_fence() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#	if defined(__i386__) || defined(__x86_64__)
+#		define mge_cpu_relax() __builtin_ia32_pause()
+#	else
+#		define mge_cpu_relax() do {} while (0)
+#	endif
+
+static inline mgl_bool_t mge_internal_atomic_cas_i32(mge_atomic_i32_t* ptr, mgl_i32_t expected, mgl_i32_t desired)
+{
+	return __atomic_compare_exchange_n(ptr, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline mgl_bool_t mge_internal_atomic_cas_i64(mge_atomic_i64_t* ptr, mgl_i64_t expected, mgl_i64_t desired)
+{
+	return __atomic_compare_exchange_n(ptr, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline mgl_bool_t mge_internal_atomic_cas_ptr(void* volatile* ptr, void* expected, void* desired)
+{
+	return __atomic_compare_exchange_n(ptr, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+#endif
+
+#if defined(_MSC_VER)
+#	define MGE_THREAD_LOCAL __declspec(thread)
+#	define MGE_CACHE_ALIGN __declspec(align(64))
+#else
+#	define MGE_THREAD_LOCAL __thread
+#	define MGE_CACHE_ALIGN __attribute__((aligned(64)))
+#endif
+
+#endif
@@ -0,0 +1,155 @@
+#include <mge/platform/file.h>
+
+#include <mgl/memory/allocator.h>
+
+#if defined(_WIN32)
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <unistd.h>
+#	include <errno.h>
+#endif
+
+mgl_bool_t mge_internal_write_file(const mgl_chr8_t * path, const void * data, mgl_u64_t size)
+{
+	MGL_DEBUG_ASSERT(path != NULL && (data != NULL || size == 0));
+
+#if defined(_WIN32)
+	HANDLE file = CreateFileA((const char*)path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return MGL_FALSE;
+
+	const mgl_u8_t* bytes = (const mgl_u8_t*)data;
+	while (size > 0)
+	{
+		DWORD written;
+		DWORD chunk = size > 0x40000000 ? 0x40000000 : (DWORD)size;
+		if (!WriteFile(file, bytes, chunk, &written, NULL) || written == 0)
+		{
+			CloseHandle(file);
+			return MGL_FALSE;
+		}
+		bytes += written;
+		size -= written;
+	}
+
+	return CloseHandle(file) ? MGL_TRUE : MGL_FALSE;
+#else
+	int file = open((const char*)path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (file < 0)
+		return MGL_FALSE;
+
+	const mgl_u8_t* bytes = (const mgl_u8_t*)data;
+	while (size > 0)
+	{
+		ssize_t written = write(file, bytes, size);
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written <= 0)
+		{
+			close(file);
+			return MGL_FALSE;
+		}
+		bytes += written;
+		size -= (mgl_u64_t)written;
+	}
+
+	return close(file) == 0 ? MGL_TRUE : MGL_FALSE;
+#endif
+}
+
+mgl_bool_t mge_internal_read_file(const mgl_chr8_t * path, void * allocator, mgl_u8_t ** out_data, mgl_u64_t * out_size)
+{
+	MGL_DEBUG_ASSERT(path != NULL && allocator != NULL && out_data != NULL && out_size != NULL);
+
+#if defined(_WIN32)
+	HANDLE file = CreateFileA((const char*)path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return MGL_FALSE;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size))
+	{
+		CloseHandle(file);
+		return MGL_FALSE;
+	}
+	mgl_u64_t size = (mgl_u64_t)file_size.QuadPart;
+#else
+	int file = open((const char*)path, O_RDONLY);
+	if (file < 0)
+		return MGL_FALSE;
+
+	off_t end = lseek(file, 0, SEEK_END);
+	if (end < 0 || lseek(file, 0, SEEK_SET) < 0)
+	{
+		close(file);
+		return MGL_FALSE;
+	}
+	mgl_u64_t size = (mgl_u64_t)end;
+#endif
+
+	mgl_u8_t* data;
+	if (mgl_allocate(allocator, size + 1, (void**)&data) != MGL_ERROR_NONE)
+	{
+#if defined(_WIN32)
+		CloseHandle(file);
+#else
+		close(file);
+#endif
+		return MGL_FALSE;
+	}
+
+	mgl_u64_t offset = 0;
+	while (offset < size)
+	{
+#if defined(_WIN32)
+		DWORD read;
+		DWORD chunk = size - offset > 0x40000000 ? 0x40000000 : (DWORD)(size - offset);
+		if (!ReadFile(file, data + offset, chunk, &read, NULL) || read == 0)
+			break;
+#else
+		ssize_t read = pread(file, data + offset, size - offset, (off_t)offset);
+		if (read < 0 && errno == EINTR)
+			continue;
+		if (read <= 0)
+			break;
+#endif
+		offset += (mgl_u64_t)read;
+	}
+
+#if defined(_WIN32)
+	CloseHandle(file);
+#else
+	close(file);
+#endif
+
+	if (offset != size)
+	{
+		mgl_deallocate(allocator, data);
+		return MGL_FALSE;
+	}
+
+	data[size] = 0;
+	*out_data = data;
+	*out_size = size;
+	return MGL_TRUE;
+}
+
+mgl_bool_t mge_internal_drop_file_cache(const mgl_chr8_t * path)
+{
+	MGL_DEBUG_ASSERT(path != NULL);
+
+#if defined(__linux__)
+	int file = open((const char*)path, O_RDONLY);
+	if (file < 0)
+		return MGL_FALSE;
+
+	// Only clean pages are dropped, so write back any dirty ones first
+	mgl_bool_t dropped = fdatasync(file) == 0 && posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0;
+	close(file);
+	return dropped;
+#else
+	return MGL_FALSE;
+#endif
+}
@@ -0,0 +1,35 @@
+#ifndef MGE_PLATFORM_FILE_H
+#define MGE_PLATFORM_FILE_H
+
+#include <mgl/type.h>
+
+/// <summary>
+///		Creates (or overwrites) a native file and writes data to it.
+///		Used for engine output files which don't go through MGL archives (e.g. profile traces).
+/// </summary>
+/// <param name="path">File path</param>
+/// <param name="data">Data</param>
+/// <param name="size">Data size in bytes</param>
+/// <returns>MGL_TRUE if the whole data was written, otherwise MGL_FALSE</returns>
+mgl_bool_t mge_internal_write_file(const mgl_chr8_t* path, const void* data, mgl_u64_t size);
+
+/// <summary>
+///		Reads a whole native file into memory, allocated on an allocator, followed by a null character.
+///		Used for tool input files which don't go through MGL archives (e.g. benchmark baselines).
+/// </summary>
+/// <param name="path">File path</param>
+/// <param name="allocator">Allocator used for the data</param>
+/// <param name="out_data">Out data (deallocated with mgl_deallocate)</param>
+/// <param name="out_size">Out data size in bytes, without the null character</param>
+/// <returns>MGL_TRUE if the whole file was read, otherwise MGL_FALSE</returns>
+mgl_bool_t mge_internal_read_file(const mgl_chr8_t* path, void* allocator, mgl_u8_t** out_data, mgl_u64_t* out_size);
+
+/// <summary>
+///		Drops the cached pages of a native file from the OS page cache, so it is read from the disk again.
+///		Used by benchmarks which measure cold reads.
+/// </summary>
+/// <param name="path">File path</param>
+/// <returns>MGL_TRUE if the pages were dropped, otherwise MGL_FALSE (always on platforms other than Linux)</returns>
+mgl_bool_t mge_internal_drop_file_cache(const mgl_chr8_t* path);
+
+#endif
@@ -0,0 +1,433 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#	define _GNU_SOURCE // O_DIRECT
+#endif
+
+#include <mge/platform/io.h>
+#include <mge/log.h>
+
+#include <mgl/memory/allocator.h>
+#include <mgl/memory/manipulation.h>
+
+#if defined(MGE_IO_URING) && defined(__linux__)
+#	define MGE_IO_URING_AVAILABLE
+#	include <mge/platform/atomic.h>
+#	include <linux/io_uring.h>
+#	include <sys/mman.h>
+#	include <sys/syscall.h>
+#	include <sys/uio.h>
+#	include <errno.h>
+#	include <fcntl.h>
+#	include <stdint.h>
+#	include <unistd.h>
+#endif
+
+#ifdef MGE_IO_URING_AVAILABLE
+
+// Reads bigger than this are split, since a single io_uring read is limited to 32 bits
+#define MGE_IO_MAX_READ_SIZE (1 << 30)
+
+typedef struct
+{
+	mgl_u64_t read;
+	int file;
+	mgl_u64_t offset;
+	mgl_u64_t size;
+	mgl_u8_t* buffer;
+
+	// Direct reads go to a registered buffer, covering an aligned range which starts at 'offset'
+	mgl_u64_t buffer_index;
+	mgl_u64_t done;
+} mge_io_operation_t;
+
+struct mge_io_queue_t
+{
+	void* allocator;
+	int ring;
+	mgl_u32_t depth;
+
+	void* sq_ptr;
+	mgl_u64_t sq_size;
+	mge_atomic_i32_t* sq_tail;
+	mgl_u32_t sq_mask;
+	mgl_u32_t* sq_array;
+	struct io_uring_sqe* sqes;
+	mgl_u64_t sqes_size;
+	mgl_u32_t pending_submit_count;
+
+	void* cq_ptr;
+	mgl_u64_t cq_size;
+	mge_atomic_i32_t* cq_head;
+	mge_atomic_i32_t* cq_tail;
+	mgl_u32_t cq_mask;
+	struct io_uring_cqe* cqes;
+
+	mgl_u8_t* buffers;
+	mgl_u64_t buffer_count;
+	mgl_u64_t buffer_size;
+	mgl_bool_t registered;
+	mgl_u64_t* free_buffers;
+	mgl_u64_t free_buffer_count;
+
+	mge_io_operation_t* operations;
+	mgl_u64_t* free_operations;
+	mgl_u64_t free_operation_count;
+};
+
+static void mge_io_queue_operation(mge_io_queue_t* queue, mgl_u64_t index)
+{
+	mge_io_operation_t* op = &queue->operations[index];
+	mgl_u32_t tail = (mgl_u32_t)mge_atomic_load_i32(queue->sq_tail);
+	mgl_u32_t slot = tail & queue->sq_mask;
+	struct io_uring_sqe* sqe = &queue->sqes[slot];
+	*sqe = (struct io_uring_sqe) { 0 };
+
+	mgl_u64_t size = op->size - op->done;
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = op->file;
+	sqe->off = op->offset + op->done;
+	sqe->addr = (mgl_u64_t)(uintptr_t)(op->buffer + op->done);
+	sqe->len = (mgl_u32_t)(size > MGE_IO_MAX_READ_SIZE ? MGE_IO_MAX_READ_SIZE : size);
+	sqe->user_data = index;
+	if (op->buffer_index != (mgl_u64_t)-1 && queue->registered)
+	{
+		sqe->opcode = IORING_OP_READ_FIXED;
+		sqe->buf_index = (mgl_u16_t)op->buffer_index;
+	}
+
+	queue->sq_array[slot] = slot;
+	mge_atomic_store_i32(queue->sq_tail, (mgl_i32_t)(tail + 1));
+	queue->pending_submit_count += 1;
+}
+
+static void mge_io_unmap_queue(mge_io_queue_t* queue)
+{
+	if (queue->sqes != NULL && queue->sqes != MAP_FAILED)
+		munmap(queue->sqes, queue->sqes_size);
+	if (queue->cq_ptr != NULL && queue->cq_ptr != MAP_FAILED && queue->cq_ptr != queue->sq_ptr)
+		munmap(queue->cq_ptr, queue->cq_size);
+	if (queue->sq_ptr != NULL && queue->sq_ptr != MAP_FAILED)
+		munmap(queue->sq_ptr, queue->sq_size);
+	close(queue->ring);
+}
+
+static mgl_bool_t mge_io_map_queue(mge_io_queue_t* queue, mgl_u32_t depth)
+{
+	struct io_uring_params params = { 0 };
+	queue->ring = (int)syscall(__NR_io_uring_setup, depth, &params);
+	if (queue->ring < 0)
+		return MGL_FALSE;
+
+	// IORING_OP_READ was added on the same kernel release as IORING_FEAT_RW_CUR_POS (5.6)
+	if (!(params.features & IORING_FEAT_RW_CUR_POS))
+	{
+		close(queue->ring);
+		return MGL_FALSE;
+	}
+
+	queue->sq_size = params.sq_off.array + params.sq_entries * sizeof(mgl_u32_t);
+	queue->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		if (queue->cq_size > queue->sq_size)
+			queue->sq_size = queue->cq_size;
+		queue->cq_size = queue->sq_size;
+	}
+
+	queue->sq_ptr = mmap(NULL, queue->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, queue->ring, IORING_OFF_SQ_RING);
+	queue->cq_ptr = queue->sq_ptr;
+	queue->sqes = NULL;
+	if (queue->sq_ptr != MAP_FAILED && !(params.features & IORING_FEAT_SINGLE_MMAP))
+		queue->cq_ptr = mmap(NULL, queue->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, queue->ring, IORING_OFF_CQ_RING);
+	queue->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	if (queue->sq_ptr != MAP_FAILED && queue->cq_ptr != MAP_FAILED)
+		queue->sqes = (struct io_uring_sqe*)mmap(NULL, queue->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, queue->ring, IORING_OFF_SQES);
+	if (queue->sq_ptr == MAP_FAILED || queue->cq_ptr == MAP_FAILED || queue->sqes == MAP_FAILED)
+	{
+		mge_io_unmap_queue(queue);
+		return MGL_FALSE;
+	}
+
+	mgl_u8_t* sq = (mgl_u8_t*)queue->sq_ptr;
+	mgl_u8_t* cq = (mgl_u8_t*)queue->cq_ptr;
+	queue->sq_tail = (mge_atomic_i32_t*)(sq + params.sq_off.tail);
+	queue->sq_mask = *(mgl_u32_t*)(sq + params.sq_off.ring_mask);
+	queue->sq_array = (mgl_u32_t*)(sq + params.sq_off.array);
+	queue->cq_head = (mge_atomic_i32_t*)(cq + params.cq_off.head);
+	queue->cq_tail = (mge_atomic_i32_t*)(cq + params.cq_off.tail);
+	queue->cq_mask = *(mgl_u32_t*)(cq + params.cq_off.ring_mask);
+	queue->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+	queue->pending_submit_count = 0;
+	return MGL_TRUE;
+}
+
+#endif
+
+mge_io_queue_t * mge_internal_init_io_queue(void * allocator, mgl_u32_t depth, mgl_u64_t buffer_count, mgl_u64_t buffer_size)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL && depth > 0 && buffer_count > 0 && buffer_size % MGE_IO_DIRECT_ALIGNMENT == 0);
+
+#ifdef MGE_IO_URING_AVAILABLE
+	mge_io_queue_t* queue;
+	mgl_error_t err = mgl_allocate(allocator, sizeof(mge_io_queue_t), (void**)&queue);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate I/O queue", err);
+
+	if (!mge_io_map_queue(queue, depth))
+	{
+		err = mgl_deallocate(allocator, queue);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate I/O queue", err);
+		MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"io_uring isn't available, falling back to MGL file reads\n");
+		return NULL;
+	}
+
+	queue->allocator = allocator;
+	queue->depth = depth;
+	queue->buffer_count = buffer_count;
+	queue->buffer_size = buffer_size;
+
+	// Allocate operations and buffers
+	err = mgl_allocate(allocator, depth * sizeof(mge_io_operation_t), (void**)&queue->operations);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate I/O queue operations", err);
+	err = mgl_allocate(allocator, depth * sizeof(mgl_u64_t), (void**)&queue->free_operations);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate I/O queue operations", err);
+	err = mgl_allocate_aligned(allocator, buffer_count * buffer_size, MGE_IO_DIRECT_ALIGNMENT, (void**)&queue->buffers);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate I/O queue buffers", err);
+	err = mgl_allocate(allocator, buffer_count * sizeof(mgl_u64_t), (void**)&queue->free_buffers);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate I/O queue buffers", err);
+
+	for (mgl_u64_t i = 0; i < depth; ++i)
+		queue->free_operations[i] = i;
+	queue->free_operation_count = depth;
+	for (mgl_u64_t i = 0; i < buffer_count; ++i)
+		queue->free_buffers[i] = i;
+	queue->free_buffer_count = buffer_count;
+
+	// Register the buffers, so the kernel doesn't have to map them on every read
+	struct iovec* iovecs;
+	err = mgl_allocate(allocator, buffer_count * sizeof(struct iovec), (void**)&iovecs);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate I/O queue buffers", err);
+	for (mgl_u64_t i = 0; i < buffer_count; ++i)
+	{
+		iovecs[i].iov_base = queue->buffers + i * buffer_size;
+		iovecs[i].iov_len = buffer_size;
+	}
+	queue->registered = syscall(__NR_io_uring_register, queue->ring, IORING_REGISTER_BUFFERS, iovecs, (unsigned)buffer_count) == 0;
+	err = mgl_deallocate(allocator, iovecs);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate I/O queue buffer list", err);
+	if (!queue->registered)
+		MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Couldn't register io_uring buffers (locked memory limit too low?), direct reads won't use fixed buffers\n");
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully initialized io_uring I/O queue\n");
+	return queue;
+#else
+	return NULL;
+#endif
+}
+
+void mge_internal_terminate_io_queue(mge_io_queue_t * queue)
+{
+	MGL_DEBUG_ASSERT(queue != NULL);
+
+#ifdef MGE_IO_URING_AVAILABLE
+	if (queue->registered)
+		syscall(__NR_io_uring_register, queue->ring, IORING_UNREGISTER_BUFFERS, NULL, 0);
+	mge_io_unmap_queue(queue);
+
+	mgl_error_t err = mgl_deallocate(queue->allocator, queue->free_buffers);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate I/O queue buffers", err);
+	err = mgl_deallocate_aligned(queue->allocator, queue->buffers);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate I/O queue buffers", err);
+	err = mgl_deallocate(queue->allocator, queue->free_operations);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate I/O queue operations", err);
+	err = mgl_deallocate(queue->allocator, queue->operations);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate I/O queue operations", err);
+	err = mgl_deallocate(queue->allocator, queue);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate I/O queue", err);
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully terminated io_uring I/O queue\n");
+#endif
+}
+
+#ifdef MGE_IO_URING_AVAILABLE
+
+// Handles a completed operation, returning MGL_TRUE if it was queued again to read the rest of its data
+static mgl_bool_t mge_io_complete_operation(mge_io_read_t* reads, mge_io_operation_t* op, mgl_i32_t result)
+{
+	mge_io_read_t* read = &reads[op->read];
+	if (result == -EAGAIN || result == -EINTR)
+		return MGL_TRUE;
+	if (result < 0)
+	{
+		read->failed = MGL_TRUE;
+		return MGL_FALSE;
+	}
+
+	op->done += (mgl_u64_t)result;
+	if (op->buffer_index == (mgl_u64_t)-1)
+	{
+		if (result == 0)
+			read->failed = MGL_TRUE;
+		return result > 0 && op->done < op->size;
+	}
+
+	// Direct reads can only continue from an aligned position, otherwise the end of the file was reached
+	if (result > 0 && op->done < op->size && op->done % MGE_IO_DIRECT_ALIGNMENT == 0)
+		return MGL_TRUE;
+
+	// Copy the part of the read's range covered by the aligned range
+	mgl_u64_t begin = op->offset > read->offset ? op->offset : read->offset;
+	mgl_u64_t end = op->offset + op->size < read->offset + read->size ? op->offset + op->size : read->offset + read->size;
+	if (op->offset + op->done < end)
+	{
+		read->failed = MGL_TRUE;
+		return MGL_FALSE;
+	}
+	mgl_mem_copy((mgl_u8_t*)read->buffer + (begin - read->offset), op->buffer + (begin - op->offset), end - begin);
+	return MGL_FALSE;
+}
+
+#endif
+
+void mge_internal_read_io(mge_io_queue_t * queue, mge_io_read_t * reads, mgl_u64_t count)
+{
+	MGL_DEBUG_ASSERT(queue != NULL && (reads != NULL || count == 0));
+
+#ifdef MGE_IO_URING_AVAILABLE
+	for (mgl_u64_t i = 0; i < count; ++i)
+		reads[i].failed = MGL_FALSE;
+
+	// Direct reads are split in aligned ranges of up to a buffer, 'next_offset' is where the next one starts
+	mgl_u64_t next_read = 0;
+	mgl_u64_t next_offset = reads != NULL && count > 0 ? reads[0].offset & ~(mgl_u64_t)(MGE_IO_DIRECT_ALIGNMENT - 1) : 0;
+	mgl_u64_t in_flight = 0;
+
+	for (;;)
+	{
+		// Queue new operations while there are free ones (and free buffers, for direct reads)
+		while (next_read < count && queue->free_operation_count > 0)
+		{
+			mge_io_read_t* read = &reads[next_read];
+			mge_io_operation_t* op;
+			mgl_u64_t index;
+			if (read->size == 0)
+				goto next;
+
+			if (!read->direct)
+			{
+				index = queue->free_operations[--queue->free_operation_count];
+				op = &queue->operations[index];
+				op->read = next_read;
+				op->file = read->file;
+				op->offset = read->offset;
+				op->size = read->size;
+				op->buffer = (mgl_u8_t*)read->buffer;
+				op->buffer_index = (mgl_u64_t)-1;
+				op->done = 0;
+				mge_io_queue_operation(queue, index);
+				in_flight += 1;
+				goto next;
+			}
+
+			if (queue->free_buffer_count == 0)
+				break;
+
+			mgl_u64_t end = (read->offset + read->size + MGE_IO_DIRECT_ALIGNMENT - 1) & ~(mgl_u64_t)(MGE_IO_DIRECT_ALIGNMENT - 1);
+			index = queue->free_operations[--queue->free_operation_count];
+			op = &queue->operations[index];
+			op->read = next_read;
+			op->file = read->file;
+			op->offset = next_offset;
+			op->size = end - next_offset < queue->buffer_size ? end - next_offset : queue->buffer_size;
+			op->buffer_index = queue->free_buffers[--queue->free_buffer_count];
+			op->buffer = queue->buffers + op->buffer_index * queue->buffer_size;
+			op->done = 0;
+			mge_io_queue_operation(queue, index);
+			in_flight += 1;
+
+			next_offset += op->size;
+			if (next_offset < end)
+				continue;
+
+		next:
+			next_read += 1;
+			if (next_read < count)
+				next_offset = reads[next_read].offset & ~(mgl_u64_t)(MGE_IO_DIRECT_ALIGNMENT - 1);
+		}
+
+		if (in_flight == 0)
+			break;
+
+		// Submit the queued operations and wait for at least one of them
+		int ret = (int)syscall(__NR_io_uring_enter, queue->ring, queue->pending_submit_count, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+		if (ret < 0)
+		{
+			if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+				continue;
+			mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to submit io_uring reads");
+		}
+		queue->pending_submit_count -= (mgl_u32_t)ret;
+
+		// Reap completions
+		mgl_u32_t head = (mgl_u32_t)mge_atomic_load_i32(queue->cq_head);
+		mgl_u32_t tail = (mgl_u32_t)mge_atomic_load_i32(queue->cq_tail);
+		for (; head != tail; ++head)
+		{
+			struct io_uring_cqe* cqe = &queue->cqes[head & queue->cq_mask];
+			mgl_u64_t index = (mgl_u64_t)cqe->user_data;
+			mge_io_operation_t* op = &queue->operations[index];
+			if (mge_io_complete_operation(reads, op, cqe->res))
+			{
+				mge_io_queue_operation(queue, index);
+				continue;
+			}
+
+			if (op->buffer_index != (mgl_u64_t)-1)
+				queue->free_buffers[queue->free_buffer_count++] = op->buffer_index;
+			queue->free_operations[queue->free_operation_count++] = index;
+			in_flight -= 1;
+		}
+		mge_atomic_store_i32(queue->cq_head, (mgl_i32_t)head);
+	}
+#endif
+}
+
+int mge_internal_open_io_file(const mgl_chr8_t * path, mgl_bool_t direct, mgl_bool_t * out_direct)
+{
+	MGL_DEBUG_ASSERT(path != NULL && out_direct != NULL);
+	*out_direct = MGL_FALSE;
+
+#ifdef MGE_IO_URING_AVAILABLE
+	if (direct)
+	{
+		int file = open((const char*)path, O_RDONLY | O_DIRECT | O_CLOEXEC);
+		if (file >= 0)
+		{
+			*out_direct = MGL_TRUE;
+			return file;
+		}
+	}
+	return open((const char*)path, O_RDONLY | O_CLOEXEC);
+#else
+	return -1;
+#endif
+}
+
+void mge_internal_close_io_file(int file)
+{
+#ifdef MGE_IO_URING_AVAILABLE
+	if (file >= 0)
+		close(file);
+#endif
+}
@@ -0,0 +1,77 @@
+#ifndef MGE_PLATFORM_IO_H
+#define MGE_PLATFORM_IO_H
+
+#include <mgl/type.h>
+
+// Alignment of the offsets, sizes and buffers of direct (unbuffered) reads
+#define MGE_IO_DIRECT_ALIGNMENT 4096
+
+typedef struct mge_io_queue_t mge_io_queue_t;
+typedef struct mge_io_read_t mge_io_read_t;
+
+struct mge_io_read_t
+{
+	/// <summary>
+	///		Native file, opened with mge_internal_open_io_file.
+	/// </summary>
+	int file;
+
+	/// <summary>
+	///		Whether the file was opened for direct reads, which go through the queue's registered buffers and are
+	///		then copied to the read buffer, so the read doesn't need to be aligned.
+	/// </summary>
+	mgl_bool_t direct;
+
+	mgl_u64_t offset;
+	mgl_u64_t size;
+	void* buffer;
+
+	/// <summary>
+	///		Set by mge_internal_read_io when the read fails or the end of the file is reached before size bytes are read.
+	/// </summary>
+	mgl_bool_t failed;
+};
+
+/// <summary>
+///		Initializes an I/O queue, which keeps many reads in flight from a single thread through io_uring.
+///		Only available on Linux builds with MGE_IO_URING, and only if the kernel supports io_uring.
+///		Queues aren't thread safe, they must only be used by one thread at a time.
+/// </summary>
+/// <param name="allocator">Allocator used</param>
+/// <param name="depth">Max number of reads in flight</param>
+/// <param name="buffer_count">Number of buffers registered for direct reads</param>
+/// <param name="buffer_size">Size of each registered buffer (a multiple of MGE_IO_DIRECT_ALIGNMENT)</param>
+/// <returns>Pointer to queue, or NULL if io_uring isn't available</returns>
+mge_io_queue_t* mge_internal_init_io_queue(void* allocator, mgl_u32_t depth, mgl_u64_t buffer_count, mgl_u64_t buffer_size);
+
+/// <summary>
+///		Terminates an I/O queue.
+/// </summary>
+/// <param name="queue">Pointer to queue</param>
+void mge_internal_terminate_io_queue(mge_io_queue_t* queue);
+
+/// <summary>
+///		Runs a set of reads, keeping as many in flight as the queue allows, and returns once all of them are done.
+///		Short reads are resubmitted until the whole size is read.
+/// </summary>
+/// <param name="queue">Pointer to queue</param>
+/// <param name="reads">Reads</param>
+/// <param name="count">Read count</param>
+void mge_internal_read_io(mge_io_queue_t* queue, mge_io_read_t* reads, mgl_u64_t count);
+
+/// <summary>
+///		Opens a native file for reading through an I/O queue.
+/// </summary>
+/// <param name="path">File path</param>
+/// <param name="direct">Whether to try to open the file for direct reads, which bypass the page cache</param>
+/// <param name="out_direct">Out whether the file was opened for direct reads (not every file system supports them)</param>
+/// <returns>File, or -1 if it couldn't be opened</returns>
+int mge_internal_open_io_file(const mgl_chr8_t* path, mgl_bool_t direct, mgl_bool_t* out_direct);
+
+/// <summary>
+///		Closes a native file opened with mge_internal_open_io_file.
+/// </summary>
+/// <param name="file">File</param>
+void mge_internal_close_io_file(int file);
+
+#endif
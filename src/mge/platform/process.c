@@ -0,0 +1,46 @@
+#include <mge/platform/process.h>
+
+#if defined(_WIN32)
+#	define WIN32_LEAN_AND_MEAN
+#	define PSAPI_VERSION 2 // Exported by kernel32, no need to link psapi
+#	include <windows.h>
+#	include <psapi.h>
+#elif defined(__linux__)
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+mgl_u64_t mge_internal_get_resident_memory_size(void)
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+	return (mgl_u64_t)counters.WorkingSetSize;
+#elif defined(__linux__)
+	// '/proc/self/statm' holds the total program size followed by the resident set size, in pages
+	char buffer[128];
+	int file = open("/proc/self/statm", O_RDONLY);
+	if (file < 0)
+		return 0;
+	ssize_t size = read(file, buffer, sizeof(buffer) - 1);
+	close(file);
+	if (size <= 0)
+		return 0;
+	buffer[size] = 0;
+
+	const char* p = buffer;
+	while (*p != 0 && *p != ' ')
+		p += 1;
+	if (*p == 0)
+		return 0;
+	p += 1;
+
+	mgl_u64_t pages = 0;
+	for (; *p >= '0' && *p <= '9'; ++p)
+		pages = pages * 10 + (mgl_u64_t)(*p - '0');
+	return pages * (mgl_u64_t)sysconf(_SC_PAGESIZE);
+#else
+	return 0;
+#endif
+}
@@ -0,0 +1,13 @@
+#ifndef MGE_PLATFORM_PROCESS_H
+#define MGE_PLATFORM_PROCESS_H
+
+#include <mgl/type.h>
+
+/// <summary>
+///		Gets the resident set size of the current process (the physical memory it uses).
+///		Used by tools which watch the memory use of the whole process (e.g. soak tests).
+/// </summary>
+/// <returns>Resident set size in bytes, or 0 if it isn't available on this platform</returns>
+mgl_u64_t mge_internal_get_resident_memory_size(void);
+
+#endif
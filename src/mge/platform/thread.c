@@ -0,0 +1,76 @@
+#include <mge/platform/thread.h>
+#include <mge/log.h>
+
+#if defined(_WIN32)
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else
+#	include <pthread.h>
+#	include <sched.h>
+#	include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+static DWORD WINAPI mge_thread_entry(LPVOID arg)
+#else
+static void* mge_thread_entry(void* arg)
+#endif
+{
+	mge_thread_t* thread = (mge_thread_t*)arg;
+	thread->func(thread->arg);
+	return 0;
+}
+
+void mge_internal_create_thread(mge_thread_t * thread, void(*func)(void *arg), void * arg)
+{
+	MGL_DEBUG_ASSERT(thread != NULL && func != NULL);
+
+	thread->func = func;
+	thread->arg = arg;
+
+#if defined(_WIN32)
+	thread->handle = CreateThread(NULL, 0, &mge_thread_entry, thread, 0, NULL);
+	if (thread->handle == NULL)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to create thread");
+#else
+	pthread_t* handle = (pthread_t*)&thread->handle;
+	MGL_DEBUG_ASSERT(sizeof(pthread_t) <= sizeof(thread->handle));
+	if (pthread_create(handle, NULL, &mge_thread_entry, thread) != 0)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to create thread");
+#endif
+}
+
+void mge_internal_join_thread(mge_thread_t * thread)
+{
+	MGL_DEBUG_ASSERT(thread != NULL);
+
+#if defined(_WIN32)
+	WaitForSingleObject((HANDLE)thread->handle, INFINITE);
+	CloseHandle((HANDLE)thread->handle);
+#else
+	if (pthread_join(*(pthread_t*)&thread->handle, NULL) != 0)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to join thread");
+#endif
+	thread->handle = NULL;
+}
+
+void mge_internal_yield_thread(void)
+{
+#if defined(_WIN32)
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
+
+mgl_u64_t mge_internal_get_cpu_count(void)
+{
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (mgl_u64_t)info.dwNumberOfProcessors : 1;
+#else
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (mgl_u64_t)count : 1;
+#endif
+}
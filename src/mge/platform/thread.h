@@ -0,0 +1,40 @@
+#ifndef MGE_PLATFORM_THREAD_H
+#define MGE_PLATFORM_THREAD_H
+
+#include <mgl/type.h>
+
+typedef struct mge_thread_t mge_thread_t;
+
+struct mge_thread_t
+{
+	void* handle;
+	void(*func)(void* arg);
+	void* arg;
+};
+
+/// <summary>
+///		Starts a new native thread.
+/// </summary>
+/// <param name="thread">Thread handle (must stay valid until the thread is joined)</param>
+/// <param name="func">Thread entry function</param>
+/// <param name="arg">Argument passed to the entry function</param>
+void mge_internal_create_thread(mge_thread_t* thread, void(*func)(void* arg), void* arg);
+
+/// <summary>
+///		Waits for a thread to finish and releases its handle.
+/// </summary>
+/// <param name="thread">Thread handle</param>
+void mge_internal_join_thread(mge_thread_t* thread);
+
+/// <summary>
+///		Yields the rest of the calling thread's time slice.
+/// </summary>
+void mge_internal_yield_thread(void);
+
+/// <summary>
+///		Gets the number of logical processors available.
+/// </summary>
+/// <returns>Logical processor count (at least 1)</returns>
+mgl_u64_t mge_internal_get_cpu_count(void);
+
+#endif
@@ -0,0 +1,327 @@
+#include <mge/profile.h>
+#include <mge/time.h>
+#include <mge/log.h>
+
+#include <mge/platform/atomic.h>
+#include <mge/platform/file.h>
+
+#include <mgl/memory/allocator.h>
+
+// Threads which record events after this many threads are already recording are ignored
+#define MGE_MAX_PROFILE_THREAD_COUNT 64
+
+typedef struct
+{
+	// End events have no name
+	const mgl_chr8_t* name;
+	const mgl_chr8_t* detail;
+	mgl_u64_t time;
+} mge_profile_event_t;
+
+typedef struct
+{
+	mge_profile_event_t* events;
+	mge_atomic_i64_t event_count;
+	mgl_u64_t dropped_event_count;
+} mge_profile_thread_t;
+
+typedef struct
+{
+	// NULL while measuring the trace size
+	mgl_chr8_t* data;
+	mgl_u64_t size;
+	mgl_bool_t first_event;
+} mge_profile_writer_t;
+
+volatile mgl_bool_t mge_internal_profiling = MGL_FALSE;
+
+static void* mge_profile_allocator = NULL;
+static mgl_u64_t mge_max_profile_event_count = 0;
+static mgl_u64_t mge_profile_start_time = 0;
+static mge_profile_thread_t mge_profile_threads[MGE_MAX_PROFILE_THREAD_COUNT];
+static mge_atomic_i32_t mge_profile_thread_count = 0;
+static MGE_THREAD_LOCAL mge_profile_thread_t* mge_current_profile_thread = NULL;
+
+static mge_profile_thread_t* mge_get_profile_thread(void)
+{
+	if (mge_current_profile_thread != NULL)
+		return mge_current_profile_thread;
+
+	// The event buffer is allocated when the thread records its first event, and kept until the profiler is terminated
+	if (mge_atomic_load_i32(&mge_profile_thread_count) >= MGE_MAX_PROFILE_THREAD_COUNT)
+		return NULL;
+	mgl_i32_t index = mge_atomic_add_i32(&mge_profile_thread_count, 1) - 1;
+	if (index >= MGE_MAX_PROFILE_THREAD_COUNT)
+		return NULL;
+
+	mge_profile_thread_t* thread = &mge_profile_threads[index];
+	mgl_error_t err = mgl_allocate(mge_profile_allocator, mge_max_profile_event_count * sizeof(mge_profile_event_t), (void**)&thread->events);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate profile event buffer", err);
+	thread->dropped_event_count = 0;
+	mge_atomic_store_i64(&thread->event_count, 0);
+
+	mge_current_profile_thread = thread;
+	return thread;
+}
+
+static void mge_record_profile_event(const mgl_chr8_t* name, const mgl_chr8_t* detail)
+{
+	mge_profile_thread_t* thread = mge_get_profile_thread();
+	if (thread == NULL)
+		return;
+
+	mgl_i64_t count = thread->event_count;
+	if ((mgl_u64_t)count >= mge_max_profile_event_count)
+	{
+		thread->dropped_event_count += 1;
+		return;
+	}
+
+	mge_profile_event_t* event = &thread->events[count];
+	event->name = name;
+	event->detail = detail;
+	event->time = mge_get_time();
+
+	// Published after the event is written, the trace writer only reads up to the count
+	mge_atomic_store_i64(&thread->event_count, count + 1);
+}
+
+static void mge_write_profile_str(mge_profile_writer_t* writer, const mgl_chr8_t* str)
+{
+	for (; *str != 0; ++str)
+	{
+		if (writer->data != NULL)
+			writer->data[writer->size] = *str;
+		writer->size += 1;
+	}
+}
+
+static void mge_write_profile_escaped_str(mge_profile_writer_t* writer, const mgl_chr8_t* str)
+{
+	static const mgl_chr8_t hex[] = u8"0123456789abcdef";
+
+	for (; *str != 0; ++str)
+	{
+		mgl_u8_t c = (mgl_u8_t)*str;
+		mgl_chr8_t escaped[7] = { (mgl_chr8_t)c, 0 };
+		if (c == '"' || c == '\\')
+		{
+			escaped[0] = '\\';
+			escaped[1] = (mgl_chr8_t)c;
+			escaped[2] = 0;
+		}
+		else if (c < 0x20)
+		{
+			escaped[0] = '\\';
+			escaped[1] = 'u';
+			escaped[2] = '0';
+			escaped[3] = '0';
+			escaped[4] = hex[c >> 4];
+			escaped[5] = hex[c & 0xF];
+			escaped[6] = 0;
+		}
+		mge_write_profile_str(writer, escaped);
+	}
+}
+
+static void mge_write_profile_u64(mge_profile_writer_t* writer, mgl_u64_t value, mgl_u64_t min_digit_count)
+{
+	mgl_chr8_t digits[21];
+	mgl_u64_t i = sizeof(digits) - 1;
+	digits[i] = 0;
+	do
+	{
+		digits[--i] = (mgl_chr8_t)('0' + value % 10);
+		value /= 10;
+		min_digit_count = min_digit_count > 0 ? min_digit_count - 1 : 0;
+	} while (value != 0 || min_digit_count > 0);
+	mge_write_profile_str(writer, &digits[i]);
+}
+
+static void mge_write_profile_event(mge_profile_writer_t* writer, const mgl_chr8_t* name, const mgl_chr8_t* detail, mgl_u64_t time, mgl_u64_t tid)
+{
+	mge_write_profile_str(writer, writer->first_event ? u8"\n" : u8",\n");
+	writer->first_event = MGL_FALSE;
+
+	if (name != NULL)
+	{
+		mge_write_profile_str(writer, u8"{\"name\":\"");
+		mge_write_profile_escaped_str(writer, name);
+		mge_write_profile_str(writer, u8"\",\"ph\":\"B\",\"ts\":");
+	}
+	else
+		mge_write_profile_str(writer, u8"{\"ph\":\"E\",\"ts\":");
+
+	// Chrome traces use microseconds
+	time = time > mge_profile_start_time ? time - mge_profile_start_time : 0;
+	mge_write_profile_u64(writer, time / 1000, 1);
+	mge_write_profile_str(writer, u8".");
+	mge_write_profile_u64(writer, time % 1000, 3);
+
+	mge_write_profile_str(writer, u8",\"pid\":0,\"tid\":");
+	mge_write_profile_u64(writer, tid, 1);
+	if (detail != NULL)
+	{
+		mge_write_profile_str(writer, u8",\"args\":{\"detail\":\"");
+		mge_write_profile_escaped_str(writer, detail);
+		mge_write_profile_str(writer, u8"\"}");
+	}
+	mge_write_profile_str(writer, u8"}");
+}
+
+static void mge_write_profile_trace(mge_profile_writer_t* writer, mgl_u64_t end_time)
+{
+	writer->size = 0;
+	writer->first_event = MGL_TRUE;
+	mge_write_profile_str(writer, u8"{\"traceEvents\":[");
+
+	mgl_i32_t thread_count = mge_atomic_load_i32(&mge_profile_thread_count);
+	if (thread_count > MGE_MAX_PROFILE_THREAD_COUNT)
+		thread_count = MGE_MAX_PROFILE_THREAD_COUNT;
+
+	for (mgl_i32_t t = 0; t < thread_count; ++t)
+	{
+		mge_profile_thread_t* thread = &mge_profile_threads[t];
+		mgl_u64_t event_count = (mgl_u64_t)mge_atomic_load_i64(&thread->event_count);
+		if (event_count == 0)
+			continue;
+
+		mge_write_profile_str(writer, writer->first_event ? u8"\n" : u8",\n");
+		writer->first_event = MGL_FALSE;
+		mge_write_profile_str(writer, u8"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":");
+		mge_write_profile_u64(writer, (mgl_u64_t)t, 1);
+		mge_write_profile_str(writer, t == 0 ? u8",\"args\":{\"name\":\"Main thread\"}}" : u8",\"args\":{\"name\":\"Thread\"}}");
+
+		// Events which were open when the capture started or finished are cut at its limits
+		mgl_u64_t depth = 0;
+		for (mgl_u64_t i = 0; i < event_count; ++i)
+		{
+			mge_profile_event_t* event = &thread->events[i];
+			if (event->name == NULL && depth == 0)
+				continue;
+			depth = event->name != NULL ? depth + 1 : depth - 1;
+			mge_write_profile_event(writer, event->name, event->detail, event->time, (mgl_u64_t)t);
+		}
+		for (; depth > 0; --depth)
+			mge_write_profile_event(writer, NULL, NULL, end_time, (mgl_u64_t)t);
+	}
+
+	mge_write_profile_str(writer, u8"\n],\"displayTimeUnit\":\"ns\"}\n");
+}
+
+void mge_internal_init_profiler(void * allocator, mgl_u64_t max_event_count)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL);
+	if (max_event_count == 0)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to initialize profiler, max event count must be greater than 0");
+
+	mge_profile_allocator = allocator;
+	mge_max_profile_event_count = max_event_count;
+	mge_atomic_store_i32(&mge_profile_thread_count, 0);
+
+	// The initializing thread is the main thread, which always shows up first
+	mge_get_profile_thread();
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully initialized profiler\n");
+}
+
+void mge_internal_terminate_profiler(void)
+{
+	mge_internal_profiling = MGL_FALSE;
+	mge_atomic_fence();
+
+	mgl_i32_t thread_count = mge_atomic_load_i32(&mge_profile_thread_count);
+	if (thread_count > MGE_MAX_PROFILE_THREAD_COUNT)
+		thread_count = MGE_MAX_PROFILE_THREAD_COUNT;
+
+	// Deallocate event buffers
+	for (mgl_i32_t t = 0; t < thread_count; ++t)
+	{
+		mgl_error_t err = mgl_deallocate(mge_profile_allocator, mge_profile_threads[t].events);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate profile event buffer", err);
+	}
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully terminated profiler\n");
+}
+
+void mge_start_profile_capture(void)
+{
+	mge_internal_profiling = MGL_FALSE;
+	mge_atomic_fence();
+
+	mgl_i32_t thread_count = mge_atomic_load_i32(&mge_profile_thread_count);
+	if (thread_count > MGE_MAX_PROFILE_THREAD_COUNT)
+		thread_count = MGE_MAX_PROFILE_THREAD_COUNT;
+	for (mgl_i32_t t = 0; t < thread_count; ++t)
+	{
+		mge_atomic_store_i64(&mge_profile_threads[t].event_count, 0);
+		mge_profile_threads[t].dropped_event_count = 0;
+	}
+
+	mge_profile_start_time = mge_get_time();
+	mge_atomic_fence();
+	mge_internal_profiling = MGL_TRUE;
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Started profile capture\n");
+}
+
+void mge_finish_profile_capture(const mgl_chr8_t * path)
+{
+	MGL_DEBUG_ASSERT(path != NULL);
+	if (!mge_internal_profiling)
+		return;
+
+	mge_internal_profiling = MGL_FALSE;
+	mge_atomic_fence();
+	mgl_u64_t end_time = mge_get_time();
+
+	// Measure the trace and then write it
+	mge_profile_writer_t writer;
+	writer.data = NULL;
+	mge_write_profile_trace(&writer, end_time);
+
+	mgl_error_t err = mgl_allocate(mge_profile_allocator, writer.size, (void**)&writer.data);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate profile trace", err);
+	mge_write_profile_trace(&writer, end_time);
+
+	if (mge_internal_write_file(path, writer.data, writer.size))
+	{
+		MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Wrote profile trace '");
+		MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, path);
+		MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"'\n");
+	}
+	else
+	{
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"WARNING: Failed to write profile trace '");
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, path);
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+	}
+
+	err = mgl_deallocate(mge_profile_allocator, writer.data);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate profile trace", err);
+
+	mgl_i32_t thread_count = mge_atomic_load_i32(&mge_profile_thread_count);
+	if (thread_count > MGE_MAX_PROFILE_THREAD_COUNT)
+		thread_count = MGE_MAX_PROFILE_THREAD_COUNT;
+	for (mgl_i32_t t = 0; t < thread_count; ++t)
+		if (mge_profile_threads[t].dropped_event_count > 0)
+		{
+			MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"WARNING: Profile event buffers were full, some events were dropped (increase -mge-max-profile-event-count)\n");
+			break;
+		}
+}
+
+void mge_internal_begin_profile_event(const mgl_chr8_t * name, const mgl_chr8_t * detail)
+{
+	MGL_DEBUG_ASSERT(name != NULL);
+	mge_record_profile_event(name, detail);
+}
+
+void mge_internal_end_profile_event(void)
+{
+	mge_record_profile_event(NULL, NULL);
+}
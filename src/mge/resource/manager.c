@@ -1,23 +1,120 @@
 #include <mge/resource/manager.h>
 #include <mge/log.h>
+#include <mge/profile.h>
 
 #include <mge/resource/text.h>
+#include <mge/resource/prefab.h>
+#include <mge/job/system.h>
+#include <mge/memory/pool.h>
+#include <mge/platform/atomic.h>
+#include <mge/platform/io.h>
+#include <mge/platform/thread.h>
 
 #include <mgl/file/archive.h>
 #include <mgl/string/manipulation.h>
 #include <mgl/memory/allocator.h>
 #include <mgl/memory/manipulation.h>
 
+// Resource data up to this size (including the loader's data header) is allocated on the resource data pool
+#define MGE_RESOURCE_DATA_POOL_BLOCK_SIZE 256
+#define MGE_RESOURCE_DATA_POOL_CHUNK_BLOCK_COUNT 64
+
+// I/O queue used by mge_load_resources, on Linux builds with MGE_IO_URING
+#define MGE_RESOURCE_IO_QUEUE_DEPTH 64
+#define MGE_RESOURCE_IO_BUFFER_COUNT 8
+#define MGE_RESOURCE_IO_BUFFER_SIZE (1024 * 1024)
+#define MGE_RESOURCE_IO_BATCH_SIZE 256
+
+// Texts of at least this size are read bypassing the page cache, since they would only push other data out of it
+#define MGE_RESOURCE_IO_DIRECT_SIZE (1024 * 1024)
+
+#define MGE_MAX_RESOURCE_NATIVE_PATH_SIZE (2 * MGE_MAX_RESOURCE_DATA_PATH_SIZE)
+
+typedef struct
+{
+	mge_resource_t* rsc;
+	mgl_u64_t file;
+	mgl_u64_t text_size;
+	mge_text_resource_data_t* data;
+} mge_resource_io_load_t;
+
+typedef struct
+{
+	const mgl_chr8_t* path;
+	int file;
+	int direct_file;
+	mgl_bool_t direct_opened;
+} mge_resource_io_file_t;
+
+typedef struct
+{
+	mge_resource_manager_t* manager;
+	mge_resource_t** resources;
+	mgl_u64_t count;
+} mge_resource_batch_load_job_data_t;
+
+typedef struct
+{
+	mge_resource_manager_t* manager;
+	mgl_chr8_t* path;
+} mge_resource_info_file_job_data_t;
+
+// Name lookup table, rebuilt and published as a new snapshot when an info file is added, so it never changes while
+// it is being read
+typedef struct
+{
+	mgl_u64_t mask;
+	mge_resource_t** slots;
+} mge_resource_index_t;
+
+// Lookups in flight, counted on one of two epochs (see mge_synchronize_resource_readers)
+typedef struct
+{
+	mge_atomic_i32_t count[2];
+	mgl_u8_t padding[64 - 2 * sizeof(mge_atomic_i32_t)];
+} mge_resource_reader_t;
+
 struct mge_resource_manager_t
 {
 	void* allocator;
+	mge_pool_allocator_t* data_pool;
 	mgl_u64_t max_resource_count;
 	mge_resource_t* resources;
+
+	// Info files are added one at a time, while lookups read the published index without locking, each thread counting
+	// itself on its own reader (job workers, and then one shared by every other thread)
+	mgl_mutex_t registration_mutex;
+	mgl_u64_t resource_count;
+	mge_resource_index_t* volatile index;
+	mge_atomic_i32_t reader_epoch;
+	mgl_u64_t reader_count;
+	mge_resource_reader_t* readers;
+
+	// Background loads of permanent resources are children of a root job, which is only run by mge_wait_resource_loads
+	// (the root is created, and swapped out by the wait, with the registration mutex locked)
+	mge_job_system_t* job_system;
+	mge_job_t* load_root;
+	mge_atomic_i32_t pending_load_count;
+
+	// Resources on native directories are read in batches through an I/O queue, which is NULL when it isn't available
+	mge_io_queue_t* io_queue;
+	mgl_mutex_t io_mutex;
+	mge_resource_io_load_t* io_loads;
+	mge_resource_io_file_t* io_files;
+	mge_io_read_t* io_reads;
+
+	mgl_u64_t native_directory_count;
+	struct
+	{
+		mgl_chr8_t archive[MGE_MAX_RESOURCE_NAME_SIZE];
+		mgl_chr8_t directory[MGE_MAX_RESOURCE_DATA_PATH_SIZE];
+	} native_directories[MGE_MAX_RESOURCE_NATIVE_DIRECTORY_COUNT];
 };
 
 static void mge_force_resource_load(mge_resource_t* rsc)
 {
 	MGL_DEBUG_ASSERT(rsc != NULL);
+	MGE_PROFILE_BEGIN_DETAIL(u8"Load resource", rsc->name);
 
 	switch (rsc->type)
 	{
@@ -25,7 +122,11 @@ static void mge_force_resource_load(mge_resource_t* rsc)
 			break;
 
 		case MGE_RESOURCE_TEXT:
-			mge_resource_load_text(rsc->manager->allocator, rsc);
+			mge_resource_load_text(rsc);
+			break;
+
+		case MGE_RESOURCE_PREFAB:
+			mge_resource_load_prefab(rsc);
 			break;
 
 		default:
@@ -39,11 +140,13 @@ static void mge_force_resource_load(mge_resource_t* rsc)
 	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"Loaded resource '");
 	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, rsc->name);
 	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"'\n");
+	MGE_PROFILE_END();
 }
 
 static void mge_force_resource_unload(mge_resource_t* rsc)
 {
 	MGL_DEBUG_ASSERT(rsc != NULL);
+	MGE_PROFILE_BEGIN_DETAIL(u8"Unload resource", rsc->name);
 
 	switch (rsc->type)
 	{
@@ -54,6 +157,10 @@ static void mge_force_resource_unload(mge_resource_t* rsc)
 			mge_resource_unload_text(rsc);
 			break;
 
+		case MGE_RESOURCE_PREFAB:
+			mge_resource_unload_prefab(rsc);
+			break;
+
 		default:
 			MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"Couldn't unload resource '");
 			MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, rsc->name);
@@ -67,6 +174,7 @@ static void mge_force_resource_unload(mge_resource_t* rsc)
 	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"Unloaded resource '");
 	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, rsc->name);
 	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"'\n");
+	MGE_PROFILE_END();
 }
 
 static void mge_access_resource(mge_resource_t* rsc, void* access)
@@ -79,6 +187,10 @@ static void mge_access_resource(mge_resource_t* rsc, void* access)
 			mge_resource_access_text(rsc, (mge_text_resource_access_t*)access);
 			return;
 
+		case MGE_RESOURCE_PREFAB:
+			mge_resource_access_prefab(rsc, (mge_prefab_resource_access_t*)access);
+			return;
+
 		case MGE_RESOURCE_EMPTY:
 			MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"Couldn't access resource '");
 			MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, rsc->name);
@@ -163,22 +275,352 @@ static void mge_resource_unload_dependencies(mge_resource_t* rsc)
 	}
 }
 
-static mge_resource_t* mge_get_free_resource(mge_resource_manager_t* manager)
+static void mge_resource_load_root_job(mge_job_t* job, void* data)
+{
+
+}
+
+static void mge_resource_load_job(mge_job_t* job, void* data)
+{
+	mge_resource_t* rsc = *(mge_resource_t**)data;
+
+	// The resource might have been opened, and so loaded, before this job ran
+	mgl_error_t err = mgl_lock_mutex(&rsc->data.mutex);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to lock resource data mutex", err);
+
+	if (rsc->data.ptr == NULL)
+		mge_force_resource_load(rsc);
+
+	err = mgl_unlock_mutex(&rsc->data.mutex);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to unlock resource data mutex", err);
+
+	mge_atomic_add_i32(&rsc->manager->pending_load_count, -1);
+}
+
+static void mge_load_permanent_resource_batch(mge_resource_manager_t* manager, mge_resource_t** resources, mgl_u64_t count)
+{
+	MGL_DEBUG_ASSERT(manager != NULL && resources != NULL);
+
+	mge_load_resources(manager, resources, count);
+
+	mgl_error_t err = mgl_deallocate(manager->allocator, resources);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate permanent resource list", err);
+}
+
+static void mge_resource_batch_load_job(mge_job_t* job, void* data)
+{
+	mge_resource_batch_load_job_data_t* batch = (mge_resource_batch_load_job_data_t*)data;
+	mge_load_permanent_resource_batch(batch->manager, batch->resources, batch->count);
+	mge_atomic_add_i32(&batch->manager->pending_load_count, -1);
+}
+
+// Returns the load root a background load can be queued under, counting it as pending, or NULL if it must be loaded
+// right away. Must be called with the registration mutex locked, and the load queued before unlocking it
+static mge_job_t* mge_begin_background_load(mge_resource_manager_t* manager)
+{
+	MGL_DEBUG_ASSERT(manager != NULL);
+
+	// Load right away when no other worker could load it, or when too many loads are in flight
+	mge_job_system_t* system = manager->job_system;
+	if (system == NULL ||
+		mge_get_job_worker_count(system) < 2 ||
+		mge_get_job_worker_index(system) == mge_get_job_worker_count(system) ||
+		mge_atomic_load_i32(&manager->pending_load_count) >= MGE_MAX_BACKGROUND_RESOURCE_LOAD_COUNT)
+		return NULL;
+
+	if (manager->load_root == NULL)
+		manager->load_root = mge_create_job(system, NULL, &mge_resource_load_root_job, NULL, 0);
+	mge_atomic_add_i32(&manager->pending_load_count, 1);
+	return manager->load_root;
+}
+
+static void mge_queue_permanent_resource_load(mge_resource_manager_t* manager, mge_resource_t* rsc)
+{
+	MGL_DEBUG_ASSERT(manager != NULL && rsc != NULL);
+
+	mge_job_t* root = mge_begin_background_load(manager);
+	if (root == NULL)
+	{
+		mge_force_resource_load(rsc);
+		return;
+	}
+
+	mge_run_job(mge_create_job(manager->job_system, root, &mge_resource_load_job, &rsc, sizeof(rsc)));
+}
+
+static void mge_queue_permanent_resource_batch_load(mge_resource_manager_t* manager, mge_resource_t** resources, mgl_u64_t count)
+{
+	MGL_DEBUG_ASSERT(manager != NULL && resources != NULL);
+
+	mge_job_t* root = mge_begin_background_load(manager);
+	if (root == NULL)
+	{
+		mge_load_permanent_resource_batch(manager, resources, count);
+		return;
+	}
+
+	mge_resource_batch_load_job_data_t batch = { manager, resources, count };
+	mge_run_job(mge_create_job(manager->job_system, root, &mge_resource_batch_load_job, &batch, sizeof(batch)));
+}
+
+static mgl_bool_t mge_get_resource_native_path(mge_resource_manager_t* manager, const mgl_chr8_t* path, mgl_chr8_t* out_path)
+{
+	MGL_DEBUG_ASSERT(manager != NULL && path != NULL);
+
+	for (mgl_u64_t i = 0; i < manager->native_directory_count; ++i)
+	{
+		// Data paths start with the archive name, followed by the path on the archive
+		const mgl_chr8_t* archive = manager->native_directories[i].archive;
+		mgl_u64_t j = 0;
+		while (archive[j] != 0 && archive[j] == path[j])
+			++j;
+		if (archive[j] != 0 || path[j] != '/')
+			continue;
+
+		if (out_path != NULL)
+		{
+			mgl_u64_t size = 0;
+			for (const mgl_chr8_t* c = manager->native_directories[i].directory; *c != 0; ++c)
+				out_path[size++] = *c;
+			for (const mgl_chr8_t* c = path + j; *c != 0; ++c)
+				out_path[size++] = *c;
+			out_path[size] = 0;
+		}
+
+		return MGL_TRUE;
+	}
+
+	return MGL_FALSE;
+}
+
+static mgl_bool_t mge_can_read_resource_batched(mge_resource_manager_t* manager, mge_resource_t* rsc)
+{
+	MGL_DEBUG_ASSERT(manager != NULL && rsc != NULL);
+
+	return manager->io_queue != NULL &&
+		rsc->type == MGE_RESOURCE_TEXT &&
+		(rsc->dependency_count == 0 || (rsc->hints & MGE_RESOURCE_HINT_PERMANENT)) &&
+		mge_get_resource_native_path(manager, rsc->data.path, NULL);
+}
+
+static void mge_check_resource_batch_reads(mge_resource_manager_t* manager, mgl_u64_t count)
 {
 	MGL_DEBUG_ASSERT(manager != NULL);
 
-	for (mgl_u32_t i = 0; i < manager->max_resource_count; ++i)
-		if (manager->resources[i].manager == NULL)
+	for (mgl_u64_t i = 0; i < count; ++i)
+		if (manager->io_reads[i].failed)
+		{
+			MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"Failed to read text resource data file on '");
+			MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, manager->io_loads[i].rsc->data.path);
+			MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+			mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to read text resource data file");
+		}
+}
+
+static void mge_read_resource_batch(mge_resource_manager_t* manager, mgl_u64_t count)
+{
+	MGL_DEBUG_ASSERT(manager != NULL && manager->io_queue != NULL && count <= MGE_RESOURCE_IO_BATCH_SIZE);
+	MGE_PROFILE_BEGIN(u8"Read resource batch");
+
+	mge_resource_io_load_t* loads = manager->io_loads;
+	mge_resource_io_file_t* files = manager->io_files;
+	mge_io_read_t* reads = manager->io_reads;
+	mgl_chr8_t native_path[MGE_MAX_RESOURCE_NATIVE_PATH_SIZE];
+	mgl_u64_t file_count = 0;
+
+	// Open each data file once, and read the text sizes
+	for (mgl_u64_t i = 0; i < count; ++i)
+	{
+		mge_resource_t* rsc = loads[i].rsc;
+		mgl_u64_t j = 0;
+		while (j < file_count && !mgl_str_equal(files[j].path, rsc->data.path))
+			++j;
+
+		if (j == file_count)
+		{
+			mgl_bool_t direct;
+			mge_get_resource_native_path(manager, rsc->data.path, native_path);
+			files[j].path = rsc->data.path;
+			files[j].file = mge_internal_open_io_file(native_path, MGL_FALSE, &direct);
+			files[j].direct_file = -1;
+			files[j].direct_opened = MGL_FALSE;
+			if (files[j].file < 0)
+			{
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"Couldn't open text resource data file on '");
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, native_path);
+				MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+				mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to load text resource data file, couldn't open file");
+			}
+			file_count += 1;
+		}
+
+		loads[i].file = j;
+		reads[i] = (mge_io_read_t) { files[j].file, MGL_FALSE, rsc->data.offset, sizeof(loads[i].text_size), &loads[i].text_size, MGL_FALSE };
+	}
+
+	mge_internal_read_io(manager->io_queue, reads, count);
+	mge_check_resource_batch_reads(manager, count);
+
+	// Read the texts, opening the files again for direct reads when there are big ones
+	for (mgl_u64_t i = 0; i < count; ++i)
+	{
+		mge_resource_io_file_t* file = &files[loads[i].file];
+		if (loads[i].text_size >= MGE_RESOURCE_IO_DIRECT_SIZE && !file->direct_opened)
+		{
+			mgl_bool_t direct;
+			mge_get_resource_native_path(manager, file->path, native_path);
+			file->direct_file = mge_internal_open_io_file(native_path, MGL_TRUE, &direct);
+			file->direct_opened = MGL_TRUE;
+			if (!direct)
+			{
+				mge_internal_close_io_file(file->direct_file);
+				file->direct_file = -1;
+			}
+		}
+
+		mgl_bool_t direct = loads[i].text_size >= MGE_RESOURCE_IO_DIRECT_SIZE && file->direct_file >= 0;
+		loads[i].data = mge_internal_allocate_text_resource_data(loads[i].rsc, loads[i].text_size);
+		reads[i] = (mge_io_read_t) { direct ? file->direct_file : file->file, direct, loads[i].rsc->data.offset + sizeof(loads[i].text_size), loads[i].text_size, (void*)loads[i].data->text, MGL_FALSE };
+	}
+
+	mge_internal_read_io(manager->io_queue, reads, count);
+	mge_check_resource_batch_reads(manager, count);
+
+	for (mgl_u64_t i = 0; i < file_count; ++i)
+	{
+		mge_internal_close_io_file(files[i].file);
+		mge_internal_close_io_file(files[i].direct_file);
+	}
+
+	// The resources might have been opened, and so loaded, while they were being read
+	for (mgl_u64_t i = 0; i < count; ++i)
+	{
+		mge_resource_t* rsc = loads[i].rsc;
+		mgl_error_t err = mgl_lock_mutex(&rsc->data.mutex);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to lock resource data mutex", err);
+
+		if (rsc->data.ptr == NULL)
 		{
-			manager->resources[i].manager = manager;
-			return &manager->resources[i];
+			rsc->data.ptr = loads[i].data;
+			MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"Loaded resource '");
+			MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, rsc->name);
+			MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"'\n");
+		}
+		else
+		{
+			err = mgl_deallocate(loads[i].data->allocator, loads[i].data);
+			if (err != MGL_ERROR_NONE)
+				mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate text resource data", err);
 		}
 
-	mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to create resource, max resource count surpassed");
+		err = mgl_unlock_mutex(&rsc->data.mutex);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to unlock resource data mutex", err);
+	}
+
+	MGE_PROFILE_END();
+}
+
+static mge_resource_t* mge_get_free_resource(mge_resource_manager_t* manager)
+{
+	MGL_DEBUG_ASSERT(manager != NULL);
+
+	// Resources are never removed, so the free ones are always at the end
+	if (manager->resource_count == manager->max_resource_count)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to create resource, max resource count surpassed");
+
+	mge_resource_t* rsc = &manager->resources[manager->resource_count++];
+	rsc->manager = manager;
+	return rsc;
+}
+
+static mgl_u64_t mge_hash_resource_name(const mgl_chr8_t* name)
+{
+	// FNV-1a
+	mgl_u64_t hash = 14695981039346656037ull;
+	for (mgl_u64_t i = 0; i < MGE_MAX_RESOURCE_NAME_SIZE && name[i] != 0; ++i)
+		hash = (hash ^ (mgl_u8_t)name[i]) * 1099511628211ull;
+	return hash;
+}
+
+static mge_resource_t* mge_lookup_resource(mge_resource_index_t* index, const mgl_chr8_t* name)
+{
+	if (index == NULL)
+		return NULL;
+
+	for (mgl_u64_t i = mge_hash_resource_name(name) & index->mask; index->slots[i] != NULL; i = (i + 1) & index->mask)
+		if (mgl_str_equal(name, index->slots[i]->name))
+			return index->slots[i];
 	return NULL;
 }
 
-mge_resource_manager_t * mge_init_resource_manager(void * allocator, mgl_u64_t max_resource_count)
+static void mge_synchronize_resource_readers(mge_resource_manager_t* manager)
+{
+	MGL_DEBUG_ASSERT(manager != NULL);
+
+	// After each epoch flip, wait for the lookups counted on the previous epoch.
+	// Two flips are needed, since a lookup might read the epoch before the first flip and only count itself after it
+	for (mgl_u32_t i = 0; i < 2; ++i)
+	{
+		mgl_i32_t epoch = mge_atomic_load_i32(&manager->reader_epoch);
+		mge_atomic_store_i32(&manager->reader_epoch, epoch + 1);
+		for (mgl_u64_t j = 0; j < manager->reader_count; ++j)
+			while (mge_atomic_load_i32(&manager->readers[j].count[epoch & 1]) != 0)
+				mge_internal_yield_thread();
+	}
+}
+
+static void mge_publish_resource_index(mge_resource_manager_t* manager)
+{
+	MGL_DEBUG_ASSERT(manager != NULL);
+	MGE_PROFILE_BEGIN(u8"Publish resource index");
+
+	// Build a new index with every resource, keeping it at most half full
+	mgl_u64_t capacity = 16;
+	while (capacity < 2 * manager->resource_count)
+		capacity *= 2;
+
+	mge_resource_index_t* index;
+	mgl_error_t err = mgl_allocate(manager->allocator, sizeof(mge_resource_index_t) + capacity * sizeof(mge_resource_t*), (void**)&index);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate resource index", err);
+
+	index->mask = capacity - 1;
+	index->slots = (mge_resource_t**)(index + 1);
+	for (mgl_u64_t i = 0; i < capacity; ++i)
+		index->slots[i] = NULL;
+
+	// When two resources have the same name, the one added first is found
+	for (mgl_u64_t i = 0; i < manager->resource_count; ++i)
+	{
+		mge_resource_t* rsc = &manager->resources[i];
+		mgl_u64_t j = mge_hash_resource_name(rsc->name) & index->mask;
+		for (; index->slots[j] != NULL; j = (j + 1) & index->mask)
+			if (mgl_str_equal(rsc->name, index->slots[j]->name))
+				break;
+		if (index->slots[j] == NULL)
+			index->slots[j] = rsc;
+	}
+
+	// Publish it, and deallocate the previous one once no lookup can be reading it
+	mge_resource_index_t* previous = (mge_resource_index_t*)manager->index;
+	mge_atomic_store_ptr(&manager->index, index);
+	if (previous != NULL)
+	{
+		mge_synchronize_resource_readers(manager);
+		err = mgl_deallocate(manager->allocator, previous);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate resource index", err);
+	}
+
+	MGE_PROFILE_END();
+}
+
+mge_resource_manager_t * mge_init_resource_manager(void * allocator, mge_job_system_t * job_system, mgl_u64_t max_resource_count)
 {
 	MGL_DEBUG_ASSERT(allocator != NULL && max_resource_count > 0);
 
@@ -196,6 +638,46 @@ mge_resource_manager_t * mge_init_resource_manager(void * allocator, mgl_u64_t m
 
 	manager->allocator = allocator;
 	manager->max_resource_count = max_resource_count;
+	manager->resource_count = 0;
+	manager->index = NULL;
+	mge_atomic_store_i32(&manager->reader_epoch, 0);
+	err = mgl_create_mutex(&manager->registration_mutex);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to create resource manager registration mutex", err);
+
+	// Allocate readers
+	manager->reader_count = job_system != NULL ? mge_get_job_worker_count(job_system) + 1 : 1;
+	err = mgl_allocate_aligned(allocator, manager->reader_count * sizeof(mge_resource_reader_t), 64, (void**)&manager->readers);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate resource manager readers", err);
+	for (mgl_u64_t i = 0; i < manager->reader_count; ++i)
+	{
+		mge_atomic_store_i32(&manager->readers[i].count[0], 0);
+		mge_atomic_store_i32(&manager->readers[i].count[1], 0);
+	}
+	manager->data_pool = mge_init_pool_allocator(allocator, MGE_RESOURCE_DATA_POOL_BLOCK_SIZE, MGE_RESOURCE_DATA_POOL_CHUNK_BLOCK_COUNT);
+	manager->job_system = job_system;
+	manager->load_root = NULL;
+	mge_atomic_store_i32(&manager->pending_load_count, 0);
+	manager->native_directory_count = 0;
+
+	// Init I/O queue
+	manager->io_queue = mge_internal_init_io_queue(allocator, MGE_RESOURCE_IO_QUEUE_DEPTH, MGE_RESOURCE_IO_BUFFER_COUNT, MGE_RESOURCE_IO_BUFFER_SIZE);
+	if (manager->io_queue != NULL)
+	{
+		err = mgl_create_mutex(&manager->io_mutex);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to create resource manager I/O mutex", err);
+		err = mgl_allocate(allocator, MGE_RESOURCE_IO_BATCH_SIZE * sizeof(mge_resource_io_load_t), (void**)&manager->io_loads);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate resource manager I/O batch", err);
+		err = mgl_allocate(allocator, MGE_RESOURCE_IO_BATCH_SIZE * sizeof(mge_resource_io_file_t), (void**)&manager->io_files);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate resource manager I/O batch", err);
+		err = mgl_allocate(allocator, MGE_RESOURCE_IO_BATCH_SIZE * sizeof(mge_io_read_t), (void**)&manager->io_reads);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate resource manager I/O batch", err);
+	}
 
 	// Init resources
 	for (mgl_u64_t i = 0; i < manager->max_resource_count; ++i)
@@ -210,6 +692,9 @@ void mge_terminate_resource_manager(mge_resource_manager_t * manager)
 {
 	MGL_DEBUG_ASSERT(manager != NULL);
 
+	// Wait for background loads
+	mge_wait_resource_loads(manager);
+
 	// Unload loaded resources
 	for (mgl_u64_t i = 0; i < manager->max_resource_count; ++i)
 		if (manager->resources[i].manager != NULL)
@@ -221,8 +706,44 @@ void mge_terminate_resource_manager(mge_resource_manager_t * manager)
 				mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to destroy resource data mutex", err);
 		}
 
+	// Terminate resource data pool
+	mge_terminate_pool_allocator(manager->data_pool);
+
+	// Terminate I/O queue
+	mgl_error_t err;
+	if (manager->io_queue != NULL)
+	{
+		err = mgl_deallocate(manager->allocator, manager->io_reads);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate resource manager I/O batch", err);
+		err = mgl_deallocate(manager->allocator, manager->io_files);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate resource manager I/O batch", err);
+		err = mgl_deallocate(manager->allocator, manager->io_loads);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate resource manager I/O batch", err);
+		err = mgl_destroy_mutex(&manager->io_mutex);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to destroy resource manager I/O mutex", err);
+		mge_internal_terminate_io_queue(manager->io_queue);
+	}
+
+	// Deallocate index and readers
+	if (manager->index != NULL)
+	{
+		err = mgl_deallocate(manager->allocator, (void*)manager->index);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate resource index", err);
+	}
+	err = mgl_deallocate_aligned(manager->allocator, manager->readers);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate resource manager readers", err);
+	err = mgl_destroy_mutex(&manager->registration_mutex);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to destroy resource manager registration mutex", err);
+
 	// Deallocate resources
-	mgl_error_t err = mgl_deallocate(manager->allocator, manager->resources);
+	err = mgl_deallocate(manager->allocator, manager->resources);
 	if (err != MGL_ERROR_NONE)
 		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate resources array on resource manager", err);
 
@@ -234,13 +755,20 @@ void mge_terminate_resource_manager(mge_resource_manager_t * manager)
 	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully terminated resource manager\n");
 }
 
-void mge_add_resource_info_file(mge_resource_manager_t * manager, const mgl_chr8_t * path)
+// Background registrations already run on a job, so they load the file's permanent resources themselves
+static void mge_register_resource_info_file(mge_resource_manager_t* manager, const mgl_chr8_t* path, mgl_bool_t background)
 {
 	MGL_DEBUG_ASSERT(manager != NULL && path != NULL);
+	MGE_PROFILE_BEGIN(u8"Add resource info file");
+
+	// New resources aren't visible to lookups until the new index is published, so they are filled without locking them
+	mgl_error_t err = mgl_lock_mutex(&manager->registration_mutex);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to lock resource manager registration mutex", err);
 	
 	// Find and open file
 	mgl_iterator_t file;
-	mgl_error_t err = mgl_file_find(path, &file);
+	err = mgl_file_find(path, &file);
 	if (err != MGL_ERROR_NONE)
 	{
 		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"Couldn't find resource info file on '");
@@ -281,6 +809,16 @@ void mge_add_resource_info_file(mge_resource_manager_t * manager, const mgl_chr8
 		goto read_error;
 	mgl_from_little_endian_4(&rsc_count, &rsc_count);
 
+	// With an I/O queue, permanent resources are read together once the whole file is parsed
+	mge_resource_t** permanent_resources = NULL;
+	mgl_u64_t permanent_count = 0;
+	if (manager->io_queue != NULL && rsc_count > 0)
+	{
+		err = mgl_allocate(manager->allocator, rsc_count * sizeof(mge_resource_t*), (void**)&permanent_resources);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate permanent resource list", err);
+	}
+
 	for (mgl_u32_t i = 0; i < rsc_count; ++i)
 	{
 		mge_resource_t* rsc = mge_get_free_resource(manager);
@@ -349,12 +887,37 @@ void mge_add_resource_info_file(mge_resource_manager_t * manager, const mgl_chr8
 			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to create resource data mutex", err);
 
 		if (rsc->hints & MGE_RESOURCE_HINT_PERMANENT)
-			mge_force_resource_load(rsc);
+		{
+			if (permanent_resources != NULL)
+				permanent_resources[permanent_count++] = rsc;
+			else if (background)
+				mge_force_resource_load(rsc);
+			else
+				mge_queue_permanent_resource_load(manager, rsc);
+		}
 	}
 
 	// Close file
 	mgl_file_close(&stream);
 
+	mge_publish_resource_index(manager);
+
+	if (permanent_count > 0 && background)
+		mge_load_permanent_resource_batch(manager, permanent_resources, permanent_count);
+	else if (permanent_count > 0)
+		mge_queue_permanent_resource_batch_load(manager, permanent_resources, permanent_count);
+	else if (permanent_resources != NULL)
+	{
+		err = mgl_deallocate(manager->allocator, permanent_resources);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate permanent resource list", err);
+	}
+
+	err = mgl_unlock_mutex(&manager->registration_mutex);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to unlock resource manager registration mutex", err);
+
+	MGE_PROFILE_END();
 	return;
 
 read_error:
@@ -364,13 +927,99 @@ read_error:
 	mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to read resource info file", err);
 }
 
+static void mge_resource_info_file_job(mge_job_t* job, void* data)
+{
+	mge_resource_info_file_job_data_t* info = (mge_resource_info_file_job_data_t*)data;
+	mge_resource_manager_t* manager = info->manager;
+
+	mge_register_resource_info_file(manager, info->path, MGL_TRUE);
+
+	mgl_error_t err = mgl_deallocate(manager->allocator, info->path);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate resource info file path", err);
+
+	mge_atomic_add_i32(&manager->pending_load_count, -1);
+}
+
+void mge_add_resource_info_file(mge_resource_manager_t * manager, const mgl_chr8_t * path)
+{
+	MGL_DEBUG_ASSERT(manager != NULL && path != NULL);
+	mge_register_resource_info_file(manager, path, MGL_FALSE);
+}
+
+void mge_queue_resource_info_file(mge_resource_manager_t * manager, const mgl_chr8_t * path)
+{
+	MGL_DEBUG_ASSERT(manager != NULL && path != NULL);
+
+	if (mgl_str_size(path) >= MGE_MAX_RESOURCE_DATA_PATH_SIZE)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to queue resource info file, path too long");
+
+	// The job is queued under the root with the registration mutex locked, the same as permanent resource loads
+	mgl_error_t err = mgl_lock_mutex(&manager->registration_mutex);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to lock resource manager registration mutex", err);
+
+	mge_job_t* root = mge_begin_background_load(manager);
+	if (root != NULL)
+	{
+		// The path is copied, since the caller might not keep it until the job runs
+		mge_resource_info_file_job_data_t info;
+		info.manager = manager;
+		err = mgl_allocate(manager->allocator, MGE_MAX_RESOURCE_DATA_PATH_SIZE, (void**)&info.path);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate resource info file path", err);
+		mgl_str_copy(path, info.path, MGE_MAX_RESOURCE_DATA_PATH_SIZE);
+
+		mge_run_job(mge_create_job(manager->job_system, root, &mge_resource_info_file_job, &info, sizeof(info)));
+	}
+
+	err = mgl_unlock_mutex(&manager->registration_mutex);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to unlock resource manager registration mutex", err);
+
+	// The registration locks the mutex itself
+	if (root == NULL)
+		mge_register_resource_info_file(manager, path, MGL_FALSE);
+}
+
+void mge_add_resource_native_directory(mge_resource_manager_t * manager, const mgl_chr8_t * archive, const mgl_chr8_t * directory)
+{
+	MGL_DEBUG_ASSERT(manager != NULL && archive != NULL && directory != NULL);
+
+	if (manager->native_directory_count == MGE_MAX_RESOURCE_NATIVE_DIRECTORY_COUNT)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to add resource native directory, max native directory count surpassed");
+	if (mgl_str_size(archive) >= MGE_MAX_RESOURCE_NAME_SIZE || mgl_str_size(directory) >= MGE_MAX_RESOURCE_DATA_PATH_SIZE)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to add resource native directory, archive name or directory path too long");
+
+	mgl_str_copy(archive, manager->native_directories[manager->native_directory_count].archive, MGE_MAX_RESOURCE_NAME_SIZE);
+	mgl_str_copy(directory, manager->native_directories[manager->native_directory_count].directory, MGE_MAX_RESOURCE_DATA_PATH_SIZE);
+	manager->native_directory_count += 1;
+}
+
+mge_resource_t * mge_try_find_resource(mge_resource_manager_t * manager, const mgl_chr8_t * name)
+{
+	MGL_DEBUG_ASSERT(manager != NULL && name != NULL);
+
+	mge_resource_reader_t* reader = &manager->readers[0];
+	if (manager->job_system != NULL)
+		reader = &manager->readers[mge_get_job_worker_index(manager->job_system)];
+
+	// Count the lookup on the current epoch, so the index read isn't deallocated until it is done
+	mgl_i32_t epoch = mge_atomic_load_i32(&manager->reader_epoch) & 1;
+	mge_atomic_add_i32(&reader->count[epoch], 1);
+	mge_resource_t* rsc = mge_lookup_resource((mge_resource_index_t*)mge_atomic_load_ptr(&manager->index), name);
+	mge_atomic_add_i32(&reader->count[epoch], -1);
+
+	return rsc;
+}
+
 mge_resource_t * mge_find_resource(mge_resource_manager_t * manager, const mgl_chr8_t * name)
 {
 	MGL_DEBUG_ASSERT(manager != NULL && name != NULL);
 
-	for (mgl_u64_t i = 0; i < manager->max_resource_count; ++i)
-		if (manager->resources[i].manager == manager && mgl_str_equal(name, manager->resources[i].name))
-			return &manager->resources[i];
+	mge_resource_t* rsc = mge_try_find_resource(manager, name);
+	if (rsc != NULL)
+		return rsc;
 
 	MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"Couldn't find resource '");
 	MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, name);
@@ -414,6 +1063,90 @@ void mge_open_resource(mge_resource_t * rsc, void * access, mgl_enum_u32_t rsc_t
 	MGE_LOG_VERBOSE_3(MGE_LOG_ENGINE, u8"'\n");
 }
 
+void mge_load_resources(mge_resource_manager_t * manager, mge_resource_t ** resources, mgl_u64_t count)
+{
+	MGL_DEBUG_ASSERT(manager != NULL && (resources != NULL || count == 0));
+	MGE_PROFILE_BEGIN(u8"Load resources");
+
+	// The I/O queue and its batch are only used by one thread at a time
+	mgl_error_t err;
+	if (manager->io_queue != NULL)
+	{
+		err = mgl_lock_mutex(&manager->io_mutex);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to lock resource manager I/O mutex", err);
+	}
+
+	mgl_u64_t batch_count = 0;
+	for (mgl_u64_t i = 0; i < count; ++i)
+	{
+		mge_resource_t* rsc = resources[i];
+		MGL_DEBUG_ASSERT(rsc != NULL && rsc->manager == manager);
+
+		err = mgl_lock_mutex(&rsc->data.mutex);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to lock resource data mutex", err);
+
+		// Permanent resources are loaded without their dependencies, as in mge_add_resource_info_file
+		mgl_bool_t batched = rsc->data.ptr == NULL && mge_can_read_resource_batched(manager, rsc);
+		if (rsc->data.ptr == NULL && !batched)
+		{
+			if (!(rsc->hints & MGE_RESOURCE_HINT_PERMANENT))
+				mge_resource_load_dependencies(rsc);
+			mge_force_resource_load(rsc);
+		}
+
+		err = mgl_unlock_mutex(&rsc->data.mutex);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to unlock resource data mutex", err);
+
+		if (!batched)
+			continue;
+
+		manager->io_loads[batch_count++].rsc = rsc;
+		if (batch_count == MGE_RESOURCE_IO_BATCH_SIZE)
+		{
+			mge_read_resource_batch(manager, batch_count);
+			batch_count = 0;
+		}
+	}
+
+	if (batch_count > 0)
+		mge_read_resource_batch(manager, batch_count);
+
+	if (manager->io_queue != NULL)
+	{
+		err = mgl_unlock_mutex(&manager->io_mutex);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to unlock resource manager I/O mutex", err);
+	}
+
+	MGE_PROFILE_END();
+}
+
+void mge_wait_resource_loads(mge_resource_manager_t * manager)
+{
+	MGL_DEBUG_ASSERT(manager != NULL);
+
+	// Take the root, so loads queued from now on go under a new one instead of a root which might be finished
+	mgl_error_t err = mgl_lock_mutex(&manager->registration_mutex);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to lock resource manager registration mutex", err);
+	mge_job_t* root = manager->load_root;
+	manager->load_root = NULL;
+	err = mgl_unlock_mutex(&manager->registration_mutex);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to unlock resource manager registration mutex", err);
+
+	if (root == NULL)
+		return;
+
+	MGE_PROFILE_BEGIN(u8"Wait for resource loads");
+	// The root might have been created by another worker
+	mge_run_and_wait_job(root);
+	MGE_PROFILE_END();
+}
+
 void mge_close_resource(void * access)
 {
 	MGL_DEBUG_ASSERT(access != NULL);
@@ -446,3 +1179,12 @@ void mge_close_resource(void * access)
 	if (err != MGL_ERROR_NONE)
 		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to unlock resource data mutex", err);
 }
+
+void * mge_internal_get_resource_data_allocator(mge_resource_manager_t * manager, mgl_u64_t size)
+{
+	MGL_DEBUG_ASSERT(manager != NULL);
+
+	if (size <= MGE_RESOURCE_DATA_POOL_BLOCK_SIZE)
+		return manager->data_pool;
+	return manager->allocator;
+}
@@ -0,0 +1,138 @@
+#include <mge/resource/prefab.h>
+#include <mge/log.h>
+
+#include <mgl/file/archive.h>
+#include <mgl/memory/allocator.h>
+
+static mgl_bool_t mge_validate_prefab(const mge_prefab_resource_data_t* data)
+{
+	for (mgl_u64_t i = 0; i < data->node_count; ++i)
+		if (data->parents[i] != MGE_PREFAB_NO_PARENT && data->parents[i] >= i)
+			return MGL_FALSE;
+
+	for (mgl_u64_t i = 0; i < data->component_count; ++i)
+		if (data->components[i].node >= data->node_count ||
+			data->components[i].payload_offset > data->payloads_size ||
+			data->components[i].payload_size > data->payloads_size - data->components[i].payload_offset)
+			return MGL_FALSE;
+
+	return MGL_TRUE;
+}
+
+void mge_resource_load_prefab(mge_resource_t * rsc)
+{
+	MGL_DEBUG_ASSERT(rsc != NULL && rsc->type == MGE_RESOURCE_PREFAB);
+
+	// Find and open file
+	mgl_iterator_t file;
+	mgl_error_t err = mgl_file_find(rsc->data.path, &file);
+	if (err != MGL_ERROR_NONE)
+	{
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"Couldn't find prefab resource data file on '");
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, rsc->data.path);
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to load prefab resource data file, file not found", err);
+	}
+
+	mgl_file_stream_t stream;
+	err = mgl_file_open(&file, &stream, MGL_FILE_READ);
+	if (err != MGL_ERROR_NONE)
+	{
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"Couldn't open prefab resource data file on '");
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, rsc->data.path);
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to load prefab resource data file, couldn't open file", err);
+	}
+
+	// Seek data offset
+	err = mgl_seek_r(&stream, (mgl_i64_t)rsc->data.offset, MGL_STREAM_SEEK_BEGIN);
+	if (err != MGL_ERROR_NONE)
+	{
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"Couldn't seek to offset on prefab resource data file on '");
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, rsc->data.path);
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to seek to offset on prefab resource data file", err);
+	}
+
+	// Read header
+	mgl_u64_t header[3];
+	err = mgl_read(&stream, header, sizeof(header), NULL);
+	if (err != MGL_ERROR_NONE)
+		goto read_error;
+
+	// The counts are checked first, so that the sizes computed from them can't overflow
+	if (header[0] > MGE_MAX_PREFAB_NODE_COUNT || header[1] > MGE_MAX_PREFAB_COMPONENT_COUNT || header[2] > MGE_MAX_PREFAB_PAYLOADS_SIZE)
+	{
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"Invalid prefab resource data on '");
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, rsc->data.path);
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to load prefab resource, too many nodes or components, or payloads too big");
+	}
+
+	// The arrays are stored in the file with the same layout they have in memory, so they are read all at once
+	mgl_u64_t transforms_size = header[0] * sizeof(mgl_f32m4x4_t);
+	mgl_u64_t components_size = header[1] * sizeof(mge_prefab_component_t);
+	mgl_u64_t parents_size = header[0] * sizeof(mgl_u32_t);
+	mgl_u64_t names_size = header[0] * MGE_MAX_SCENE_NODE_NAME_SIZE;
+	mgl_u64_t body_size = transforms_size + components_size + parents_size + names_size + header[2];
+
+	void* allocator = mge_internal_get_resource_data_allocator(rsc->manager, sizeof(mge_prefab_resource_data_t) + body_size);
+	mge_prefab_resource_data_t* data;
+	err = mgl_allocate(allocator, sizeof(mge_prefab_resource_data_t) + body_size, (void**)&data);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate prefab resource data", err);
+
+	mgl_u8_t* body = (mgl_u8_t*)data + sizeof(mge_prefab_resource_data_t);
+	data->allocator = allocator;
+	data->node_count = header[0];
+	data->component_count = header[1];
+	data->payloads_size = header[2];
+	data->transforms = (const mgl_f32m4x4_t*)body;
+	data->components = (const mge_prefab_component_t*)(body + transforms_size);
+	data->parents = (const mgl_u32_t*)(body + transforms_size + components_size);
+	data->names = (const mgl_chr8_t(*)[MGE_MAX_SCENE_NODE_NAME_SIZE])(body + transforms_size + components_size + parents_size);
+	data->payloads = body + transforms_size + components_size + parents_size + names_size;
+
+	err = mgl_read(&stream, body, body_size, NULL);
+	if (err != MGL_ERROR_NONE)
+		goto read_error;
+
+	if (!mge_validate_prefab(data))
+	{
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"Invalid prefab resource data on '");
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, rsc->data.path);
+		MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to load prefab resource, invalid node parents or components");
+	}
+
+	rsc->data.ptr = data;
+
+	// Close file
+	mgl_file_close(&stream);
+
+	return;
+
+read_error:
+	MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"Failed to read prefab resource data file on '");
+	MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, rsc->data.path);
+	MGE_LOG_VERBOSE_0(MGE_LOG_ENGINE, u8"'\n");
+	mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to read prefab resource data file", err);
+}
+
+void mge_resource_unload_prefab(mge_resource_t * rsc)
+{
+	MGL_DEBUG_ASSERT(rsc != NULL && rsc->type == MGE_RESOURCE_PREFAB);
+
+	mge_prefab_resource_data_t* data = (mge_prefab_resource_data_t*)rsc->data.ptr;
+	mgl_error_t err = mgl_deallocate(data->allocator, data);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate prefab resource data", err);
+}
+
+void mge_resource_access_prefab(mge_resource_t * rsc, mge_prefab_resource_access_t * access)
+{
+	MGL_DEBUG_ASSERT(rsc != NULL && access != NULL && rsc->type == MGE_RESOURCE_PREFAB);
+
+	access->base.rsc = rsc;
+	access->data = (mge_prefab_resource_data_t*)rsc->data.ptr;
+}
@@ -4,9 +4,28 @@
 #include <mgl/file/archive.h>
 #include <mgl/memory/allocator.h>
 
-void mge_resource_load_text(void* allocator, mge_resource_t * rsc)
+mge_text_resource_data_t * mge_internal_allocate_text_resource_data(mge_resource_t * rsc, mgl_u64_t text_size)
 {
-	MGL_DEBUG_ASSERT(allocator != NULL && rsc != NULL && rsc->type == MGE_RESOURCE_TEXT);
+	MGL_DEBUG_ASSERT(rsc != NULL && rsc->type == MGE_RESOURCE_TEXT);
+
+	mgl_u64_t data_size = sizeof(mge_text_resource_data_t) + text_size + 1;
+	void* allocator = mge_internal_get_resource_data_allocator(rsc->manager, data_size);
+	mge_text_resource_data_t* data;
+	mgl_error_t err = mgl_allocate(allocator, data_size, (void**)&data);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate text resource data", err);
+	
+	data->allocator = allocator;
+	data->size = text_size;
+	data->text = (mgl_u8_t*)data + sizeof(mge_text_resource_data_t);
+
+	*((mgl_u8_t*)data + sizeof(mge_text_resource_data_t) + text_size) = 0;
+	return data;
+}
+
+void mge_resource_load_text(mge_resource_t * rsc)
+{
+	MGL_DEBUG_ASSERT(rsc != NULL && rsc->type == MGE_RESOURCE_TEXT);
 
 	// Find and open file
 	mgl_iterator_t file;
@@ -45,17 +64,8 @@ void mge_resource_load_text(void* allocator, mge_resource_t * rsc)
 	if (err != MGL_ERROR_NONE)
 		goto read_error;
 
-	mge_text_resource_data_t* data;
-	err = mgl_allocate(allocator, sizeof(mge_text_resource_data_t) + text_size + 1, (void**)&data);
-	if (err != MGL_ERROR_NONE)
-		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate text resource data", err);
-	
-	data->allocator = allocator;
-	data->size = text_size;
-	data->text = (mgl_u8_t*)data + sizeof(mge_text_resource_data_t);
-
-	*((mgl_u8_t*)data + sizeof(mge_text_resource_data_t) + text_size) = 0;
-	err = mgl_read(&stream, (mgl_u8_t*)data + sizeof(mge_text_resource_data_t), text_size, NULL);
+	mge_text_resource_data_t* data = mge_internal_allocate_text_resource_data(rsc, text_size);
+	err = mgl_read(&stream, (mgl_u8_t*)data->text, text_size, NULL);
 	if (err != MGL_ERROR_NONE)
 		goto read_error;
 
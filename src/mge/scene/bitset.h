@@ -0,0 +1,29 @@
+#ifndef MGE_SCENE_BITSET_H
+#define MGE_SCENE_BITSET_H
+
+#include <mgl/type.h>
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#endif
+
+// Bitsets indexed by scene node index, stored as arrays of 64 bit words
+
+#define MGE_SCENE_BITSET_WORD_COUNT(bit_count) (((bit_count) + 63) / 64)
+#define MGE_SCENE_BITSET_SET(bits, index) ((bits)[(index) / 64] |= (1ull << ((index) % 64)))
+#define MGE_SCENE_BITSET_CLEAR(bits, index) ((bits)[(index) / 64] &= ~(1ull << ((index) % 64)))
+#define MGE_SCENE_BITSET_TEST(bits, index) ((mgl_bool_t)(((bits)[(index) / 64] >> ((index) % 64)) & 1))
+
+// Index of the lowest set bit (bits must not be zero)
+static inline mgl_u64_t mge_scene_bitset_ctz(mgl_u64_t bits)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, bits);
+	return index;
+#else
+	return (mgl_u64_t)__builtin_ctzll(bits);
+#endif
+}
+
+#endif
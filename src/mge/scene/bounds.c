@@ -0,0 +1,171 @@
+#include <mge/scene/bounds.h>
+
+#include <math.h>
+#include <float.h>
+
+void mge_clear_aabb(mge_aabb_t * aabb)
+{
+	MGL_DEBUG_ASSERT(aabb != NULL);
+	for (int i = 0; i < 3; ++i)
+	{
+		aabb->min[i] = FLT_MAX;
+		aabb->max[i] = -FLT_MAX;
+	}
+}
+
+mgl_bool_t mge_is_aabb_empty(const mge_aabb_t * aabb)
+{
+	MGL_DEBUG_ASSERT(aabb != NULL);
+	return aabb->min[0] > aabb->max[0] || aabb->min[1] > aabb->max[1] || aabb->min[2] > aabb->max[2];
+}
+
+void mge_merge_aabb(const mge_aabb_t * a, const mge_aabb_t * b, mge_aabb_t * out)
+{
+	MGL_DEBUG_ASSERT(a != NULL && b != NULL && out != NULL);
+	for (int i = 0; i < 3; ++i)
+	{
+		out->min[i] = a->min[i] < b->min[i] ? a->min[i] : b->min[i];
+		out->max[i] = a->max[i] > b->max[i] ? a->max[i] : b->max[i];
+	}
+}
+
+void mge_transform_aabb(const mgl_f32m4x4_t * m, const mge_aabb_t * aabb, mge_aabb_t * out)
+{
+	MGL_DEBUG_ASSERT(m != NULL && aabb != NULL && out != NULL && aabb != out);
+
+	if (mge_is_aabb_empty(aabb))
+	{
+		mge_clear_aabb(out);
+		return;
+	}
+
+	// Arvo's method: start from the translation and add the extremes of each rotated axis
+	for (int i = 0; i < 3; ++i)
+	{
+		out->min[i] = out->max[i] = MGE_F32M4X4_AT(m, i, 3);
+		for (int j = 0; j < 3; ++j)
+		{
+			mgl_f32_t a = MGE_F32M4X4_AT(m, i, j) * aabb->min[j];
+			mgl_f32_t b = MGE_F32M4X4_AT(m, i, j) * aabb->max[j];
+			if (a < b)
+			{
+				out->min[i] += a;
+				out->max[i] += b;
+			}
+			else
+			{
+				out->min[i] += b;
+				out->max[i] += a;
+			}
+		}
+	}
+}
+
+mgl_f32_t mge_get_aabb_surface_area(const mge_aabb_t * aabb)
+{
+	MGL_DEBUG_ASSERT(aabb != NULL);
+	if (mge_is_aabb_empty(aabb))
+		return 0.0f;
+
+	mgl_f32_t x = aabb->max[0] - aabb->min[0];
+	mgl_f32_t y = aabb->max[1] - aabb->min[1];
+	mgl_f32_t z = aabb->max[2] - aabb->min[2];
+	return 2.0f * (x * y + y * z + z * x);
+}
+
+void mge_frustum_from_matrix(const mgl_f32m4x4_t * m, mge_frustum_t * frustum)
+{
+	MGL_DEBUG_ASSERT(m != NULL && frustum != NULL);
+
+	// Gribb-Hartmann: each plane is the last row of the matrix plus or minus one of the others
+	for (int i = 0; i < 3; ++i)
+		for (int j = 0; j < 4; ++j)
+		{
+			frustum->planes[i * 2 + 0][j] = MGE_F32M4X4_AT(m, 3, j) + MGE_F32M4X4_AT(m, i, j);
+			frustum->planes[i * 2 + 1][j] = MGE_F32M4X4_AT(m, 3, j) - MGE_F32M4X4_AT(m, i, j);
+		}
+
+	for (int i = 0; i < 6; ++i)
+	{
+		mgl_f32_t* p = frustum->planes[i];
+		mgl_f32_t length = sqrtf(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+		if (length > 0.0f)
+			for (int j = 0; j < 4; ++j)
+				p[j] /= length;
+	}
+}
+
+mgl_bool_t mge_aabb_intersects_aabb(const mge_aabb_t * a, const mge_aabb_t * b)
+{
+	MGL_DEBUG_ASSERT(a != NULL && b != NULL);
+	return a->min[0] <= b->max[0] && a->max[0] >= b->min[0] &&
+		   a->min[1] <= b->max[1] && a->max[1] >= b->min[1] &&
+		   a->min[2] <= b->max[2] && a->max[2] >= b->min[2];
+}
+
+mgl_bool_t mge_aabb_intersects_sphere(const mge_aabb_t * aabb, const mge_sphere_t * sphere)
+{
+	MGL_DEBUG_ASSERT(aabb != NULL && sphere != NULL);
+	if (mge_is_aabb_empty(aabb))
+		return MGL_FALSE;
+
+	// Squared distance from the center to the closest point on the box
+	mgl_f32_t distance = 0.0f;
+	for (int i = 0; i < 3; ++i)
+	{
+		mgl_f32_t c = sphere->center[i];
+		if (c < aabb->min[i])
+			distance += (aabb->min[i] - c) * (aabb->min[i] - c);
+		else if (c > aabb->max[i])
+			distance += (c - aabb->max[i]) * (c - aabb->max[i]);
+	}
+	return distance <= sphere->radius * sphere->radius;
+}
+
+mgl_bool_t mge_aabb_intersects_frustum(const mge_aabb_t * aabb, const mge_frustum_t * frustum)
+{
+	MGL_DEBUG_ASSERT(aabb != NULL && frustum != NULL);
+	if (mge_is_aabb_empty(aabb))
+		return MGL_FALSE;
+
+	// Test the box corner furthest along each plane normal
+	for (int i = 0; i < 6; ++i)
+	{
+		const mgl_f32_t* p = frustum->planes[i];
+		mgl_f32_t x = p[0] >= 0.0f ? aabb->max[0] : aabb->min[0];
+		mgl_f32_t y = p[1] >= 0.0f ? aabb->max[1] : aabb->min[1];
+		mgl_f32_t z = p[2] >= 0.0f ? aabb->max[2] : aabb->min[2];
+		if (p[0] * x + p[1] * y + p[2] * z + p[3] < 0.0f)
+			return MGL_FALSE;
+	}
+	return MGL_TRUE;
+}
+
+mgl_bool_t mge_aabb_intersects_ray(const mge_aabb_t * aabb, const mge_ray_t * ray, mgl_f32_t * distance)
+{
+	MGL_DEBUG_ASSERT(aabb != NULL && ray != NULL);
+
+	// Slab test
+	mgl_f32_t near = 0.0f;
+	mgl_f32_t far = ray->max_distance;
+	for (int i = 0; i < 3; ++i)
+	{
+		mgl_f32_t inv = 1.0f / ray->direction[i];
+		mgl_f32_t t0 = (aabb->min[i] - ray->origin[i]) * inv;
+		mgl_f32_t t1 = (aabb->max[i] - ray->origin[i]) * inv;
+		if (t0 > t1)
+		{
+			mgl_f32_t t = t0;
+			t0 = t1;
+			t1 = t;
+		}
+		near = t0 > near ? t0 : near;
+		far = t1 < far ? t1 : far;
+		if (near > far)
+			return MGL_FALSE;
+	}
+
+	if (distance != NULL)
+		*distance = near;
+	return MGL_TRUE;
+}
@@ -0,0 +1,671 @@
+#include <mge/scene/bvh.h>
+#include <mge/scene/manager.h>
+#include <mge/scene/node.h>
+#include <mge/log.h>
+
+#include <mge/scene/bitset.h>
+
+#include <mgl/memory/allocator.h>
+
+#define MGE_SCENE_BVH_INVALID 0xFFFFFFFFu
+#define MGE_SCENE_BVH_OVERFLOW_BIT 0x80000000u
+
+#define MGE_SCENE_BVH_BIN_COUNT 16
+#define MGE_SCENE_BVH_MAX_LEAF_SIZE 4
+#define MGE_SCENE_BVH_MAX_FORCED_LEAF_SIZE 16
+#define MGE_SCENE_BVH_MAX_DEPTH 60
+#define MGE_SCENE_BVH_STACK_SIZE 64
+
+// Cost of visiting an internal node, relative to testing a scene node's bounds
+#define MGE_SCENE_BVH_TRAVERSAL_COST 1.0f
+
+// Overflow nodes are tested linearly by every query, so the tree is rebuilt once there are this many of them
+#define MGE_SCENE_BVH_MAX_OVERFLOW_COUNT 256
+
+// The tree is rebuilt once refitting makes its SAH cost this many times worse than after the last rebuild
+#define MGE_SCENE_BVH_REBUILD_COST_RATIO 1.5f
+
+typedef struct mge_scene_bvh_node_t mge_scene_bvh_node_t;
+
+struct mge_scene_bvh_node_t
+{
+	mge_aabb_t aabb;
+
+	// Leaves store the range of scene nodes [first, first + count) and internal nodes store their
+	// children at first and first + 1 (children are always allocated after their parents)
+	mgl_u32_t first;
+	mgl_u32_t count;
+	mgl_u32_t parent;
+	mgl_u16_t leaf;
+	mgl_u16_t dirty;
+};
+
+struct mge_scene_bvh_t
+{
+	void* allocator;
+	mge_scene_manager_t* manager;
+
+	mge_scene_bvh_node_t* tree;
+	mgl_u64_t tree_node_count;
+
+	// Scene node indices stored in the tree, grouped by leaf
+	mgl_u32_t* items;
+	mgl_u32_t* item_leaves;
+	mgl_f32_t* item_centroids;
+	mgl_u64_t item_count;
+
+	// Scene nodes added since the last rebuild
+	mgl_u32_t* overflow;
+	mgl_u64_t overflow_count;
+
+	// Position of each scene node on the items array (or on the overflow array, with the overflow bit set)
+	mgl_u32_t* slots;
+
+	// Static BVHs store the frozen nodes, and are rebuilt when the scene manager's static version changes
+	mgl_bool_t is_static;
+	mgl_u64_t static_version;
+
+	mgl_u64_t rebuild_interval;
+	mgl_u64_t update_count;
+	mgl_u64_t rebuild_count;
+	mgl_f32_t cost;
+	mgl_f32_t build_cost;
+};
+
+typedef mgl_bool_t(*mge_scene_bvh_test_func_t)(const mge_aabb_t* aabb, const void* shape);
+
+static const mge_aabb_t* mge_get_scene_bvh_item_aabb(mge_scene_bvh_t* bvh, mgl_u32_t node)
+{
+	return &bvh->manager->nodes[node].bounds.global;
+}
+
+static void mge_make_scene_bvh_leaf(mge_scene_bvh_t* bvh, mgl_u32_t index, mgl_u32_t first, mgl_u32_t count)
+{
+	mge_scene_bvh_node_t* node = &bvh->tree[index];
+	node->leaf = 1;
+	node->first = first;
+	node->count = count;
+
+	for (mgl_u32_t i = first; i < first + count; ++i)
+	{
+		bvh->item_leaves[i] = index;
+		bvh->slots[bvh->items[i]] = i;
+	}
+}
+
+static void mge_swap_scene_bvh_items(mge_scene_bvh_t* bvh, mgl_u32_t a, mgl_u32_t b)
+{
+	mgl_u32_t t = bvh->items[a];
+	bvh->items[a] = bvh->items[b];
+	bvh->items[b] = t;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		mgl_f32_t c = bvh->item_centroids[a * 3 + i];
+		bvh->item_centroids[a * 3 + i] = bvh->item_centroids[b * 3 + i];
+		bvh->item_centroids[b * 3 + i] = c;
+	}
+}
+
+static void mge_build_scene_bvh_node(mge_scene_bvh_t* bvh, mgl_u32_t index, mgl_u32_t first, mgl_u32_t count, mgl_u32_t depth)
+{
+	mge_scene_bvh_node_t* node = &bvh->tree[index];
+	node->dirty = 0;
+
+	// Compute the node bounds and the bounds of the item centroids
+	mge_aabb_t centroid_bounds;
+	mge_clear_aabb(&node->aabb);
+	mge_clear_aabb(&centroid_bounds);
+	for (mgl_u32_t i = first; i < first + count; ++i)
+	{
+		mge_merge_aabb(&node->aabb, mge_get_scene_bvh_item_aabb(bvh, bvh->items[i]), &node->aabb);
+		for (int j = 0; j < 3; ++j)
+		{
+			mgl_f32_t c = bvh->item_centroids[i * 3 + j];
+			centroid_bounds.min[j] = c < centroid_bounds.min[j] ? c : centroid_bounds.min[j];
+			centroid_bounds.max[j] = c > centroid_bounds.max[j] ? c : centroid_bounds.max[j];
+		}
+	}
+
+	if (count <= MGE_SCENE_BVH_MAX_LEAF_SIZE || depth >= MGE_SCENE_BVH_MAX_DEPTH)
+	{
+		mge_make_scene_bvh_leaf(bvh, index, first, count);
+		return;
+	}
+
+	// Split along the axis where the centroids are most spread
+	int axis = 0;
+	for (int j = 1; j < 3; ++j)
+		if (centroid_bounds.max[j] - centroid_bounds.min[j] > centroid_bounds.max[axis] - centroid_bounds.min[axis])
+			axis = j;
+	mgl_f32_t extent = centroid_bounds.max[axis] - centroid_bounds.min[axis];
+	if (extent <= 0.0f)
+	{
+		mge_make_scene_bvh_leaf(bvh, index, first, count);
+		return;
+	}
+
+	// Bin the items by centroid
+	mgl_u32_t bin_counts[MGE_SCENE_BVH_BIN_COUNT];
+	mge_aabb_t bin_aabbs[MGE_SCENE_BVH_BIN_COUNT];
+	for (int b = 0; b < MGE_SCENE_BVH_BIN_COUNT; ++b)
+	{
+		bin_counts[b] = 0;
+		mge_clear_aabb(&bin_aabbs[b]);
+	}
+
+	mgl_f32_t scale = (mgl_f32_t)MGE_SCENE_BVH_BIN_COUNT / extent;
+	for (mgl_u32_t i = first; i < first + count; ++i)
+	{
+		int b = (int)((bvh->item_centroids[i * 3 + axis] - centroid_bounds.min[axis]) * scale);
+		b = b < MGE_SCENE_BVH_BIN_COUNT ? b : MGE_SCENE_BVH_BIN_COUNT - 1;
+		bin_counts[b] += 1;
+		mge_merge_aabb(&bin_aabbs[b], mge_get_scene_bvh_item_aabb(bvh, bvh->items[i]), &bin_aabbs[b]);
+	}
+
+	// Sweep the bins from both sides and evaluate the SAH on each of the split planes
+	mgl_f32_t left_areas[MGE_SCENE_BVH_BIN_COUNT - 1];
+	mgl_u32_t left_counts[MGE_SCENE_BVH_BIN_COUNT - 1];
+	mge_aabb_t acc;
+	mgl_u32_t acc_count = 0;
+	mge_clear_aabb(&acc);
+	for (int b = 0; b < MGE_SCENE_BVH_BIN_COUNT - 1; ++b)
+	{
+		mge_merge_aabb(&acc, &bin_aabbs[b], &acc);
+		acc_count += bin_counts[b];
+		left_areas[b] = mge_get_aabb_surface_area(&acc);
+		left_counts[b] = acc_count;
+	}
+
+	mgl_f32_t area = mge_get_aabb_surface_area(&node->aabb);
+	area = area > 0.0f ? area : 1.0f;
+	mgl_f32_t best_cost = 0.0f;
+	int best_split = -1;
+	mge_clear_aabb(&acc);
+	acc_count = 0;
+	for (int b = MGE_SCENE_BVH_BIN_COUNT - 1; b > 0; --b)
+	{
+		mge_merge_aabb(&acc, &bin_aabbs[b], &acc);
+		acc_count += bin_counts[b];
+		if (acc_count == 0 || left_counts[b - 1] == 0)
+			continue;
+
+		mgl_f32_t cost = MGE_SCENE_BVH_TRAVERSAL_COST + (left_areas[b - 1] * left_counts[b - 1] + mge_get_aabb_surface_area(&acc) * acc_count) / area;
+		if (best_split < 0 || cost < best_cost)
+		{
+			best_cost = cost;
+			best_split = b;
+		}
+	}
+
+	// Splitting isn't worth it, unless the leaf would get too big
+	if (best_split < 0 || (best_cost >= (mgl_f32_t)count && count <= MGE_SCENE_BVH_MAX_FORCED_LEAF_SIZE))
+	{
+		mge_make_scene_bvh_leaf(bvh, index, first, count);
+		return;
+	}
+
+	// Partition the items in place
+	mgl_u32_t i = first;
+	mgl_u32_t j = first + count;
+	while (i < j)
+	{
+		int b = (int)((bvh->item_centroids[i * 3 + axis] - centroid_bounds.min[axis]) * scale);
+		b = b < MGE_SCENE_BVH_BIN_COUNT ? b : MGE_SCENE_BVH_BIN_COUNT - 1;
+		if (b < best_split)
+			i += 1;
+		else
+			mge_swap_scene_bvh_items(bvh, i, --j);
+	}
+
+	mgl_u32_t left_count = i - first;
+	if (left_count == 0 || left_count == count)
+		left_count = count / 2;
+
+	mgl_u32_t left = (mgl_u32_t)bvh->tree_node_count;
+	bvh->tree_node_count += 2;
+	node->leaf = 0;
+	node->first = left;
+	node->count = 0;
+	bvh->tree[left].parent = index;
+	bvh->tree[left + 1].parent = index;
+
+	mge_build_scene_bvh_node(bvh, left, first, left_count, depth + 1);
+	mge_build_scene_bvh_node(bvh, left + 1, first + left_count, count - left_count, depth + 1);
+}
+
+static void mge_mark_scene_bvh_node_dirty(mge_scene_bvh_t* bvh, mgl_u32_t index)
+{
+	while (index != MGE_SCENE_BVH_INVALID && !bvh->tree[index].dirty)
+	{
+		bvh->tree[index].dirty = 1;
+		index = bvh->tree[index].parent;
+	}
+}
+
+static void mge_refit_scene_bvh(mge_scene_bvh_t* bvh)
+{
+	// Children are always after their parents, so a reverse scan refits bottom-up
+	mgl_f32_t cost = 0.0f;
+	for (mgl_u64_t i = bvh->tree_node_count; i-- > 0;)
+	{
+		mge_scene_bvh_node_t* node = &bvh->tree[i];
+		if (node->dirty)
+		{
+			if (node->leaf)
+			{
+				mge_clear_aabb(&node->aabb);
+				for (mgl_u32_t j = node->first; j < node->first + node->count; ++j)
+					mge_merge_aabb(&node->aabb, mge_get_scene_bvh_item_aabb(bvh, bvh->items[j]), &node->aabb);
+			}
+			else
+				mge_merge_aabb(&bvh->tree[node->first].aabb, &bvh->tree[node->first + 1].aabb, &node->aabb);
+			node->dirty = 0;
+		}
+
+		cost += mge_get_aabb_surface_area(&node->aabb) * (node->leaf ? (mgl_f32_t)node->count : MGE_SCENE_BVH_TRAVERSAL_COST);
+	}
+
+	mgl_f32_t area = mge_get_aabb_surface_area(&bvh->tree[0].aabb);
+	bvh->cost = area > 0.0f ? cost / area : 0.0f;
+}
+
+static mgl_bool_t mge_is_far_from_scene_bvh_leaf(const mge_aabb_t* leaf, const mge_aabb_t* aabb)
+{
+	// Far means outside of the leaf's box grown by half of its size on each side
+	for (int i = 0; i < 3; ++i)
+	{
+		mgl_f32_t margin = 0.5f * (leaf->max[i] - leaf->min[i]);
+		if (aabb->max[i] < leaf->min[i] - margin || aabb->min[i] > leaf->max[i] + margin)
+			return MGL_TRUE;
+	}
+	return MGL_FALSE;
+}
+
+static void mge_remove_scene_bvh_item(mge_scene_bvh_t* bvh, mgl_u32_t index)
+{
+	mgl_u32_t slot = bvh->slots[index];
+	bvh->slots[index] = MGE_SCENE_BVH_INVALID;
+
+	if (slot & MGE_SCENE_BVH_OVERFLOW_BIT)
+	{
+		// Swap-remove from the overflow array
+		mgl_u32_t position = slot & ~MGE_SCENE_BVH_OVERFLOW_BIT;
+		bvh->overflow_count -= 1;
+		if (position != bvh->overflow_count)
+		{
+			bvh->overflow[position] = bvh->overflow[bvh->overflow_count];
+			bvh->slots[bvh->overflow[position]] = position | MGE_SCENE_BVH_OVERFLOW_BIT;
+		}
+	}
+	else
+	{
+		// Swap-remove from the leaf's range, leaving a hole at its end until the next rebuild
+		mgl_u32_t leaf = bvh->item_leaves[slot];
+		mge_scene_bvh_node_t* node = &bvh->tree[leaf];
+		mgl_u32_t last = node->first + node->count - 1;
+		if (slot != last)
+		{
+			bvh->items[slot] = bvh->items[last];
+			bvh->slots[bvh->items[slot]] = slot;
+		}
+		node->count -= 1;
+		bvh->item_count -= 1;
+		mge_mark_scene_bvh_node_dirty(bvh, leaf);
+	}
+}
+
+static mgl_u64_t mge_query_scene_bvh(mge_scene_bvh_t* bvh, mge_scene_bvh_test_func_t test, const void* shape, mgl_u32_t* nodes, mgl_u64_t max_node_count)
+{
+	mgl_u64_t found = 0;
+
+	mgl_u32_t stack[MGE_SCENE_BVH_STACK_SIZE];
+	mgl_u64_t stack_size = 0;
+	stack[stack_size++] = 0;
+	while (stack_size > 0)
+	{
+		mge_scene_bvh_node_t* node = &bvh->tree[stack[--stack_size]];
+		if (!test(&node->aabb, shape))
+			continue;
+
+		if (node->leaf)
+		{
+			for (mgl_u32_t i = node->first; i < node->first + node->count; ++i)
+				if (test(mge_get_scene_bvh_item_aabb(bvh, bvh->items[i]), shape))
+				{
+					if (nodes != NULL && found < max_node_count)
+						nodes[found] = bvh->items[i];
+					found += 1;
+				}
+		}
+		else
+		{
+			stack[stack_size++] = node->first + 1;
+			stack[stack_size++] = node->first;
+		}
+	}
+
+	for (mgl_u64_t i = 0; i < bvh->overflow_count; ++i)
+		if (test(mge_get_scene_bvh_item_aabb(bvh, bvh->overflow[i]), shape))
+		{
+			if (nodes != NULL && found < max_node_count)
+				nodes[found] = bvh->overflow[i];
+			found += 1;
+		}
+
+	return found;
+}
+
+static mgl_bool_t mge_scene_bvh_test_aabb(const mge_aabb_t* aabb, const void* shape)
+{
+	return mge_aabb_intersects_aabb(aabb, (const mge_aabb_t*)shape);
+}
+
+static mgl_bool_t mge_scene_bvh_test_sphere(const mge_aabb_t* aabb, const void* shape)
+{
+	return mge_aabb_intersects_sphere(aabb, (const mge_sphere_t*)shape);
+}
+
+static mgl_bool_t mge_scene_bvh_test_frustum(const mge_aabb_t* aabb, const void* shape)
+{
+	return mge_aabb_intersects_frustum(aabb, (const mge_frustum_t*)shape);
+}
+
+static mgl_bool_t mge_scene_bvh_test_ray(const mge_aabb_t* aabb, const void* shape)
+{
+	return mge_aabb_intersects_ray(aabb, (const mge_ray_t*)shape, NULL);
+}
+
+static mge_scene_bvh_t* mge_create_scene_bvh(void* allocator, mge_scene_manager_t* manager, mgl_u64_t rebuild_interval, mgl_bool_t is_static)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL && manager != NULL);
+	if (manager->max_node_count >= MGE_SCENE_BVH_OVERFLOW_BIT)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to initialize scene BVH, too many scene nodes");
+	if (!is_static && manager->moved_nodes_consumer != NULL)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to initialize scene BVH, the scene manager already has a dynamic BVH");
+
+	mge_scene_bvh_t* bvh;
+
+	// Allocate BVH
+	mgl_error_t err = mgl_allocate(allocator, sizeof(mge_scene_bvh_t), (void**)&bvh);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate scene BVH", err);
+
+	// Allocate arrays (a tree with N leaves has at most 2N - 1 nodes)
+	mgl_u64_t max_count = manager->max_node_count;
+	err = mgl_allocate(allocator, 2 * max_count * sizeof(mge_scene_bvh_node_t), (void**)&bvh->tree);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate tree on scene BVH", err);
+	err = mgl_allocate(allocator, max_count * sizeof(mgl_u32_t), (void**)&bvh->items);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate items array on scene BVH", err);
+	err = mgl_allocate(allocator, max_count * sizeof(mgl_u32_t), (void**)&bvh->item_leaves);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate item leaves array on scene BVH", err);
+	err = mgl_allocate(allocator, 3 * max_count * sizeof(mgl_f32_t), (void**)&bvh->item_centroids);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate item centroids array on scene BVH", err);
+	err = mgl_allocate(allocator, max_count * sizeof(mgl_u32_t), (void**)&bvh->overflow);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate overflow array on scene BVH", err);
+	err = mgl_allocate(allocator, max_count * sizeof(mgl_u32_t), (void**)&bvh->slots);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate slots array on scene BVH", err);
+
+	bvh->allocator = allocator;
+	bvh->manager = manager;
+	bvh->rebuild_interval = rebuild_interval;
+	bvh->is_static = is_static;
+	if (!is_static)
+		manager->moved_nodes_consumer = bvh;
+
+	mge_rebuild_scene_bvh(bvh);
+	bvh->rebuild_count = 0;
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully initialized scene BVH\n");
+
+	return bvh;
+}
+
+mge_scene_bvh_t * mge_init_scene_bvh(void * allocator, mge_scene_manager_t * manager, mgl_u64_t rebuild_interval)
+{
+	return mge_create_scene_bvh(allocator, manager, rebuild_interval, MGL_FALSE);
+}
+
+mge_scene_bvh_t * mge_init_static_scene_bvh(void * allocator, mge_scene_manager_t * manager)
+{
+	return mge_create_scene_bvh(allocator, manager, 0, MGL_TRUE);
+}
+
+void mge_terminate_scene_bvh(mge_scene_bvh_t * bvh)
+{
+	MGL_DEBUG_ASSERT(bvh != NULL);
+
+	if (bvh->manager->moved_nodes_consumer == bvh)
+		bvh->manager->moved_nodes_consumer = NULL;
+
+	// Deallocate arrays
+	mgl_error_t err = mgl_deallocate(bvh->allocator, bvh->slots);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate slots array on scene BVH", err);
+	err = mgl_deallocate(bvh->allocator, bvh->overflow);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate overflow array on scene BVH", err);
+	err = mgl_deallocate(bvh->allocator, bvh->item_centroids);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate item centroids array on scene BVH", err);
+	err = mgl_deallocate(bvh->allocator, bvh->item_leaves);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate item leaves array on scene BVH", err);
+	err = mgl_deallocate(bvh->allocator, bvh->items);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate items array on scene BVH", err);
+	err = mgl_deallocate(bvh->allocator, bvh->tree);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate tree on scene BVH", err);
+
+	// Deallocate BVH
+	err = mgl_deallocate(bvh->allocator, bvh);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate scene BVH", err);
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully terminated scene BVH\n");
+}
+
+void mge_update_scene_bvh(mge_scene_bvh_t * bvh)
+{
+	MGL_DEBUG_ASSERT(bvh != NULL);
+
+	mge_scene_manager_t* manager = bvh->manager;
+	mgl_bool_t refit = MGL_FALSE;
+
+	// Frozen nodes change rarely, so static BVHs are just rebuilt when they do
+	if (bvh->is_static)
+	{
+		bvh->update_count += 1;
+		if (bvh->static_version != manager->static_version)
+			mge_rebuild_scene_bvh(bvh);
+		return;
+	}
+
+	// The moved nodes list is cleared below, so no other BVH can be reading it
+	MGL_DEBUG_ASSERT(manager->moved_nodes_consumer == bvh);
+	for (mgl_u64_t i = 0; i < manager->moved_node_count; ++i)
+	{
+		mgl_u32_t index = manager->moved_nodes[i];
+		mge_scene_node_t* node = &manager->nodes[index];
+		mgl_bool_t present = !node->trash && !mge_is_aabb_empty(&node->bounds.global) && !MGE_SCENE_BITSET_TEST(manager->static_bits, index);
+		mgl_u32_t slot = bvh->slots[index];
+
+		// Nodes which moved far away from their leaf (teleported, or destroyed and then recreated on the same index)
+		// would bloat the tree if refitted, so they are moved to the overflow list instead
+		if (present && slot != MGE_SCENE_BVH_INVALID && !(slot & MGE_SCENE_BVH_OVERFLOW_BIT) &&
+			mge_is_far_from_scene_bvh_leaf(&bvh->tree[bvh->item_leaves[slot]].aabb, &node->bounds.global))
+		{
+			mge_remove_scene_bvh_item(bvh, index);
+			slot = MGE_SCENE_BVH_INVALID;
+			refit = MGL_TRUE;
+		}
+
+		if (slot == MGE_SCENE_BVH_INVALID)
+		{
+			// New nodes are kept out of the tree until the next rebuild
+			if (present)
+			{
+				bvh->slots[index] = (mgl_u32_t)bvh->overflow_count | MGE_SCENE_BVH_OVERFLOW_BIT;
+				bvh->overflow[bvh->overflow_count++] = index;
+			}
+		}
+		else if (!present)
+		{
+			mge_remove_scene_bvh_item(bvh, index);
+			refit = MGL_TRUE;
+		}
+		else if (!(slot & MGE_SCENE_BVH_OVERFLOW_BIT))
+		{
+			mge_mark_scene_bvh_node_dirty(bvh, bvh->item_leaves[slot]);
+			refit = MGL_TRUE;
+		}
+	}
+	mge_clear_moved_scene_nodes(manager);
+
+	bvh->update_count += 1;
+	if (refit)
+		mge_refit_scene_bvh(bvh);
+
+	if ((bvh->rebuild_interval != 0 && bvh->update_count >= bvh->rebuild_interval) ||
+		bvh->overflow_count > MGE_SCENE_BVH_MAX_OVERFLOW_COUNT ||
+		bvh->cost > bvh->build_cost * MGE_SCENE_BVH_REBUILD_COST_RATIO)
+		mge_rebuild_scene_bvh(bvh);
+}
+
+void mge_rebuild_scene_bvh(mge_scene_bvh_t * bvh)
+{
+	MGL_DEBUG_ASSERT(bvh != NULL);
+
+	mge_scene_manager_t* manager = bvh->manager;
+	if (!bvh->is_static)
+		mge_clear_moved_scene_nodes(manager);
+	bvh->static_version = manager->static_version;
+
+	// Gather every node with bounds which is frozen (static BVHs) or not (dynamic BVHs)
+	bvh->item_count = 0;
+	for (mgl_u64_t i = 0; i < manager->max_node_count; ++i)
+	{
+		mge_scene_node_t* node = &manager->nodes[i];
+		bvh->slots[i] = MGE_SCENE_BVH_INVALID;
+		if (node->trash || mge_is_aabb_empty(&node->bounds.global) || MGE_SCENE_BITSET_TEST(manager->static_bits, i) != bvh->is_static)
+			continue;
+
+		for (int j = 0; j < 3; ++j)
+			bvh->item_centroids[bvh->item_count * 3 + j] = 0.5f * (node->bounds.global.min[j] + node->bounds.global.max[j]);
+		bvh->items[bvh->item_count++] = (mgl_u32_t)i;
+	}
+	bvh->overflow_count = 0;
+
+	// Build the tree
+	bvh->tree_node_count = 1;
+	bvh->tree[0].parent = MGE_SCENE_BVH_INVALID;
+	mge_build_scene_bvh_node(bvh, 0, 0, (mgl_u32_t)bvh->item_count, 0);
+
+	// Compute the SAH cost of the new tree
+	mge_refit_scene_bvh(bvh);
+	bvh->build_cost = bvh->cost;
+	bvh->update_count = 0;
+	bvh->rebuild_count += 1;
+}
+
+mgl_u64_t mge_query_scene_bvh_aabb(mge_scene_bvh_t * bvh, const mge_aabb_t * aabb, mgl_u32_t * nodes, mgl_u64_t max_node_count)
+{
+	MGL_DEBUG_ASSERT(bvh != NULL && aabb != NULL);
+	return mge_query_scene_bvh(bvh, &mge_scene_bvh_test_aabb, aabb, nodes, max_node_count);
+}
+
+mgl_u64_t mge_query_scene_bvh_sphere(mge_scene_bvh_t * bvh, const mge_sphere_t * sphere, mgl_u32_t * nodes, mgl_u64_t max_node_count)
+{
+	MGL_DEBUG_ASSERT(bvh != NULL && sphere != NULL);
+	return mge_query_scene_bvh(bvh, &mge_scene_bvh_test_sphere, sphere, nodes, max_node_count);
+}
+
+mgl_u64_t mge_query_scene_bvh_frustum(mge_scene_bvh_t * bvh, const mge_frustum_t * frustum, mgl_u32_t * nodes, mgl_u64_t max_node_count)
+{
+	MGL_DEBUG_ASSERT(bvh != NULL && frustum != NULL);
+	return mge_query_scene_bvh(bvh, &mge_scene_bvh_test_frustum, frustum, nodes, max_node_count);
+}
+
+mgl_u64_t mge_query_scene_bvh_ray(mge_scene_bvh_t * bvh, const mge_ray_t * ray, mgl_u32_t * nodes, mgl_u64_t max_node_count)
+{
+	MGL_DEBUG_ASSERT(bvh != NULL && ray != NULL);
+	return mge_query_scene_bvh(bvh, &mge_scene_bvh_test_ray, ray, nodes, max_node_count);
+}
+
+mgl_bool_t mge_raycast_scene_bvh(mge_scene_bvh_t * bvh, const mge_ray_t * ray, mgl_u32_t * node, mgl_f32_t * distance)
+{
+	MGL_DEBUG_ASSERT(bvh != NULL && ray != NULL && node != NULL);
+
+	// The ray is shortened on every hit, so farther subtrees get culled
+	mge_ray_t r = *ray;
+	mgl_bool_t hit = MGL_FALSE;
+	mgl_f32_t d;
+
+	for (mgl_u64_t i = 0; i < bvh->overflow_count; ++i)
+		if (mge_aabb_intersects_ray(mge_get_scene_bvh_item_aabb(bvh, bvh->overflow[i]), &r, &d))
+		{
+			r.max_distance = d;
+			*node = bvh->overflow[i];
+			hit = MGL_TRUE;
+		}
+
+	mgl_u32_t stack[MGE_SCENE_BVH_STACK_SIZE];
+	mgl_u64_t stack_size = 0;
+	stack[stack_size++] = 0;
+	while (stack_size > 0)
+	{
+		mge_scene_bvh_node_t* n = &bvh->tree[stack[--stack_size]];
+		if (!mge_aabb_intersects_ray(&n->aabb, &r, NULL))
+			continue;
+
+		if (n->leaf)
+		{
+			for (mgl_u32_t i = n->first; i < n->first + n->count; ++i)
+				if (mge_aabb_intersects_ray(mge_get_scene_bvh_item_aabb(bvh, bvh->items[i]), &r, &d))
+				{
+					r.max_distance = d;
+					*node = bvh->items[i];
+					hit = MGL_TRUE;
+				}
+			continue;
+		}
+
+		// Visit the nearest child first
+		mgl_f32_t left_distance, right_distance;
+		mgl_bool_t left_hit = mge_aabb_intersects_ray(&bvh->tree[n->first].aabb, &r, &left_distance);
+		mgl_bool_t right_hit = mge_aabb_intersects_ray(&bvh->tree[n->first + 1].aabb, &r, &right_distance);
+		if (left_hit && right_hit)
+		{
+			mgl_bool_t left_first = left_distance <= right_distance;
+			stack[stack_size++] = left_first ? n->first + 1 : n->first;
+			stack[stack_size++] = left_first ? n->first : n->first + 1;
+		}
+		else if (left_hit)
+			stack[stack_size++] = n->first;
+		else if (right_hit)
+			stack[stack_size++] = n->first + 1;
+	}
+
+	if (hit && distance != NULL)
+		*distance = r.max_distance;
+	return hit;
+}
+
+void mge_get_scene_bvh_stats(mge_scene_bvh_t * bvh, mge_scene_bvh_stats_t * stats)
+{
+	MGL_DEBUG_ASSERT(bvh != NULL && stats != NULL);
+
+	stats->tree_node_count = bvh->tree_node_count;
+	stats->tree_scene_node_count = bvh->item_count;
+	stats->overflow_scene_node_count = bvh->overflow_count;
+	stats->rebuild_count = bvh->rebuild_count;
+	stats->cost = bvh->cost;
+	stats->build_cost = bvh->build_cost;
+}
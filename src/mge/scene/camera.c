@@ -0,0 +1,65 @@
+#include <mge/scene/camera.h>
+#include <mge/scene/manager.h>
+#include <mge/scene/node.h>
+#include <mge/scene/bounds.h>
+
+#include <math.h>
+
+static void mge_invert_rigid_transform(const mgl_f32m4x4_t* m, mgl_f32m4x4_t* out)
+{
+	// The inverse of [R t] is [R^T -R^T t]
+	mgl_f32m4x4_identity(out);
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+			MGE_F32M4X4_AT(out, i, j) = MGE_F32M4X4_AT(m, j, i);
+		MGE_F32M4X4_AT(out, i, 3) = -(MGE_F32M4X4_AT(m, 0, i) * MGE_F32M4X4_AT(m, 0, 3) +
+									  MGE_F32M4X4_AT(m, 1, i) * MGE_F32M4X4_AT(m, 1, 3) +
+									  MGE_F32M4X4_AT(m, 2, i) * MGE_F32M4X4_AT(m, 2, 3));
+	}
+}
+
+void mge_register_camera_component_type(mge_scene_manager_t * manager, mgl_u64_t max_camera_count)
+{
+	mge_register_scene_component_type(manager, MGE_SCENE_COMPONENT_CAMERA, sizeof(mge_camera_component_t), max_camera_count, NULL);
+}
+
+mge_camera_component_t * mge_create_camera_component(mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(node != NULL);
+
+	mge_camera_component_t* camera = (mge_camera_component_t*)mge_create_scene_component(node, MGE_SCENE_COMPONENT_CAMERA);
+	camera->view_count = 1;
+	for (mgl_u32_t i = 0; i < MGE_MAX_CAMERA_VIEW_COUNT; ++i)
+	{
+		mgl_f32m4x4_identity(&camera->projection[i]);
+		mgl_f32m4x4_identity(&camera->eye[i]);
+	}
+
+	return camera;
+}
+
+void mge_set_camera_perspective(mge_camera_component_t * camera, mgl_u32_t view, mgl_f32_t fov_y, mgl_f32_t aspect, mgl_f32_t near, mgl_f32_t far)
+{
+	MGL_DEBUG_ASSERT(camera != NULL && view < MGE_MAX_CAMERA_VIEW_COUNT && aspect > 0.0f && near > 0.0f && far > near);
+
+	mgl_f32m4x4_t* m = &camera->projection[view];
+	mgl_f32_t f = 1.0f / tanf(0.5f * fov_y);
+	for (int i = 0; i < 16; ++i)
+		m->data[i] = 0.0f;
+	MGE_F32M4X4_AT(m, 0, 0) = f / aspect;
+	MGE_F32M4X4_AT(m, 1, 1) = f;
+	MGE_F32M4X4_AT(m, 2, 2) = (far + near) / (near - far);
+	MGE_F32M4X4_AT(m, 2, 3) = 2.0f * far * near / (near - far);
+	MGE_F32M4X4_AT(m, 3, 2) = -1.0f;
+}
+
+void mge_get_camera_view_projection(mge_camera_component_t * camera, mgl_u32_t view, mgl_f32m4x4_t * out)
+{
+	MGL_DEBUG_ASSERT(camera != NULL && view < camera->view_count && out != NULL && camera->base.node != NULL);
+
+	mgl_f32m4x4_t eye, view_matrix;
+	mgl_f32m4x4_mul(mge_scene_node_get_global_transform(camera->base.node), &camera->eye[view], &eye);
+	mge_invert_rigid_transform(&eye, &view_matrix);
+	mgl_f32m4x4_mul(&camera->projection[view], &view_matrix, out);
+}
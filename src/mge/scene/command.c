@@ -0,0 +1,424 @@
+#include <mge/scene/command.h>
+#include <mge/scene/component.h>
+#include <mge/scene/node.h>
+#include <mge/scene/pool.h>
+#include <mge/log.h>
+
+#include <mgl/memory/allocator.h>
+#include <mgl/memory/manipulation.h>
+#include <mgl/string/manipulation.h>
+
+#define MGE_SCENE_COMMAND_PENDING_BIT 0x80000000u
+
+// The generation of a pending handle stores its buffer index on the low bits and the buffer's apply epoch on the rest,
+// so handles kept past the next apply don't resolve to nodes created by a later one (until the epoch wraps around)
+#define MGE_SCENE_COMMAND_BUFFER_BITS 8
+#define MGE_MAX_SCENE_COMMAND_BUFFER_COUNT (1u << MGE_SCENE_COMMAND_BUFFER_BITS)
+#define MGE_SCENE_COMMAND_DATA_SIZE 64
+
+enum
+{
+	MGE_SCENE_COMMAND_CREATE_NODE,
+	MGE_SCENE_COMMAND_DESTROY_NODE,
+	MGE_SCENE_COMMAND_SET_PARENT,
+	MGE_SCENE_COMMAND_SET_TRANSFORM,
+	MGE_SCENE_COMMAND_CREATE_COMPONENT,
+};
+
+typedef struct
+{
+	mgl_u32_t type;
+	mgl_enum_u32_t component_type;
+	mgl_u64_t key;
+	mge_scene_node_handle_t node;
+	mge_scene_node_handle_t parent;
+	union
+	{
+		mgl_chr8_t name[MGE_MAX_SCENE_NODE_NAME_SIZE];
+		mgl_f32m4x4_t transform;
+		struct
+		{
+			mgl_u64_t offset;
+			mgl_u64_t size;
+		} data;
+	} args;
+} mge_scene_command_t;
+
+typedef struct
+{
+	mgl_u64_t key;
+	mgl_u32_t buffer;
+	mgl_u32_t first;
+	mgl_u64_t count;
+} mge_scene_command_run_t;
+
+struct mge_scene_command_buffer_t
+{
+	mgl_u32_t index;
+	mgl_u64_t key;
+
+	mge_scene_command_t* commands;
+	mgl_u64_t command_count;
+	mgl_u64_t max_command_count;
+
+	/// <summary>
+	///		Component data copied by the recorded commands.
+	/// </summary>
+	mgl_u8_t* data;
+	mgl_u64_t data_size;
+	mgl_u64_t max_data_size;
+
+	/// <summary>
+	///		Number of nodes created since the last apply, and the handles of the nodes created by the last apply.
+	/// </summary>
+	mgl_u32_t pending_count;
+	mge_scene_node_handle_t* created;
+
+	/// <summary>
+	///		Epoch of the handles recorded since the last apply, and epoch of the handles on created.
+	/// </summary>
+	mgl_u32_t epoch;
+	mgl_u32_t created_epoch;
+
+	// Each buffer is written by a different thread, so they are kept on different cache lines
+	mgl_u8_t padding[64];
+};
+
+struct mge_scene_commands_t
+{
+	void* allocator;
+	mge_scene_manager_t* manager;
+	mgl_u64_t buffer_count;
+	mge_scene_command_buffer_t* buffers;
+
+	/// <summary>
+	///		Runs of consecutive commands with the same key, sorted by key on apply.
+	/// </summary>
+	mge_scene_command_run_t* runs;
+	mge_scene_command_run_t* run_scratch;
+};
+
+static mge_scene_command_t* mge_push_scene_command(mge_scene_command_buffer_t* buffer, mgl_u32_t type, mge_scene_node_handle_t node)
+{
+	if (buffer->command_count >= buffer->max_command_count)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to record scene command, the command buffer is full");
+
+	mge_scene_command_t* command = &buffer->commands[buffer->command_count++];
+	command->type = type;
+	command->key = buffer->key;
+	command->node = node;
+	return command;
+}
+
+static mge_scene_node_t* mge_resolve_scene_command_node(mge_scene_commands_t* commands, mge_scene_node_handle_t handle)
+{
+	return mge_resolve_scene_node_handle(commands->manager, mge_resolve_scene_command_handle(commands, handle));
+}
+
+static void mge_sort_scene_command_runs(mge_scene_commands_t* commands, mgl_u64_t count)
+{
+	// Bottom-up merge sort, which is stable, so runs with the same key keep the buffer order
+	mge_scene_command_run_t* src = commands->runs;
+	mge_scene_command_run_t* dst = commands->run_scratch;
+	for (mgl_u64_t width = 1; width < count; width *= 2)
+	{
+		for (mgl_u64_t begin = 0; begin < count; begin += 2 * width)
+		{
+			mgl_u64_t mid = begin + width < count ? begin + width : count;
+			mgl_u64_t end = begin + 2 * width < count ? begin + 2 * width : count;
+			mgl_u64_t i = begin, j = mid;
+			for (mgl_u64_t k = begin; k < end; ++k)
+				dst[k] = i < mid && (j >= end || src[i].key <= src[j].key) ? src[i++] : src[j++];
+		}
+
+		mge_scene_command_run_t* temp = src;
+		src = dst;
+		dst = temp;
+	}
+
+	if (src != commands->runs)
+		mgl_mem_copy(commands->runs, src, count * sizeof(mge_scene_command_run_t));
+}
+
+static void mge_apply_scene_command(mge_scene_commands_t* commands, mge_scene_command_buffer_t* buffer, mge_scene_command_t* command)
+{
+	mge_scene_node_t* node = NULL;
+	if (command->type != MGE_SCENE_COMMAND_CREATE_NODE)
+	{
+		node = mge_resolve_scene_command_node(commands, command->node);
+		if (node == NULL)
+			return;
+	}
+
+	switch (command->type)
+	{
+	case MGE_SCENE_COMMAND_CREATE_NODE:
+	{
+		mge_scene_node_t* parent = mge_resolve_scene_command_node(commands, command->parent);
+		if (parent != NULL)
+			buffer->created[command->node.index & ~MGE_SCENE_COMMAND_PENDING_BIT] = mge_scene_node_get_handle(mge_create_scene_node(parent, command->args.name));
+		break;
+	}
+
+	case MGE_SCENE_COMMAND_DESTROY_NODE:
+		if (!node->trash && node->parent != NULL)
+			mge_queue_scene_node_destroy(node);
+		break;
+
+	case MGE_SCENE_COMMAND_SET_PARENT:
+	{
+		mge_scene_node_t* parent = mge_resolve_scene_command_node(commands, command->parent);
+		if (parent != NULL)
+			mge_scene_node_set_parent(node, parent);
+		break;
+	}
+
+	case MGE_SCENE_COMMAND_SET_TRANSFORM:
+		node->transform.local = command->args.transform;
+		mge_scene_node_set_dirty(node);
+		break;
+
+	case MGE_SCENE_COMMAND_CREATE_COMPONENT:
+	{
+		mge_scene_component_pool_t* pool = mge_get_scene_component_pool(commands->manager, command->component_type);
+		if (pool == NULL)
+			mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to apply scene command, component type isn't registered");
+		if (command->args.data.size > pool->component_size - sizeof(mge_scene_component_t))
+			mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to apply scene command, component data is bigger than the component");
+
+		mgl_u8_t* component = (mgl_u8_t*)mge_create_pooled_scene_component(pool, node);
+		mgl_mem_copy(component + sizeof(mge_scene_component_t), buffer->data + command->args.data.offset, command->args.data.size);
+		break;
+	}
+
+	default:
+		MGL_DEBUG_ASSERT(MGL_FALSE);
+		break;
+	}
+}
+
+mge_scene_commands_t * mge_init_scene_commands(void * allocator, mge_scene_manager_t * manager, mgl_u64_t buffer_count, mgl_u64_t max_command_count)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL && manager != NULL && buffer_count > 0 && max_command_count > 0);
+	if (buffer_count > MGE_MAX_SCENE_COMMAND_BUFFER_COUNT)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to init scene command buffers, too many buffers");
+
+	mge_scene_commands_t* commands;
+
+	// Allocate command buffers
+	mgl_error_t err = mgl_allocate(allocator, sizeof(mge_scene_commands_t), (void**)&commands);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate scene command buffers", err);
+	commands->allocator = allocator;
+	commands->manager = manager;
+	commands->buffer_count = buffer_count;
+
+	err = mgl_allocate(allocator, buffer_count * sizeof(mge_scene_command_buffer_t), (void**)&commands->buffers);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate scene command buffer array", err);
+
+	for (mgl_u64_t i = 0; i < buffer_count; ++i)
+	{
+		mge_scene_command_buffer_t* buffer = &commands->buffers[i];
+		buffer->index = (mgl_u32_t)i;
+		buffer->key = 0;
+		buffer->command_count = 0;
+		buffer->max_command_count = max_command_count;
+		buffer->data_size = 0;
+		buffer->max_data_size = max_command_count * MGE_SCENE_COMMAND_DATA_SIZE;
+		buffer->pending_count = 0;
+		buffer->epoch = 0;
+		buffer->created_epoch = (mgl_u32_t)-1;
+
+		err = mgl_allocate(allocator, max_command_count * sizeof(mge_scene_command_t), (void**)&buffer->commands);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate scene command buffer commands", err);
+		err = mgl_allocate(allocator, buffer->max_data_size, (void**)&buffer->data);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate scene command buffer data", err);
+		err = mgl_allocate(allocator, max_command_count * sizeof(mge_scene_node_handle_t), (void**)&buffer->created);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate scene command buffer created handles", err);
+	}
+
+	// Allocate runs, there is at most one per command
+	err = mgl_allocate(allocator, buffer_count * max_command_count * sizeof(mge_scene_command_run_t), (void**)&commands->runs);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate scene command runs", err);
+	err = mgl_allocate(allocator, buffer_count * max_command_count * sizeof(mge_scene_command_run_t), (void**)&commands->run_scratch);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate scene command run scratch", err);
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully initialized scene command buffers\n");
+
+	return commands;
+}
+
+void mge_terminate_scene_commands(mge_scene_commands_t * commands)
+{
+	MGL_DEBUG_ASSERT(commands != NULL);
+
+	// Deallocate runs
+	mgl_error_t err = mgl_deallocate(commands->allocator, commands->run_scratch);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate scene command run scratch", err);
+	err = mgl_deallocate(commands->allocator, commands->runs);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate scene command runs", err);
+
+	// Deallocate buffers
+	for (mgl_u64_t i = 0; i < commands->buffer_count; ++i)
+	{
+		mge_scene_command_buffer_t* buffer = &commands->buffers[i];
+		err = mgl_deallocate(commands->allocator, buffer->created);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate scene command buffer created handles", err);
+		err = mgl_deallocate(commands->allocator, buffer->data);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate scene command buffer data", err);
+		err = mgl_deallocate(commands->allocator, buffer->commands);
+		if (err != MGL_ERROR_NONE)
+			mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate scene command buffer commands", err);
+	}
+	err = mgl_deallocate(commands->allocator, commands->buffers);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate scene command buffer array", err);
+
+	err = mgl_deallocate(commands->allocator, commands);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate scene command buffers", err);
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully terminated scene command buffers\n");
+}
+
+mge_scene_command_buffer_t * mge_get_scene_command_buffer(mge_scene_commands_t * commands, mgl_u64_t index)
+{
+	MGL_DEBUG_ASSERT(commands != NULL && index < commands->buffer_count);
+	return &commands->buffers[index];
+}
+
+void mge_set_scene_command_key(mge_scene_command_buffer_t * buffer, mgl_u64_t key)
+{
+	MGL_DEBUG_ASSERT(buffer != NULL);
+	buffer->key = key;
+}
+
+mge_scene_node_handle_t mge_record_create_scene_node(mge_scene_command_buffer_t * buffer, mge_scene_node_handle_t parent, const mgl_chr8_t * name)
+{
+	MGL_DEBUG_ASSERT(buffer != NULL);
+
+	// Pending handles store the creation index on this buffer, and the buffer index and epoch as their generation
+	mge_scene_node_handle_t handle;
+	handle.index = buffer->pending_count | MGE_SCENE_COMMAND_PENDING_BIT;
+	handle.generation = (buffer->epoch << MGE_SCENE_COMMAND_BUFFER_BITS) | buffer->index;
+
+	mge_scene_command_t* command = mge_push_scene_command(buffer, MGE_SCENE_COMMAND_CREATE_NODE, handle);
+	command->parent = parent;
+	mgl_str_copy(name != NULL ? name : u8"[unnamed]", command->args.name, MGE_MAX_SCENE_NODE_NAME_SIZE);
+	buffer->pending_count += 1;
+
+	return handle;
+}
+
+void mge_record_destroy_scene_node(mge_scene_command_buffer_t * buffer, mge_scene_node_handle_t node)
+{
+	MGL_DEBUG_ASSERT(buffer != NULL);
+	mge_push_scene_command(buffer, MGE_SCENE_COMMAND_DESTROY_NODE, node);
+}
+
+void mge_record_set_scene_node_parent(mge_scene_command_buffer_t * buffer, mge_scene_node_handle_t node, mge_scene_node_handle_t parent)
+{
+	MGL_DEBUG_ASSERT(buffer != NULL);
+	mge_push_scene_command(buffer, MGE_SCENE_COMMAND_SET_PARENT, node)->parent = parent;
+}
+
+void mge_record_set_scene_node_transform(mge_scene_command_buffer_t * buffer, mge_scene_node_handle_t node, const mgl_f32m4x4_t * local)
+{
+	MGL_DEBUG_ASSERT(buffer != NULL && local != NULL);
+	mge_push_scene_command(buffer, MGE_SCENE_COMMAND_SET_TRANSFORM, node)->args.transform = *local;
+}
+
+void mge_record_create_scene_component(mge_scene_command_buffer_t * buffer, mge_scene_node_handle_t node, mgl_enum_u32_t type, const void * data, mgl_u64_t data_size)
+{
+	MGL_DEBUG_ASSERT(buffer != NULL && (data != NULL || data_size == 0));
+	if (buffer->data_size + data_size > buffer->max_data_size)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to record scene command, the command buffer data is full");
+
+	mge_scene_command_t* command = mge_push_scene_command(buffer, MGE_SCENE_COMMAND_CREATE_COMPONENT, node);
+	command->component_type = type;
+	command->args.data.offset = buffer->data_size;
+	command->args.data.size = data_size;
+	if (data_size > 0)
+		mgl_mem_copy(buffer->data + buffer->data_size, data, data_size);
+	buffer->data_size += data_size;
+}
+
+void mge_apply_scene_commands(mge_scene_commands_t * commands)
+{
+	MGL_DEBUG_ASSERT(commands != NULL);
+
+	// Split each buffer into runs of commands with the same key, and forget the nodes created by the last apply
+	mgl_u64_t run_count = 0;
+	for (mgl_u64_t i = 0; i < commands->buffer_count; ++i)
+	{
+		mge_scene_command_buffer_t* buffer = &commands->buffers[i];
+		for (mgl_u32_t j = 0; j < buffer->pending_count; ++j)
+			buffer->created[j] = MGE_SCENE_NODE_NULL_HANDLE;
+		buffer->created_epoch = buffer->epoch++;
+
+		for (mgl_u64_t j = 0; j < buffer->command_count; ++j)
+		{
+			if (j == 0 || buffer->commands[j].key != buffer->commands[j - 1].key)
+			{
+				mge_scene_command_run_t* run = &commands->runs[run_count++];
+				run->key = buffer->commands[j].key;
+				run->buffer = (mgl_u32_t)i;
+				run->first = (mgl_u32_t)j;
+				run->count = 0;
+			}
+			commands->runs[run_count - 1].count += 1;
+		}
+	}
+
+	if (run_count == 0)
+		return;
+
+	// The result only depends on the keys, not on which thread recorded each run
+	mge_sort_scene_command_runs(commands, run_count);
+	for (mgl_u64_t i = 0; i < run_count; ++i)
+	{
+		mge_scene_command_run_t* run = &commands->runs[i];
+		mge_scene_command_buffer_t* buffer = &commands->buffers[run->buffer];
+		for (mgl_u64_t j = 0; j < run->count; ++j)
+			mge_apply_scene_command(commands, buffer, &buffer->commands[run->first + j]);
+	}
+
+	for (mgl_u64_t i = 0; i < commands->buffer_count; ++i)
+	{
+		commands->buffers[i].command_count = 0;
+		commands->buffers[i].data_size = 0;
+		commands->buffers[i].pending_count = 0;
+	}
+
+	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"Applied scene commands\n");
+}
+
+mge_scene_node_handle_t mge_resolve_scene_command_handle(mge_scene_commands_t * commands, mge_scene_node_handle_t handle)
+{
+	MGL_DEBUG_ASSERT(commands != NULL);
+
+	if (!(handle.index & MGE_SCENE_COMMAND_PENDING_BIT))
+		return handle;
+
+	mgl_u32_t buffer_index = handle.generation & (MGE_MAX_SCENE_COMMAND_BUFFER_COUNT - 1);
+	mgl_u32_t index = handle.index & ~MGE_SCENE_COMMAND_PENDING_BIT;
+	if (buffer_index >= commands->buffer_count || index >= commands->buffers[buffer_index].max_command_count)
+		return MGE_SCENE_NODE_NULL_HANDLE;
+
+	// Handles recorded before the last apply are stale
+	mge_scene_command_buffer_t* buffer = &commands->buffers[buffer_index];
+	mgl_u32_t epoch = (mgl_u32_t)(buffer->created_epoch << MGE_SCENE_COMMAND_BUFFER_BITS) >> MGE_SCENE_COMMAND_BUFFER_BITS;
+	if (handle.generation >> MGE_SCENE_COMMAND_BUFFER_BITS != epoch)
+		return MGE_SCENE_NODE_NULL_HANDLE;
+	return buffer->created[index];
+}
@@ -0,0 +1,345 @@
+#include <mge/scene/culling.h>
+#include <mge/scene/camera.h>
+#include <mge/scene/manager.h>
+#include <mge/scene/node.h>
+#include <mge/scene/pool.h>
+#include <mge/job/system.h>
+#include <mge/log.h>
+
+#include <mge/scene/bitset.h>
+
+#include <mgl/memory/allocator.h>
+
+#include <math.h>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define MGE_CULLING_SSE
+#include <xmmintrin.h>
+#endif
+
+// Number of bounds culled by each job (must be a multiple of 4)
+#define MGE_CULLING_CHUNK_SIZE 4096
+
+struct mge_culling_t
+{
+	void* allocator;
+
+	mgl_u64_t max_bounds_count;
+	mgl_u64_t max_view_count;
+	mgl_u64_t max_chunk_count;
+
+	// Bounds, stored as centers and half extents (padded to a multiple of 4)
+	mgl_u64_t bounds_count;
+	mgl_u32_t* ids;
+	mgl_f32_t* center[3];
+	mgl_f32_t* extent[3];
+
+	mgl_u64_t view_count;
+	mge_frustum_t* views;
+
+	// Each view has a list of max_bounds_count entries, where each chunk first writes its results at its own offset
+	mgl_u32_t* visible;
+	mgl_u64_t* visible_counts;
+	mgl_u32_t* chunk_visible_counts;
+};
+
+typedef struct
+{
+	mge_culling_t* culling;
+	mge_job_system_t* system;
+	mgl_u32_t first_chunk;
+	mgl_u32_t chunk_count;
+} mge_culling_job_data_t;
+
+static void mge_cull_chunk(mge_culling_t* culling, mgl_u64_t chunk)
+{
+	mgl_u64_t begin = chunk * MGE_CULLING_CHUNK_SIZE;
+	mgl_u64_t end = begin + MGE_CULLING_CHUNK_SIZE < culling->bounds_count ? begin + MGE_CULLING_CHUNK_SIZE : culling->bounds_count;
+	mgl_u32_t* counts = &culling->chunk_visible_counts[chunk * culling->max_view_count];
+	for (mgl_u64_t v = 0; v < culling->view_count; ++v)
+		counts[v] = 0;
+
+	for (mgl_u64_t i = begin; i < end; i += 4)
+	{
+		// Lanes past the last bounds are padding
+		mgl_u32_t valid = end - i >= 4 ? 0xF : (1u << (end - i)) - 1;
+
+#ifdef MGE_CULLING_SSE
+		__m128 cx = _mm_loadu_ps(&culling->center[0][i]);
+		__m128 cy = _mm_loadu_ps(&culling->center[1][i]);
+		__m128 cz = _mm_loadu_ps(&culling->center[2][i]);
+		__m128 ex = _mm_loadu_ps(&culling->extent[0][i]);
+		__m128 ey = _mm_loadu_ps(&culling->extent[1][i]);
+		__m128 ez = _mm_loadu_ps(&culling->extent[2][i]);
+		__m128 sign = _mm_set1_ps(-0.0f);
+#endif
+
+		for (mgl_u64_t v = 0; v < culling->view_count; ++v)
+		{
+			const mge_frustum_t* frustum = &culling->views[v];
+			mgl_u32_t mask;
+
+			// A box is outside a plane if its center's distance is lower than minus its projected radius
+#ifdef MGE_CULLING_SSE
+			__m128 inside = _mm_cmpeq_ps(_mm_setzero_ps(), _mm_setzero_ps());
+			for (int p = 0; p < 6; ++p)
+			{
+				__m128 a = _mm_set1_ps(frustum->planes[p][0]);
+				__m128 b = _mm_set1_ps(frustum->planes[p][1]);
+				__m128 c = _mm_set1_ps(frustum->planes[p][2]);
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, cx), _mm_mul_ps(b, cy)), _mm_add_ps(_mm_mul_ps(c, cz), _mm_set1_ps(frustum->planes[p][3])));
+				__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(sign, a), ex), _mm_mul_ps(_mm_andnot_ps(sign, b), ey)), _mm_mul_ps(_mm_andnot_ps(sign, c), ez));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+			}
+			mask = (mgl_u32_t)_mm_movemask_ps(inside) & valid;
+#else
+			mask = 0;
+			for (mgl_u32_t l = 0; l < 4; ++l)
+			{
+				if (!(valid & (1u << l)))
+					continue;
+
+				mgl_bool_t inside = MGL_TRUE;
+				for (int p = 0; p < 6 && inside; ++p)
+				{
+					const mgl_f32_t* plane = frustum->planes[p];
+					mgl_f32_t distance = plane[0] * culling->center[0][i + l] + plane[1] * culling->center[1][i + l] + plane[2] * culling->center[2][i + l] + plane[3];
+					mgl_f32_t radius = fabsf(plane[0]) * culling->extent[0][i + l] + fabsf(plane[1]) * culling->extent[1][i + l] + fabsf(plane[2]) * culling->extent[2][i + l];
+					inside = distance + radius >= 0.0f;
+				}
+				mask |= (mgl_u32_t)inside << l;
+			}
+#endif
+
+			// Append the visible lanes to the chunk's part of the view's list
+			mgl_u32_t* out = &culling->visible[v * culling->max_bounds_count + begin];
+			while (mask != 0)
+			{
+				out[counts[v]++] = culling->ids[i + mge_scene_bitset_ctz(mask)];
+				mask &= mask - 1;
+			}
+		}
+	}
+}
+
+static void mge_culling_job(mge_job_t* job, void* data)
+{
+	mge_culling_job_data_t* range = (mge_culling_job_data_t*)data;
+
+	// Split the range until each job has a single chunk
+	while (range->chunk_count > 1)
+	{
+		mge_culling_job_data_t half = *range;
+		half.first_chunk = range->first_chunk + range->chunk_count / 2;
+		half.chunk_count = range->chunk_count - range->chunk_count / 2;
+		range->chunk_count /= 2;
+		mge_run_job(mge_create_job(range->system, job, &mge_culling_job, &half, sizeof(half)));
+	}
+
+	if (range->chunk_count == 1)
+		mge_cull_chunk(range->culling, range->first_chunk);
+}
+
+mge_culling_t * mge_init_culling(void * allocator, mgl_u64_t max_bounds_count, mgl_u64_t max_view_count)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL && max_bounds_count > 0 && max_view_count > 0);
+
+	mge_culling_t* culling;
+
+	// Allocate culling stage
+	mgl_error_t err = mgl_allocate(allocator, sizeof(mge_culling_t), (void**)&culling);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate culling stage", err);
+
+	culling->allocator = allocator;
+	culling->max_bounds_count = max_bounds_count;
+	culling->max_view_count = max_view_count;
+	culling->max_chunk_count = (max_bounds_count + MGE_CULLING_CHUNK_SIZE - 1) / MGE_CULLING_CHUNK_SIZE;
+	culling->bounds_count = 0;
+	culling->view_count = 0;
+
+	// Allocate bounds (padded so that the last group of 4 can be loaded at once)
+	mgl_u64_t padded_count = (max_bounds_count + 3) & ~3ull;
+	err = mgl_allocate(allocator, padded_count * sizeof(mgl_u32_t), (void**)&culling->ids);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate bounds IDs on culling stage", err);
+	err = mgl_allocate(allocator, 6 * padded_count * sizeof(mgl_f32_t), (void**)&culling->center[0]);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate bounds on culling stage", err);
+	for (int i = 0; i < 3; ++i)
+	{
+		culling->center[i] = culling->center[0] + i * padded_count;
+		culling->extent[i] = culling->center[0] + (3 + i) * padded_count;
+	}
+	for (mgl_u64_t i = 0; i < 6 * padded_count; ++i)
+		culling->center[0][i] = 0.0f;
+
+	// Allocate views and visible lists
+	err = mgl_allocate(allocator, max_view_count * sizeof(mge_frustum_t), (void**)&culling->views);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate views on culling stage", err);
+	err = mgl_allocate(allocator, max_view_count * max_bounds_count * sizeof(mgl_u32_t), (void**)&culling->visible);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate visible lists on culling stage", err);
+	err = mgl_allocate(allocator, max_view_count * sizeof(mgl_u64_t), (void**)&culling->visible_counts);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate visible counts on culling stage", err);
+	err = mgl_allocate(allocator, culling->max_chunk_count * max_view_count * sizeof(mgl_u32_t), (void**)&culling->chunk_visible_counts);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate chunk visible counts on culling stage", err);
+	for (mgl_u64_t i = 0; i < max_view_count; ++i)
+		culling->visible_counts[i] = 0;
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully initialized culling stage\n");
+
+	return culling;
+}
+
+void mge_terminate_culling(mge_culling_t * culling)
+{
+	MGL_DEBUG_ASSERT(culling != NULL);
+
+	// Deallocate views and visible lists
+	mgl_error_t err = mgl_deallocate(culling->allocator, culling->chunk_visible_counts);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate chunk visible counts on culling stage", err);
+	err = mgl_deallocate(culling->allocator, culling->visible_counts);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate visible counts on culling stage", err);
+	err = mgl_deallocate(culling->allocator, culling->visible);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate visible lists on culling stage", err);
+	err = mgl_deallocate(culling->allocator, culling->views);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate views on culling stage", err);
+
+	// Deallocate bounds
+	err = mgl_deallocate(culling->allocator, culling->center[0]);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate bounds on culling stage", err);
+	err = mgl_deallocate(culling->allocator, culling->ids);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate bounds IDs on culling stage", err);
+
+	// Deallocate culling stage
+	err = mgl_deallocate(culling->allocator, culling);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate culling stage", err);
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully terminated culling stage\n");
+}
+
+void mge_clear_culling(mge_culling_t * culling)
+{
+	MGL_DEBUG_ASSERT(culling != NULL);
+
+	culling->bounds_count = 0;
+	for (mgl_u64_t i = 0; i < culling->view_count; ++i)
+		culling->visible_counts[i] = 0;
+	culling->view_count = 0;
+}
+
+void mge_add_culling_bounds(mge_culling_t * culling, mgl_u32_t id, const mge_aabb_t * aabb)
+{
+	MGL_DEBUG_ASSERT(culling != NULL && aabb != NULL && !mge_is_aabb_empty(aabb));
+	if (culling->bounds_count >= culling->max_bounds_count)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to add culling bounds, max bounds count surpassed");
+
+	mgl_u64_t i = culling->bounds_count++;
+	culling->ids[i] = id;
+	for (int j = 0; j < 3; ++j)
+	{
+		culling->center[j][i] = 0.5f * (aabb->min[j] + aabb->max[j]);
+		culling->extent[j][i] = 0.5f * (aabb->max[j] - aabb->min[j]);
+	}
+}
+
+mgl_u64_t mge_add_culling_view(mge_culling_t * culling, const mge_frustum_t * frustum)
+{
+	MGL_DEBUG_ASSERT(culling != NULL && frustum != NULL);
+	if (culling->view_count >= culling->max_view_count)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to add culling view, max view count surpassed");
+
+	culling->views[culling->view_count] = *frustum;
+	culling->visible_counts[culling->view_count] = 0;
+	return culling->view_count++;
+}
+
+void mge_gather_scene_culling(mge_culling_t * culling, mge_scene_manager_t * manager)
+{
+	MGL_DEBUG_ASSERT(culling != NULL && manager != NULL);
+
+	mge_clear_culling(culling);
+
+	// Bounds of the nodes which are active in the hierarchy
+	for (mgl_u64_t i = mge_next_active_scene_node(manager, 0); i < manager->max_node_count; i = mge_next_active_scene_node(manager, i + 1))
+		if (!mge_is_aabb_empty(&manager->nodes[i].bounds.global))
+			mge_add_culling_bounds(culling, (mgl_u32_t)i, &manager->nodes[i].bounds.global);
+
+	// Views of the active cameras
+	mge_scene_component_pool_t* pool = mge_get_scene_component_pool(manager, MGE_SCENE_COMPONENT_CAMERA);
+	if (pool == NULL)
+		return;
+
+	mgl_u64_t camera_count;
+	mge_camera_component_t* cameras = (mge_camera_component_t*)mge_get_active_pooled_scene_components(pool, &camera_count);
+	for (mgl_u64_t i = 0; i < camera_count; ++i)
+	{
+		cameras[i].first_culling_view = culling->view_count;
+		for (mgl_u32_t v = 0; v < cameras[i].view_count; ++v)
+		{
+			mgl_f32m4x4_t view_projection;
+			mge_frustum_t frustum;
+			mge_get_camera_view_projection(&cameras[i], v, &view_projection);
+			mge_frustum_from_matrix(&view_projection, &frustum);
+			mge_add_culling_view(culling, &frustum);
+		}
+	}
+}
+
+void mge_run_culling(mge_culling_t * culling, mge_job_system_t * system)
+{
+	MGL_DEBUG_ASSERT(culling != NULL);
+
+	mgl_u64_t chunk_count = (culling->bounds_count + MGE_CULLING_CHUNK_SIZE - 1) / MGE_CULLING_CHUNK_SIZE;
+	if (system != NULL && chunk_count > 1)
+	{
+		mge_culling_job_data_t data = { culling, system, 0, (mgl_u32_t)chunk_count };
+		mge_job_t* root = mge_create_job(system, NULL, &mge_culling_job, &data, sizeof(data));
+		mge_run_job(root);
+		mge_wait_job(root);
+	}
+	else
+		for (mgl_u64_t c = 0; c < chunk_count; ++c)
+			mge_cull_chunk(culling, c);
+
+	// Join the results of each chunk
+	for (mgl_u64_t v = 0; v < culling->view_count; ++v)
+	{
+		mgl_u32_t* list = &culling->visible[v * culling->max_bounds_count];
+		mgl_u64_t count = 0;
+		for (mgl_u64_t c = 0; c < chunk_count; ++c)
+		{
+			mgl_u32_t chunk_visible_count = culling->chunk_visible_counts[c * culling->max_view_count + v];
+			mgl_u32_t* chunk_list = &list[c * MGE_CULLING_CHUNK_SIZE];
+			if (chunk_list != &list[count])
+				for (mgl_u32_t i = 0; i < chunk_visible_count; ++i)
+					list[count + i] = chunk_list[i];
+			count += chunk_visible_count;
+		}
+		culling->visible_counts[v] = count;
+	}
+}
+
+const mgl_u32_t * mge_get_culling_visible_list(mge_culling_t * culling, mgl_u64_t view, mgl_u64_t * count)
+{
+	MGL_DEBUG_ASSERT(culling != NULL && view < culling->view_count && count != NULL);
+	*count = culling->visible_counts[view];
+	return &culling->visible[view * culling->max_bounds_count];
+}
+
+const mgl_u32_t * mge_get_camera_visible_scene_nodes(mge_culling_t * culling, mge_camera_component_t * camera, mgl_u32_t view, mgl_u64_t * count)
+{
+	MGL_DEBUG_ASSERT(camera != NULL && view < camera->view_count);
+	return mge_get_culling_visible_list(culling, camera->first_culling_view + view, count);
+}
@@ -0,0 +1,79 @@
+#include <mge/scene/journal.h>
+#include <mge/scene/manager.h>
+#include <mge/log.h>
+
+#include <mgl/memory/allocator.h>
+#include <mgl/memory/manipulation.h>
+
+mge_scene_journal_t * mge_init_scene_journal(void * allocator, mgl_u64_t max_node_count)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL && max_node_count > 0);
+
+	mge_scene_journal_t* journal;
+
+	// Allocate journal
+	mgl_error_t err = mgl_allocate(allocator, sizeof(mge_scene_journal_t), (void**)&journal);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate scene journal", err);
+
+	// Allocate arrays
+	err = mgl_allocate(allocator, max_node_count * sizeof(mgl_u32_t), (void**)&journal->nodes);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate nodes array on scene journal", err);
+	err = mgl_allocate(allocator, max_node_count * sizeof(mgl_u8_t), (void**)&journal->changes);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate changes array on scene journal", err);
+	mgl_mem_set(journal->changes, max_node_count * sizeof(mgl_u8_t), 0);
+	journal->node_count = 0;
+
+	return journal;
+}
+
+void mge_terminate_scene_journal(void * allocator, mge_scene_journal_t * journal)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL && journal != NULL);
+
+	// Deallocate arrays
+	mgl_error_t err = mgl_deallocate(allocator, journal->changes);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate changes array on scene journal", err);
+	err = mgl_deallocate(allocator, journal->nodes);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate nodes array on scene journal", err);
+
+	// Deallocate journal
+	err = mgl_deallocate(allocator, journal);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate scene journal", err);
+}
+
+const mge_scene_journal_t * mge_get_scene_journal(mge_scene_manager_t * manager)
+{
+	MGL_DEBUG_ASSERT(manager != NULL);
+	return manager->published_journal;
+}
+
+void mge_record_scene_node_change(mge_scene_manager_t * manager, mgl_u64_t index, mgl_u8_t changes)
+{
+	MGL_DEBUG_ASSERT(manager != NULL && index < manager->max_node_count);
+
+	// Nodes are only added to the list on their first change
+	mge_scene_journal_t* journal = manager->journal;
+	if (journal->changes[index] == 0)
+		journal->nodes[journal->node_count++] = (mgl_u32_t)index;
+	journal->changes[index] |= changes;
+}
+
+void mge_publish_scene_journal(mge_scene_manager_t * manager)
+{
+	MGL_DEBUG_ASSERT(manager != NULL);
+
+	mge_scene_journal_t* journal = manager->published_journal;
+	manager->published_journal = manager->journal;
+	manager->journal = journal;
+
+	// Clear the old journal, only touching the nodes which changed on it
+	for (mgl_u64_t i = 0; i < journal->node_count; ++i)
+		journal->changes[journal->nodes[i]] = 0;
+	journal->node_count = 0;
+}
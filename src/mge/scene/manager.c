@@ -1,9 +1,110 @@
 #include <mge/scene/manager.h>
 #include <mge/scene/component.h>
 #include <mge/scene/node.h>
+#include <mge/scene/pool.h>
+#include <mge/scene/journal.h>
+#include <mge/scene/trs.h>
+#include <mge/resource/prefab.h>
 #include <mge/log.h>
 
+#include <mge/scene/bitset.h>
+
 #include <mgl/string/manipulation.h>
+#include <mgl/memory/manipulation.h>
+
+static mgl_u32_t mge_hash_scene_node_name(const mgl_chr8_t* name, mgl_u64_t size)
+{
+	// FNV-1a
+	mgl_u32_t hash = 2166136261u;
+	for (mgl_u64_t i = 0; i < size && name[i] != 0; ++i)
+		hash = (hash ^ (mgl_u8_t)name[i]) * 16777619u;
+	return hash;
+}
+
+static mgl_u64_t mge_get_scene_name_slot(mge_scene_manager_t* manager, mge_scene_node_t* parent, mgl_u32_t name_hash)
+{
+	// Keyed by the parent's handle instead of its index, so that relocating a parent doesn't move its children's entries
+	mgl_u64_t key = ((mgl_u64_t)parent->handle << 32) | name_hash;
+	key ^= key >> 33;
+	key *= 0xFF51AFD7ED558CCDull;
+	key ^= key >> 33;
+	return key & manager->name_table_mask;
+}
+
+static mgl_u64_t mge_find_scene_name_slot(mge_scene_manager_t* manager, mge_scene_node_t* parent, const mgl_chr8_t* name, mgl_u64_t size, mgl_u32_t hash)
+{
+	// Returns the slot with the first node with the name, or the empty slot where the search stopped
+	for (mgl_u64_t slot = mge_get_scene_name_slot(manager, parent, hash);; slot = (slot + 1) & manager->name_table_mask)
+	{
+		mgl_u32_t index = manager->name_table[slot];
+		if (index == MGE_SCENE_NAME_TABLE_EMPTY)
+			return slot;
+
+		mge_scene_node_t* node = &manager->nodes[index];
+		if (node->parent != parent || node->name_hash != hash)
+			continue;
+
+		mgl_u64_t i = 0;
+		while (i < size && node->name[i] == name[i])
+			++i;
+		if (i == size && node->name[i] == 0)
+			return slot;
+	}
+}
+
+static mgl_u64_t mge_get_scene_node_name_entry(mge_scene_manager_t* manager, mge_scene_node_t* node)
+{
+	// Finds the slot which stores a node, which must be the first node of its chain
+	mgl_u32_t index = (mgl_u32_t)(node - manager->nodes);
+	mgl_u64_t slot = mge_get_scene_name_slot(manager, node->parent, node->name_hash);
+	while (manager->name_table[slot] != index)
+	{
+		MGL_DEBUG_ASSERT(manager->name_table[slot] != MGE_SCENE_NAME_TABLE_EMPTY);
+		slot = (slot + 1) & manager->name_table_mask;
+	}
+	return slot;
+}
+
+static void mge_acquire_scene_node_handle(mge_scene_manager_t* manager, mge_scene_node_t* node)
+{
+	// There are as many handles as node slots, so there is always a free handle for a free slot
+	node->handle = manager->free_handles[--manager->free_handle_count];
+	manager->handle_nodes[node->handle] = (mgl_u32_t)(node - manager->nodes);
+}
+
+static void mge_push_scene_node_destroy_queue(mge_scene_manager_t* manager, mgl_u64_t index)
+{
+	// Slots which were destroyed and queued again leave stale entries behind, drop them if the queue fills up
+	if (manager->destroy_queue_count >= manager->max_node_count)
+	{
+		mgl_u64_t count = 0;
+		for (mgl_u64_t i = 0; i < manager->destroy_queue_count; ++i)
+		{
+			mgl_u32_t queued = manager->destroy_queue[i];
+			if (MGE_SCENE_BITSET_TEST(manager->destroy_bits, queued))
+			{
+				MGE_SCENE_BITSET_CLEAR(manager->destroy_bits, queued);
+				manager->destroy_queue[count++] = queued;
+			}
+		}
+		for (mgl_u64_t i = 0; i < count; ++i)
+			MGE_SCENE_BITSET_SET(manager->destroy_bits, manager->destroy_queue[i]);
+		manager->destroy_queue_count = count;
+	}
+
+	MGE_SCENE_BITSET_SET(manager->destroy_bits, index);
+	manager->destroy_queue[manager->destroy_queue_count++] = (mgl_u32_t)index;
+}
+
+static mge_scene_node_t* mge_find_scene_node_child_n(mge_scene_node_t* parent, const mgl_chr8_t* name, mgl_u64_t size)
+{
+	if (size >= MGE_MAX_SCENE_NODE_NAME_SIZE)
+		return NULL;
+
+	mge_scene_manager_t* manager = parent->manager;
+	mgl_u32_t index = manager->name_table[mge_find_scene_name_slot(manager, parent, name, size, mge_hash_scene_node_name(name, size))];
+	return index == MGE_SCENE_NAME_TABLE_EMPTY ? NULL : &manager->nodes[index];
+}
 
 mge_scene_manager_t * mge_init_scene_manager(void * allocator, mgl_u64_t max_node_count)
 {
@@ -24,21 +125,126 @@ mge_scene_manager_t * mge_init_scene_manager(void * allocator, mgl_u64_t max_nod
 	manager->allocator = allocator;
 	manager->max_node_count = max_node_count;
 
+	// Allocate active bitset
+	err = mgl_allocate(allocator, MGE_SCENE_BITSET_WORD_COUNT(max_node_count) * sizeof(mgl_u64_t), (void**)&manager->active_bits);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate active bitset on scene manager", err);
+	mgl_mem_set(manager->active_bits, MGE_SCENE_BITSET_WORD_COUNT(max_node_count) * sizeof(mgl_u64_t), 0);
+
+	// Allocate static bitset
+	err = mgl_allocate(allocator, MGE_SCENE_BITSET_WORD_COUNT(max_node_count) * sizeof(mgl_u64_t), (void**)&manager->static_bits);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate static bitset on scene manager", err);
+	mgl_mem_set(manager->static_bits, MGE_SCENE_BITSET_WORD_COUNT(max_node_count) * sizeof(mgl_u64_t), 0);
+	manager->static_version = 0;
+
+	// Allocate moved nodes list
+	err = mgl_allocate(allocator, max_node_count * sizeof(mgl_u32_t), (void**)&manager->moved_nodes);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate moved nodes list on scene manager", err);
+	err = mgl_allocate(allocator, MGE_SCENE_BITSET_WORD_COUNT(max_node_count) * sizeof(mgl_u64_t), (void**)&manager->moved_bits);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate moved bitset on scene manager", err);
+	mgl_mem_set(manager->moved_bits, MGE_SCENE_BITSET_WORD_COUNT(max_node_count) * sizeof(mgl_u64_t), 0);
+	manager->moved_node_count = 0;
+	manager->moved_nodes_consumer = NULL;
+
+	// Init journals
+	manager->journal = mge_init_scene_journal(allocator, max_node_count);
+	manager->published_journal = mge_init_scene_journal(allocator, max_node_count);
+
+	// Allocate destroy queue
+	err = mgl_allocate(allocator, max_node_count * sizeof(mgl_u32_t), (void**)&manager->destroy_queue);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate destroy queue on scene manager", err);
+	err = mgl_allocate(allocator, MGE_SCENE_BITSET_WORD_COUNT(max_node_count) * sizeof(mgl_u64_t), (void**)&manager->destroy_bits);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate destroy bitset on scene manager", err);
+	mgl_mem_set(manager->destroy_bits, MGE_SCENE_BITSET_WORD_COUNT(max_node_count) * sizeof(mgl_u64_t), 0);
+	manager->destroy_queue_count = 0;
+	err = mgl_allocate(allocator, max_node_count * sizeof(mgl_u32_t), (void**)&manager->destroy_nodes);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate destroyed nodes list on scene manager", err);
+
+	// Allocate name table, with at most half of its slots used
+	mgl_u64_t name_table_size = 16;
+	while (name_table_size < max_node_count * 2)
+		name_table_size *= 2;
+	err = mgl_allocate(allocator, name_table_size * sizeof(mgl_u32_t), (void**)&manager->name_table);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate name table on scene manager", err);
+	mgl_mem_set(manager->name_table, name_table_size * sizeof(mgl_u32_t), 0xFF);
+	manager->name_table_mask = name_table_size - 1;
+
+	// Allocate handles
+	err = mgl_allocate(allocator, max_node_count * sizeof(mgl_u32_t), (void**)&manager->handle_nodes);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate handle nodes on scene manager", err);
+	err = mgl_allocate(allocator, max_node_count * sizeof(mgl_u32_t), (void**)&manager->handle_generations);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate handle generations on scene manager", err);
+	err = mgl_allocate(allocator, max_node_count * sizeof(mgl_u32_t), (void**)&manager->free_handles);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate free handles on scene manager", err);
+	for (mgl_u64_t i = 0; i < max_node_count; ++i)
+	{
+		manager->handle_generations[i] = 1;
+		manager->free_handles[i] = (mgl_u32_t)(max_node_count - 1 - i);
+	}
+	manager->free_handle_count = max_node_count;
+	manager->defragment_cursor = 1;
+
+	// Allocate TRS arrays, padded so that they can be read 4 nodes at a time
+	mgl_u64_t trs_size = (max_node_count + 3) & ~3ull;
+	err = mgl_allocate(allocator, trs_size * 10 * sizeof(mgl_f32_t), (void**)&manager->trs.translation[0]);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate TRS arrays on scene manager", err);
+	mgl_mem_set(manager->trs.translation[0], trs_size * 10 * sizeof(mgl_f32_t), 0);
+	for (mgl_u64_t i = 1; i < 3; ++i)
+		manager->trs.translation[i] = manager->trs.translation[0] + i * trs_size;
+	for (mgl_u64_t i = 0; i < 4; ++i)
+		manager->trs.rotation[i] = manager->trs.translation[0] + (3 + i) * trs_size;
+	for (mgl_u64_t i = 0; i < 3; ++i)
+		manager->trs.scale[i] = manager->trs.translation[0] + (7 + i) * trs_size;
+	err = mgl_allocate(allocator, MGE_SCENE_BITSET_WORD_COUNT(max_node_count) * sizeof(mgl_u64_t), (void**)&manager->trs.bits);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate TRS bitset on scene manager", err);
+	mgl_mem_set(manager->trs.bits, MGE_SCENE_BITSET_WORD_COUNT(max_node_count) * sizeof(mgl_u64_t), 0);
+	err = mgl_allocate(allocator, MGE_SCENE_BITSET_WORD_COUNT(max_node_count) * sizeof(mgl_u64_t), (void**)&manager->trs.dirty_bits);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate TRS dirty bitset on scene manager", err);
+	mgl_mem_set(manager->trs.dirty_bits, MGE_SCENE_BITSET_WORD_COUNT(max_node_count) * sizeof(mgl_u64_t), 0);
+
 	// Init nodes
 	for (mgl_u64_t i = 0; i < manager->max_node_count; ++i)
 		manager->nodes[i].trash = MGL_TRUE;
+	manager->free_node_hint = 1;
+
+	// Init component pools
+	for (mgl_u64_t i = 0; i < MGE_MAX_SCENE_COMPONENT_TYPE_COUNT; ++i)
+		manager->component_pools[i] = NULL;
 
 	// Init root
 	manager->root = &manager->nodes[0];
 	manager->root->active = MGL_TRUE;
 	manager->root->trash = MGL_FALSE;
+	manager->root->parent = NULL;
+	manager->root->next = NULL;
+	manager->root->prev = NULL;
 	manager->root->first_child = NULL;
 	manager->root->first_component = NULL;
 	mgl_f32m4x4_identity(&manager->root->transform.local);
 	mgl_f32m4x4_identity(&manager->root->transform.global);
 	manager->root->transform.dirty = MGL_FALSE;
+	mge_clear_aabb(&manager->root->bounds.local);
+	mge_clear_aabb(&manager->root->bounds.global);
 	manager->root->manager = manager;
+	mge_acquire_scene_node_handle(manager, manager->root);
 	mgl_str_copy(u8"[root]", manager->root->name, MGE_MAX_SCENE_NODE_NAME_SIZE);
+	manager->root->name_hash = mge_hash_scene_node_name(manager->root->name, MGE_MAX_SCENE_NODE_NAME_SIZE);
+	manager->root->prev_same_name = NULL;
+	manager->root->next_same_name = NULL;
+	MGE_SCENE_BITSET_SET(manager->active_bits, 0);
 
 	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully initialized scene manager\n");
 
@@ -53,8 +259,73 @@ void mge_terminate_scene_manager(mge_scene_manager_t * manager)
 	mge_clear_children_scene_node(manager->root);
 	mge_clear_components_scene_node(manager->root);
 
+	// Terminate component pools
+	for (mgl_u64_t i = 0; i < MGE_MAX_SCENE_COMPONENT_TYPE_COUNT; ++i)
+		if (manager->component_pools[i] != NULL)
+			mge_terminate_scene_component_pool(manager->component_pools[i]);
+
+	// Deallocate TRS arrays
+	mgl_error_t err = mgl_deallocate(manager->allocator, manager->trs.dirty_bits);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate TRS dirty bitset on scene manager", err);
+	err = mgl_deallocate(manager->allocator, manager->trs.bits);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate TRS bitset on scene manager", err);
+	err = mgl_deallocate(manager->allocator, manager->trs.translation[0]);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate TRS arrays on scene manager", err);
+
+	// Deallocate handles
+	err = mgl_deallocate(manager->allocator, manager->free_handles);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate free handles on scene manager", err);
+	err = mgl_deallocate(manager->allocator, manager->handle_generations);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate handle generations on scene manager", err);
+	err = mgl_deallocate(manager->allocator, manager->handle_nodes);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate handle nodes on scene manager", err);
+
+	// Deallocate name table
+	err = mgl_deallocate(manager->allocator, manager->name_table);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate name table on scene manager", err);
+
+	// Deallocate destroy queue
+	err = mgl_deallocate(manager->allocator, manager->destroy_nodes);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate destroyed nodes list on scene manager", err);
+	err = mgl_deallocate(manager->allocator, manager->destroy_bits);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate destroy bitset on scene manager", err);
+	err = mgl_deallocate(manager->allocator, manager->destroy_queue);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate destroy queue on scene manager", err);
+
+	// Terminate journals
+	mge_terminate_scene_journal(manager->allocator, manager->published_journal);
+	mge_terminate_scene_journal(manager->allocator, manager->journal);
+
+	// Deallocate moved nodes list
+	err = mgl_deallocate(manager->allocator, manager->moved_bits);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate moved bitset on scene manager", err);
+	err = mgl_deallocate(manager->allocator, manager->moved_nodes);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate moved nodes list on scene manager", err);
+
+	// Deallocate static bitset
+	err = mgl_deallocate(manager->allocator, manager->static_bits);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate static bitset on scene manager", err);
+
+	// Deallocate active bitset
+	err = mgl_deallocate(manager->allocator, manager->active_bits);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate active bitset on scene manager", err);
+
 	// Deallocate nodes
-	mgl_error_t err = mgl_deallocate(manager->allocator, manager->nodes);
+	err = mgl_deallocate(manager->allocator, manager->nodes);
 	if (err != MGL_ERROR_NONE)
 		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate nodes array on resource manager", err);
 
@@ -73,10 +344,11 @@ mge_scene_node_t* mge_create_scene_node(mge_scene_node_t * parent, const mgl_chr
 		name = u8"[unnamed]";
 
 	mge_scene_node_t* node = NULL;
-	for (mgl_u32_t i = 0; i < parent->manager->max_node_count; ++i)
+	for (mgl_u64_t i = parent->manager->free_node_hint; i < parent->manager->max_node_count; ++i)
 		if (parent->manager->nodes[i].trash)
 		{
 			node = &parent->manager->nodes[i];
+			parent->manager->free_node_hint = i + 1;
 			break;
 		}
 	if (node == NULL)
@@ -88,12 +360,19 @@ mge_scene_node_t* mge_create_scene_node(mge_scene_node_t * parent, const mgl_chr
 	node->first_component = NULL;
 	mgl_f32m4x4_identity(&node->transform.local);
 	node->transform.dirty = MGL_TRUE;
+	mge_clear_aabb(&node->bounds.local);
+	mge_clear_aabb(&node->bounds.global);
 	node->manager = parent->manager;
+	mge_acquire_scene_node_handle(node->manager, node);
 	mgl_str_copy(name, node->name, MGE_MAX_SCENE_NODE_NAME_SIZE);
 
 	// Add to parent and update transform
 	mge_scene_add_child(parent, node);
+	mge_insert_scene_node_name(node);
+	mge_record_scene_node_change(node->manager, (mgl_u64_t)(node - node->manager->nodes), MGE_SCENE_NODE_CREATED);
 	mge_scene_node_update_transform(node);
+	if (mge_scene_node_is_frozen(parent))
+		mge_scene_node_freeze(node);
 
 	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"Created scene node '");
 	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, node->name);
@@ -102,6 +381,200 @@ mge_scene_node_t* mge_create_scene_node(mge_scene_node_t * parent, const mgl_chr
 	return node;
 }
 
+mge_scene_node_t * mge_instantiate_prefab(mge_scene_node_t * parent, const mge_prefab_resource_data_t * prefab)
+{
+	MGL_DEBUG_ASSERT(parent != NULL && prefab != NULL && prefab->node_count > 0);
+
+	mge_scene_manager_t* manager = parent->manager;
+
+	// Find a contiguous block of free nodes
+	mgl_u64_t first_free = manager->max_node_count;
+	mgl_u64_t start = manager->free_node_hint;
+	mgl_u64_t end = start;
+	for (; end < manager->max_node_count && end - start < prefab->node_count; ++end)
+		if (!manager->nodes[end].trash)
+			start = end + 1;
+		else if (first_free == manager->max_node_count)
+			first_free = end;
+	if (end - start < prefab->node_count)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to instantiate prefab, not enough contiguous free scene nodes");
+	manager->free_node_hint = first_free == start ? end : first_free;
+
+	// Parents always come before their children, so the nodes are initialized and linked in order
+	mge_scene_node_t* nodes = &manager->nodes[start];
+	mge_scene_node_get_global_transform(parent);
+	for (mgl_u64_t i = 0; i < prefab->node_count; ++i)
+	{
+		mge_scene_node_t* node = &nodes[i];
+		mge_scene_node_t* node_parent = prefab->parents[i] == MGE_PREFAB_NO_PARENT ? parent : &nodes[prefab->parents[i]];
+
+		node->manager = manager;
+		mge_acquire_scene_node_handle(manager, node);
+		node->trash = MGL_FALSE;
+		node->active = MGL_TRUE;
+		node->first_child = NULL;
+		node->first_component = NULL;
+		mgl_mem_copy(node->name, prefab->names[i], MGE_MAX_SCENE_NODE_NAME_SIZE);
+		node->name[MGE_MAX_SCENE_NODE_NAME_SIZE - 1] = 0;
+		node->transform.local = prefab->transforms[i];
+		mgl_f32m4x4_mul(&node_parent->transform.global, &node->transform.local, &node->transform.global);
+		node->transform.dirty = MGL_FALSE;
+		mge_clear_aabb(&node->bounds.local);
+		mge_clear_aabb(&node->bounds.global);
+
+		node->parent = node_parent;
+		node->next = node_parent->first_child;
+		node->prev = NULL;
+		if (node_parent->first_child != NULL)
+			node_parent->first_child->prev = node;
+		node_parent->first_child = node;
+		if (MGE_SCENE_BITSET_TEST(manager->active_bits, (mgl_u64_t)(node_parent - manager->nodes)))
+			MGE_SCENE_BITSET_SET(manager->active_bits, start + i);
+		else
+			MGE_SCENE_BITSET_CLEAR(manager->active_bits, start + i);
+
+		mge_insert_scene_node_name(node);
+		mge_record_scene_node_change(manager, start + i, MGE_SCENE_NODE_CREATED | MGE_SCENE_NODE_TRANSFORMED);
+	}
+
+	// Create the components, now that every node is linked and active
+	for (mgl_u64_t i = 0; i < prefab->component_count; ++i)
+	{
+		const mge_prefab_component_t* c = &prefab->components[i];
+		mge_scene_component_pool_t* pool = mge_get_scene_component_pool(manager, c->type);
+		if (pool == NULL)
+			mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to instantiate prefab, component type isn't registered");
+		if (c->payload_size > pool->component_size - sizeof(mge_scene_component_t))
+			mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to instantiate prefab, component payload is bigger than the component");
+
+		mgl_u8_t* component = (mgl_u8_t*)mge_create_pooled_scene_component(pool, &nodes[c->node]);
+		mgl_mem_copy(component + sizeof(mge_scene_component_t), prefab->payloads + c->payload_offset, c->payload_size);
+		if (!mge_is_aabb_empty(&c->bounds))
+			mge_scene_component_set_bounds((mge_scene_component_t*)component, &c->bounds);
+	}
+
+	// Prefabs instantiated under frozen nodes are frozen too
+	if (mge_scene_node_is_frozen(parent))
+		for (mgl_u64_t i = 0; i < prefab->node_count; ++i)
+			if (prefab->parents[i] == MGE_PREFAB_NO_PARENT)
+				mge_scene_node_freeze(&nodes[i]);
+
+	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"Instantiated prefab\n");
+
+	return nodes;
+}
+
+static void mge_destroy_scene_subtrees(mge_scene_manager_t* manager, mgl_u64_t root_count)
+{
+	mgl_u32_t* nodes = manager->destroy_nodes;
+
+	// Detach the subtree roots from their parents, the whole subtrees are thrown away so the active bits aren't propagated
+	for (mgl_u64_t i = 0; i < root_count; ++i)
+	{
+		mge_scene_node_t* node = &manager->nodes[nodes[i]];
+		if (node->prev != NULL)
+			node->prev->next = node->next;
+		else
+			node->parent->first_child = node->next;
+		if (node->next != NULL)
+			node->next->prev = node->prev;
+		node->next = NULL;
+		node->prev = NULL;
+	}
+
+	// Gather every node in the subtrees (breadth-first, using the list itself as the queue), and the types of their components
+	mgl_u64_t count = root_count;
+	mgl_u64_t types = 0;
+	mgl_bool_t other_types = MGL_FALSE;
+	for (mgl_u64_t i = 0; i < count; ++i)
+	{
+		mge_scene_node_t* node = &manager->nodes[nodes[i]];
+		node->trash = MGL_TRUE;
+		for (mge_scene_component_t* c = node->first_component; c != NULL; c = c->next)
+			if (c->type < MGE_MAX_SCENE_COMPONENT_TYPE_COUNT)
+				types |= 1ull << c->type;
+			else
+				other_types = MGL_TRUE;
+		for (mge_scene_node_t* c = node->first_child; c != NULL; c = c->next)
+			nodes[count++] = (mgl_u32_t)(c - manager->nodes);
+	}
+
+	// Destroy the components one type at a time, so that the destroy functions of each type run together.
+	// Types past the pools' range can't be pooled, so the components left after every pooled type are destroyed together
+	while (types != 0 || other_types)
+	{
+		mgl_enum_u32_t type = MGE_MAX_SCENE_COMPONENT_TYPE_COUNT;
+		if (types != 0)
+		{
+			type = (mgl_enum_u32_t)mge_scene_bitset_ctz(types);
+			types &= types - 1;
+		}
+		else
+			other_types = MGL_FALSE;
+
+		for (mgl_u64_t i = 0; i < count; ++i)
+		{
+			mge_scene_node_t* node = &manager->nodes[nodes[i]];
+			mge_scene_component_t* c = node->first_component;
+			while (c != NULL)
+			{
+				if (type < MGE_MAX_SCENE_COMPONENT_TYPE_COUNT ? c->type != type : c->type < MGE_MAX_SCENE_COMPONENT_TYPE_COUNT)
+				{
+					c = c->next;
+					continue;
+				}
+
+				// The components before this one on the list have other types, so they aren't moved by this type's pool
+				mge_scene_component_t* prev = c->prev;
+				if (prev != NULL)
+					prev->next = c->next;
+				else
+					node->first_component = c->next;
+				if (c->next != NULL)
+					c->next->prev = prev;
+				c->node = NULL;
+				c->destroy_func(c);
+				c = prev != NULL ? prev->next : node->first_component;
+			}
+		}
+	}
+
+	// Free the nodes
+	for (mgl_u64_t i = 0; i < count; ++i)
+	{
+		mge_scene_node_t* node = &manager->nodes[nodes[i]];
+		mge_remove_scene_node_name(node);
+		manager->handle_generations[node->handle] += 1;
+		manager->free_handles[manager->free_handle_count++] = node->handle;
+		node->first_child = NULL;
+		node->active = MGL_FALSE;
+		MGE_SCENE_BITSET_CLEAR(manager->active_bits, nodes[i]);
+		MGE_SCENE_BITSET_CLEAR(manager->destroy_bits, nodes[i]);
+		MGE_SCENE_BITSET_CLEAR(manager->trs.bits, nodes[i]);
+		MGE_SCENE_BITSET_CLEAR(manager->trs.dirty_bits, nodes[i]);
+		mge_record_scene_node_change(manager, nodes[i], MGE_SCENE_NODE_DESTROYED);
+		if (MGE_SCENE_BITSET_TEST(manager->static_bits, nodes[i]))
+		{
+			MGE_SCENE_BITSET_CLEAR(manager->static_bits, nodes[i]);
+			manager->static_version += 1;
+		}
+
+		// Let spatial structures know the node is gone
+		if (!mge_is_aabb_empty(&node->bounds.global))
+		{
+			mge_clear_aabb(&node->bounds.global);
+			mge_mark_scene_node_moved(node);
+		}
+
+		if (nodes[i] < manager->free_node_hint)
+			manager->free_node_hint = nodes[i];
+	}
+	for (mgl_u64_t i = 0; i < count; ++i)
+		manager->nodes[nodes[i]].parent = NULL;
+
+	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"Destroyed scene nodes\n");
+}
+
 void mge_destroy_scene_node(mge_scene_node_t * node)
 {
 	MGL_DEBUG_ASSERT(node != NULL);
@@ -111,30 +584,59 @@ void mge_destroy_scene_node(mge_scene_node_t * node)
 	if (node->trash)
 		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to destroy scene node, this scene node was already destroyed");
 
-	mge_clear_children_scene_node(node);
-	mge_clear_components_scene_node(node);
+	node->manager->destroy_nodes[0] = (mgl_u32_t)(node - node->manager->nodes);
+	mge_destroy_scene_subtrees(node->manager, 1);
+}
 
-	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"Destroyed scene node '");
-	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, node->name);
-	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"'\n");
+void mge_queue_scene_node_destroy(mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(node != NULL);
+
+	if (node->parent == NULL)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to queue scene node destruction, the root scene node cannot be destroyed");
+	if (node->trash)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to queue scene node destruction, this scene node was already destroyed");
+
+	mge_scene_manager_t* manager = node->manager;
+	mgl_u64_t index = (mgl_u64_t)(node - manager->nodes);
+	if (MGE_SCENE_BITSET_TEST(manager->destroy_bits, index))
+		return;
 
-	mge_scene_remove_child(node->parent, node);
-	node->trash = MGL_TRUE;
+	mge_push_scene_node_destroy_queue(manager, index);
 }
 
-void mge_clear_children_scene_node(mge_scene_node_t * node)
+void mge_flush_scene_node_destroy_queue(mge_scene_manager_t * manager)
 {
-	MGL_DEBUG_ASSERT(node != NULL);
+	MGL_DEBUG_ASSERT(manager != NULL);
 
-	// Destroy all of the children on the node
-	mge_scene_node_t* c = node->first_child;
-	while (c != NULL)
+	// Skip the nodes which were destroyed since they were queued, and stale entries of slots which were queued again.
+	// Queued nodes inside other queued subtrees are detached from them first, so they're still only visited once
+	mgl_u64_t root_count = 0;
+	for (mgl_u64_t i = 0; i < manager->destroy_queue_count; ++i)
 	{
-		mge_scene_node_t* n = c->next;
-		mge_destroy_scene_node(c);
-		c = n;
+		mgl_u32_t index = manager->destroy_queue[i];
+		if (MGE_SCENE_BITSET_TEST(manager->destroy_bits, index))
+		{
+			MGE_SCENE_BITSET_CLEAR(manager->destroy_bits, index);
+			manager->destroy_nodes[root_count++] = index;
+		}
 	}
-	node->first_child = NULL;
+	manager->destroy_queue_count = 0;
+
+	if (root_count > 0)
+		mge_destroy_scene_subtrees(manager, root_count);
+}
+
+void mge_clear_children_scene_node(mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(node != NULL);
+
+	// Destroy all of the children on the node at once
+	mgl_u64_t root_count = 0;
+	for (mge_scene_node_t* c = node->first_child; c != NULL; c = c->next)
+		node->manager->destroy_nodes[root_count++] = (mgl_u32_t)(c - node->manager->nodes);
+	if (root_count > 0)
+		mge_destroy_scene_subtrees(node->manager, root_count);
 }
 
 void mge_clear_components_scene_node(mge_scene_node_t * node)
@@ -143,9 +645,403 @@ void mge_clear_components_scene_node(mge_scene_node_t * node)
 
 	// Destroy all of the components on the node
 	while (node->first_component != NULL)
+		mge_destroy_scene_component(node->first_component);
+}
+
+static void mge_update_scene_node_transforms(mge_scene_node_t* node)
+{
+	// Frozen subtrees are baked, so they are skipped entirely
+	if (MGE_SCENE_BITSET_TEST(node->manager->static_bits, (mgl_u64_t)(node - node->manager->nodes)))
+		return;
+
+	if (node->transform.dirty)
+		mge_scene_node_update_transform(node);
+
+	for (mge_scene_node_t* c = node->first_child; c != NULL; c = c->next)
+		mge_update_scene_node_transforms(c);
+}
+
+mge_scene_node_t * mge_find_scene_node(mge_scene_manager_t * manager, const mgl_chr8_t * path)
+{
+	MGL_DEBUG_ASSERT(manager != NULL && path != NULL);
+
+	mge_scene_node_t* node = manager->root;
+	while (node != NULL && *path != 0)
+	{
+		// Find the end of the current path component
+		mgl_u64_t size = 0;
+		while (path[size] != 0 && path[size] != '/')
+			++size;
+
+		// Empty components (leading, trailing or repeated separators) are skipped
+		if (size > 0)
+			node = mge_find_scene_node_child_n(node, path, size);
+		path += path[size] == '/' ? size + 1 : size;
+	}
+
+	return node;
+}
+
+static mge_scene_node_t* mge_remap_scene_node(mge_scene_node_t* node, mge_scene_node_t* a, mge_scene_node_t* b)
+{
+	return node == a ? b : (node == b ? a : node);
+}
+
+static void mge_relink_scene_node_siblings(mge_scene_node_t* node)
+{
+	// Point the node's siblings (and its parent, if it's the first child) to its new slot
+	if (node->prev != NULL)
+		node->prev->next = node;
+	else
+		node->parent->first_child = node;
+	if (node->next != NULL)
+		node->next->prev = node;
+	if (node->prev_same_name != NULL)
+		node->prev_same_name->next_same_name = node;
+	if (node->next_same_name != NULL)
+		node->next_same_name->prev_same_name = node;
+}
+
+static void mge_relink_scene_node_children(mge_scene_manager_t* manager, mge_scene_node_t* node)
+{
+	// Point the node's children, components and handle to its new slot
+	for (mge_scene_node_t* c = node->first_child; c != NULL; c = c->next)
+		c->parent = node;
+	for (mge_scene_component_t* c = node->first_component; c != NULL; c = c->next)
+		c->node = node;
+	manager->handle_nodes[node->handle] = (mgl_u32_t)(node - manager->nodes);
+}
+
+static void mge_swap_scene_nodes(mge_scene_manager_t* manager, mgl_u64_t a, mgl_u64_t b)
+{
+	mge_scene_node_t* na = &manager->nodes[a];
+	mge_scene_node_t* nb = &manager->nodes[b];
+	MGL_DEBUG_ASSERT(a != 0 && b != 0 && (!na->trash || !nb->trash));
+
+	// The name table entries are found before anything moves, since finding them needs the old indices
+	mgl_u64_t slot_a = !na->trash && na->prev_same_name == NULL ? mge_get_scene_node_name_entry(manager, na) : MGE_SCENE_NAME_TABLE_EMPTY;
+	mgl_u64_t slot_b = !nb->trash && nb->prev_same_name == NULL ? mge_get_scene_node_name_entry(manager, nb) : MGE_SCENE_NAME_TABLE_EMPTY;
+
+	mge_scene_node_t temp = *na;
+	*na = *nb;
+	*nb = temp;
+
+	// Fix the links between the two nodes first, then the links from every other node
+	mge_scene_node_t* swapped[2] = { na, nb };
+	for (mgl_u64_t i = 0; i < 2; ++i)
+	{
+		mge_scene_node_t* node = swapped[i];
+		if (node->trash)
+			continue;
+		node->parent = mge_remap_scene_node(node->parent, na, nb);
+		node->first_child = mge_remap_scene_node(node->first_child, na, nb);
+		node->next = mge_remap_scene_node(node->next, na, nb);
+		node->prev = mge_remap_scene_node(node->prev, na, nb);
+		node->prev_same_name = mge_remap_scene_node(node->prev_same_name, na, nb);
+		node->next_same_name = mge_remap_scene_node(node->next_same_name, na, nb);
+	}
+	// Children lists can only be walked once the sibling links of both nodes are fixed
+	for (mgl_u64_t i = 0; i < 2; ++i)
+		if (!swapped[i]->trash)
+			mge_relink_scene_node_siblings(swapped[i]);
+	for (mgl_u64_t i = 0; i < 2; ++i)
+		if (!swapped[i]->trash)
+			mge_relink_scene_node_children(manager, swapped[i]);
+	if (slot_a != MGE_SCENE_NAME_TABLE_EMPTY)
+		manager->name_table[slot_a] = (mgl_u32_t)b;
+	if (slot_b != MGE_SCENE_NAME_TABLE_EMPTY)
+		manager->name_table[slot_b] = (mgl_u32_t)a;
+
+	// Swap the per index state
+	mge_record_scene_node_change(manager, a, MGE_SCENE_NODE_RELOCATED);
+	mge_record_scene_node_change(manager, b, MGE_SCENE_NODE_RELOCATED);
+	if (MGE_SCENE_BITSET_TEST(manager->static_bits, a) || MGE_SCENE_BITSET_TEST(manager->static_bits, b))
+		manager->static_version += 1;
+	mgl_u64_t* swapped_bits[4] = { manager->active_bits, manager->static_bits, manager->trs.bits, manager->trs.dirty_bits };
+	for (mgl_u64_t i = 0; i < 4; ++i)
+		if (MGE_SCENE_BITSET_TEST(swapped_bits[i], a) != MGE_SCENE_BITSET_TEST(swapped_bits[i], b))
+		{
+			swapped_bits[i][a / 64] ^= 1ull << (a % 64);
+			swapped_bits[i][b / 64] ^= 1ull << (b % 64);
+		}
+	mgl_f32_t* trs_values[10] =
+	{
+		manager->trs.translation[0], manager->trs.translation[1], manager->trs.translation[2],
+		manager->trs.rotation[0], manager->trs.rotation[1], manager->trs.rotation[2], manager->trs.rotation[3],
+		manager->trs.scale[0], manager->trs.scale[1], manager->trs.scale[2],
+	};
+	for (mgl_u64_t i = 0; i < 10; ++i)
+	{
+		mgl_f32_t value = trs_values[i][a];
+		trs_values[i][a] = trs_values[i][b];
+		trs_values[i][b] = value;
+	}
+
+	mgl_bool_t destroy_a = MGE_SCENE_BITSET_TEST(manager->destroy_bits, a);
+	mgl_bool_t destroy_b = MGE_SCENE_BITSET_TEST(manager->destroy_bits, b);
+	MGE_SCENE_BITSET_CLEAR(manager->destroy_bits, a);
+	MGE_SCENE_BITSET_CLEAR(manager->destroy_bits, b);
+	if (destroy_b)
+		mge_push_scene_node_destroy_queue(manager, a);
+	if (destroy_a)
+		mge_push_scene_node_destroy_queue(manager, b);
+
+	// Spatial structures index nodes by slot, so both slots changed bounds
+	if (!mge_is_aabb_empty(&na->bounds.global) || !mge_is_aabb_empty(&nb->bounds.global))
+	{
+		mgl_u64_t indices[2] = { a, b };
+		for (mgl_u64_t i = 0; i < 2; ++i)
+			if (!MGE_SCENE_BITSET_TEST(manager->moved_bits, indices[i]))
+			{
+				MGE_SCENE_BITSET_SET(manager->moved_bits, indices[i]);
+				manager->moved_nodes[manager->moved_node_count++] = (mgl_u32_t)indices[i];
+			}
+	}
+
+	if (na->trash && a < manager->free_node_hint)
+		manager->free_node_hint = a;
+	if (nb->trash && b < manager->free_node_hint)
+		manager->free_node_hint = b;
+}
+
+static mge_scene_node_t* mge_next_scene_node_depth_first(mge_scene_node_t* node)
+{
+	if (node->first_child != NULL)
+		return node->first_child;
+	while (node->next == NULL)
+	{
+		node = node->parent;
+		if (node->parent == NULL)
+			return NULL;
+	}
+	return node->next;
+}
+
+mge_scene_node_t * mge_resolve_scene_node_handle(mge_scene_manager_t * manager, mge_scene_node_handle_t handle)
+{
+	MGL_DEBUG_ASSERT(manager != NULL);
+
+	if (handle.index >= manager->max_node_count || manager->handle_generations[handle.index] != handle.generation)
+		return NULL;
+	return &manager->nodes[manager->handle_nodes[handle.index]];
+}
+
+mgl_u64_t mge_defragment_scene(mge_scene_manager_t * manager, mgl_u64_t max_move_count)
+{
+	MGL_DEBUG_ASSERT(manager != NULL);
+
+	// Resume after the last placed node, or start over if it was destroyed since the last call
+	mgl_u64_t position = manager->defragment_cursor;
+	mge_scene_node_t* node;
+	if (position > 1 && position <= manager->max_node_count && !manager->nodes[position - 1].trash)
+		node = mge_next_scene_node_depth_first(&manager->nodes[position - 1]);
+	else
+	{
+		position = 1;
+		node = manager->root->first_child;
+	}
+
+	// Every node visited is placed on the next slot, swapping it with whatever was there
+	mgl_u64_t move_count = 0;
+	while (node != NULL && move_count < max_move_count)
+	{
+		mgl_u64_t index = (mgl_u64_t)(node - manager->nodes);
+		if (index != position)
+		{
+			mge_swap_scene_nodes(manager, index, position);
+			node = &manager->nodes[position];
+			move_count += 1;
+		}
+
+		position += 1;
+		node = mge_next_scene_node_depth_first(node);
+	}
+	manager->defragment_cursor = node == NULL ? 1 : position;
+
+	if (move_count > 0)
+		MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"Defragmented scene nodes\n");
+
+	return move_count;
+}
+
+void mge_insert_scene_node_name(mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(node != NULL && node->parent != NULL);
+
+	mge_scene_manager_t* manager = node->manager;
+	mgl_u64_t size = 0;
+	while (size < MGE_MAX_SCENE_NODE_NAME_SIZE && node->name[size] != 0)
+		++size;
+	node->name_hash = mge_hash_scene_node_name(node->name, size);
+	node->prev_same_name = NULL;
+	node->next_same_name = NULL;
+
+	// If a sibling already has the same name, chain the node after it instead of adding another entry to the table
+	mgl_u64_t slot = mge_find_scene_name_slot(manager, node->parent, node->name, size, node->name_hash);
+	if (manager->name_table[slot] == MGE_SCENE_NAME_TABLE_EMPTY)
+		manager->name_table[slot] = (mgl_u32_t)(node - manager->nodes);
+	else
+	{
+		mge_scene_node_t* first = &manager->nodes[manager->name_table[slot]];
+		node->prev_same_name = first;
+		node->next_same_name = first->next_same_name;
+		if (first->next_same_name != NULL)
+			first->next_same_name->prev_same_name = node;
+		first->next_same_name = node;
+	}
+}
+
+void mge_remove_scene_node_name(mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(node != NULL && node->parent != NULL);
+
+	mge_scene_manager_t* manager = node->manager;
+
+	// Nodes in the middle of a chain aren't on the table
+	if (node->prev_same_name != NULL)
 	{
-		mge_scene_component_t* c = node->first_component;
-		node->first_component = c->next;
-		c->destroy_func(c);
+		node->prev_same_name->next_same_name = node->next_same_name;
+		if (node->next_same_name != NULL)
+			node->next_same_name->prev_same_name = node->prev_same_name;
+		return;
 	}
+
+	mgl_u64_t slot = mge_get_scene_node_name_entry(manager, node);
+
+	// The next node with the same name has the same key, so it takes the entry over
+	if (node->next_same_name != NULL)
+	{
+		node->next_same_name->prev_same_name = NULL;
+		manager->name_table[slot] = (mgl_u32_t)(node->next_same_name - manager->nodes);
+		return;
+	}
+
+	// Shift back the following entries of the cluster which can't be reached anymore, so no tombstones are needed
+	for (mgl_u64_t next = (slot + 1) & manager->name_table_mask;; next = (next + 1) & manager->name_table_mask)
+	{
+		mgl_u32_t other = manager->name_table[next];
+		if (other == MGE_SCENE_NAME_TABLE_EMPTY)
+			break;
+
+		mge_scene_node_t* other_node = &manager->nodes[other];
+		mgl_u64_t home = mge_get_scene_name_slot(manager, other_node->parent, other_node->name_hash);
+		if (((next - home) & manager->name_table_mask) >= ((next - slot) & manager->name_table_mask))
+		{
+			manager->name_table[slot] = other;
+			slot = next;
+		}
+	}
+	manager->name_table[slot] = MGE_SCENE_NAME_TABLE_EMPTY;
+}
+
+void mge_update_scene_transforms(mge_scene_manager_t * manager)
+{
+	MGL_DEBUG_ASSERT(manager != NULL);
+
+	// Local transforms of nodes with TRS are composed in batch first
+	mge_compose_scene_trs(manager);
+
+	// The root node has no parent transform, so start on its children
+	for (mge_scene_node_t* c = manager->root->first_child; c != NULL; c = c->next)
+		mge_update_scene_node_transforms(c);
+}
+
+void mge_mark_scene_node_moved(mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(node != NULL);
+
+	mge_scene_manager_t* manager = node->manager;
+	mgl_u64_t index = (mgl_u64_t)(node - manager->nodes);
+	if (MGE_SCENE_BITSET_TEST(manager->moved_bits, index))
+		return;
+
+	MGE_SCENE_BITSET_SET(manager->moved_bits, index);
+	manager->moved_nodes[manager->moved_node_count++] = (mgl_u32_t)index;
+}
+
+void mge_clear_moved_scene_nodes(mge_scene_manager_t * manager)
+{
+	MGL_DEBUG_ASSERT(manager != NULL);
+
+	for (mgl_u64_t i = 0; i < manager->moved_node_count; ++i)
+		MGE_SCENE_BITSET_CLEAR(manager->moved_bits, manager->moved_nodes[i]);
+	manager->moved_node_count = 0;
+}
+
+mgl_u64_t mge_next_active_scene_node(mge_scene_manager_t * manager, mgl_u64_t index)
+{
+	MGL_DEBUG_ASSERT(manager != NULL);
+
+	if (index >= manager->max_node_count)
+		return manager->max_node_count;
+
+	// Mask the bits before the start index on the first word
+	mgl_u64_t word = index / 64;
+	mgl_u64_t bits = manager->active_bits[word] & (~0ull << (index % 64));
+	mgl_u64_t word_count = MGE_SCENE_BITSET_WORD_COUNT(manager->max_node_count);
+
+	while (bits == 0)
+	{
+		word += 1;
+		if (word >= word_count)
+			return manager->max_node_count;
+		bits = manager->active_bits[word];
+	}
+
+	index = word * 64 + mge_scene_bitset_ctz(bits);
+	return index < manager->max_node_count ? index : manager->max_node_count;
+}
+
+mge_scene_component_pool_t * mge_register_scene_component_type(mge_scene_manager_t * manager, mgl_enum_u32_t type, mgl_u64_t component_size, mgl_u64_t max_component_count, void(*destroy_func)(void *component))
+{
+	MGL_DEBUG_ASSERT(manager != NULL);
+	if (type >= MGE_MAX_SCENE_COMPONENT_TYPE_COUNT)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to register scene component type, invalid type");
+	if (manager->component_pools[type] != NULL)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to register scene component type, type already registered");
+
+	manager->component_pools[type] = mge_init_scene_component_pool(manager->allocator, type, component_size, max_component_count, destroy_func);
+
+	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"Registered scene component type\n");
+
+	return manager->component_pools[type];
+}
+
+mge_scene_node_t * mge_find_scene_node_child(mge_scene_node_t * parent, const mgl_chr8_t * name)
+{
+	MGL_DEBUG_ASSERT(parent != NULL && name != NULL);
+
+	mgl_u64_t size = 0;
+	while (name[size] != 0)
+		++size;
+	return mge_find_scene_node_child_n(parent, name, size);
+}
+
+mge_scene_component_pool_t * mge_get_scene_component_pool(mge_scene_manager_t * manager, mgl_enum_u32_t type)
+{
+	MGL_DEBUG_ASSERT(manager != NULL);
+	if (type >= MGE_MAX_SCENE_COMPONENT_TYPE_COUNT)
+		return NULL;
+	return manager->component_pools[type];
+}
+
+void * mge_create_scene_component(mge_scene_node_t * node, mgl_enum_u32_t type)
+{
+	MGL_DEBUG_ASSERT(node != NULL);
+
+	mge_scene_component_pool_t* pool = mge_get_scene_component_pool(node->manager, type);
+	if (pool == NULL)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to create scene component, component type isn't registered");
+
+	return mge_create_pooled_scene_component(pool, node);
+}
+
+void mge_destroy_scene_component(void * component)
+{
+	MGL_DEBUG_ASSERT(component != NULL);
+
+	mge_scene_component_t* c = (mge_scene_component_t*)component;
+	if (c->node != NULL)
+		mge_scene_remove_component(c->node, c);
+	c->destroy_func(c);
 }
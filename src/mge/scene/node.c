@@ -1,8 +1,43 @@
 #include <mge/scene/node.h>
 #include <mge/scene/component.h>
+#include <mge/scene/manager.h>
+#include <mge/scene/pool.h>
+#include <mge/scene/trs.h>
+#include <mge/scene/journal.h>
 
 #include <mge/log.h>
 
+#include <mge/scene/bitset.h>
+
+#include <mgl/string/manipulation.h>
+
+static void mge_scene_node_update_active_bits(mge_scene_node_t* node, mgl_bool_t parent_active)
+{
+	mgl_u64_t index = (mgl_u64_t)(node - node->manager->nodes);
+	mgl_bool_t active = parent_active && node->active;
+
+	// If the bit didn't change, the rest of the subtree didn't change either
+	if (MGE_SCENE_BITSET_TEST(node->manager->active_bits, index) == active)
+		return;
+
+	if (active)
+		MGE_SCENE_BITSET_SET(node->manager->active_bits, index);
+	else
+		MGE_SCENE_BITSET_CLEAR(node->manager->active_bits, index);
+
+	// Move pooled components across their pools' active boundary
+	mge_scene_component_t* c = node->first_component;
+	while (c != NULL)
+	{
+		if (c->pool != NULL)
+			c = (mge_scene_component_t*)mge_refresh_pooled_scene_component(c);
+		c = c->next;
+	}
+
+	for (mge_scene_node_t* child = node->first_child; child != NULL; child = child->next)
+		mge_scene_node_update_active_bits(child, active);
+}
+
 mgl_f32m4x4_t * mge_scene_node_get_local_transform(mge_scene_node_t * node)
 {
 	MGL_DEBUG_ASSERT(node != NULL);
@@ -25,15 +60,61 @@ void mge_scene_node_update_transform(mge_scene_node_t * node)
 	if (node->parent != NULL && node->parent->transform.dirty)
 		mge_scene_node_update_transform(node->parent);
 
+	// Nodes with TRS whose local transform matrix is out of date compose it first
+	mge_compose_scene_node_trs(node);
+
 	// Update the global transform matrix
 	mgl_f32m4x4_mul(&node->parent->transform.global, &node->transform.local, &node->transform.global);
 	node->transform.dirty = MGL_FALSE;
+	mge_record_scene_node_change(node->manager, (mgl_u64_t)(node - node->manager->nodes), MGE_SCENE_NODE_TRANSFORMED);
+
+	// Update the global bounds
+	if (!mge_is_aabb_empty(&node->bounds.local) || !mge_is_aabb_empty(&node->bounds.global))
+	{
+		mge_transform_aabb(&node->transform.global, &node->bounds.local, &node->bounds.global);
+		mge_mark_scene_node_moved(node);
+	}
+}
+
+void mge_scene_node_update_bounds(mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(node != NULL);
+
+	mge_clear_aabb(&node->bounds.local);
+	for (mge_scene_component_t* c = node->first_component; c != NULL; c = c->next)
+		mge_merge_aabb(&node->bounds.local, &c->bounds, &node->bounds.local);
+
+	// Dirty nodes get their global bounds updated with their transform
+	if (!node->transform.dirty)
+	{
+		mge_transform_aabb(&node->transform.global, &node->bounds.local, &node->bounds.global);
+		mge_mark_scene_node_moved(node);
+		if (mge_scene_node_is_frozen(node))
+			node->manager->static_version += 1;
+	}
+}
+
+void mge_scene_component_set_bounds(mge_scene_component_t * component, const mge_aabb_t * bounds)
+{
+	MGL_DEBUG_ASSERT(component != NULL);
+
+	if (bounds != NULL)
+		component->bounds = *bounds;
+	else
+		mge_clear_aabb(&component->bounds);
+
+	if (component->node != NULL)
+		mge_scene_node_update_bounds(component->node);
 }
 
 void mge_scene_node_set_dirty(mge_scene_node_t * node)
 {
 	MGL_DEBUG_ASSERT(node != NULL);
 
+	// The descendants of a dirty node are always dirty too, and frozen subtrees are never dirty
+	if (node->transform.dirty || mge_scene_node_is_frozen(node))
+		return;
+
 	mge_scene_node_t* c = node->first_child;
 	while (c != NULL)
 	{
@@ -44,62 +125,186 @@ void mge_scene_node_set_dirty(mge_scene_node_t * node)
 	node->transform.dirty = MGL_TRUE;
 }
 
+static void mge_scene_node_set_frozen(mge_scene_node_t* node, mgl_bool_t frozen)
+{
+	mgl_u64_t index = (mgl_u64_t)(node - node->manager->nodes);
+	if (frozen)
+	{
+		// Parents come first, so the parent's transform is already baked
+		if (node->transform.dirty)
+			mge_scene_node_update_transform(node);
+		MGE_SCENE_BITSET_SET(node->manager->static_bits, index);
+	}
+	else
+		MGE_SCENE_BITSET_CLEAR(node->manager->static_bits, index);
+
+	// Move the node between the static and the dynamic spatial structures
+	if (!mge_is_aabb_empty(&node->bounds.global))
+		mge_mark_scene_node_moved(node);
+
+	for (mge_scene_node_t* c = node->first_child; c != NULL; c = c->next)
+		mge_scene_node_set_frozen(c, frozen);
+}
+
+void mge_scene_node_freeze(mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(node != NULL);
+	if (node->parent == NULL)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to freeze scene node, the root scene node cannot be frozen");
+	if (mge_scene_node_is_frozen(node))
+		return;
+
+	// Bake the transforms of the node's ancestors first
+	mge_scene_node_get_global_transform(node);
+	mge_scene_node_set_frozen(node, MGL_TRUE);
+	node->manager->static_version += 1;
+}
+
+void mge_scene_node_unfreeze(mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(node != NULL);
+	if (!mge_scene_node_is_frozen(node))
+		return;
+	if (mge_scene_node_is_frozen(node->parent))
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to unfreeze scene node, its parent is frozen");
+
+	mge_scene_node_set_frozen(node, MGL_FALSE);
+	node->manager->static_version += 1;
+
+	// Pick up the changes made while the subtree was frozen
+	mge_scene_node_set_dirty(node);
+}
+
+mgl_bool_t mge_scene_node_is_frozen(mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(node != NULL);
+	return MGE_SCENE_BITSET_TEST(node->manager->static_bits, (mgl_u64_t)(node - node->manager->nodes));
+}
+
+mge_scene_node_handle_t mge_scene_node_get_handle(mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(node != NULL && !node->trash);
+
+	mge_scene_node_handle_t handle;
+	handle.index = node->handle;
+	handle.generation = node->manager->handle_generations[node->handle];
+	return handle;
+}
+
+void mge_scene_node_set_name(mge_scene_node_t * node, const mgl_chr8_t * name)
+{
+	MGL_DEBUG_ASSERT(node != NULL && name != NULL);
+	if (node->parent == NULL)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to set scene node name, the root scene node cannot be renamed");
+
+	mge_remove_scene_node_name(node);
+	mgl_str_copy(name, node->name, MGE_MAX_SCENE_NODE_NAME_SIZE);
+	mge_insert_scene_node_name(node);
+}
+
+void mge_scene_node_set_parent(mge_scene_node_t * node, mge_scene_node_t * parent)
+{
+	MGL_DEBUG_ASSERT(node != NULL && parent != NULL);
+	if (node->parent == NULL)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to set scene node parent, the root scene node cannot be moved");
+	if (mge_scene_node_is_frozen(node))
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to set scene node parent, the scene node is frozen");
+	for (mge_scene_node_t* p = parent; p != NULL; p = p->parent)
+		if (p == node)
+			mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to set scene node parent, the new parent is on the node's subtree");
+	if (node->parent == parent)
+		return;
+
+	// Removing the child clears its active flag, which must be kept
+	mgl_bool_t active = node->active;
+	mge_remove_scene_node_name(node);
+	mge_scene_remove_child(node->parent, node);
+	node->active = active;
+	mge_scene_add_child(parent, node);
+	mge_insert_scene_node_name(node);
+	mge_scene_node_set_dirty(node);
+	if (mge_scene_node_is_frozen(parent))
+		mge_scene_node_freeze(node);
+}
+
+void mge_scene_node_set_active(mge_scene_node_t * node, mgl_bool_t active)
+{
+	MGL_DEBUG_ASSERT(node != NULL);
+
+	node->active = active;
+	mge_scene_node_update_active_bits(node, node->parent == NULL || mge_scene_node_is_active(node->parent));
+}
+
+mgl_bool_t mge_scene_node_is_active(mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(node != NULL);
+	return MGE_SCENE_BITSET_TEST(node->manager->active_bits, (mgl_u64_t)(node - node->manager->nodes));
+}
+
 void mge_scene_add_component(mge_scene_node_t * node, mge_scene_component_t * component)
 {
 	MGL_DEBUG_ASSERT(node != NULL && component != NULL);
 	component->next = node->first_component;
+	component->prev = NULL;
 	component->node = node;
+	if (node->first_component != NULL)
+		node->first_component->prev = component;
 	node->first_component = component;
+	mge_record_scene_node_change(node->manager, (mgl_u64_t)(node - node->manager->nodes), MGE_SCENE_NODE_COMPONENT_ADDED);
+
+	if (!mge_is_aabb_empty(&component->bounds))
+		mge_scene_node_update_bounds(node);
 }
 
 void mge_scene_remove_component(mge_scene_node_t * node, mge_scene_component_t * component)
 {
-	MGL_DEBUG_ASSERT(node != NULL && component != NULL);
-	mge_scene_component_t* c = node->first_component;
+	MGL_DEBUG_ASSERT(node != NULL && component != NULL && component->node == node);
 
-	if (c == component)
-		node->first_component = component->next;
+	if (component->prev != NULL)
+		component->prev->next = component->next;
 	else
-	{
-		while (c->next != component)
-		{
-			c = c->next;
-			if (c == NULL)
-				mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to remove component from node, component not found");
-		}
-		c->next = component->next;
-	}
+		node->first_component = component->next;
+	if (component->next != NULL)
+		component->next->prev = component->prev;
 
 	component->node = NULL;
+	component->next = NULL;
+	component->prev = NULL;
 	component->active = MGL_FALSE;
+	mge_record_scene_node_change(node->manager, (mgl_u64_t)(node - node->manager->nodes), MGE_SCENE_NODE_COMPONENT_REMOVED);
+
+	if (!mge_is_aabb_empty(&component->bounds))
+		mge_scene_node_update_bounds(node);
 }
 
 void mge_scene_add_child(mge_scene_node_t * parent, mge_scene_node_t * child)
 {
 	MGL_DEBUG_ASSERT(parent != NULL && child != NULL);
 	child->next = parent->first_child;
+	child->prev = NULL;
 	child->parent = parent;
+	if (parent->first_child != NULL)
+		parent->first_child->prev = child;
 	parent->first_child = child;
+
+	mge_scene_node_update_active_bits(child, mge_scene_node_is_active(parent));
 }
 
 void mge_scene_remove_child(mge_scene_node_t * parent, mge_scene_node_t * child)
 {
-	MGL_DEBUG_ASSERT(parent != NULL && child != NULL);
-	mge_scene_node_t* c = parent->first_child;
+	MGL_DEBUG_ASSERT(parent != NULL && child != NULL && child->parent == parent);
 
-	if (c == child)
-		parent->first_child = child->next;
+	if (child->prev != NULL)
+		child->prev->next = child->next;
 	else
-	{
-		while (c->next != child)
-		{
-			c = c->next;
-			if (c == NULL)
-				mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to remove child from parent node, child node not found");
-		}
-		c->next = child->next;
-	}
+		parent->first_child = child->next;
+	if (child->next != NULL)
+		child->next->prev = child->prev;
 
 	child->parent = NULL;
+	child->next = NULL;
+	child->prev = NULL;
 	child->active = MGL_FALSE;
+
+	mge_scene_node_update_active_bits(child, MGL_FALSE);
 }
@@ -0,0 +1,437 @@
+#include <mge/scene/occlusion.h>
+#include <mge/scene/manager.h>
+#include <mge/scene/node.h>
+#include <mge/scene/pool.h>
+#include <mge/log.h>
+
+#include <mgl/memory/allocator.h>
+
+#include <float.h>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define MGE_OCCLUSION_SSE
+#include <xmmintrin.h>
+#endif
+
+#define MGE_MAX_OCCLUSION_LEVEL_COUNT 16
+
+struct mge_occlusion_t
+{
+	void* allocator;
+
+	mgl_u64_t width;
+	mgl_u64_t height;
+
+	// Hierarchical Z pyramid, where level 0 is the depth buffer
+	mgl_u64_t level_count;
+	mgl_f32_t* levels[MGE_MAX_OCCLUSION_LEVEL_COUNT];
+	mgl_u64_t level_widths[MGE_MAX_OCCLUSION_LEVEL_COUNT];
+	mgl_u64_t level_heights[MGE_MAX_OCCLUSION_LEVEL_COUNT];
+
+	mgl_f32m4x4_t view_projection;
+	mge_occlusion_stats_t stats;
+};
+
+typedef struct
+{
+	mgl_f32_t x, y, z, w;
+} mge_occlusion_vertex_t;
+
+static void mge_transform_occlusion_vertex(const mgl_f32m4x4_t* m, const mgl_f32_t* p, mge_occlusion_vertex_t* out)
+{
+	out->x = MGE_F32M4X4_AT(m, 0, 0) * p[0] + MGE_F32M4X4_AT(m, 0, 1) * p[1] + MGE_F32M4X4_AT(m, 0, 2) * p[2] + MGE_F32M4X4_AT(m, 0, 3);
+	out->y = MGE_F32M4X4_AT(m, 1, 0) * p[0] + MGE_F32M4X4_AT(m, 1, 1) * p[1] + MGE_F32M4X4_AT(m, 1, 2) * p[2] + MGE_F32M4X4_AT(m, 1, 3);
+	out->z = MGE_F32M4X4_AT(m, 2, 0) * p[0] + MGE_F32M4X4_AT(m, 2, 1) * p[1] + MGE_F32M4X4_AT(m, 2, 2) * p[2] + MGE_F32M4X4_AT(m, 2, 3);
+	out->w = MGE_F32M4X4_AT(m, 3, 0) * p[0] + MGE_F32M4X4_AT(m, 3, 1) * p[1] + MGE_F32M4X4_AT(m, 3, 2) * p[2] + MGE_F32M4X4_AT(m, 3, 3);
+}
+
+static void mge_rasterize_occlusion_triangle(mge_occlusion_t* occlusion, const mgl_f32_t* v0, const mgl_f32_t* v1, const mgl_f32_t* v2)
+{
+	// Make the triangle counter-clockwise, so that the edge functions are positive inside
+	mgl_f32_t area = (v1[0] - v0[0]) * (v2[1] - v0[1]) - (v2[0] - v0[0]) * (v1[1] - v0[1]);
+	if (area < 0.0f)
+	{
+		const mgl_f32_t* t = v1;
+		v1 = v2;
+		v2 = t;
+		area = -area;
+	}
+	if (area <= 1e-8f)
+		return;
+
+	// Bounding rectangle, with the first column aligned to 4 pixels
+	mgl_f32_t min_x = v0[0] < v1[0] ? v0[0] : v1[0];
+	min_x = min_x < v2[0] ? min_x : v2[0];
+	mgl_f32_t max_x = v0[0] > v1[0] ? v0[0] : v1[0];
+	max_x = max_x > v2[0] ? max_x : v2[0];
+	mgl_f32_t min_y = v0[1] < v1[1] ? v0[1] : v1[1];
+	min_y = min_y < v2[1] ? min_y : v2[1];
+	mgl_f32_t max_y = v0[1] > v1[1] ? v0[1] : v1[1];
+	max_y = max_y > v2[1] ? max_y : v2[1];
+	if (max_x < 0.0f || max_y < 0.0f || min_x >= (mgl_f32_t)occlusion->width || min_y >= (mgl_f32_t)occlusion->height)
+		return;
+	mgl_i64_t x0 = min_x > 0.0f ? (mgl_i64_t)min_x & ~3ll : 0;
+	mgl_i64_t y0 = min_y > 0.0f ? (mgl_i64_t)min_y : 0;
+	mgl_i64_t x1 = max_x < (mgl_f32_t)(occlusion->width - 1) ? (mgl_i64_t)max_x : (mgl_i64_t)occlusion->width - 1;
+	mgl_i64_t y1 = max_y < (mgl_f32_t)(occlusion->height - 1) ? (mgl_i64_t)max_y : (mgl_i64_t)occlusion->height - 1;
+
+	// Edge functions E(x, y) = a * x + b * y + c, and depth interpolated with the normalized edge functions
+	mgl_f32_t inv_area = 1.0f / area;
+	const mgl_f32_t* e[3][2] = { { v1, v2 }, { v2, v0 }, { v0, v1 } };
+	mgl_f32_t a[3], b[3], c[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		a[i] = e[i][0][1] - e[i][1][1];
+		b[i] = e[i][1][0] - e[i][0][0];
+		c[i] = -(a[i] * e[i][0][0] + b[i] * e[i][0][1]);
+	}
+	mgl_f32_t za = (a[0] * v0[2] + a[1] * v1[2] + a[2] * v2[2]) * inv_area;
+	mgl_f32_t zb = (b[0] * v0[2] + b[1] * v1[2] + b[2] * v2[2]) * inv_area;
+	mgl_f32_t zc = (c[0] * v0[2] + c[1] * v1[2] + c[2] * v2[2]) * inv_area;
+
+	occlusion->stats.rasterized_triangle_count += 1;
+
+#ifdef MGE_OCCLUSION_SSE
+	__m128 offsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+	__m128 zero = _mm_setzero_ps();
+	for (mgl_i64_t y = y0; y <= y1; ++y)
+	{
+		mgl_f32_t py = (mgl_f32_t)y + 0.5f;
+		__m128 row[3];
+		for (int i = 0; i < 3; ++i)
+			row[i] = _mm_set1_ps(b[i] * py + c[i]);
+		__m128 zrow = _mm_set1_ps(zb * py + zc);
+
+		mgl_f32_t* depth = &occlusion->levels[0][y * occlusion->width];
+		for (mgl_i64_t x = x0; x <= x1; x += 4)
+		{
+			__m128 px = _mm_add_ps(_mm_set1_ps((mgl_f32_t)x), offsets);
+			__m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[0]), px), row[0]), zero);
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[1]), px), row[1]), zero));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[2]), px), row[2]), zero));
+			if (_mm_movemask_ps(inside) == 0)
+				continue;
+
+			// Keep the nearest depth on the covered pixels
+			__m128 old = _mm_loadu_ps(&depth[x]);
+			__m128 z = _mm_min_ps(old, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(za), px), zrow));
+			_mm_storeu_ps(&depth[x], _mm_or_ps(_mm_and_ps(inside, z), _mm_andnot_ps(inside, old)));
+		}
+	}
+#else
+	for (mgl_i64_t y = y0; y <= y1; ++y)
+	{
+		mgl_f32_t py = (mgl_f32_t)y + 0.5f;
+		mgl_f32_t* depth = &occlusion->levels[0][y * occlusion->width];
+		for (mgl_i64_t x = x0; x <= x1; ++x)
+		{
+			mgl_f32_t px = (mgl_f32_t)x + 0.5f;
+			if (a[0] * px + b[0] * py + c[0] < 0.0f || a[1] * px + b[1] * py + c[1] < 0.0f || a[2] * px + b[2] * py + c[2] < 0.0f)
+				continue;
+
+			mgl_f32_t z = za * px + zb * py + zc;
+			if (z < depth[x])
+				depth[x] = z;
+		}
+	}
+#endif
+}
+
+static void mge_rasterize_occlusion_clip_triangle(mge_occlusion_t* occlusion, const mge_occlusion_vertex_t* triangle)
+{
+	// Clip against the near plane (z >= -w), which turns the triangle into a polygon of up to 4 vertices
+	mge_occlusion_vertex_t polygon[4];
+	int count = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		const mge_occlusion_vertex_t* p = &triangle[i];
+		const mge_occlusion_vertex_t* q = &triangle[(i + 1) % 3];
+		mgl_f32_t dp = p->z + p->w;
+		mgl_f32_t dq = q->z + q->w;
+
+		if (dp >= 0.0f)
+			polygon[count++] = *p;
+		if ((dp >= 0.0f) != (dq >= 0.0f))
+		{
+			mgl_f32_t t = dp / (dp - dq);
+			polygon[count].x = p->x + t * (q->x - p->x);
+			polygon[count].y = p->y + t * (q->y - p->y);
+			polygon[count].z = p->z + t * (q->z - p->z);
+			polygon[count].w = p->w + t * (q->w - p->w);
+			count += 1;
+		}
+	}
+	if (count < 3)
+		return;
+
+	// Project to screen space
+	mgl_f32_t screen[4][3];
+	for (int i = 0; i < count; ++i)
+	{
+		if (polygon[i].w <= 1e-6f)
+			return;
+		mgl_f32_t inv_w = 1.0f / polygon[i].w;
+		screen[i][0] = (polygon[i].x * inv_w * 0.5f + 0.5f) * (mgl_f32_t)occlusion->width;
+		screen[i][1] = (polygon[i].y * inv_w * 0.5f + 0.5f) * (mgl_f32_t)occlusion->height;
+		screen[i][2] = polygon[i].z * inv_w * 0.5f + 0.5f;
+	}
+
+	mge_rasterize_occlusion_triangle(occlusion, screen[0], screen[1], screen[2]);
+	if (count == 4)
+		mge_rasterize_occlusion_triangle(occlusion, screen[0], screen[2], screen[3]);
+}
+
+void mge_register_occluder_component_type(mge_scene_manager_t * manager, mgl_u64_t max_occluder_count)
+{
+	mge_register_scene_component_type(manager, MGE_SCENE_COMPONENT_OCCLUDER, sizeof(mge_occluder_component_t), max_occluder_count, NULL);
+}
+
+mge_occluder_component_t * mge_create_occluder_component(mge_scene_node_t * node, const mgl_f32_t * vertices, const mgl_u32_t * indices, mgl_u64_t triangle_count)
+{
+	MGL_DEBUG_ASSERT(node != NULL && (triangle_count == 0 || (vertices != NULL && indices != NULL)));
+
+	mge_occluder_component_t* occluder = (mge_occluder_component_t*)mge_create_scene_component(node, MGE_SCENE_COMPONENT_OCCLUDER);
+	occluder->vertices = vertices;
+	occluder->indices = indices;
+	occluder->triangle_count = triangle_count;
+	return occluder;
+}
+
+mge_occlusion_t * mge_init_occlusion(void * allocator, mgl_u64_t width, mgl_u64_t height)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL);
+	if (width < 4 || (width & (width - 1)) != 0 || height < 1 || (height & (height - 1)) != 0)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to initialize occlusion culling stage, the depth buffer size must be a power of two");
+
+	mge_occlusion_t* occlusion;
+
+	// Allocate occlusion culling stage
+	mgl_error_t err = mgl_allocate(allocator, sizeof(mge_occlusion_t), (void**)&occlusion);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate occlusion culling stage", err);
+
+	occlusion->allocator = allocator;
+	occlusion->width = width;
+	occlusion->height = height;
+
+	// Compute the size of each pyramid level, down to a single texel
+	mgl_u64_t total_size = 0;
+	occlusion->level_count = 0;
+	for (mgl_u64_t w = width, h = height;; w = w > 1 ? w / 2 : 1, h = h > 1 ? h / 2 : 1)
+	{
+		if (occlusion->level_count >= MGE_MAX_OCCLUSION_LEVEL_COUNT)
+			mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to initialize occlusion culling stage, the depth buffer is too big");
+		occlusion->level_widths[occlusion->level_count] = w;
+		occlusion->level_heights[occlusion->level_count] = h;
+		occlusion->level_count += 1;
+		total_size += w * h;
+		if (w == 1 && h == 1)
+			break;
+	}
+
+	// Allocate pyramid
+	err = mgl_allocate(allocator, total_size * sizeof(mgl_f32_t), (void**)&occlusion->levels[0]);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate depth buffer on occlusion culling stage", err);
+	for (mgl_u64_t i = 1; i < occlusion->level_count; ++i)
+		occlusion->levels[i] = occlusion->levels[i - 1] + occlusion->level_widths[i - 1] * occlusion->level_heights[i - 1];
+
+	mgl_f32m4x4_identity(&occlusion->view_projection);
+	mge_clear_occlusion(occlusion, &occlusion->view_projection);
+	mge_build_occlusion_pyramid(occlusion);
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully initialized occlusion culling stage\n");
+
+	return occlusion;
+}
+
+void mge_terminate_occlusion(mge_occlusion_t * occlusion)
+{
+	MGL_DEBUG_ASSERT(occlusion != NULL);
+
+	// Deallocate pyramid
+	mgl_error_t err = mgl_deallocate(occlusion->allocator, occlusion->levels[0]);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate depth buffer on occlusion culling stage", err);
+
+	// Deallocate occlusion culling stage
+	err = mgl_deallocate(occlusion->allocator, occlusion);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate occlusion culling stage", err);
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully terminated occlusion culling stage\n");
+}
+
+void mge_clear_occlusion(mge_occlusion_t * occlusion, const mgl_f32m4x4_t * view_projection)
+{
+	MGL_DEBUG_ASSERT(occlusion != NULL && view_projection != NULL);
+
+	occlusion->view_projection = *view_projection;
+	occlusion->stats.rasterized_triangle_count = 0;
+	occlusion->stats.tested_bounds_count = 0;
+	occlusion->stats.occluded_bounds_count = 0;
+
+	mgl_u64_t size = occlusion->width * occlusion->height;
+	for (mgl_u64_t i = 0; i < size; ++i)
+		occlusion->levels[0][i] = 1.0f;
+}
+
+void mge_rasterize_occluder(mge_occlusion_t * occlusion, const mgl_f32m4x4_t * model, const mgl_f32_t * vertices, const mgl_u32_t * indices, mgl_u64_t triangle_count)
+{
+	MGL_DEBUG_ASSERT(occlusion != NULL && model != NULL && (triangle_count == 0 || (vertices != NULL && indices != NULL)));
+
+	mgl_f32m4x4_t mvp;
+	mgl_f32m4x4_mul(&occlusion->view_projection, model, &mvp);
+
+	for (mgl_u64_t i = 0; i < triangle_count; ++i)
+	{
+		mge_occlusion_vertex_t triangle[3];
+		for (int j = 0; j < 3; ++j)
+			mge_transform_occlusion_vertex(&mvp, &vertices[indices[i * 3 + j] * 3], &triangle[j]);
+		mge_rasterize_occlusion_clip_triangle(occlusion, triangle);
+	}
+}
+
+void mge_rasterize_scene_occluders(mge_occlusion_t * occlusion, mge_scene_manager_t * manager)
+{
+	MGL_DEBUG_ASSERT(occlusion != NULL && manager != NULL);
+
+	mge_scene_component_pool_t* pool = mge_get_scene_component_pool(manager, MGE_SCENE_COMPONENT_OCCLUDER);
+	if (pool == NULL)
+		return;
+
+	mgl_u64_t count;
+	mge_occluder_component_t* occluders = (mge_occluder_component_t*)mge_get_active_pooled_scene_components(pool, &count);
+	for (mgl_u64_t i = 0; i < count; ++i)
+		mge_rasterize_occluder(occlusion, mge_scene_node_get_global_transform(occluders[i].base.node), occluders[i].vertices, occluders[i].indices, occluders[i].triangle_count);
+}
+
+void mge_build_occlusion_pyramid(mge_occlusion_t * occlusion)
+{
+	MGL_DEBUG_ASSERT(occlusion != NULL);
+
+	// Each texel keeps the farthest depth of the 2x2 texels below it
+	for (mgl_u64_t l = 1; l < occlusion->level_count; ++l)
+	{
+		const mgl_f32_t* src = occlusion->levels[l - 1];
+		mgl_f32_t* dst = occlusion->levels[l];
+		mgl_u64_t src_width = occlusion->level_widths[l - 1];
+		mgl_u64_t src_height = occlusion->level_heights[l - 1];
+		mgl_u64_t dx = src_width > 1 ? 1 : 0;
+		mgl_u64_t dy = src_height > 1 ? src_width : 0;
+
+		for (mgl_u64_t y = 0; y < occlusion->level_heights[l]; ++y)
+			for (mgl_u64_t x = 0; x < occlusion->level_widths[l]; ++x)
+			{
+				const mgl_f32_t* s = &src[(src_height > 1 ? y * 2 : y) * src_width + (src_width > 1 ? x * 2 : x)];
+				mgl_f32_t a = s[0] > s[dx] ? s[0] : s[dx];
+				mgl_f32_t b = s[dy] > s[dy + dx] ? s[dy] : s[dy + dx];
+				dst[y * occlusion->level_widths[l] + x] = a > b ? a : b;
+			}
+	}
+}
+
+mgl_bool_t mge_is_aabb_occluded(mge_occlusion_t * occlusion, const mge_aabb_t * aabb)
+{
+	MGL_DEBUG_ASSERT(occlusion != NULL && aabb != NULL);
+
+	occlusion->stats.tested_bounds_count += 1;
+
+	// Transform the minimum corner and the box edges, the other corners are sums of these
+	const mgl_f32m4x4_t* m = &occlusion->view_projection;
+	mge_occlusion_vertex_t base, edges[3];
+	mge_transform_occlusion_vertex(m, aabb->min, &base);
+	for (int i = 0; i < 3; ++i)
+	{
+		mgl_f32_t size = aabb->max[i] - aabb->min[i];
+		edges[i].x = MGE_F32M4X4_AT(m, 0, i) * size;
+		edges[i].y = MGE_F32M4X4_AT(m, 1, i) * size;
+		edges[i].z = MGE_F32M4X4_AT(m, 2, i) * size;
+		edges[i].w = MGE_F32M4X4_AT(m, 3, i) * size;
+	}
+
+	// Project the box corners and find their screen rectangle and nearest depth
+	mgl_f32_t min_x = FLT_MAX, max_x = -FLT_MAX, min_y = FLT_MAX, max_y = -FLT_MAX, min_z = FLT_MAX;
+	for (int i = 0; i < 8; ++i)
+	{
+		mge_occlusion_vertex_t v = base;
+		for (int j = 0; j < 3; ++j)
+			if (i & (1 << j))
+			{
+				v.x += edges[j].x;
+				v.y += edges[j].y;
+				v.z += edges[j].z;
+				v.w += edges[j].w;
+			}
+		if (v.z < -v.w || v.w <= 1e-6f)
+			return MGL_FALSE;
+
+		mgl_f32_t inv_w = 1.0f / v.w;
+		mgl_f32_t x = (v.x * inv_w * 0.5f + 0.5f) * (mgl_f32_t)occlusion->width;
+		mgl_f32_t y = (v.y * inv_w * 0.5f + 0.5f) * (mgl_f32_t)occlusion->height;
+		mgl_f32_t z = v.z * inv_w * 0.5f + 0.5f;
+		min_x = x < min_x ? x : min_x;
+		max_x = x > max_x ? x : max_x;
+		min_y = y < min_y ? y : min_y;
+		max_y = y > max_y ? y : max_y;
+		min_z = z < min_z ? z : min_z;
+	}
+
+	// Off-screen boxes are left to frustum culling
+	if (max_x < 0.0f || max_y < 0.0f || min_x >= (mgl_f32_t)occlusion->width || min_y >= (mgl_f32_t)occlusion->height)
+		return MGL_FALSE;
+	mgl_u64_t x0 = min_x > 0.0f ? (mgl_u64_t)min_x : 0;
+	mgl_u64_t y0 = min_y > 0.0f ? (mgl_u64_t)min_y : 0;
+	mgl_u64_t x1 = max_x < (mgl_f32_t)(occlusion->width - 1) ? (mgl_u64_t)max_x : occlusion->width - 1;
+	mgl_u64_t y1 = max_y < (mgl_f32_t)(occlusion->height - 1) ? (mgl_u64_t)max_y : occlusion->height - 1;
+
+	// Pick the finest level where the rectangle covers at most 2x2 texels
+	mgl_u64_t l = 0;
+	while (l + 1 < occlusion->level_count && ((x1 >> l) - (x0 >> l) > 1 || (y1 >> l) - (y0 >> l) > 1))
+		l += 1;
+
+	mgl_f32_t max_z = 0.0f;
+	const mgl_f32_t* level = occlusion->levels[l];
+	for (mgl_u64_t y = y0 >> l; y <= (y1 >> l); ++y)
+		for (mgl_u64_t x = x0 >> l; x <= (x1 >> l); ++x)
+		{
+			mgl_f32_t z = level[y * occlusion->level_widths[l] + x];
+			max_z = z > max_z ? z : max_z;
+		}
+
+	// Texels without occluders are at the far plane and never occlude anything
+	if (max_z < 1.0f && min_z > max_z)
+	{
+		occlusion->stats.occluded_bounds_count += 1;
+		return MGL_TRUE;
+	}
+	return MGL_FALSE;
+}
+
+mgl_u64_t mge_filter_occluded_scene_nodes(mge_occlusion_t * occlusion, mge_scene_manager_t * manager, const mgl_u32_t * nodes, mgl_u64_t count, mgl_u32_t * out)
+{
+	MGL_DEBUG_ASSERT(occlusion != NULL && manager != NULL && (count == 0 || (nodes != NULL && out != NULL)));
+
+	mgl_u64_t visible_count = 0;
+	for (mgl_u64_t i = 0; i < count; ++i)
+	{
+		mgl_u32_t index = nodes[i];
+		if (!mge_is_aabb_occluded(occlusion, &manager->nodes[index].bounds.global))
+			out[visible_count++] = index;
+	}
+	return visible_count;
+}
+
+const mgl_f32_t * mge_get_occlusion_depth_buffer(mge_occlusion_t * occlusion, mgl_u64_t * width, mgl_u64_t * height)
+{
+	MGL_DEBUG_ASSERT(occlusion != NULL && width != NULL && height != NULL);
+	*width = occlusion->width;
+	*height = occlusion->height;
+	return occlusion->levels[0];
+}
+
+void mge_get_occlusion_stats(mge_occlusion_t * occlusion, mge_occlusion_stats_t * stats)
+{
+	MGL_DEBUG_ASSERT(occlusion != NULL && stats != NULL);
+	*stats = occlusion->stats;
+}
@@ -0,0 +1,186 @@
+#include <mge/scene/pool.h>
+#include <mge/scene/component.h>
+#include <mge/scene/node.h>
+#include <mge/log.h>
+
+#include <mgl/memory/allocator.h>
+#include <mgl/memory/manipulation.h>
+
+static mgl_u64_t mge_get_pooled_scene_component_index(mge_scene_component_pool_t* pool, mge_scene_component_t* component)
+{
+	mgl_u64_t offset = (mgl_u64_t)((mgl_u8_t*)component - pool->components);
+	MGL_DEBUG_ASSERT(offset % pool->component_size == 0 && offset / pool->component_size < pool->component_count);
+	return offset / pool->component_size;
+}
+
+static void mge_move_pooled_scene_component(mge_scene_component_pool_t* pool, mgl_u64_t src, mgl_u64_t dst)
+{
+	if (src == dst)
+		return;
+
+	mge_scene_component_t* from = (mge_scene_component_t*)MGE_POOLED_SCENE_COMPONENT(pool, src);
+	mge_scene_component_t* to = (mge_scene_component_t*)MGE_POOLED_SCENE_COMPONENT(pool, dst);
+	mgl_mem_copy(to, from, pool->component_size);
+
+	// Fix the node's component list, which still points to the old location
+	if (to->node != NULL)
+	{
+		if (to->prev != NULL)
+			to->prev->next = to;
+		else
+			to->node->first_component = to;
+		if (to->next != NULL)
+			to->next->prev = to;
+	}
+}
+
+static void mge_swap_pooled_scene_components(mge_scene_component_pool_t* pool, mgl_u64_t a, mgl_u64_t b)
+{
+	if (a == b)
+		return;
+
+	// The slot after the last component is used as scratch space
+	mge_move_pooled_scene_component(pool, a, pool->max_component_count);
+	mge_move_pooled_scene_component(pool, b, a);
+	mge_move_pooled_scene_component(pool, pool->max_component_count, b);
+}
+
+static void mge_release_pooled_scene_component(void* component)
+{
+	mge_scene_component_t* base = (mge_scene_component_t*)component;
+	mge_scene_component_pool_t* pool = base->pool;
+	MGL_DEBUG_ASSERT(pool != NULL && !pool->updating);
+
+	if (pool->destroy_func != NULL)
+		pool->destroy_func(component);
+
+	// Swap-remove, keeping the active components packed at the start of the array
+	mgl_u64_t index = mge_get_pooled_scene_component_index(pool, base);
+	if (index < pool->active_component_count)
+	{
+		pool->active_component_count -= 1;
+		mge_move_pooled_scene_component(pool, pool->active_component_count, index);
+		index = pool->active_component_count;
+	}
+	pool->component_count -= 1;
+	mge_move_pooled_scene_component(pool, pool->component_count, index);
+}
+
+mge_scene_component_pool_t * mge_init_scene_component_pool(void * allocator, mgl_enum_u32_t type, mgl_u64_t component_size, mgl_u64_t max_component_count, void(*destroy_func)(void *component))
+{
+	MGL_DEBUG_ASSERT(allocator != NULL && component_size >= sizeof(mge_scene_component_t) && max_component_count > 0);
+
+	mge_scene_component_pool_t* pool;
+
+	// Allocate pool
+	mgl_error_t err = mgl_allocate(allocator, sizeof(mge_scene_component_pool_t), (void**)&pool);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate scene component pool", err);
+
+	// Allocate components (with an extra slot used when swapping components)
+	err = mgl_allocate(allocator, (max_component_count + 1) * component_size, (void**)&pool->components);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate components array on scene component pool", err);
+
+	pool->allocator = allocator;
+	pool->type = type;
+	pool->component_size = component_size;
+	pool->max_component_count = max_component_count;
+	pool->component_count = 0;
+	pool->active_component_count = 0;
+	pool->destroy_func = destroy_func;
+	pool->updating = MGL_FALSE;
+
+	return pool;
+}
+
+void mge_terminate_scene_component_pool(mge_scene_component_pool_t * pool)
+{
+	MGL_DEBUG_ASSERT(pool != NULL);
+
+	// Destroy remaining components
+	while (pool->component_count > 0)
+	{
+		mge_scene_component_t* c = (mge_scene_component_t*)MGE_POOLED_SCENE_COMPONENT(pool, pool->component_count - 1);
+		if (c->node != NULL)
+			mge_scene_remove_component(c->node, c);
+		c->destroy_func(c);
+	}
+
+	// Deallocate components
+	mgl_error_t err = mgl_deallocate(pool->allocator, pool->components);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate components array on scene component pool", err);
+
+	// Deallocate pool
+	err = mgl_deallocate(pool->allocator, pool);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate scene component pool", err);
+}
+
+void * mge_create_pooled_scene_component(mge_scene_component_pool_t * pool, mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(pool != NULL && node != NULL && !pool->updating);
+	if (pool->component_count >= pool->max_component_count)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to create scene component, component pool limit surpassed");
+
+	// Create the component on the inactive part and then move it if its node is active
+	mge_scene_component_t* component = (mge_scene_component_t*)MGE_POOLED_SCENE_COMPONENT(pool, pool->component_count);
+	pool->component_count += 1;
+
+	mgl_mem_set(component, pool->component_size, 0);
+	mge_clear_aabb(&component->bounds);
+	component->type = pool->type;
+	component->active = MGL_TRUE;
+	component->pool = pool;
+	component->destroy_func = &mge_release_pooled_scene_component;
+	mge_scene_add_component(node, component);
+
+	return mge_refresh_pooled_scene_component(component);
+}
+
+void * mge_set_pooled_scene_component_active(void * component, mgl_bool_t active)
+{
+	MGL_DEBUG_ASSERT(component != NULL);
+
+	((mge_scene_component_t*)component)->active = active;
+	return mge_refresh_pooled_scene_component(component);
+}
+
+void * mge_refresh_pooled_scene_component(void * component)
+{
+	MGL_DEBUG_ASSERT(component != NULL);
+
+	mge_scene_component_t* base = (mge_scene_component_t*)component;
+	mge_scene_component_pool_t* pool = base->pool;
+	MGL_DEBUG_ASSERT(pool != NULL);
+
+	mgl_bool_t enabled = base->active && base->node != NULL && mge_scene_node_is_active(base->node);
+	mgl_u64_t index = mge_get_pooled_scene_component_index(pool, base);
+	if (enabled == (index < pool->active_component_count))
+		return component;
+	MGL_DEBUG_ASSERT(!pool->updating);
+
+	// Swap with the component at the boundary between the active and inactive components
+	if (enabled)
+	{
+		mge_swap_pooled_scene_components(pool, index, pool->active_component_count);
+		index = pool->active_component_count;
+		pool->active_component_count += 1;
+	}
+	else
+	{
+		pool->active_component_count -= 1;
+		mge_swap_pooled_scene_components(pool, index, pool->active_component_count);
+		index = pool->active_component_count;
+	}
+
+	return MGE_POOLED_SCENE_COMPONENT(pool, index);
+}
+
+void * mge_get_active_pooled_scene_components(mge_scene_component_pool_t * pool, mgl_u64_t * count)
+{
+	MGL_DEBUG_ASSERT(pool != NULL && count != NULL);
+	*count = pool->active_component_count;
+	return pool->components;
+}
@@ -0,0 +1,174 @@
+#include <mge/scene/scheduler.h>
+#include <mge/scene/manager.h>
+#include <mge/scene/component.h>
+#include <mge/scene/pool.h>
+#include <mge/time.h>
+#include <mge/log.h>
+#include <mge/profile.h>
+
+#include <mgl/memory/allocator.h>
+#include <mgl/memory/manipulation.h>
+
+typedef struct
+{
+	mge_scene_update_func_t update;
+	mge_scene_update_priority_func_t priority;
+	mgl_u64_t interval;
+	void* data;
+
+	// Position on the active components where the next run starts, so that deferred components go first
+	mgl_u64_t cursor;
+
+	mge_scene_update_stats_t stats;
+} mge_scene_update_entry_t;
+
+struct mge_scene_scheduler_t
+{
+	void* allocator;
+	mge_scene_manager_t* manager;
+
+	// Time budget for deferrable updates, in nanoseconds
+	mgl_u64_t budget;
+
+	// Time of the last run
+	mgl_u64_t time;
+
+	mge_scene_update_entry_t entries[MGE_MAX_SCENE_COMPONENT_TYPE_COUNT];
+	mgl_enum_u32_t types[MGE_MAX_SCENE_COMPONENT_TYPE_COUNT];
+	mgl_u64_t type_count;
+};
+
+mge_scene_scheduler_t * mge_init_scene_scheduler(void * allocator, mge_scene_manager_t * manager, mgl_u64_t budget)
+{
+	MGL_DEBUG_ASSERT(allocator != NULL && manager != NULL);
+
+	mge_scene_scheduler_t* scheduler;
+
+	// Allocate scheduler
+	mgl_error_t err = mgl_allocate(allocator, sizeof(mge_scene_scheduler_t), (void**)&scheduler);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to allocate scene scheduler", err);
+
+	scheduler->allocator = allocator;
+	scheduler->manager = manager;
+	scheduler->budget = budget * 1000;
+	scheduler->time = 0;
+	scheduler->type_count = 0;
+
+	// Types without an update report empty stats
+	mgl_mem_set(scheduler->entries, sizeof(scheduler->entries), 0);
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully initialized scene scheduler\n");
+
+	return scheduler;
+}
+
+void mge_terminate_scene_scheduler(mge_scene_scheduler_t * scheduler)
+{
+	MGL_DEBUG_ASSERT(scheduler != NULL);
+
+	// Deallocate scheduler
+	mgl_error_t err = mgl_deallocate(scheduler->allocator, scheduler);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_ENGINE, u8"Failed to deallocate scene scheduler", err);
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_ENGINE, u8"Successfully terminated scene scheduler\n");
+}
+
+void mge_register_scene_update(mge_scene_scheduler_t * scheduler, mgl_enum_u32_t type, mge_scene_update_func_t update, mge_scene_update_priority_func_t priority, mgl_u64_t interval, void * data)
+{
+	MGL_DEBUG_ASSERT(scheduler != NULL && update != NULL);
+	if (type >= MGE_MAX_SCENE_COMPONENT_TYPE_COUNT || mge_get_scene_component_pool(scheduler->manager, type) == NULL)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to register scene update, component type isn't registered");
+	for (mgl_u64_t i = 0; i < scheduler->type_count; ++i)
+		if (scheduler->types[i] == type)
+			mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to register scene update, type already registered");
+
+	mge_scene_update_entry_t* entry = &scheduler->entries[type];
+	entry->update = update;
+	entry->priority = priority;
+	entry->interval = interval;
+	entry->data = data;
+	entry->cursor = 0;
+	entry->stats.update_count = 0;
+	entry->stats.deferred_count = 0;
+	entry->stats.time = 0;
+	scheduler->types[scheduler->type_count++] = type;
+
+	MGE_LOG_VERBOSE_2(MGE_LOG_ENGINE, u8"Registered scene update\n");
+}
+
+void mge_run_scene_updates(mge_scene_scheduler_t * scheduler, mgl_u64_t time)
+{
+	MGL_DEBUG_ASSERT(scheduler != NULL && time > 0 && time >= scheduler->time);
+
+	// Components which were never updated get the time since the last run
+	mgl_u64_t run_delta = scheduler->time != 0 ? time - scheduler->time : 0;
+	scheduler->time = time;
+
+	mgl_u64_t deadline = mge_get_time() + scheduler->budget;
+	mgl_bool_t within_budget = MGL_TRUE;
+
+	for (mgl_u64_t t = 0; t < scheduler->type_count; ++t)
+	{
+		mge_scene_update_entry_t* entry = &scheduler->entries[scheduler->types[t]];
+		mge_scene_component_pool_t* pool = mge_get_scene_component_pool(scheduler->manager, scheduler->types[t]);
+		MGE_PROFILE_BEGIN(u8"Scene component updates");
+		mgl_u64_t start = mge_get_time();
+		entry->stats.update_count = 0;
+		entry->stats.deferred_count = 0;
+
+		mgl_u64_t count;
+		mgl_u8_t* components = (mgl_u8_t*)mge_get_active_pooled_scene_components(pool, &count);
+		if (entry->cursor >= count)
+			entry->cursor = 0;
+		mgl_u64_t first_deferred = count;
+
+		// Update functions can't move the components being iterated (see mge_register_scene_update)
+		pool->updating = MGL_TRUE;
+		for (mgl_u64_t k = 0; k < count; ++k)
+		{
+			mgl_u64_t i = entry->cursor + k < count ? entry->cursor + k : entry->cursor + k - count;
+			mge_scene_component_t* component = (mge_scene_component_t*)(components + i * pool->component_size);
+			mgl_u64_t elapsed = component->update_time != 0 ? time - component->update_time : run_delta;
+
+			// Components which reached their interval are always updated, the rest only while there's budget left
+			if (entry->interval != 0 && elapsed < entry->interval)
+			{
+				if (entry->priority != NULL)
+				{
+					mgl_f32_t priority = entry->priority(component, entry->data);
+					priority = priority < 0.0f ? 0.0f : (priority > 1.0f ? 1.0f : priority);
+					if (elapsed < (mgl_u64_t)((mgl_f64_t)entry->interval * (1.0 - priority)))
+						continue;
+				}
+
+				if (within_budget)
+					within_budget = mge_get_time() < deadline;
+				if (!within_budget)
+				{
+					entry->stats.deferred_count += 1;
+					if (first_deferred == count)
+						first_deferred = i;
+					continue;
+				}
+			}
+
+			entry->update(component, (mgl_f64_t)elapsed / MGE_NANOSECONDS_PER_SECOND, entry->data);
+			component->update_time = time;
+			entry->stats.update_count += 1;
+		}
+		pool->updating = MGL_FALSE;
+
+		if (first_deferred != count)
+			entry->cursor = first_deferred;
+		entry->stats.time = mge_get_time() - start;
+		MGE_PROFILE_END();
+	}
+}
+
+void mge_get_scene_update_stats(mge_scene_scheduler_t * scheduler, mgl_enum_u32_t type, mge_scene_update_stats_t * stats)
+{
+	MGL_DEBUG_ASSERT(scheduler != NULL && type < MGE_MAX_SCENE_COMPONENT_TYPE_COUNT && stats != NULL);
+	*stats = scheduler->entries[type].stats;
+}
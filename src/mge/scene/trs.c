@@ -0,0 +1,271 @@
+#include <mge/scene/trs.h>
+#include <mge/scene/manager.h>
+#include <mge/scene/node.h>
+#include <mge/log.h>
+
+#include <mge/scene/bitset.h>
+
+#include <math.h>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define MGE_TRS_SSE
+#include <xmmintrin.h>
+#endif
+
+static void mge_compose_trs_matrix(mge_scene_manager_t* manager, mgl_u64_t i, mgl_f32m4x4_t* m)
+{
+	mgl_f32_t x = manager->trs.rotation[0][i], y = manager->trs.rotation[1][i], z = manager->trs.rotation[2][i], w = manager->trs.rotation[3][i];
+	mgl_f32_t sx = manager->trs.scale[0][i], sy = manager->trs.scale[1][i], sz = manager->trs.scale[2][i];
+
+	// Columns of the rotation matrix, scaled
+	m->data[0] = (1.0f - 2.0f * (y * y + z * z)) * sx;
+	m->data[1] = 2.0f * (x * y + w * z) * sx;
+	m->data[2] = 2.0f * (x * z - w * y) * sx;
+	m->data[3] = 0.0f;
+	m->data[4] = 2.0f * (x * y - w * z) * sy;
+	m->data[5] = (1.0f - 2.0f * (x * x + z * z)) * sy;
+	m->data[6] = 2.0f * (y * z + w * x) * sy;
+	m->data[7] = 0.0f;
+	m->data[8] = 2.0f * (x * z + w * y) * sz;
+	m->data[9] = 2.0f * (y * z - w * x) * sz;
+	m->data[10] = (1.0f - 2.0f * (x * x + y * y)) * sz;
+	m->data[11] = 0.0f;
+	m->data[12] = manager->trs.translation[0][i];
+	m->data[13] = manager->trs.translation[1][i];
+	m->data[14] = manager->trs.translation[2][i];
+	m->data[15] = 1.0f;
+}
+
+static void mge_decompose_trs_matrix(mge_scene_manager_t* manager, mgl_u64_t i, const mgl_f32m4x4_t* m)
+{
+	const mgl_f32_t* d = m->data;
+	manager->trs.translation[0][i] = d[12];
+	manager->trs.translation[1][i] = d[13];
+	manager->trs.translation[2][i] = d[14];
+
+	// The scale is the length of each column, mirrored matrices get a negative x scale
+	mgl_f32_t s[3];
+	for (mgl_u64_t c = 0; c < 3; ++c)
+		s[c] = sqrtf(d[c * 4 + 0] * d[c * 4 + 0] + d[c * 4 + 1] * d[c * 4 + 1] + d[c * 4 + 2] * d[c * 4 + 2]);
+	mgl_f32_t det =
+		d[0] * (d[5] * d[10] - d[9] * d[6]) -
+		d[4] * (d[1] * d[10] - d[9] * d[2]) +
+		d[8] * (d[1] * d[6] - d[5] * d[2]);
+	if (det < 0.0f)
+		s[0] = -s[0];
+
+	mgl_f32_t r[3][3];
+	for (mgl_u64_t c = 0; c < 3; ++c)
+	{
+		manager->trs.scale[c][i] = s[c];
+		mgl_f32_t inv = s[c] != 0.0f ? 1.0f / s[c] : 0.0f;
+		for (mgl_u64_t row = 0; row < 3; ++row)
+			r[row][c] = d[c * 4 + row] * inv;
+	}
+
+	// Rotation matrix to quaternion, picking the largest diagonal term for precision
+	mgl_f32_t q[4];
+	mgl_f32_t trace = r[0][0] + r[1][1] + r[2][2];
+	if (trace > 0.0f)
+	{
+		mgl_f32_t k = sqrtf(trace + 1.0f) * 2.0f;
+		q[0] = (r[2][1] - r[1][2]) / k;
+		q[1] = (r[0][2] - r[2][0]) / k;
+		q[2] = (r[1][0] - r[0][1]) / k;
+		q[3] = 0.25f * k;
+	}
+	else if (r[0][0] > r[1][1] && r[0][0] > r[2][2])
+	{
+		mgl_f32_t k = sqrtf(1.0f + r[0][0] - r[1][1] - r[2][2]) * 2.0f;
+		q[0] = 0.25f * k;
+		q[1] = (r[0][1] + r[1][0]) / k;
+		q[2] = (r[0][2] + r[2][0]) / k;
+		q[3] = (r[2][1] - r[1][2]) / k;
+	}
+	else if (r[1][1] > r[2][2])
+	{
+		mgl_f32_t k = sqrtf(1.0f + r[1][1] - r[0][0] - r[2][2]) * 2.0f;
+		q[0] = (r[0][1] + r[1][0]) / k;
+		q[1] = 0.25f * k;
+		q[2] = (r[1][2] + r[2][1]) / k;
+		q[3] = (r[0][2] - r[2][0]) / k;
+	}
+	else
+	{
+		mgl_f32_t k = sqrtf(1.0f + r[2][2] - r[0][0] - r[1][1]) * 2.0f;
+		q[0] = (r[0][2] + r[2][0]) / k;
+		q[1] = (r[1][2] + r[2][1]) / k;
+		q[2] = 0.25f * k;
+		q[3] = (r[1][0] - r[0][1]) / k;
+	}
+	for (mgl_u64_t c = 0; c < 4; ++c)
+		manager->trs.rotation[c][i] = q[c];
+}
+
+static mgl_u64_t mge_mark_scene_node_trs_dirty(mge_scene_node_t* node)
+{
+	mge_scene_manager_t* manager = node->manager;
+	mgl_u64_t index = (mgl_u64_t)(node - manager->nodes);
+	if (!MGE_SCENE_BITSET_TEST(manager->trs.bits, index))
+		mge_scene_node_enable_trs(node);
+	MGE_SCENE_BITSET_SET(manager->trs.dirty_bits, index);
+	mge_scene_node_set_dirty(node);
+	return index;
+}
+
+void mge_scene_node_enable_trs(mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(node != NULL);
+	if (node->parent == NULL)
+		mge_fatal_error(MGE_LOG_ENGINE, u8"Failed to enable scene node TRS, the root scene node cannot be transformed");
+
+	mge_scene_manager_t* manager = node->manager;
+	mgl_u64_t index = (mgl_u64_t)(node - manager->nodes);
+	if (MGE_SCENE_BITSET_TEST(manager->trs.bits, index))
+		return;
+
+	mge_decompose_trs_matrix(manager, index, &node->transform.local);
+	MGE_SCENE_BITSET_SET(manager->trs.bits, index);
+}
+
+void mge_scene_node_disable_trs(mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(node != NULL);
+
+	mge_compose_scene_node_trs(node);
+	MGE_SCENE_BITSET_CLEAR(node->manager->trs.bits, (mgl_u64_t)(node - node->manager->nodes));
+}
+
+mgl_bool_t mge_scene_node_has_trs(mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(node != NULL);
+	return MGE_SCENE_BITSET_TEST(node->manager->trs.bits, (mgl_u64_t)(node - node->manager->nodes));
+}
+
+void mge_scene_node_set_translation(mge_scene_node_t * node, const mgl_f32_t translation[3])
+{
+	MGL_DEBUG_ASSERT(node != NULL && translation != NULL);
+
+	mgl_u64_t index = mge_mark_scene_node_trs_dirty(node);
+	for (mgl_u64_t i = 0; i < 3; ++i)
+		node->manager->trs.translation[i][index] = translation[i];
+}
+
+void mge_scene_node_set_rotation(mge_scene_node_t * node, const mgl_f32_t rotation[4])
+{
+	MGL_DEBUG_ASSERT(node != NULL && rotation != NULL);
+
+	mgl_u64_t index = mge_mark_scene_node_trs_dirty(node);
+	for (mgl_u64_t i = 0; i < 4; ++i)
+		node->manager->trs.rotation[i][index] = rotation[i];
+}
+
+void mge_scene_node_set_scale(mge_scene_node_t * node, const mgl_f32_t scale[3])
+{
+	MGL_DEBUG_ASSERT(node != NULL && scale != NULL);
+
+	mgl_u64_t index = mge_mark_scene_node_trs_dirty(node);
+	for (mgl_u64_t i = 0; i < 3; ++i)
+		node->manager->trs.scale[i][index] = scale[i];
+}
+
+void mge_scene_node_get_trs(mge_scene_node_t * node, mgl_f32_t translation[3], mgl_f32_t rotation[4], mgl_f32_t scale[3])
+{
+	MGL_DEBUG_ASSERT(node != NULL && mge_scene_node_has_trs(node));
+
+	mge_scene_manager_t* manager = node->manager;
+	mgl_u64_t index = (mgl_u64_t)(node - manager->nodes);
+	for (mgl_u64_t i = 0; i < 4; ++i)
+	{
+		if (translation != NULL && i < 3)
+			translation[i] = manager->trs.translation[i][index];
+		if (rotation != NULL)
+			rotation[i] = manager->trs.rotation[i][index];
+		if (scale != NULL && i < 3)
+			scale[i] = manager->trs.scale[i][index];
+	}
+}
+
+void mge_compose_scene_node_trs(mge_scene_node_t * node)
+{
+	MGL_DEBUG_ASSERT(node != NULL);
+
+	mge_scene_manager_t* manager = node->manager;
+	mgl_u64_t index = (mgl_u64_t)(node - manager->nodes);
+	if (!MGE_SCENE_BITSET_TEST(manager->trs.dirty_bits, index))
+		return;
+
+	mge_compose_trs_matrix(manager, index, &node->transform.local);
+	MGE_SCENE_BITSET_CLEAR(manager->trs.dirty_bits, index);
+}
+
+void mge_compose_scene_trs(mge_scene_manager_t * manager)
+{
+	MGL_DEBUG_ASSERT(manager != NULL);
+
+	mgl_u64_t word_count = MGE_SCENE_BITSET_WORD_COUNT(manager->max_node_count);
+	for (mgl_u64_t word = 0; word < word_count; ++word)
+	{
+		mgl_u64_t bits = manager->trs.dirty_bits[word];
+		manager->trs.dirty_bits[word] = 0;
+
+		// Each group of 4 consecutive nodes with at least one dirty node is composed at once
+		while (bits != 0)
+		{
+			mgl_u64_t group = mge_scene_bitset_ctz(bits) / 4;
+			mgl_u64_t mask = (bits >> (group * 4)) & 0xF;
+			bits &= ~(0xFull << (group * 4));
+			mgl_u64_t first = word * 64 + group * 4;
+
+#ifdef MGE_TRS_SSE
+			__m128 x = _mm_loadu_ps(&manager->trs.rotation[0][first]);
+			__m128 y = _mm_loadu_ps(&manager->trs.rotation[1][first]);
+			__m128 z = _mm_loadu_ps(&manager->trs.rotation[2][first]);
+			__m128 w = _mm_loadu_ps(&manager->trs.rotation[3][first]);
+			__m128 one = _mm_set1_ps(1.0f);
+			__m128 two = _mm_set1_ps(2.0f);
+
+			__m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+			__m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+			__m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+			__m128 sx = _mm_loadu_ps(&manager->trs.scale[0][first]);
+			__m128 sy = _mm_loadu_ps(&manager->trs.scale[1][first]);
+			__m128 sz = _mm_loadu_ps(&manager->trs.scale[2][first]);
+
+			// Element (row, column) of the four matrices
+			__m128 m[4][4];
+			m[0][0] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+			m[1][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+			m[2][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+			m[3][0] = _mm_setzero_ps();
+			m[0][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+			m[1][1] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+			m[2][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+			m[3][1] = _mm_setzero_ps();
+			m[0][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+			m[1][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+			m[2][2] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+			m[3][2] = _mm_setzero_ps();
+			m[0][3] = _mm_loadu_ps(&manager->trs.translation[0][first]);
+			m[1][3] = _mm_loadu_ps(&manager->trs.translation[1][first]);
+			m[2][3] = _mm_loadu_ps(&manager->trs.translation[2][first]);
+			m[3][3] = one;
+
+			// Transposing the rows of each column gives that column for each of the four nodes
+			for (mgl_u64_t c = 0; c < 4; ++c)
+			{
+				__m128 r0 = m[0][c], r1 = m[1][c], r2 = m[2][c], r3 = m[3][c];
+				_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+				__m128 columns[4] = { r0, r1, r2, r3 };
+				for (mgl_u64_t i = 0; i < 4; ++i)
+					if (mask & (1ull << i))
+						_mm_storeu_ps(&manager->nodes[first + i].transform.local.data[c * 4], columns[i]);
+			}
+#else
+			for (mgl_u64_t i = 0; i < 4; ++i)
+				if (mask & (1ull << i))
+					mge_compose_trs_matrix(manager, first + i, &manager->nodes[first + i].transform.local);
+#endif
+		}
+	}
+}
@@ -0,0 +1,39 @@
+#include <mge/time.h>
+
+#if defined(_WIN32)
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else
+#	include <time.h>
+#	include <errno.h>
+#endif
+
+mgl_u64_t mge_get_time(void)
+{
+#if defined(_WIN32)
+	static LARGE_INTEGER frequency = { 0 };
+	if (frequency.QuadPart == 0)
+		QueryPerformanceFrequency(&frequency);
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return (mgl_u64_t)(counter.QuadPart / frequency.QuadPart) * MGE_NANOSECONDS_PER_SECOND +
+		(mgl_u64_t)(counter.QuadPart % frequency.QuadPart) * MGE_NANOSECONDS_PER_SECOND / (mgl_u64_t)frequency.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (mgl_u64_t)ts.tv_sec * MGE_NANOSECONDS_PER_SECOND + (mgl_u64_t)ts.tv_nsec;
+#endif
+}
+
+void mge_sleep(mgl_u64_t ns)
+{
+#if defined(_WIN32)
+	Sleep((DWORD)((ns + 999999) / 1000000));
+#else
+	struct timespec ts;
+	ts.tv_sec = (time_t)(ns / MGE_NANOSECONDS_PER_SECOND);
+	ts.tv_nsec = (long)(ns % MGE_NANOSECONDS_PER_SECOND);
+	while (nanosleep(&ts, &ts) != 0 && errno == EINTR);
+#endif
+}
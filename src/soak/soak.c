@@ -0,0 +1,532 @@
+#include "../bench/data.h"
+
+#include <mge/config.h>
+#include <mge/game.h>
+#include <mge/log.h>
+#include <mge/loop.h>
+#include <mge/time.h>
+#include <mge/memory/tracking.h>
+#include <mge/platform/file.h>
+#include <mge/platform/process.h>
+#include <mge/resource/manager.h>
+#include <mge/resource/text.h>
+#include <mge/scene/node.h>
+
+#include <mgl/memory/allocator.h>
+#include <mgl/stream/stream.h>
+#include <mgl/string/manipulation.h>
+
+// Number of frames opened resources and churned nodes are kept for
+#define SOAK_LIFETIME 8
+// Number of children of each node of the static hierarchy
+#define SOAK_FAN_OUT 8
+#define SOAK_TEXT_SIZE 64
+#define SOAK_PACK_NAME u8"mge_soak"
+
+// Latencies are counted on log-linear buckets: 16 exact buckets, then 8 buckets per power of two,
+// so percentiles are off by at most 12.5%
+#define SOAK_BUCKET_COUNT (16 + 60 * 8)
+#define SOAK_MAX_JSON_SIZE (1 << 14)
+
+typedef struct
+{
+	const mgl_chr8_t* name;
+	mgl_u64_t count;
+	mgl_u64_t max;
+	mgl_u64_t buckets[SOAK_BUCKET_COUNT];
+} soak_metric_t;
+
+enum
+{
+	SOAK_METRIC_FRAME,
+	SOAK_METRIC_RESOURCE_OPEN,
+	SOAK_METRIC_RESOURCE_CLOSE,
+	SOAK_METRIC_NODE_CREATE,
+	SOAK_METRIC_NODE_DESTROY,
+	SOAK_METRIC_UPDATE_TRANSFORMS,
+	SOAK_METRIC_COUNT,
+};
+
+static struct
+{
+	mgl_u64_t duration;
+	mgl_u64_t warmup;
+	mgl_u64_t report_interval;
+	mgl_u64_t resource_count;
+	mgl_u64_t node_count;
+	mgl_u64_t open_count;
+	mgl_u64_t churn_count;
+	const mgl_chr8_t* output_path;
+	mgl_bool_t has_max_rss_growth;
+	mgl_u64_t max_rss_growth;
+} soak_options = { 60, 10, 10, 10000, 100000, 1000, 1000, NULL, MGL_FALSE, 0 };
+
+static struct
+{
+	mge_resource_manager_t* resource_manager;
+	mge_resource_t** resources;
+	mge_text_resource_access_t* accesses;
+	mgl_u64_t access_count;
+	mgl_u64_t access_position;
+
+	mge_scene_manager_t* scene_manager;
+	mge_scene_node_t** nodes;
+	mge_scene_node_t** churned_nodes;
+	mgl_u64_t churned_node_count;
+	mgl_u64_t churned_node_position;
+
+	mgl_u32_t random;
+
+	// Times are in nanoseconds
+	mgl_u64_t start_time;
+	mgl_u64_t measure_time;
+	mgl_u64_t last_frame_time;
+	mgl_u64_t next_report_time;
+	mgl_u64_t end_time;
+	mgl_bool_t measuring;
+	mgl_u64_t frame_count;
+
+	// Memory is sampled when the warm-up ends and when the run ends
+	mgl_u64_t start_rss;
+	mgl_u64_t end_rss;
+	mge_memory_stats_t start_heap;
+	mge_memory_stats_t end_heap;
+	mge_memory_stats_t game_before;
+	mge_memory_stats_t game_after;
+} soak;
+
+static soak_metric_t soak_metrics[SOAK_METRIC_COUNT] =
+{
+	{ u8"frame", 0, 0, { 0 } },
+	{ u8"resource/open", 0, 0, { 0 } },
+	{ u8"resource/close", 0, 0, { 0 } },
+	{ u8"scene/create_node", 0, 0, { 0 } },
+	{ u8"scene/destroy_node", 0, 0, { 0 } },
+	{ u8"scene/update_transforms", 0, 0, { 0 } },
+};
+
+static mgl_chr8_t soak_json[SOAK_MAX_JSON_SIZE];
+static mgl_u64_t soak_json_size = 0;
+
+static mgl_u64_t soak_get_bucket(mgl_u64_t value)
+{
+	if (value < 16)
+		return value;
+	mgl_u64_t msb = 4;
+	for (mgl_u64_t shift = 32; shift > 0; shift /= 2)
+		if ((value >> msb) >> shift != 0)
+			msb += shift;
+	return 16 + (msb - 4) * 8 + ((value >> (msb - 3)) & 7);
+}
+
+// Highest value counted on a bucket
+static mgl_u64_t soak_get_bucket_limit(mgl_u64_t bucket)
+{
+	if (bucket < 16)
+		return bucket;
+	mgl_u64_t msb = 4 + (bucket - 16) / 8;
+	mgl_u64_t sub = (bucket - 16) % 8;
+	return ((8 + sub + 1) << (msb - 3)) - 1;
+}
+
+static void soak_record(mgl_enum_u32_t metric, mgl_u64_t time)
+{
+	if (!soak.measuring)
+		return;
+	soak_metric_t* m = &soak_metrics[metric];
+	m->count += 1;
+	m->buckets[soak_get_bucket(time)] += 1;
+	if (time > m->max)
+		m->max = time;
+}
+
+// Gets a percentile (in tenths of a percent) of a metric's values
+static mgl_u64_t soak_get_percentile(const soak_metric_t* metric, mgl_u64_t permille)
+{
+	if (metric->count == 0)
+		return 0;
+	mgl_u64_t target = (metric->count * permille + 999) / 1000;
+	mgl_u64_t count = 0;
+	for (mgl_u64_t i = 0; i < SOAK_BUCKET_COUNT; ++i)
+	{
+		count += metric->buckets[i];
+		if (count >= target)
+		{
+			mgl_u64_t limit = soak_get_bucket_limit(i);
+			return limit < metric->max ? limit : metric->max;
+		}
+	}
+	return metric->max;
+}
+
+static void soak_parse_options(mge_game_locator_t* locator)
+{
+	for (mgl_u64_t i = 0; i + 1 < locator->argument_count; ++i)
+	{
+		const mgl_chr8_t* option = locator->arguments[i];
+		const mgl_chr8_t* value = locator->arguments[i + 1];
+
+		if (mgl_str_equal(option, u8"-soak-duration"))
+			soak_options.duration = bench_parse_u64_option(option, value);
+		else if (mgl_str_equal(option, u8"-soak-warmup"))
+			soak_options.warmup = bench_parse_u64_option(option, value);
+		else if (mgl_str_equal(option, u8"-soak-report-interval"))
+			soak_options.report_interval = bench_parse_u64_option(option, value);
+		else if (mgl_str_equal(option, u8"-soak-resources"))
+			soak_options.resource_count = bench_parse_u64_option(option, value);
+		else if (mgl_str_equal(option, u8"-soak-nodes"))
+			soak_options.node_count = bench_parse_u64_option(option, value);
+		else if (mgl_str_equal(option, u8"-soak-opens"))
+			soak_options.open_count = bench_parse_u64_option(option, value);
+		else if (mgl_str_equal(option, u8"-soak-churn"))
+			soak_options.churn_count = bench_parse_u64_option(option, value);
+		else if (mgl_str_equal(option, u8"-soak-output"))
+			soak_options.output_path = value;
+		else if (mgl_str_equal(option, u8"-soak-max-rss-growth"))
+		{
+			soak_options.has_max_rss_growth = MGL_TRUE;
+			soak_options.max_rss_growth = bench_parse_u64_option(option, value);
+		}
+		else
+			continue;
+		i += 1;
+	}
+
+	if (soak_options.duration == 0 || soak_options.warmup >= soak_options.duration)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to parse soak options, the warm-up must be shorter than the duration");
+	if (soak_options.resource_count == 0 || soak_options.node_count == 0)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to parse soak options, there must be at least one resource and one node");
+}
+
+static void* soak_allocate(mge_game_locator_t* locator, mgl_u64_t size)
+{
+	void* ptr;
+	if (mgl_allocate(locator->game_allocator, size > 0 ? size : 1, &ptr) != MGL_ERROR_NONE)
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to allocate soak test data");
+	return ptr;
+}
+
+static void soak_deallocate(mge_game_locator_t* locator, void* ptr)
+{
+	mgl_error_t err = mgl_deallocate(locator->game_allocator, ptr);
+	if (err != MGL_ERROR_NONE)
+		mge_fatal_mgl_error(MGE_LOG_GAME_CLIENT, u8"Failed to deallocate soak test data", err);
+}
+
+static void soak_init_resources(mge_game_locator_t* locator)
+{
+	mgl_chr8_t path[MGE_MAX_RESOURCE_DATA_PATH_SIZE];
+	mgl_chr8_t name[MGE_MAX_RESOURCE_NAME_SIZE];
+
+	bench_generate_resource_pack(SOAK_PACK_NAME, soak_options.resource_count, MGE_RESOURCE_TEXT, SOAK_TEXT_SIZE);
+	soak.resource_manager = mge_init_resource_manager(locator->game_allocator, NULL, soak_options.resource_count);
+	bench_get_resource_pack_path(SOAK_PACK_NAME, path);
+	mge_add_resource_info_file(soak.resource_manager, path);
+
+	soak.resources = (mge_resource_t**)soak_allocate(locator, soak_options.resource_count * sizeof(mge_resource_t*));
+	for (mgl_u64_t i = 0; i < soak_options.resource_count; ++i)
+	{
+		bench_get_resource_name(i, name);
+		soak.resources[i] = mge_find_resource(soak.resource_manager, name);
+	}
+
+	soak.accesses = (mge_text_resource_access_t*)soak_allocate(locator, soak_options.open_count * SOAK_LIFETIME * sizeof(mge_text_resource_access_t));
+	soak.access_count = 0;
+	soak.access_position = 0;
+}
+
+static void soak_terminate_resources(mge_game_locator_t* locator)
+{
+	for (mgl_u64_t i = 0; i < soak.access_count; ++i)
+		mge_close_resource(&soak.accesses[i]);
+	soak_deallocate(locator, soak.accesses);
+	soak_deallocate(locator, soak.resources);
+	mge_terminate_resource_manager(soak.resource_manager);
+}
+
+static void soak_init_scene(mge_game_locator_t* locator)
+{
+	// Plus the churned nodes and the root node
+	mgl_u64_t churned_capacity = soak_options.churn_count * SOAK_LIFETIME;
+	soak.scene_manager = mge_init_scene_manager(locator->game_allocator, soak_options.node_count + churned_capacity + 1);
+
+	// Static hierarchy, breadth-first, where every node has SOAK_FAN_OUT children
+	soak.nodes = (mge_scene_node_t**)soak_allocate(locator, soak_options.node_count * sizeof(mge_scene_node_t*));
+	for (mgl_u64_t i = 0; i < soak_options.node_count; ++i)
+	{
+		mge_scene_node_t* parent = i < SOAK_FAN_OUT ? soak.scene_manager->root : soak.nodes[(i - SOAK_FAN_OUT) / SOAK_FAN_OUT];
+		soak.nodes[i] = mge_create_scene_node(parent, NULL);
+	}
+	mge_update_scene_transforms(soak.scene_manager);
+
+	soak.churned_nodes = (mge_scene_node_t**)soak_allocate(locator, churned_capacity * sizeof(mge_scene_node_t*));
+	soak.churned_node_count = 0;
+	soak.churned_node_position = 0;
+}
+
+static void soak_terminate_scene(mge_game_locator_t* locator)
+{
+	soak_deallocate(locator, soak.churned_nodes);
+	soak_deallocate(locator, soak.nodes);
+	mge_terminate_scene_manager(soak.scene_manager);
+}
+
+// Opens random resources and closes the ones opened SOAK_LIFETIME frames ago, so resources keep being loaded and unloaded
+static void soak_update_resources(void)
+{
+	mgl_u64_t capacity = soak_options.open_count * SOAK_LIFETIME;
+	for (mgl_u64_t i = 0; i < soak_options.open_count; ++i)
+	{
+		mge_text_resource_access_t* access = &soak.accesses[soak.access_position];
+		mgl_u64_t time;
+		if (soak.access_count == capacity)
+		{
+			time = mge_get_time();
+			mge_close_resource(access);
+			soak_record(SOAK_METRIC_RESOURCE_CLOSE, mge_get_time() - time);
+		}
+		else
+			soak.access_count += 1;
+
+		mge_resource_t* rsc = soak.resources[bench_random(&soak.random) % soak_options.resource_count];
+		time = mge_get_time();
+		mge_open_resource(rsc, access, MGE_RESOURCE_TEXT);
+		soak_record(SOAK_METRIC_RESOURCE_OPEN, mge_get_time() - time);
+
+		soak.access_position = (soak.access_position + 1) % capacity;
+	}
+}
+
+// Replaces the nodes created SOAK_LIFETIME frames ago with new leaves, moves random nodes and updates the transforms
+static void soak_update_scene(void)
+{
+	mgl_u64_t capacity = soak_options.churn_count * SOAK_LIFETIME;
+	for (mgl_u64_t i = 0; i < soak_options.churn_count; ++i)
+	{
+		mge_scene_node_t** node = &soak.churned_nodes[soak.churned_node_position];
+		mgl_u64_t time;
+		if (soak.churned_node_count == capacity)
+		{
+			time = mge_get_time();
+			mge_destroy_scene_node(*node);
+			soak_record(SOAK_METRIC_NODE_DESTROY, mge_get_time() - time);
+		}
+		else
+			soak.churned_node_count += 1;
+
+		mge_scene_node_t* parent = soak.nodes[bench_random(&soak.random) % soak_options.node_count];
+		time = mge_get_time();
+		*node = mge_create_scene_node(parent, NULL);
+		soak_record(SOAK_METRIC_NODE_CREATE, mge_get_time() - time);
+
+		soak.churned_node_position = (soak.churned_node_position + 1) % capacity;
+	}
+
+	for (mgl_u64_t i = 0; i < soak_options.churn_count; ++i)
+		mge_scene_node_set_dirty(soak.nodes[bench_random(&soak.random) % soak_options.node_count]);
+
+	mgl_u64_t time = mge_get_time();
+	mge_update_scene_transforms(soak.scene_manager);
+	soak_record(SOAK_METRIC_UPDATE_TRANSFORMS, mge_get_time() - time);
+}
+
+// Appends a byte count, which can be negative
+static void soak_append_i64(mgl_chr8_t* buffer, mgl_u64_t* size, mgl_u64_t max_size, mgl_i64_t value)
+{
+	if (value < 0)
+	{
+		bench_append(buffer, size, max_size, u8"-");
+		bench_append_u64(buffer, size, max_size, (mgl_u64_t)-value);
+	}
+	else
+		bench_append_u64(buffer, size, max_size, (mgl_u64_t)value);
+}
+
+static void soak_log_progress(mgl_u64_t now)
+{
+	mgl_chr8_t line[256];
+	mgl_u64_t size = 0;
+	const soak_metric_t* frame = &soak_metrics[SOAK_METRIC_FRAME];
+	mge_memory_stats_t heap;
+	mge_get_memory_stats(NULL, &heap);
+
+	bench_append(line, &size, sizeof(line), u8"Soak test at ");
+	bench_append_u64(line, &size, sizeof(line), (now - soak.start_time) / MGE_NANOSECONDS_PER_SECOND);
+	bench_append(line, &size, sizeof(line), u8" s: ");
+	bench_append_u64(line, &size, sizeof(line), soak.frame_count);
+	bench_append(line, &size, sizeof(line), u8" frames, frame p99 ");
+	bench_append_u64(line, &size, sizeof(line), soak_get_percentile(frame, 990) / 1000);
+	bench_append(line, &size, sizeof(line), u8" us, RSS ");
+	bench_append_u64(line, &size, sizeof(line), mge_internal_get_resident_memory_size() / 1024);
+	bench_append(line, &size, sizeof(line), u8" KiB, heap ");
+	bench_append_u64(line, &size, sizeof(line), heap.live_bytes / 1024);
+	bench_append(line, &size, sizeof(line), u8" KiB\n");
+	MGE_LOG_VERBOSE_1(MGE_LOG_GAME_CLIENT, line);
+}
+
+static void soak_write_json(void)
+{
+	mgl_chr8_t* b = soak_json;
+	mgl_u64_t* s = &soak_json_size;
+	mgl_u64_t m = SOAK_MAX_JSON_SIZE;
+	mgl_u64_t measured_time = soak.end_time - soak.measure_time;
+
+	bench_append(b, s, m, u8"{\n\t\"version\": \"" MGE_VERSION u8"\",\n\t\"duration_s\": ");
+	bench_append_u64(b, s, m, soak_options.duration);
+	bench_append(b, s, m, u8",\n\t\"warmup_s\": ");
+	bench_append_u64(b, s, m, soak_options.warmup);
+	bench_append(b, s, m, u8",\n\t\"resources\": ");
+	bench_append_u64(b, s, m, soak_options.resource_count);
+	bench_append(b, s, m, u8",\n\t\"nodes\": ");
+	bench_append_u64(b, s, m, soak_options.node_count);
+	bench_append(b, s, m, u8",\n\t\"opens_per_frame\": ");
+	bench_append_u64(b, s, m, soak_options.open_count);
+	bench_append(b, s, m, u8",\n\t\"churn_per_frame\": ");
+	bench_append_u64(b, s, m, soak_options.churn_count);
+	bench_append(b, s, m, u8",\n\t\"frames\": ");
+	bench_append_u64(b, s, m, soak.frame_count);
+
+	bench_append(b, s, m, u8",\n\t\"metrics\": [\n");
+	for (mgl_u64_t i = 0; i < SOAK_METRIC_COUNT; ++i)
+	{
+		const soak_metric_t* metric = &soak_metrics[i];
+		bench_append(b, s, m, u8"\t\t{ \"name\": \"");
+		bench_append(b, s, m, metric->name);
+		bench_append(b, s, m, u8"\", \"count\": ");
+		bench_append_u64(b, s, m, metric->count);
+		bench_append(b, s, m, u8", \"per_second\": ");
+		bench_append_u64(b, s, m, measured_time > 0 ? (mgl_u64_t)((double)metric->count * MGE_NANOSECONDS_PER_SECOND / (double)measured_time) : 0);
+		bench_append(b, s, m, u8", \"p50_ns\": ");
+		bench_append_u64(b, s, m, soak_get_percentile(metric, 500));
+		bench_append(b, s, m, u8", \"p90_ns\": ");
+		bench_append_u64(b, s, m, soak_get_percentile(metric, 900));
+		bench_append(b, s, m, u8", \"p99_ns\": ");
+		bench_append_u64(b, s, m, soak_get_percentile(metric, 990));
+		bench_append(b, s, m, u8", \"p999_ns\": ");
+		bench_append_u64(b, s, m, soak_get_percentile(metric, 999));
+		bench_append(b, s, m, u8", \"max_ns\": ");
+		bench_append_u64(b, s, m, metric->max);
+		bench_append(b, s, m, i + 1 < SOAK_METRIC_COUNT ? u8" },\n" : u8" }\n");
+	}
+
+	bench_append(b, s, m, u8"\t],\n\t\"memory\": {\n\t\t\"rss_start_bytes\": ");
+	bench_append_u64(b, s, m, soak.start_rss);
+	bench_append(b, s, m, u8",\n\t\t\"rss_end_bytes\": ");
+	bench_append_u64(b, s, m, soak.end_rss);
+	bench_append(b, s, m, u8",\n\t\t\"rss_growth_bytes\": ");
+	soak_append_i64(b, s, m, (mgl_i64_t)soak.end_rss - (mgl_i64_t)soak.start_rss);
+	bench_append(b, s, m, u8",\n\t\t\"heap_start_bytes\": ");
+	bench_append_u64(b, s, m, soak.start_heap.live_bytes);
+	bench_append(b, s, m, u8",\n\t\t\"heap_end_bytes\": ");
+	bench_append_u64(b, s, m, soak.end_heap.live_bytes);
+	bench_append(b, s, m, u8",\n\t\t\"heap_growth_bytes\": ");
+	soak_append_i64(b, s, m, (mgl_i64_t)soak.end_heap.live_bytes - (mgl_i64_t)soak.start_heap.live_bytes);
+	bench_append(b, s, m, u8",\n\t\t\"heap_peak_bytes\": ");
+	bench_append_u64(b, s, m, soak.end_heap.peak_bytes);
+	bench_append(b, s, m, u8",\n\t\t\"leaked_bytes\": ");
+	bench_append_u64(b, s, m, soak.game_after.live_bytes - soak.game_before.live_bytes);
+	bench_append(b, s, m, u8",\n\t\t\"leaked_allocations\": ");
+	bench_append_u64(b, s, m, soak.game_after.live_allocation_count - soak.game_before.live_allocation_count);
+	bench_append(b, s, m, u8"\n\t}\n}\n");
+}
+
+void mge_game_get_config(mge_engine_config_t* config)
+{
+	// The soak test runs as fast as it can, until its duration is reached
+	config->headless = MGL_TRUE;
+	config->target_frame_rate = 0;
+	config->frame_cap = 0;
+}
+
+void mge_game_load(mge_game_locator_t* locator)
+{
+	soak_parse_options(locator);
+	bench_register_archive();
+	mge_get_memory_stats(u8"game", &soak.game_before);
+
+	MGE_LOG_VERBOSE_1(MGE_LOG_GAME_CLIENT, u8"Generating soak test data\n");
+	soak_init_resources(locator);
+	soak_init_scene(locator);
+	soak.random = 12345;
+
+	soak.start_time = mge_get_time();
+	soak.measure_time = soak.start_time + soak_options.warmup * MGE_NANOSECONDS_PER_SECOND;
+	soak.end_time = soak.start_time + soak_options.duration * MGE_NANOSECONDS_PER_SECOND;
+	soak.next_report_time = soak_options.report_interval > 0 ? soak.start_time + soak_options.report_interval * MGE_NANOSECONDS_PER_SECOND : (mgl_u64_t)-1;
+	soak.last_frame_time = soak.start_time;
+	soak.measuring = soak_options.warmup == 0;
+	soak.frame_count = 0;
+	if (soak.measuring)
+	{
+		soak.start_rss = mge_internal_get_resident_memory_size();
+		mge_get_memory_stats(NULL, &soak.start_heap);
+	}
+}
+
+void mge_game_unload(mge_game_locator_t* locator)
+{
+	soak.end_rss = mge_internal_get_resident_memory_size();
+	mge_get_memory_stats(NULL, &soak.end_heap);
+
+	// Anything left on the game allocator once everything is terminated leaked
+	soak_terminate_scene(locator);
+	soak_terminate_resources(locator);
+	mge_get_memory_stats(u8"game", &soak.game_after);
+	bench_unregister_archive();
+
+	// The JSON goes to stdout unless an output file is set
+	soak_write_json();
+	if (soak_options.output_path == NULL)
+		mgl_print(mgl_stdout_stream, soak_json);
+	else if (!mge_internal_write_file(soak_options.output_path, soak_json, soak_json_size))
+		mge_fatal_error(MGE_LOG_GAME_CLIENT, u8"Failed to write soak test results");
+
+	if (soak.game_after.live_allocation_count != soak.game_before.live_allocation_count)
+	{
+		MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, u8"Soak test leaked memory\n");
+		locator->exit_code = 1;
+	}
+
+	if (soak_options.has_max_rss_growth && soak.end_rss > soak.start_rss + soak_options.max_rss_growth * 1024 * 1024)
+	{
+		MGE_LOG_VERBOSE_0(MGE_LOG_GAME_CLIENT, u8"Soak test RSS grew over the limit\n");
+		locator->exit_code = 1;
+	}
+}
+
+void mge_game_fixed_update(mge_game_locator_t* locator)
+{
+
+}
+
+void mge_game_update(mge_game_locator_t* locator)
+{
+	mgl_u64_t now = mge_get_time();
+	if (soak.frame_count > 0)
+		soak_record(SOAK_METRIC_FRAME, now - soak.last_frame_time);
+	soak.last_frame_time = now;
+
+	if (!soak.measuring && now >= soak.measure_time)
+	{
+		soak.measuring = MGL_TRUE;
+		soak.start_rss = mge_internal_get_resident_memory_size();
+		mge_get_memory_stats(NULL, &soak.start_heap);
+	}
+
+	if (soak_options.report_interval > 0 && now >= soak.next_report_time)
+	{
+		soak_log_progress(now);
+		soak.next_report_time += soak_options.report_interval * MGE_NANOSECONDS_PER_SECOND;
+	}
+
+	if (now >= soak.end_time)
+	{
+		soak.end_time = now;
+		mge_stop_loop(locator->loop);
+		return;
+	}
+
+	soak_update_resources();
+	soak_update_scene();
+	soak.frame_count += 1;
+}